@@ -35,6 +35,68 @@ struct PixelInputType
 	float3 position3D : TEXCOORD2;
 };
 
+// The vertices of geometry drawn with a texture array keep the slice of the array after the texture co-ordinates
+struct ArrayVertexInputType
+{
+    float4 position : POSITION;
+    float3 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+};
+
+struct ArrayPixelInputType
+{
+    float4 position : SV_POSITION;
+    float3 tex : TEXCOORD0;
+    float3 normal : NORMAL;
+	float3 viewDirection : TEXCOORD1;
+	float3 position3D : TEXCOORD2;
+};
+
+// Instanced quads share the corners of one unit quad (0 to 1 on each axis), and each instance gives the quad's middle, half its
+// width and height, which way it faces, the size of its texture co-ordinates, its slice of the texture array and where its
+// texture co-ordinates start
+struct InstanceInputType
+{
+    float2 corner : POSITION;
+    float3 center : TEXCOORD1;
+    float2 extents : TEXCOORD2;
+    uint orientation : TEXCOORD3;
+    float2 textureScale : TEXCOORD4;
+    float slice : TEXCOORD5;
+    float2 textureOffset : TEXCOORD6;
+};
+
+// The ways a quad can face, as the directions its unit quad's x and y run in and its normal. Ceilings run their texture
+// co-ordinates the other way round. These need to match the table in the StaticBatchClass, and the normals are also the
+// normals of compact vertices, so they need to match the table in the CompactVertexClass
+static const float3 quadAxisU[6] =
+{
+	float3(1.0f, 0.0f, 0.0f), float3(0.0f, 0.0f, 1.0f), float3(1.0f, 0.0f, 0.0f),
+	float3(-1.0f, 0.0f, 0.0f), float3(0.0f, 0.0f, 1.0f), float3(0.0f, 0.0f, -1.0f)
+};
+
+static const float3 quadAxisV[6] =
+{
+	float3(0.0f, 0.0f, -1.0f), float3(-1.0f, 0.0f, 0.0f), float3(0.0f, -1.0f, 0.0f),
+	float3(0.0f, -1.0f, 0.0f), float3(0.0f, -1.0f, 0.0f), float3(0.0f, -1.0f, 0.0f)
+};
+
+static const float3 quadNormal[6] =
+{
+	float3(0.0f, 1.0f, 0.0f), float3(0.0f, -1.0f, 0.0f), float3(0.0f, 0.0f, -1.0f),
+	float3(0.0f, 0.0f, 1.0f), float3(1.0f, 0.0f, 0.0f), float3(-1.0f, 0.0f, 0.0f)
+};
+
+static const bool quadTextureFlipped[6] = { false, true, false, false, false, false };
+
+// Compact vertices keep their position and texture co-ordinates as half floats, which the input assembler turns back into
+// floats, and the index of their normal in the table above in the w of the position
+struct CompactVertexInputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
 PixelInputType LightVertexShader(VertexInputType input)
 {
     PixelInputType output;
@@ -69,4 +131,61 @@ PixelInputType LightVertexShader(VertexInputType input)
 	output.viewDirection = normalize(output.viewDirection);
 
     return output;
+}
+
+ArrayPixelInputType LightArrayVertexShader(ArrayVertexInputType input)
+{
+	VertexInputType lightInput;
+	PixelInputType lightOutput;
+	ArrayPixelInputType output;
+
+	// Light the vertex the same way as above
+	lightInput.position = input.position;
+	lightInput.tex = input.tex.xy;
+	lightInput.normal = input.normal;
+	lightOutput = LightVertexShader(lightInput);
+
+	// Pass the slice on to the pixel shader with the texture co-ordinates
+	output.position = lightOutput.position;
+	output.tex = float3(lightOutput.tex, input.tex.z);
+	output.normal = lightOutput.normal;
+	output.viewDirection = lightOutput.viewDirection;
+	output.position3D = lightOutput.position3D;
+
+	return output;
+}
+
+ArrayPixelInputType LightInstanceVertexShader(InstanceInputType input)
+{
+	ArrayVertexInputType quadVertex;
+	float2 textureCorner;
+	uint orientation = min(input.orientation, 5);
+
+	// Move the corner of the unit quad out to the edges of the instance's quad
+	float2 offset = (input.corner * 2.0f - 1.0f) * input.extents;
+	quadVertex.position = float4(input.center + offset.x * quadAxisU[orientation] + offset.y * quadAxisV[orientation], 1.0f);
+
+	// Scale and move the texture co-ordinates so the texture repeats across the quad as it did before
+	textureCorner = input.corner;
+	if (quadTextureFlipped[orientation])
+	{
+		textureCorner = float2(1.0f - input.corner.y, 1.0f - input.corner.x);
+	}
+	quadVertex.tex = float3(input.textureOffset + textureCorner * input.textureScale, input.slice);
+	quadVertex.normal = quadNormal[orientation];
+
+	// Light it as any other texture array vertex
+	return LightArrayVertexShader(quadVertex);
+}
+
+PixelInputType LightCompactVertexShader(CompactVertexInputType input)
+{
+	VertexInputType fullInput;
+
+	// Unpack the normal from the table, then light the vertex as any other
+	fullInput.position = float4(input.position.xyz, 1.0f);
+	fullInput.tex = input.tex;
+	fullInput.normal = quadNormal[min((uint)input.position.w, 5)];
+
+	return LightVertexShader(fullInput);
 }
\ No newline at end of file
@@ -14,6 +14,21 @@ struct VertexInputType
 	float3 normal : NORMAL;
 };
 
+// Compact vertices keep their position and texture co-ordinates as half floats, which the input assembler turns back into
+// floats, and the index of their normal in the table below in the w of the position
+struct CompactVertexInputType
+{
+    float4 position : POSITION;
+    float2 tex : TEXCOORD0;
+};
+
+// The normals a compact vertex can have. These need to match the table in the CompactVertexClass
+static const float3 compactNormal[6] =
+{
+	float3(0.0f, 1.0f, 0.0f), float3(0.0f, -1.0f, 0.0f), float3(0.0f, 0.0f, -1.0f),
+	float3(0.0f, 0.0f, 1.0f), float3(1.0f, 0.0f, 0.0f), float3(-1.0f, 0.0f, 0.0f)
+};
+
 struct PixelInputType
 {
     float4 position : SV_POSITION;
@@ -44,4 +59,16 @@ PixelInputType TextureVertexShader(VertexInputType input)
     output.normal = normalize(output.normal);
     
     return output;
+}
+
+PixelInputType TextureCompactVertexShader(CompactVertexInputType input)
+{
+	VertexInputType fullInput;
+
+	// Unpack the normal from the table, then draw the vertex as above
+	fullInput.position = float4(input.position.xyz, 1.0f);
+	fullInput.tex = input.tex;
+	fullInput.normal = compactNormal[min((uint)input.position.w, 5)];
+
+	return TextureVertexShader(fullInput);
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ ApplicationClass::ApplicationClass()
 	m_PostProcessingWindow = 0;
 	m_DistortionShader = 0;
 	m_DistortionTexture = 0;
+	m_DungeonBatch = 0;
 	m_DistortionAmount = 0.001f;
 	m_DistortionOn = true;
 	m_CollisionOn = true;
@@ -143,6 +144,105 @@ bool ApplicationClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidt
 	m_MapCamera->SetPosition(mapCameraX, mapCameraY, mapCameraZ);
 	m_MapCamera->SetRotation(mapRotationX, mapRotationY, mapRotationZ);
 
+	// If a seed search is set up, lay out the seeds without drawing them to find one that meets the targets, and show the
+	// results. The dungeon is made from the first seed that matched
+	bool SeedFound = false;
+	unsigned int FoundSeed = 0;
+	if (SEED_SEARCH_COUNT > 0)
+	{
+		SeedSearchClass* SeedSearch = new SeedSearchClass;
+		if (!SeedSearch)
+		{
+			return false;
+		}
+
+		result = SeedSearch->Initialise(SEED_SEARCH_THREADS, PREFAB_FILE);
+		if (!result)
+		{
+			MessageBox(hwnd, L"Could not initialize the seed search object.", L"Error", MB_OK);
+			SeedSearch->Shutdown();
+			delete SeedSearch;
+			SeedSearch = 0;
+			return false;
+		}
+
+		SeedSearchClass::Targets SeedTargets;
+		SeedTargets.MinRooms = SEED_TARGET_MIN_ROOMS;
+		SeedTargets.MaxRooms = SEED_TARGET_MAX_ROOMS;
+		SeedTargets.MinDepth = SEED_TARGET_MIN_DEPTH;
+		SeedTargets.MaxDepth = SEED_TARGET_MAX_DEPTH;
+		SeedTargets.MaxWidth = SEED_TARGET_MAX_SIZE;
+		SeedTargets.MaxHeight = SEED_TARGET_MAX_SIZE;
+		SeedTargets.MaxSmallDeadEnds = SEED_TARGET_MAX_SMALL_DEAD_ENDS;
+		SeedTargets.MinBranchingFactor = SEED_TARGET_MIN_BRANCHING;
+
+		SeedSearch->Search((unsigned int)time(NULL), SEED_SEARCH_COUNT, SeedSearchClass::CheckTargets, &SeedTargets);
+		if (!SeedSearch->GetMatches()->empty())
+		{
+			SeedFound = true;
+			FoundSeed = SeedSearch->GetMatches()->front().Seed;
+		}
+
+		WCHAR SearchText[256];
+		swprintf_s(SearchText, 256, L"Seeds tested: %d (%d stopped early)\nMatches: %d\nSeeds per second: %.0f\nSeed used: %u",
+			SeedSearch->GetSeedsTested(), SeedSearch->GetSeedsStoppedEarly(), SeedSearch->GetMatchCount(), SeedSearch->GetSeedsPerSecond(), FoundSeed);
+		MessageBox(hwnd, SearchText, L"Seed Search", MB_OK);
+
+		SeedSearch->Shutdown();
+		delete SeedSearch;
+		SeedSearch = 0;
+	}
+
+	// If a distribution report is set up, generate the sample of dungeons and write the report before the dungeon is made
+	if (REPORT_DUNGEON_COUNT > 0)
+	{
+		DistributionReportClass* Report = new DistributionReportClass;
+		if (!Report)
+		{
+			return false;
+		}
+
+		result = Report->Initialise(REPORT_THREADS, PREFAB_FILE);
+		if (!result)
+		{
+			MessageBox(hwnd, L"Could not initialize the distribution report object.", L"Error", MB_OK);
+			Report->Shutdown();
+			delete Report;
+			Report = 0;
+			return false;
+		}
+
+		Report->Generate((unsigned int)time(NULL), REPORT_DUNGEON_COUNT);
+		result = Report->WriteReport(REPORT_FILE);
+		if (!result)
+		{
+			MessageBox(hwnd, L"Could not write the distribution report.", L"Error", MB_OK);
+		}
+
+		Report->Shutdown();
+		delete Report;
+		Report = 0;
+	}
+
+	// If the benchmarks are set up, time the layouts they measure and write the timings before the dungeon is made
+	if (BENCHMARK_REPORT)
+	{
+		BenchmarkClass* Benchmark = new BenchmarkClass;
+		if (!Benchmark)
+		{
+			return false;
+		}
+
+		result = Benchmark->WriteReport(BENCHMARK_FILE);
+		if (!result)
+		{
+			MessageBox(hwnd, L"Could not write the benchmark report.", L"Error", MB_OK);
+		}
+
+		delete Benchmark;
+		Benchmark = 0;
+	}
+
 	// Create the Dungeon object
 	m_Dungeon = new DungeonClass;
 	if (!m_Dungeon)
@@ -150,6 +250,13 @@ bool ApplicationClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidt
 		return false;
 	}
 
+	// Use the seed that was found, with no time limit so the dungeon is the same as the layout that matched
+	if (SeedFound)
+	{
+		m_Dungeon->SetSeed(FoundSeed);
+		m_Dungeon->SetGenerationBudget(0);
+	}
+
 	// Initialise the Dungeon object 
 	result = m_Dungeon->Initialise(m_Direct3D->GetDevice(), m_Direct3D->GetDeviceContext(), &hwnd);
 	if (!result)
@@ -165,17 +272,100 @@ bool ApplicationClass::Initialize(HINSTANCE hinstance, HWND hwnd, int screenWidt
 		return false;
 	}
 
-	// Initialise the walls for the dungeon after the dungeon is initialised
-	for (auto DungeonPiece = m_Dungeon->GetDungeonPieces()->begin(); DungeonPiece != m_Dungeon->GetDungeonPieces()->end(); ++DungeonPiece)
+	// If the generation budget cut the dungeon short, say so, as another run of the same seed may not give the same dungeon
+	if (m_Dungeon->WasGenerationOutOfTime())
+	{
+		MessageBox(hwnd, L"The dungeon used up its generation time, so it was closed off early and may differ from other runs of the same seed.\nTo change the time limit, change the value of GENERATION_BUDGET_MS in DungeonClass.h", L"Warning", MB_OK);
+	}
+
+	// Initialise the walls for the dungeon after the dungeon is initialised, so that walls are placed around each dungeon piece
+	// after they have all been created. The walls of neighbouring pieces are merged where they meet
+	result = m_Dungeon->BuildWalls();
+	if (!result)
+	{
+		MessageBox(hwnd, L"Could not initialize the dungeon walls.", L"Error", MB_OK);
+		return false;
+	}
+
+	// For each wall segment, call FillGridWithWall so they are included in the collision grid. A wall shared by two pieces is one segment
+	for (auto Wall = m_Dungeon->GetWallSegments()->begin(); Wall != m_Dungeon->GetWallSegments()->end(); ++Wall)
+	{
+		// Ensures that there is information on the collision grid for each wall so they can be collided with
+		m_Dungeon->FillGridWithWall(*Wall);
+	}
+
+	// Add the walls of the prefab rooms to the collision grid after the pieces, so that pieces placed next to them don't cover them
+	m_Dungeon->FillGridWithPrefabWalls();
+
+	// Create the static batch, and put the floors, walls and ceilings of the dungeon pieces in it now that the walls are made
+	m_DungeonBatch = new StaticBatchClass;
+	if (!m_DungeonBatch)
+	{
+		return false;
+	}
+
+	result = m_DungeonBatch->Build(m_Direct3D->GetDevice(), m_Direct3D->GetDeviceContext(), m_Dungeon->GetTextureCache(), m_Dungeon->GetDungeonPieces(),
+								   BATCH_INSTANCED, 0);
+	if (!result)
+	{
+		MessageBox(hwnd, L"Could not initialize the dungeon batch.", L"Error", MB_OK);
+		return false;
+	}
+
+	// If a render cost report is set up, record the batch laid out both ways without the device and compare what each costs
+	if (RENDER_COST_REPORT)
 	{
-		// Call BuildWalls on each piece so that walls are placed around that dungeon piece after it has been created
-		(*DungeonPiece)->BuildWalls();
-		// For each wall created, then call FillGridWithWall passing in each wall of this dungeon piece so they are included in the collision grid
-		for (auto Wall = (*DungeonPiece)->Walls.begin(); Wall != (*DungeonPiece)->Walls.end(); ++ Wall)
+		RenderRecorderClass::Costs LayoutCosts[2];
+		int Layouts[2] = { BATCH_INDEXED, BATCH_INSTANCED };
+
+		RenderRecorderClass* Recorder = new RenderRecorderClass;
+		StaticBatchClass* RecordedBatch = new StaticBatchClass;
+		if ((!Recorder) || (!RecordedBatch))
+		{
+			if (RecordedBatch)
+			{
+				delete RecordedBatch;
+				RecordedBatch = 0;
+			}
+			if (Recorder)
+			{
+				delete Recorder;
+				Recorder = 0;
+			}
+			return false;
+		}
+
+		for (int i = 0; i < 2; i++)
 		{
-			// Ensures that there is information on the collision grid for each wall so they can be collided with
-			m_Dungeon->FillGridWithWall(*Wall);
+			Recorder->Reset();
+			result = RecordedBatch->Build(0, 0, 0, m_Dungeon->GetDungeonPieces(), Layouts[i], Recorder);
+			if (!result)
+			{
+				MessageBox(hwnd, L"Could not record the dungeon batch.", L"Error", MB_OK);
+				RecordedBatch->Shutdown();
+				delete RecordedBatch;
+				RecordedBatch = 0;
+				delete Recorder;
+				Recorder = 0;
+				return false;
+			}
+
+			// Record one frame of drawing the whole batch
+			RecordedBatch->Render(0);
+			LayoutCosts[i] = Recorder->GetCosts();
+			RecordedBatch->Shutdown();
 		}
+
+		result = RenderRecorderClass::WriteComparison(RENDER_COST_FILE, "Indexed batch", LayoutCosts[0], "Instanced quads", LayoutCosts[1]);
+		if (!result)
+		{
+			MessageBox(hwnd, L"Could not write the render cost report.", L"Error", MB_OK);
+		}
+
+		delete RecordedBatch;
+		RecordedBatch = 0;
+		delete Recorder;
+		Recorder = 0;
 	}
 
 	// Create the map target render object
@@ -457,6 +647,14 @@ void ApplicationClass::Shutdown()
 		m_DistortionShader = 0;
 	}
 
+	// Release the dungeon batch
+	if (m_DungeonBatch)
+	{
+		m_DungeonBatch->Shutdown();
+		delete m_DungeonBatch;
+		m_DungeonBatch = 0;
+	}
+
 	// Release the Dungeon object
 	if (m_Dungeon)
 	{
@@ -607,6 +805,19 @@ bool ApplicationClass::Frame()
 		m_ButtonTimer--;
 	}
 
+	// Swap in the textures that have finished loading since the last frame, and make the dungeon's texture array once its
+	// textures are in
+	if (m_Dungeon->GetTextureCache())
+	{
+		m_Dungeon->GetTextureCache()->Update();
+	}
+
+	result = m_DungeonBatch->Update();
+	if (!result)
+	{
+		return false;
+	}
+
 	// Update the system stats.
 	m_Timer->Frame();
 	m_Fps->Frame();
@@ -1119,55 +1330,122 @@ bool ApplicationClass::RenderDungeon(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatr
 	D3DXMatrixTranslation(&translationMatrix, 10.0f, 10.0f, 10.0f);
 	D3DXMatrixMultiply(&worldMatrix, &scalingMatrix, &translationMatrix);
 
-	// Loop through all the dungeon pieces to render them in their new positions
-	for (auto DungeonPiece = m_Dungeon->GetDungeonPieces()->begin(); DungeonPiece != m_Dungeon->GetDungeonPieces()->end(); ++DungeonPiece)
+	// Render the floors, walls and ceilings of the dungeon pieces with one instanced draw of the unit quad, using the texture array
+	// for all their textures. The ceilings are already at the top of the walls in the batch, so they use the same world matrix as the floors
+	if (m_DungeonBatch->GetInstanceCount() > 0)
 	{
-		// Push mesh data onto gfx hardware
-		(*DungeonPiece)->Render();
+		// Push the unit quad and the instances onto gfx hardware
+		m_DungeonBatch->Render(m_Direct3D->GetDeviceContext());
 
-		// Use the light shader to render the dungeon floor pieces, so that it is affected by the light shader
-		result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), (*DungeonPiece)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
-			(*DungeonPiece)->GetDungeonTexture(), m_Light, currentCamera);
+		// Use the light shader to render the batch, so that it is affected by the light that moves with the player
+		result = m_LightShader->RenderInstanced(m_Direct3D->GetDeviceContext(), m_DungeonBatch->GetIndexCount(), m_DungeonBatch->GetInstanceCount(), 0,
+			worldMatrix, viewMatrix, projectionMatrix, m_DungeonBatch->GetTexture(), m_Light, currentCamera);
 		if(!result)
 		{
 			return false;
 		}
+	}
+
+	// Loop through the floors and walls of the caves and render them in the same space as the dungeon pieces
+	list<MeshClass*>* CaveLists[2] = { m_Dungeon->GetCaveFloors(), m_Dungeon->GetCaveWalls() };
+	for (int i = 0; i < 2; i++)
+	{
+		for (auto CaveMesh = CaveLists[i]->begin(); CaveMesh != CaveLists[i]->end(); ++CaveMesh)
+		{
+			// Push mesh data onto gfx hardware
+			(*CaveMesh)->Render(m_Direct3D->GetDeviceContext());
+
+			// Render the cave with the light shader so it is lit the same way as the rest of the dungeon, using the vertex layout it was built with
+			if ((*CaveMesh)->IsCompact())
+			{
+				result = m_LightShader->RenderCompact(m_Direct3D->GetDeviceContext(), (*CaveMesh)->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, (*CaveMesh)->GetCompactOrigin()), viewMatrix, 
+													projectionMatrix, (*CaveMesh)->GetTexture(), m_Light, currentCamera);
+			}
+			else
+			{
+				result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), (*CaveMesh)->GetIndexCount(), worldMatrix, viewMatrix, 
+													projectionMatrix, (*CaveMesh)->GetTexture(), m_Light, currentCamera);
+			}
+			if (!result)
+			{
+				return false;
+			}
+		}
+	}
+
+	// Loop through the prefab rooms and render the floor, walls and plugged sockets of their templates, moved to where each room is placed
+	PrefabLibraryClass* Prefabs = m_Dungeon->GetPrefabLibrary();
+	for (auto Prefab = m_Dungeon->GetPrefabInstances()->begin(); Prefab != m_Dungeon->GetPrefabInstances()->end(); ++Prefab)
+	{
+		D3DXMATRIX prefabMatrix;
+		D3DXMatrixTranslation(&prefabMatrix, Prefab->Origin.x, 0.0f, Prefab->Origin.y);
+		D3DXMatrixMultiply(&prefabMatrix, &prefabMatrix, &worldMatrix);
 
-		// Loop through the walls belonging to this dungeon piece and render them to the scene
-		for (auto Wall = (*DungeonPiece)->Walls.begin(); Wall != (*DungeonPiece)->Walls.end(); Wall++)
+		int PartCount = PREFAB_PART_PLUGS + Prefabs->GetTemplate(Prefab->Template)->Sockets.size();
+		for (int Part = PREFAB_PART_FLOOR; Part < PartCount; Part++)
 		{
-			// Only render the walls after all have been fully created
-			if ((*DungeonPiece)->WallsGenerated)
+			// The ceiling is drawn with the ceilings, and the plug of the socket joined to the dungeon is left out for the door
+			if ((Part == PREFAB_PART_CEILING) || (Part == PREFAB_PART_PLUGS + Prefab->OpenSocket))
 			{
-				// Call render for the wall mesh
-				(*Wall)->Render(m_Direct3D->GetDeviceContext());
-
-				// Render the walls with the light shader so that it can be affected by the light that moves with the player
-				result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), (*Wall)->GetIndexCount(), worldMatrix, viewMatrix, 
-													projectionMatrix, (*Wall)->GetTexture(), m_Light, currentCamera);
-				if (!result)
-				{
-					return false;
-				}
+				continue;
+			}
+
+			// Push the template's mesh data for this part onto gfx hardware
+			Prefabs->Render(m_Direct3D->GetDeviceContext(), Prefab->Template, Part);
+
+			// Render the prefab with the light shader so it is lit the same way as the rest of the dungeon
+			ID3D11ShaderResourceView* Texture = (Part == PREFAB_PART_FLOOR) ? Prefabs->GetFloorTexture() : Prefabs->GetWallTexture();
+			result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), Prefabs->GetIndexCount(Prefab->Template, Part), prefabMatrix, viewMatrix, 
+												projectionMatrix, Texture, m_Light, currentCamera);
+			if (!result)
+			{
+				return false;
 			}
 		}
 	}
 
-	// Scale and translate the ceiling dungeon pieces similar to the floor pieces, but with a higher y translate so it is above the floor like a ceiling
+	// Scale and translate the cave and prefab ceilings similar to the floors, but with a higher y translate so they are above the floor like a ceiling
 	m_Direct3D->GetWorldMatrix(worldMatrix);
 	D3DXMatrixScaling(&scalingMatrix, DUNGEON_SCALE, DUNGEON_SCALE, DUNGEON_SCALE);
 	D3DXMatrixTranslation(&translationMatrix, 10.0f, 40.0f, 10.0f);
 	D3DXMatrixMultiply(&worldMatrix, &scalingMatrix, &translationMatrix);
 
-	// Loop through all of the ceiling pieces and render them to the scene
-	for (auto CeilingPiece = m_Dungeon->GetCeilingPieces()->begin(); CeilingPiece != m_Dungeon->GetCeilingPieces()->end(); ++CeilingPiece)
+	// Loop through the cave ceilings and render them at the height of the ceiling pieces
+	for (auto CaveCeiling = m_Dungeon->GetCaveCeilings()->begin(); CaveCeiling != m_Dungeon->GetCaveCeilings()->end(); ++CaveCeiling)
 	{
 		// Push mesh data onto gfx hardware
-		(*CeilingPiece)->Render();
+		(*CaveCeiling)->Render(m_Direct3D->GetDeviceContext());
+
+		// Render the cave ceilings using the light shader in the same way as the rest of the dungeon
+		if ((*CaveCeiling)->IsCompact())
+		{
+			result = m_LightShader->RenderCompact(m_Direct3D->GetDeviceContext(), (*CaveCeiling)->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, (*CaveCeiling)->GetCompactOrigin()), viewMatrix, 
+																projectionMatrix, (*CaveCeiling)->GetTexture(), m_Light, currentCamera);
+		}
+		else
+		{
+			result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), (*CaveCeiling)->GetIndexCount(), worldMatrix, viewMatrix, 
+																projectionMatrix, (*CaveCeiling)->GetTexture(), m_Light, currentCamera);
+		}
+		if(!result)
+		{
+			return false;
+		}
+	}
+
+	// Loop through the prefab rooms and render the ceilings of their templates at the same height
+	for (auto Prefab = m_Dungeon->GetPrefabInstances()->begin(); Prefab != m_Dungeon->GetPrefabInstances()->end(); ++Prefab)
+	{
+		D3DXMATRIX prefabMatrix;
+		D3DXMatrixTranslation(&prefabMatrix, Prefab->Origin.x, 0.0f, Prefab->Origin.y);
+		D3DXMatrixMultiply(&prefabMatrix, &prefabMatrix, &worldMatrix);
+
+		// Push the template's ceiling onto gfx hardware
+		Prefabs->Render(m_Direct3D->GetDeviceContext(), Prefab->Template, PREFAB_PART_CEILING);
 
-		// Render the ceiling pieces using the light shader so that the render is affected by the light that moves with the player
-		result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), (*CeilingPiece)->GetIndexCount(), worldMatrix, viewMatrix, 
-															projectionMatrix, (*CeilingPiece)->GetDungeonTexture(), m_Light, currentCamera);
+		// Render the prefab ceilings using the light shader in the same way as the rest of the dungeon
+		result = m_LightShader->Render(m_Direct3D->GetDeviceContext(), Prefabs->GetIndexCount(Prefab->Template, PREFAB_PART_CEILING), prefabMatrix, viewMatrix, 
+															projectionMatrix, Prefabs->GetFloorTexture(), m_Light, currentCamera);
 		if(!result)
 		{
 			return false;
@@ -1203,8 +1481,59 @@ bool ApplicationClass::RenderMap(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix,
 		(*DungeonPiece)->Render();
 
 		// Render the Dungeon pieces using the texture shader, because only want to show the texture and don't want the map to be affected by the lighting
-		result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), (*DungeonPiece)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
-				(*DungeonPiece)->GetMapTexture());
+		if ((*DungeonPiece)->IsCompact())
+		{
+			result = m_TextureShader->RenderCompact(m_Direct3D->GetDeviceContext(), (*DungeonPiece)->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, (*DungeonPiece)->GetCompactOrigin()), viewMatrix, projectionMatrix, 
+					(*DungeonPiece)->GetMapTexture());
+		}
+		else
+		{
+			result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), (*DungeonPiece)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
+					(*DungeonPiece)->GetMapTexture());
+		}
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Loop through the cave floors and render them on the map next to the pieces they are joined to
+	for (auto CaveFloor = m_Dungeon->GetCaveFloors()->begin(); CaveFloor != m_Dungeon->GetCaveFloors()->end(); ++CaveFloor)
+	{
+		// Push mesh data onto gfx hardware
+		(*CaveFloor)->Render(m_Direct3D->GetDeviceContext());
+
+		// Render the cave floors using the texture shader so the map isn't affected by the lighting
+		if ((*CaveFloor)->IsCompact())
+		{
+			result = m_TextureShader->RenderCompact(m_Direct3D->GetDeviceContext(), (*CaveFloor)->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, (*CaveFloor)->GetCompactOrigin()), viewMatrix, projectionMatrix, 
+					(*CaveFloor)->GetTexture());
+		}
+		else
+		{
+			result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), (*CaveFloor)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
+					(*CaveFloor)->GetTexture());
+		}
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Loop through the prefab rooms and render the floors of their templates on the map
+	PrefabLibraryClass* Prefabs = m_Dungeon->GetPrefabLibrary();
+	for (auto Prefab = m_Dungeon->GetPrefabInstances()->begin(); Prefab != m_Dungeon->GetPrefabInstances()->end(); ++Prefab)
+	{
+		D3DXMATRIX prefabMatrix;
+		D3DXMatrixTranslation(&prefabMatrix, Prefab->Origin.x, 0.0f, Prefab->Origin.y);
+		D3DXMatrixMultiply(&prefabMatrix, &prefabMatrix, &worldMatrix);
+
+		// Push the template's floor onto gfx hardware
+		Prefabs->Render(m_Direct3D->GetDeviceContext(), Prefab->Template, PREFAB_PART_FLOOR);
+
+		// Render the prefab floors using the texture shader so the map isn't affected by the lighting
+		result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), Prefabs->GetIndexCount(Prefab->Template, PREFAB_PART_FLOOR), prefabMatrix, viewMatrix, 
+				projectionMatrix, Prefabs->GetMapTexture());
 		if (!result)
 		{
 			return false;
@@ -1222,8 +1551,16 @@ bool ApplicationClass::RenderMap(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix,
 		(*DoorPiece)->Render();
 
 		// Render the door pieces using the texture shader, because only want to show the texture and don't want the map to be affected by the lighting
-		result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), (*DoorPiece)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
-			(*DoorPiece)->GetMapTexture());
+		if ((*DoorPiece)->IsCompact())
+		{
+			result = m_TextureShader->RenderCompact(m_Direct3D->GetDeviceContext(), (*DoorPiece)->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, (*DoorPiece)->GetCompactOrigin()), viewMatrix, projectionMatrix, 
+				(*DoorPiece)->GetMapTexture());
+		}
+		else
+		{
+			result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), (*DoorPiece)->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, 
+				(*DoorPiece)->GetMapTexture());
+		}
 		if (!result)
 		{
 			return false;
@@ -1245,7 +1582,14 @@ bool ApplicationClass::RenderMap(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix,
 	m_Dungeon->GetPlayerMesh()->Render(m_Direct3D->GetDeviceContext());
 
 	// Render the player mesh using the texture shader, because only want to show the texture and don't want the map to be affected by the lighting
-	result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), m_Dungeon->GetPlayerMesh()->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, m_Dungeon->GetPlayerMesh()->GetTexture());
+	if (m_Dungeon->GetPlayerMesh()->IsCompact())
+	{
+		result = m_TextureShader->RenderCompact(m_Direct3D->GetDeviceContext(), m_Dungeon->GetPlayerMesh()->GetIndexCount(), GetCompactWorldMatrix(worldMatrix, m_Dungeon->GetPlayerMesh()->GetCompactOrigin()), viewMatrix, projectionMatrix, m_Dungeon->GetPlayerMesh()->GetTexture());
+	}
+	else
+	{
+		result = m_TextureShader->Render(m_Direct3D->GetDeviceContext(), m_Dungeon->GetPlayerMesh()->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix, m_Dungeon->GetPlayerMesh()->GetTexture());
+	}
 	if (!result)
 	{
 		return false;
@@ -1253,3 +1597,20 @@ bool ApplicationClass::RenderMap(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix,
 
 	return true;
 }
+
+
+// Function:		Get Compact World Matrix function
+// What it does:	Moves a world matrix to the origin a piece or mesh packed its compact vertices around, so they are drawn in place
+// Takes in:		D3DXMATRIX - The world matrix the piece or mesh would be drawn with, D3DXVECTOR3 - The origin of its compact vertices
+// Returns:			D3DXMATRIX - The world matrix for its compact vertices
+
+D3DXMATRIX ApplicationClass::GetCompactWorldMatrix(D3DXMATRIX worldMatrix, D3DXVECTOR3 Origin)
+{
+	D3DXMATRIX compactMatrix;
+
+	// Move the vertices out from the origin first, then place them in the world in the same way as the full vertices
+	D3DXMatrixTranslation(&compactMatrix, Origin.x, Origin.y, Origin.z);
+	D3DXMatrixMultiply(&compactMatrix, &compactMatrix, &worldMatrix);
+
+	return compactMatrix;
+}
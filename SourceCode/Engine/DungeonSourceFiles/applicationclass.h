@@ -29,7 +29,11 @@ const float SCREEN_NEAR = 0.1f;
 #include "lightclass.h"
 #include "meshclass.h"
 #include "dungeonclass.h"
+#include "seedsearchclass.h"
+#include "distributionreportclass.h"
+#include "benchmarkclass.h"
 #include "dungeonpiececlass.h"
+#include "staticbatchclass.h"
 #include "targetwindowclass.h"
 #include "rendertextureclass.h"
 #include "textureshaderclass.h"
@@ -185,6 +189,13 @@ private:
 	// Returns:			True if it has successfully rendered, false if not
 	bool RenderMap(D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix);
 
+
+	// Function:		Get Compact World Matrix function
+	// What it does:	Moves a world matrix to the origin a piece or mesh packed its compact vertices around, so they are drawn in place
+	// Takes in:		D3DXMATRIX - The world matrix the piece or mesh would be drawn with, D3DXVECTOR3 - The origin of its compact vertices
+	// Returns:			D3DXMATRIX - The world matrix for its compact vertices
+	D3DXMATRIX GetCompactWorldMatrix(D3DXMATRIX worldMatrix, D3DXVECTOR3 Origin);
+
 // Private Member Variables
 private:
 	// General objects
@@ -209,6 +220,7 @@ private:
 
 	// Dungeon objects
 	DungeonClass* m_Dungeon;
+	StaticBatchClass* m_DungeonBatch;		// The floors, walls and ceilings of the dungeon pieces, drawn together by texture
 
 	// Map objects
 	RenderTextureClass* m_MapRenderTexture;
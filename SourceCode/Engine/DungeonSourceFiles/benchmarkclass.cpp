@@ -0,0 +1,245 @@
+#include "benchmarkclass.h"
+
+// Areas and most rooms of the scatter layouts that are timed. The first is the in-game dungeon, and the others are large
+// enough to hold about 1k, 10k and 25k rooms at the in-game room spacing
+static const float ScatterAreas[BENCHMARK_SCATTER_RUNS] = { SCATTER_AREA_SIZE, 400.0f, 1200.0f, 1800.0f };
+static const int ScatterRooms[BENCHMARK_SCATTER_RUNS] = { SCATTER_MAX_ROOMS, 1000, 10000, 25000 };
+
+
+// Function:		Benchmark constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+BenchmarkClass::BenchmarkClass()
+{
+}
+
+
+// Placeholder destructor
+BenchmarkClass::~BenchmarkClass()
+{
+}
+
+
+// Function:		Write Report function
+// What it does:	Runs every benchmark and writes their timings to a text file
+// Takes in:		char - Pointer to the file name
+// Returns:			True if the file was written, false if not
+
+bool BenchmarkClass::WriteReport(char* Filename)
+{
+	ofstream File;
+	File.open(Filename);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	File << "Layout benchmarks (seed " << BENCHMARK_SEED << ")\n\n";
+
+	TimeScatter(File);
+	TimeOccupancy(File);
+
+	File.close();
+
+	return true;
+}
+
+
+// Function:		Time Scatter function
+// What it does:	Times the scatter generator laying out each of the benchmark areas, and writes the rooms and pieces
+//					made and the time taken
+// Takes in:		ofstream - reference to the file
+// Returns:			Nothing
+
+void BenchmarkClass::TimeScatter(ofstream &File)
+{
+	File << "Scatter generator (room spacing " << SCATTER_ROOM_SPACING << ", corridor width " << SCATTER_CORRIDOR_WIDTH << ")\n";
+
+	for (int i = 0; i < BENCHMARK_SCATTER_RUNS; i++)
+	{
+		// The layout is made from rand, so seed it for each run to time the same layout every time
+		srand(BENCHMARK_SEED);
+		ScatterGeneratorClass Scatter;
+
+		std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		bool result = Scatter.Generate(ScatterAreas[i], ScatterAreas[i], SCATTER_ROOM_SPACING, SCATTER_CORRIDOR_WIDTH, ScatterRooms[i],
+									   SCATTER_EXTRA_EDGE_CHANCE);
+		double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+		File << "  Area " << ScatterAreas[i] << ", up to " << ScatterRooms[i] << " rooms: ";
+		if (!result)
+		{
+			File << "failed\n";
+		}
+		else
+		{
+			File << Scatter.GetScatteredCount() << " scattered, " << Scatter.GetRoomCount() << " kept, " << Scatter.GetPieces()->size()
+				 << " pieces, " << Scatter.GetEdgeCount() << " triangulation edges, " << Milliseconds << " ms\n";
+		}
+
+		Scatter.Shutdown();
+	}
+}
+
+
+// Function:		Time Occupancy function
+// What it does:	Grows a crowded dungeon on the grid by trying rooms against the sides of the rooms already placed, and
+//					times checking each room's area with the occupancy pyramid against checking every cell of it. The
+//					same rooms are then checked again on the finished grid and on an empty one
+// Takes in:		ofstream - reference to the file
+// Returns:			Nothing
+
+void BenchmarkClass::TimeOccupancy(ofstream &File)
+{
+	vector<float> Grid(DUNGEON_GRID_X * DUNGEON_GRID_Y, 0.0f);
+	vector<float> EmptyGrid(DUNGEON_GRID_X * DUNGEON_GRID_Y, 0.0f);
+	OccupancyPyramidClass Pyramid;
+	OccupancyPyramidClass EmptyPyramid;
+	vector<Area> Rooms;
+	vector<Area> Candidates;
+	double ScanMilliseconds = 0.0;
+	double PyramidMilliseconds = 0.0;
+	int Mismatches = 0;
+
+	File << "\nOccupancy pyramid against checking every cell (" << DUNGEON_GRID_X << "x" << DUNGEON_GRID_Y << " grid)\n";
+
+	if ((!Pyramid.Initialise(DUNGEON_GRID_X, DUNGEON_GRID_Y)) || (!EmptyPyramid.Initialise(DUNGEON_GRID_X, DUNGEON_GRID_Y)))
+	{
+		File << "  failed\n";
+		return;
+	}
+
+	srand(BENCHMARK_SEED);
+
+	// Start with an entrance room in the middle of the grid
+	Area Entrance;
+	Entrance.StartX = (DUNGEON_GRID_X / 2) - 10;
+	Entrance.StartY = (DUNGEON_GRID_Y / 2) - 10;
+	Entrance.EndX = (DUNGEON_GRID_X / 2) + 10;
+	Entrance.EndY = (DUNGEON_GRID_Y / 2) + 10;
+	Rooms.push_back(Entrance);
+
+	for (int i = 0; i < BENCHMARK_OCCUPANCY_DRAWS; i++)
+	{
+		// Try a room of a random size against a random side of a random room, centred on that side like a door
+		Area Parent = Rooms[rand() % Rooms.size()];
+		int Width = BENCHMARK_OCCUPANCY_MIN_SIZE + (rand() % BENCHMARK_OCCUPANCY_SIZE_RANGE);
+		int Height = BENCHMARK_OCCUPANCY_MIN_SIZE + (rand() % BENCHMARK_OCCUPANCY_SIZE_RANGE);
+		int Side = rand() % 4;
+		int CentreX = (Parent.StartX + Parent.EndX) / 2;
+		int CentreY = (Parent.StartY + Parent.EndY) / 2;
+		Area Room;
+
+		if ((Side == 0) || (Side == 1))
+		{
+			Room.StartX = (Side == 0) ? Parent.EndX : (Parent.StartX - Width);
+			Room.EndX = Room.StartX + Width;
+			Room.StartY = CentreY - (Height / 2);
+			Room.EndY = Room.StartY + Height;
+		}
+		else
+		{
+			Room.StartY = (Side == 2) ? Parent.EndY : (Parent.StartY - Height);
+			Room.EndY = Room.StartY + Height;
+			Room.StartX = CentreX - (Width / 2);
+			Room.EndX = Room.StartX + Width;
+		}
+
+		if ((Room.StartX < 1) || (Room.StartY < 1) || (Room.EndX > DUNGEON_GRID_X - 2) || (Room.EndY > DUNGEON_GRID_Y - 2))
+		{
+			continue;
+		}
+		Candidates.push_back(Room);
+
+		// Check inside the room's walls, as rooms share their walls with the rooms they are placed against
+		std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		bool ScanEmpty = IsGridEmpty(Grid, Room.StartX + 1, Room.StartY + 1, Room.EndX - 2, Room.EndY - 2);
+		std::chrono::steady_clock::time_point Middle = std::chrono::steady_clock::now();
+		bool PyramidEmpty = Pyramid.IsEmpty(Room.StartX + 1, Room.StartY + 1, Room.EndX - 2, Room.EndY - 2);
+		std::chrono::steady_clock::time_point End = std::chrono::steady_clock::now();
+
+		ScanMilliseconds += std::chrono::duration<double, std::milli>(Middle - Start).count();
+		PyramidMilliseconds += std::chrono::duration<double, std::milli>(End - Middle).count();
+		if (ScanEmpty != PyramidEmpty)
+		{
+			Mismatches++;
+		}
+
+		if (PyramidEmpty)
+		{
+			Rooms.push_back(Room);
+			for (int x = Room.StartX; x <= Room.EndX; x++)
+			{
+				for (int y = Room.StartY; y <= Room.EndY; y++)
+				{
+					Grid[(x * DUNGEON_GRID_Y) + y] = DUNGEON_ROOM;
+				}
+			}
+			Pyramid.Occupy(Room.StartX, Room.StartY, Room.EndX, Room.EndY);
+		}
+	}
+
+	File << "  Growing " << Rooms.size() << " rooms from " << Candidates.size() << " candidates: pyramid " << PyramidMilliseconds
+		 << " ms, every cell " << ScanMilliseconds << " ms, " << Mismatches << " different results\n";
+
+	// Check the same rooms again on the finished grid, where nearly all of them are filled, and on an empty grid
+	for (int Pass = 0; Pass < 2; Pass++)
+	{
+		vector<float> &PassGrid = (Pass == 0) ? Grid : EmptyGrid;
+		OccupancyPyramidClass &PassPyramid = (Pass == 0) ? Pyramid : EmptyPyramid;
+		int ScanFits = 0;
+		int PyramidFits = 0;
+
+		std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < Candidates.size(); i++)
+		{
+			const Area &Room = Candidates[i];
+			if (IsGridEmpty(PassGrid, Room.StartX + 1, Room.StartY + 1, Room.EndX - 2, Room.EndY - 2))
+			{
+				ScanFits++;
+			}
+		}
+		std::chrono::steady_clock::time_point Middle = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < Candidates.size(); i++)
+		{
+			const Area &Room = Candidates[i];
+			if (PassPyramid.IsEmpty(Room.StartX + 1, Room.StartY + 1, Room.EndX - 2, Room.EndY - 2))
+			{
+				PyramidFits++;
+			}
+		}
+		std::chrono::steady_clock::time_point End = std::chrono::steady_clock::now();
+
+		File << ((Pass == 0) ? "  Checking them on the finished grid: pyramid " : "  Checking them on an empty grid: pyramid ")
+			 << std::chrono::duration<double, std::milli>(End - Middle).count() << " ms, every cell "
+			 << std::chrono::duration<double, std::milli>(Middle - Start).count() << " ms, " << PyramidFits << " and " << ScanFits
+			 << " fit\n";
+	}
+
+	Pyramid.Shutdown();
+	EmptyPyramid.Shutdown();
+}
+
+
+// Function:		Is Grid Empty function
+// What it does:	Checks every cell of an area of the grid, the way the dungeon did before it had the occupancy pyramid
+// Takes in:		vector - reference to the grid, int - First and last cells of the area in x and y
+// Returns:			True if no cell in the area is filled, false if not
+
+bool BenchmarkClass::IsGridEmpty(vector<float> &Grid, int StartX, int StartY, int EndX, int EndY)
+{
+	for (int x = StartX; x <= EndX; x++)
+	{
+		for (int y = StartY; y <= EndY; y++)
+		{
+			if (Grid[(x * DUNGEON_GRID_Y) + y] == DUNGEON_ROOM)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: benchmarkclass.h
+// Benchmark Class
+// Times parts of the dungeon layout without a device, so the timings given for them can be measured again
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BENCHMARK_CLASS_H
+#define BENCHMARK_CLASS_H
+
+// For timing the benchmarks
+#include <chrono>
+
+// For writing the report
+#include <fstream>
+using std::ofstream;
+
+#include "scattergeneratorclass.h"
+#include "occupancypyramidclass.h"
+#include "dungeonclass.h"
+
+// Specify whether the application runs the benchmarks and writes their timings before the dungeon is made, and the file
+// they are written to
+#define BENCHMARK_REPORT 0
+#define BENCHMARK_FILE "benchmark_report.txt"
+
+// Specify the seed each benchmark starts from, so every run times the same layouts
+#define BENCHMARK_SEED 7
+
+// Specify the number of scatter layouts timed (their areas and room counts are set in benchmarkclass.cpp)
+#define BENCHMARK_SCATTER_RUNS 4
+
+// Specify the number of rooms drawn when growing the crowded grid for the occupancy benchmark, and the smallest size of a room
+// and the range added to it
+#define BENCHMARK_OCCUPANCY_DRAWS 400000
+#define BENCHMARK_OCCUPANCY_MIN_SIZE 15
+#define BENCHMARK_OCCUPANCY_SIZE_RANGE 25
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: BenchmarkClass
+// Each benchmark seeds the random numbers the same way, times the part of the layout it measures and writes the timing with
+// what was made, so results can be compared between machines and between changes to the code
+////////////////////////////////////////////////////////////////////////////////
+class BenchmarkClass
+{
+public:
+	// Function:		Benchmark constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	BenchmarkClass();
+
+
+	// Placeholder destructor
+	~BenchmarkClass();
+
+
+	// Function:		Write Report function
+	// What it does:	Runs every benchmark and writes their timings to a text file
+	// Takes in:		char - Pointer to the file name
+	// Returns:			True if the file was written, false if not
+	bool WriteReport(char* Filename);
+
+private:
+	// An area of the grid, from the first to the last cell in x and y
+	struct Area
+	{
+		int StartX;
+		int StartY;
+		int EndX;
+		int EndY;
+	};
+
+	// Function:		Time Scatter function
+	// What it does:	Times the scatter generator laying out each of the benchmark areas, and writes the rooms and pieces
+	//					made and the time taken
+	// Takes in:		ofstream - reference to the file
+	// Returns:			Nothing
+	void TimeScatter(ofstream &File);
+
+
+	// Function:		Time Occupancy function
+	// What it does:	Grows a crowded dungeon on the grid by trying rooms against the sides of the rooms already placed, and
+	//					times checking each room's area with the occupancy pyramid against checking every cell of it. The
+	//					same rooms are then checked again on the finished grid and on an empty one
+	// Takes in:		ofstream - reference to the file
+	// Returns:			Nothing
+	void TimeOccupancy(ofstream &File);
+
+
+	// Function:		Is Grid Empty function
+	// What it does:	Checks every cell of an area of the grid, the way the dungeon did before it had the occupancy pyramid
+	// Takes in:		vector - reference to the grid, int - First and last cells of the area in x and y
+	// Returns:			True if no cell in the area is filled, false if not
+	bool IsGridEmpty(vector<float> &Grid, int StartX, int StartY, int EndX, int EndY);
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include "bufferpoolclass.h"
+
+
+// Function:		Buffer Pool constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+BufferPoolClass::BufferPoolClass()
+{
+	m_Device = 0;
+	m_DeviceContext = 0;
+	m_QuadIndexBuffer = 0;
+}
+
+
+// Placeholder destructor
+BufferPoolClass::~BufferPoolClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Sets the device and context the pages are made and filled with, and makes the shared quad index buffer
+// Takes in:		ID3D11Device - pointer to the device, ID3D11DeviceContext - pointer to the device context
+// Returns:			True if successful, false if not
+
+bool BufferPoolClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext)
+{
+	D3D11_BUFFER_DESC IndexBufferDesc;
+	D3D11_SUBRESOURCE_DATA IndexData;
+	HRESULT result;
+
+	m_Device = Device;
+	m_DeviceContext = DeviceContext;
+
+	// The two triangles of a quad, wound the same way as the pieces and meshes always have been
+	unsigned long Indices[QUAD_INDEX_COUNT] = { 0, 1, 2, 0, 2, 3 };
+
+	// Set up the description of the static index buffer.
+	IndexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	IndexBufferDesc.ByteWidth = sizeof(Indices);
+	IndexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	IndexBufferDesc.CPUAccessFlags = 0;
+	IndexBufferDesc.MiscFlags = 0;
+	IndexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the index data.
+	IndexData.pSysMem = Indices;
+	IndexData.SysMemPitch = 0;
+	IndexData.SysMemSlicePitch = 0;
+
+	// Create the index buffer.
+	result = m_Device->CreateBuffer(&IndexBufferDesc, &IndexData, &m_QuadIndexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the pages and the quad index buffer
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void BufferPoolClass::Shutdown()
+{
+	// Release the pages
+	for (unsigned int i = 0; i < m_Pages.size(); i++)
+	{
+		if (m_Pages[i].Buffer)
+		{
+			m_Pages[i].Buffer->Release();
+			m_Pages[i].Buffer = 0;
+		}
+	}
+	m_Pages.clear();
+
+	// Release the quad index buffer
+	if (m_QuadIndexBuffer)
+	{
+		m_QuadIndexBuffer->Release();
+		m_QuadIndexBuffer = 0;
+	}
+}
+
+
+// Function:		Allocate function
+// What it does:	Copies vertices into the first page with room for them, making a new page if none has room
+// Takes in:		void - Pointer to the vertices, unsigned int - Size of the vertices in bytes, Allocation - reference to
+//					the allocation to fill in
+// Returns:			True if successful, false if the vertices are larger than a page or a page couldn't be made
+
+bool BufferPoolClass::Allocate(const void* Vertices, unsigned int Bytes, Allocation &Result)
+{
+	bool result;
+
+	// Allocations start on 16 bytes, so vertices of either layout can be bound at any offset in a page
+	unsigned int AlignedBytes = (Bytes + 15) & ~15u;
+	if ((Bytes == 0) || (AlignedBytes > BUFFER_POOL_PAGE_BYTES))
+	{
+		return false;
+	}
+
+	// Find the first page with room, or add a new one at the end
+	int Page = 0;
+	while ((Page < (int)m_Pages.size()) && (m_Pages[Page].Used + AlignedBytes > BUFFER_POOL_PAGE_BYTES))
+	{
+		Page++;
+	}
+
+	if (Page == (int)m_Pages.size())
+	{
+		result = AddPage();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	Result.Page = Page;
+	Result.Offset = m_Pages[Page].Used;
+	Result.Bytes = Bytes;
+
+	// Copy the vertices into their part of the page
+	D3D11_BOX Box;
+	Box.left = Result.Offset;
+	Box.right = Result.Offset + Bytes;
+	Box.top = 0;
+	Box.bottom = 1;
+	Box.front = 0;
+	Box.back = 1;
+	m_DeviceContext->UpdateSubresource(m_Pages[Page].Buffer, 0, &Box, Vertices, 0, 0);
+
+	m_Pages[Page].Used += AlignedBytes;
+	m_Pages[Page].Allocations++;
+
+	return true;
+}
+
+
+// Function:		Release function
+// What it does:	Gives an allocation back to its page, emptying the page once all of its allocations are given back
+// Takes in:		Allocation - reference to the allocation, which is cleared
+// Returns:			Nothing
+
+void BufferPoolClass::Release(Allocation &Vertices)
+{
+	if ((Vertices.Page < 0) || (Vertices.Page >= (int)m_Pages.size()))
+	{
+		return;
+	}
+
+	// The page is filled from the front, so it can only be filled again once nothing is left in it
+	Page &Owner = m_Pages[Vertices.Page];
+	Owner.Allocations--;
+	if (Owner.Allocations <= 0)
+	{
+		Owner.Allocations = 0;
+		Owner.Used = 0;
+	}
+
+	Vertices.Page = -1;
+	Vertices.Offset = 0;
+	Vertices.Bytes = 0;
+}
+
+
+// Function:		Bind function
+// What it does:	Sets the page of an allocation at its offset and the quad index buffer in the input assembler, with
+//					triangle list topology
+// Takes in:		ID3D11DeviceContext - pointer to the device context, Allocation - The allocation, unsigned int - Size of one vertex
+// Returns:			Nothing
+
+void BufferPoolClass::Bind(ID3D11DeviceContext* DeviceContext, Allocation Vertices, unsigned int Stride)
+{
+	unsigned int Offset = Vertices.Offset;
+
+	// Set the page to active in the input assembler from the start of the allocation, so the quad indices count from there
+	DeviceContext->IASetVertexBuffers(0, 1, &m_Pages[Vertices.Page].Buffer, &Stride, &Offset);
+
+	// Set the shared quad index buffer to active in the input assembler so it can be rendered.
+	DeviceContext->IASetIndexBuffer(m_QuadIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+
+// Function:		Get Buffer Count function
+// What it does:	Returns the number of buffers the pool has made, the pages and the quad index buffer
+// Takes in:		Nothing
+// Returns:			int - Number of buffers
+
+int BufferPoolClass::GetBufferCount()
+{
+	return (int)m_Pages.size() + (m_QuadIndexBuffer ? 1 : 0);
+}
+
+
+// Function:		Add Page function
+// What it does:	Makes a new empty page
+// Takes in:		Nothing
+// Returns:			True if successful, false if not
+
+bool BufferPoolClass::AddPage()
+{
+	D3D11_BUFFER_DESC VertexBufferDesc;
+	HRESULT result;
+	Page NewPage;
+
+	// Set up the description of the vertex buffer. It is default usage as it is filled a part at a time with UpdateSubresource
+	VertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	VertexBufferDesc.ByteWidth = BUFFER_POOL_PAGE_BYTES;
+	VertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	VertexBufferDesc.CPUAccessFlags = 0;
+	VertexBufferDesc.MiscFlags = 0;
+	VertexBufferDesc.StructureByteStride = 0;
+
+	// Create the empty vertex buffer.
+	NewPage.Buffer = 0;
+	result = m_Device->CreateBuffer(&VertexBufferDesc, NULL, &NewPage.Buffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	NewPage.Used = 0;
+	NewPage.Allocations = 0;
+	m_Pages.push_back(NewPage);
+
+	return true;
+}
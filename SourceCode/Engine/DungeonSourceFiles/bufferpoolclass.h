@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: bufferpoolclass.h
+// Buffer Pool Class
+// Holds the vertices of the dungeon pieces and meshes in a few large vertex buffers, and the one index buffer they all draw with
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BUFFER_POOL_CLASS_H
+#define BUFFER_POOL_CLASS_H
+
+#include <d3d11.h>
+
+// For vector
+#include <vector>
+using std::vector;
+
+// The size of each vertex buffer in the pool. A page holds a few thousand quads in either vertex layout
+#define BUFFER_POOL_PAGE_BYTES 65536
+
+// The number of vertices and indices in a quad
+#define QUAD_VERTEX_COUNT 4
+#define QUAD_INDEX_COUNT 6
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: BufferPoolClass
+// Every piece and mesh is a quad with the same six indices, so they all share one index buffer. Their vertices are handed
+// out of pages, large vertex buffers that are filled from the front, so a dungeon of thousands of quads makes a few
+// buffers instead of two for every quad. A piece or mesh only keeps its allocation, which is the page its vertices are in
+// and where in the page they start, and binds the page at that offset to draw. The quad indices count from the start
+// of the allocation, so they are the same for every quad.
+// Allocations are given back when their piece or mesh is shut down. A page is only reused once all of its allocations have
+// been given back, which happens when the dungeon is released, as the pieces and meshes are released together
+////////////////////////////////////////////////////////////////////////////////
+class BufferPoolClass
+{
+public:
+	// Where a piece or mesh's vertices are in the pool
+	struct Allocation
+	{
+		int Page;
+		unsigned int Offset;
+		unsigned int Bytes;
+	};
+
+	// Function:		Buffer Pool constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	BufferPoolClass();
+
+
+	// Placeholder destructor
+	~BufferPoolClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Sets the device and context the pages are made and filled with, and makes the shared quad index buffer
+	// Takes in:		ID3D11Device - pointer to the device, ID3D11DeviceContext - pointer to the device context
+	// Returns:			True if successful, false if not
+	bool Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext);
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the pages and the quad index buffer
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+
+	// Function:		Allocate function
+	// What it does:	Copies vertices into the first page with room for them, making a new page if none has room
+	// Takes in:		void - Pointer to the vertices, unsigned int - Size of the vertices in bytes, Allocation - reference to
+	//					the allocation to fill in
+	// Returns:			True if successful, false if the vertices are larger than a page or a page couldn't be made
+	bool Allocate(const void* Vertices, unsigned int Bytes, Allocation &Result);
+
+
+	// Function:		Release function
+	// What it does:	Gives an allocation back to its page, emptying the page once all of its allocations are given back
+	// Takes in:		Allocation - reference to the allocation, which is cleared
+	// Returns:			Nothing
+	void Release(Allocation &Vertices);
+
+
+	// Function:		Bind function
+	// What it does:	Sets the page of an allocation at its offset and the quad index buffer in the input assembler, with
+	//					triangle list topology
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, Allocation - The allocation, unsigned int - Size of one vertex
+	// Returns:			Nothing
+	void Bind(ID3D11DeviceContext* DeviceContext, Allocation Vertices, unsigned int Stride);
+
+
+	// Function:		Get Buffer Count function
+	// What it does:	Returns the number of buffers the pool has made, the pages and the quad index buffer
+	// Takes in:		Nothing
+	// Returns:			int - Number of buffers
+	int GetBufferCount();
+
+private:
+	// A vertex buffer in the pool, how much of it is used, and how many allocations are in it
+	struct Page
+	{
+		ID3D11Buffer* Buffer;
+		unsigned int Used;
+		int Allocations;
+	};
+
+	// Function:		Add Page function
+	// What it does:	Makes a new empty page
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if not
+	bool AddPage();
+
+private:
+	ID3D11Device* m_Device;
+	ID3D11DeviceContext* m_DeviceContext;
+	ID3D11Buffer* m_QuadIndexBuffer;
+	vector<Page> m_Pages;
+};
+
+
+#endif
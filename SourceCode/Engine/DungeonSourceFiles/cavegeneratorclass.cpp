@@ -0,0 +1,546 @@
+#include "cavegeneratorclass.h"
+
+
+// Function:		Count Bits function
+// What it does:	Counts the set bits in a word by adding neighbouring groups of bits together in parallel
+//					(Used instead of a popcount instruction so it works on every processor the application runs on)
+// Takes in:		CaveWord - Word to count
+// Returns:			int - Number of set bits
+
+static int CountBits(CaveWord Word)
+{
+	Word = Word - ((Word >> 1) & 0x5555555555555555ULL);
+	Word = (Word & 0x3333333333333333ULL) + ((Word >> 2) & 0x3333333333333333ULL);
+	Word = (Word + (Word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int)((Word * 0x0101010101010101ULL) >> 56);
+}
+
+
+// Function:		Cave Generator constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+CaveGeneratorClass::CaveGeneratorClass()
+{
+	m_PaddingMask = 0;
+	m_Width = 0;
+	m_Height = 0;
+	m_WordsPerRow = 0;
+	m_EntranceSide = 0;
+	m_EntranceStart = 0;
+	m_EntranceEnd = 0;
+}
+
+
+// Placeholder destructor
+CaveGeneratorClass::~CaveGeneratorClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Allocates the packed grids for a region of the given size and seeds them with random rock using rand
+// Takes in:		int - Width of the region in cells, int - Height of the region in cells,
+//					int - FillChance, the chance out of 100 for a cell to start as rock
+// Returns:			True if the grids were created, false if not
+
+bool CaveGeneratorClass::Initialise(int Width, int Height, int FillChance)
+{
+	if ((Width <= 0) || (Height <= 0))
+	{
+		return false;
+	}
+
+	m_Width = Width;
+	m_Height = Height;
+	m_WordsPerRow = (Width + CAVE_WORD_BITS - 1) / CAVE_WORD_BITS;
+	m_EntranceSide = 0;
+
+	// The padding mask covers the bits of the last word in each row that are past the edge of the region
+	// These bits are always set so that they count as rock when the neighbours of the last cells are added up
+	int UsedBits = Width % CAVE_WORD_BITS;
+	m_PaddingMask = (UsedBits == 0) ? 0 : (~0ULL << UsedBits);
+
+	m_Cells.assign(m_WordsPerRow * m_Height, 0);
+	m_NextCells.assign(m_WordsPerRow * m_Height, 0);
+	m_SolidRow.assign(m_WordsPerRow, ~0ULL);
+
+	// Seed every cell in the region using rand, so each cave is different
+	for (int y = 0; y < m_Height; y++)
+	{
+		CaveWord* Row = &m_Cells[y * m_WordsPerRow];
+		for (int x = 0; x < m_Width; x++)
+		{
+			if ((rand() % 100) < FillChance)
+			{
+				Row[x / CAVE_WORD_BITS] |= (1ULL << (x % CAVE_WORD_BITS));
+			}
+		}
+		Row[m_WordsPerRow - 1] |= m_PaddingMask;
+	}
+
+	return true;
+}
+
+
+// Function:		Step function
+// What it does:	Applies the automata rule to the whole region the amount of times passed in. A cell becomes rock
+//					if 5 or more of the 9 cells in its 3x3 block (itself and its neighbours) are rock. Cells outside the region count as rock
+// Takes in:		int - Number of iterations
+// Returns:			Nothing
+
+void CaveGeneratorClass::Step(int Iterations)
+{
+	for (int i = 0; i < Iterations; i++)
+	{
+		for (int y = 0; y < m_Height; y++)
+		{
+			// Rows above and below the region are solid rock
+			const CaveWord* Above = (y > 0) ? &m_Cells[(y - 1) * m_WordsPerRow] : &m_SolidRow[0];
+			const CaveWord* Below = (y < m_Height - 1) ? &m_Cells[(y + 1) * m_WordsPerRow] : &m_SolidRow[0];
+
+			StepRow(Above, &m_Cells[y * m_WordsPerRow], Below, &m_NextCells[y * m_WordsPerRow]);
+		}
+
+		// The new cells become the current cells for the next iteration
+		m_Cells.swap(m_NextCells);
+	}
+}
+
+
+// Function:		Step Row function
+// What it does:	Works out the next state of one row of words using the rows above and below it
+// Takes in:		CaveWord - Pointer to the row above, CaveWord - Pointer to this row, CaveWord - Pointer to the row below,
+//					CaveWord - Pointer to the row to write the result into
+// Returns:			Nothing
+
+void CaveGeneratorClass::StepRow(const CaveWord* Above, const CaveWord* Row, const CaveWord* Below, CaveWord* Result)
+{
+	const CaveWord* Rows[3] = { Above, Row, Below };
+
+	for (int k = 0; k < m_WordsPerRow; k++)
+	{
+		// Ones bit and twos bit of the sum of the left, middle and right cells of each of the three rows
+		CaveWord Ones[3];
+		CaveWord Twos[3];
+
+		for (int r = 0; r < 3; r++)
+		{
+			// Words either side of the region are rock
+			CaveWord Previous = (k > 0) ? Rows[r][k - 1] : ~0ULL;
+			CaveWord Middle = Rows[r][k];
+			CaveWord Next = (k < m_WordsPerRow - 1) ? Rows[r][k + 1] : ~0ULL;
+
+			// Shift the row so that each bit lines up with the cell to its left and to its right
+			CaveWord Left = (Middle << 1) | (Previous >> (CAVE_WORD_BITS - 1));
+			CaveWord Right = (Middle >> 1) | (Next << (CAVE_WORD_BITS - 1));
+
+			// Add the three bits with a full adder
+			Ones[r] = Left ^ Middle ^ Right;
+			Twos[r] = (Left & Middle) | (Right & (Left ^ Middle));
+		}
+
+		// Add the three row sums together to get the count of rock in each 3x3 block (0 to 9) as four bit planes
+		CaveWord Count1 = Ones[0] ^ Ones[1] ^ Ones[2];
+		CaveWord Carry2 = (Ones[0] & Ones[1]) | (Ones[2] & (Ones[0] ^ Ones[1]));
+
+		CaveWord TwosSum = Twos[0] ^ Twos[1] ^ Twos[2];
+		CaveWord Carry4 = (Twos[0] & Twos[1]) | (Twos[2] & (Twos[0] ^ Twos[1]));
+
+		CaveWord Count2 = TwosSum ^ Carry2;
+		CaveWord Carry4b = TwosSum & Carry2;
+
+		CaveWord Count4 = Carry4 ^ Carry4b;
+		CaveWord Count8 = Carry4 & Carry4b;
+
+		// A cell is rock if the count is 5 or more (8, or 4 plus 1 or 2)
+		Result[k] = Count8 | (Count4 & (Count2 | Count1));
+	}
+
+	// Keep the padding past the edge of the region as rock
+	Result[m_WordsPerRow - 1] |= m_PaddingMask;
+}
+
+
+// Function:		Carve Entrance function
+// What it does:	Opens a straight tunnel from the middle of one side of the region to its center so the cave can be joined
+//					to a door of a dungeon piece. The side is remembered so no wall is built across the tunnel's mouth
+// Takes in:		int - Side of the region (CAVE_SIDE defines), int - Position of the tunnel along that side in cells,
+//					int - Half width of the tunnel in cells
+// Returns:			Nothing
+
+void CaveGeneratorClass::CarveEntrance(int Side, int Position, int HalfWidth)
+{
+	int CenterX = m_Width / 2;
+	int CenterY = m_Height / 2;
+
+	m_EntranceSide = Side;
+	m_EntranceStart = Position - HalfWidth;
+	m_EntranceEnd = Position + HalfWidth;
+
+	// Carve along the x axis for entrances on the left and right, and along the y axis for entrances on the top and bottom
+	if ((Side == CAVE_SIDE_LEFT) || (Side == CAVE_SIDE_RIGHT))
+	{
+		int StartX = (Side == CAVE_SIDE_LEFT) ? 0 : CenterX;
+		int EndX = (Side == CAVE_SIDE_LEFT) ? CenterX : m_Width - 1;
+
+		for (int x = StartX; x <= EndX; x++)
+		{
+			for (int y = m_EntranceStart; y < m_EntranceEnd; y++)
+			{
+				SetCell(x, y, false);
+			}
+		}
+
+		// Join the end of the tunnel to the center of the region if the tunnel isn't in line with it
+		int Low = (Position < CenterY) ? Position : CenterY;
+		int High = (Position < CenterY) ? CenterY : Position;
+		for (int y = Low; y <= High; y++)
+		{
+			for (int x = CenterX - HalfWidth; x < CenterX + HalfWidth; x++)
+			{
+				SetCell(x, y, false);
+			}
+		}
+	}
+	else
+	{
+		int StartY = (Side == CAVE_SIDE_DOWN) ? 0 : CenterY;
+		int EndY = (Side == CAVE_SIDE_DOWN) ? CenterY : m_Height - 1;
+
+		for (int y = StartY; y <= EndY; y++)
+		{
+			for (int x = m_EntranceStart; x < m_EntranceEnd; x++)
+			{
+				SetCell(x, y, false);
+			}
+		}
+
+		int Low = (Position < CenterX) ? Position : CenterX;
+		int High = (Position < CenterX) ? CenterX : Position;
+		for (int x = Low; x <= High; x++)
+		{
+			for (int y = CenterY - HalfWidth; y < CenterY + HalfWidth; y++)
+			{
+				SetCell(x, y, false);
+			}
+		}
+	}
+}
+
+
+// Function:		Keep Connected function
+// What it does:	Flood fills the open cells from the given cell and turns every open cell that wasn't reached into rock,
+//					so that the player can walk to every part of the cave from the entrance
+// Takes in:		int - X cell to fill from, int - Y cell to fill from
+// Returns:			The number of open cells left in the cave
+
+int CaveGeneratorClass::KeepConnected(int StartX, int StartY)
+{
+	// Visited cells are marked with a set bit, in the same layout as the cells
+	vector<CaveWord> Visited(m_Cells.size(), 0);
+	vector<int> Stack;
+
+	if (IsOpen(StartX, StartY))
+	{
+		Stack.push_back(StartY * m_Width + StartX);
+		Visited[StartY * m_WordsPerRow + StartX / CAVE_WORD_BITS] |= (1ULL << (StartX % CAVE_WORD_BITS));
+	}
+
+	while (!Stack.empty())
+	{
+		int Cell = Stack.back();
+		Stack.pop_back();
+
+		int x = Cell % m_Width;
+		int y = Cell / m_Width;
+
+		// Check the four cells next to this one
+		int NeighbourX[4] = { x - 1, x + 1, x, x };
+		int NeighbourY[4] = { y, y, y - 1, y + 1 };
+
+		for (int n = 0; n < 4; n++)
+		{
+			int nx = NeighbourX[n];
+			int ny = NeighbourY[n];
+
+			if (!IsOpen(nx, ny))
+			{
+				continue;
+			}
+
+			CaveWord &Word = Visited[ny * m_WordsPerRow + nx / CAVE_WORD_BITS];
+			CaveWord Bit = 1ULL << (nx % CAVE_WORD_BITS);
+			if (!(Word & Bit))
+			{
+				Word |= Bit;
+				Stack.push_back(ny * m_Width + nx);
+			}
+		}
+	}
+
+	// Every cell that wasn't visited becomes rock, a word at a time
+	for (unsigned int i = 0; i < m_Cells.size(); i++)
+	{
+		m_Cells[i] |= ~Visited[i];
+	}
+
+	return GetOpenCellCount();
+}
+
+
+// Function:		Build Floor Rects function
+// What it does:	Merges the open cells into as few rectangles as it can by joining matching runs of open cells on neighbouring rows
+// Takes in:		vector<CaveRect> - Reference to the list to add the rectangles to
+// Returns:			Nothing
+
+void CaveGeneratorClass::BuildFloorRects(vector<CaveRect> &Rects)
+{
+	// Rectangles that are still growing, in order of their left edge
+	vector<CaveRect> Active;
+	vector<CaveRect> NextActive;
+
+	for (int y = 0; y <= m_Height; y++)
+	{
+		NextActive.clear();
+		unsigned int i = 0;
+
+		// Find each run of open cells in this row (there are none past the last row, so everything is closed)
+		int x = 0;
+		while (y < m_Height && x < m_Width)
+		{
+			if (!IsOpen(x, y))
+			{
+				x++;
+				continue;
+			}
+
+			int RunStart = x;
+			while ((x < m_Width) && IsOpen(x, y))
+			{
+				x++;
+			}
+
+			// Close any rectangles that start before this run, they can't continue
+			while ((i < Active.size()) && (Active[i].X0 < RunStart))
+			{
+				Active[i].Y1 = y;
+				Rects.push_back(Active[i]);
+				i++;
+			}
+
+			// If a rectangle has exactly the same edges as this run it grows by a row, otherwise a new rectangle starts here
+			if ((i < Active.size()) && (Active[i].X0 == RunStart) && (Active[i].X1 == x))
+			{
+				NextActive.push_back(Active[i]);
+				i++;
+			}
+			else
+			{
+				CaveRect NewRect = { RunStart, y, x, y + 1 };
+				NextActive.push_back(NewRect);
+			}
+		}
+
+		// Close the rectangles left over
+		while (i < Active.size())
+		{
+			Active[i].Y1 = y;
+			Rects.push_back(Active[i]);
+			i++;
+		}
+
+		Active.swap(NextActive);
+	}
+}
+
+
+// Function:		Build Wall Segments function
+// What it does:	Finds every boundary between an open cell and rock and joins neighbouring boundaries facing the same way
+//					into one straight wall segment
+// Takes in:		vector<CaveSegment> - Reference to the list to add the segments to
+// Returns:			Nothing
+
+void CaveGeneratorClass::BuildWallSegments(vector<CaveSegment> &Segments)
+{
+	// Walls along the x axis lie between row y - 1 and row y
+	for (int y = 0; y <= m_Height; y++)
+	{
+		CaveSegment Current = { true, y, 0, 0, 0 };
+
+		for (int x = 0; x <= m_Width; x++)
+		{
+			int OpenSide = 0;
+			if (x < m_Width)
+			{
+				bool BelowOpen = IsOpen(x, y - 1) || IsEntrance(x, y - 1);
+				bool AboveOpen = IsOpen(x, y) || IsEntrance(x, y);
+				if (BelowOpen != AboveOpen)
+				{
+					OpenSide = BelowOpen ? CAVE_SIDE_DOWN : CAVE_SIDE_UP;
+				}
+			}
+
+			// End the current segment when the boundary stops or changes direction
+			if ((Current.OpenSide != 0) && (OpenSide != Current.OpenSide))
+			{
+				Current.End = x;
+				Segments.push_back(Current);
+				Current.OpenSide = 0;
+			}
+			if ((OpenSide != 0) && (Current.OpenSide == 0))
+			{
+				Current.Start = x;
+				Current.OpenSide = OpenSide;
+			}
+		}
+	}
+
+	// Walls along the z axis lie between column x - 1 and column x
+	for (int x = 0; x <= m_Width; x++)
+	{
+		CaveSegment Current = { false, x, 0, 0, 0 };
+
+		for (int y = 0; y <= m_Height; y++)
+		{
+			int OpenSide = 0;
+			if (y < m_Height)
+			{
+				bool LeftOpen = IsOpen(x - 1, y) || IsEntrance(x - 1, y);
+				bool RightOpen = IsOpen(x, y) || IsEntrance(x, y);
+				if (LeftOpen != RightOpen)
+				{
+					OpenSide = LeftOpen ? CAVE_SIDE_LEFT : CAVE_SIDE_RIGHT;
+				}
+			}
+
+			if ((Current.OpenSide != 0) && (OpenSide != Current.OpenSide))
+			{
+				Current.End = y;
+				Segments.push_back(Current);
+				Current.OpenSide = 0;
+			}
+			if ((OpenSide != 0) && (Current.OpenSide == 0))
+			{
+				Current.Start = y;
+				Current.OpenSide = OpenSide;
+			}
+		}
+	}
+}
+
+
+// Function:		Is Open function
+// What it does:	Checks if a cell of the region is open floor. Cells outside of the region are rock
+// Takes in:		int - X cell, int - Y cell
+// Returns:			True if the cell is open floor, false if it is rock
+
+bool CaveGeneratorClass::IsOpen(int x, int y)
+{
+	if ((x < 0) || (y < 0) || (x >= m_Width) || (y >= m_Height))
+	{
+		return false;
+	}
+
+	return ((m_Cells[y * m_WordsPerRow + x / CAVE_WORD_BITS] >> (x % CAVE_WORD_BITS)) & 1ULL) == 0;
+}
+
+
+// Function:		Is Entrance function
+// What it does:	Checks if a cell just outside the region is the mouth of the entrance tunnel
+// Takes in:		int - X cell, int - Y cell
+// Returns:			True if the cell is part of the tunnel mouth
+
+bool CaveGeneratorClass::IsEntrance(int x, int y)
+{
+	if ((m_EntranceSide == CAVE_SIDE_LEFT) && (x == -1))
+	{
+		return (y >= m_EntranceStart) && (y < m_EntranceEnd);
+	}
+	if ((m_EntranceSide == CAVE_SIDE_RIGHT) && (x == m_Width))
+	{
+		return (y >= m_EntranceStart) && (y < m_EntranceEnd);
+	}
+	if ((m_EntranceSide == CAVE_SIDE_DOWN) && (y == -1))
+	{
+		return (x >= m_EntranceStart) && (x < m_EntranceEnd);
+	}
+	if ((m_EntranceSide == CAVE_SIDE_UP) && (y == m_Height))
+	{
+		return (x >= m_EntranceStart) && (x < m_EntranceEnd);
+	}
+
+	return false;
+}
+
+
+// Function:		Set Cell function
+// What it does:	Sets a cell of the region to rock or to open floor
+// Takes in:		int - X cell, int - Y cell, bool - true for rock, false for open floor
+// Returns:			Nothing
+
+void CaveGeneratorClass::SetCell(int x, int y, bool Solid)
+{
+	if ((x < 0) || (y < 0) || (x >= m_Width) || (y >= m_Height))
+	{
+		return;
+	}
+
+	CaveWord Bit = 1ULL << (x % CAVE_WORD_BITS);
+	if (Solid)
+	{
+		m_Cells[y * m_WordsPerRow + x / CAVE_WORD_BITS] |= Bit;
+	}
+	else
+	{
+		m_Cells[y * m_WordsPerRow + x / CAVE_WORD_BITS] &= ~Bit;
+	}
+}
+
+
+// Function:		Get Open Cell Count function
+// What it does:	Counts the open cells in the region a word at a time
+// Takes in:		Nothing
+// Returns:			int - Number of open cells
+
+int CaveGeneratorClass::GetOpenCellCount()
+{
+	int Count = 0;
+
+	// Padding bits are always rock so they are never counted
+	for (unsigned int i = 0; i < m_Cells.size(); i++)
+	{
+		Count += CountBits(~m_Cells[i]);
+	}
+
+	return Count;
+}
+
+
+int CaveGeneratorClass::GetWidth()
+{
+	return m_Width;
+}
+
+
+int CaveGeneratorClass::GetHeight()
+{
+	return m_Height;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the packed grids
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void CaveGeneratorClass::Shutdown()
+{
+	vector<CaveWord>().swap(m_Cells);
+	vector<CaveWord>().swap(m_NextCells);
+	vector<CaveWord>().swap(m_SolidRow);
+	m_Width = 0;
+	m_Height = 0;
+	m_WordsPerRow = 0;
+}
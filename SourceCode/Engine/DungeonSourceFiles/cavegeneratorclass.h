@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: cavegeneratorclass.h
+// Cave Generator Class
+// Generates cave shaped regions with a cellular automata, storing the cells as packed bits so that 64 cells are processed at once
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CAVE_GENERATOR_CLASS_H
+#define CAVE_GENERATOR_CLASS_H
+
+// For rand
+#include <stdlib.h>
+
+// For vector
+#include <vector>
+using std::vector;
+
+// The number of cells held in one word of the packed grid
+#define CAVE_WORD_BITS 64
+
+// Specify the chance (out of 100) that a cell starts as solid rock when the cave is seeded
+#define CAVE_FILL_CHANCE 45
+// Specify the amount of times the automata rule is applied to smooth the cave
+#define CAVE_ITERATIONS 5
+
+// Define values for the sides of the cave region (used for the entrance)
+#define CAVE_SIDE_LEFT 1
+#define CAVE_SIDE_UP 2
+#define CAVE_SIDE_RIGHT 3
+#define CAVE_SIDE_DOWN 4
+
+typedef unsigned long long CaveWord;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CaveGeneratorClass
+// Holds a bit packed grid of cells for a cave region (1 = solid rock, 0 = open floor) and smooths it with the
+// "4-5" cellular automata rule. Neighbours are counted for a whole word at a time by adding shifted copies of the
+// rows together with bitwise adders, instead of counting each cell's 8 neighbours separately.
+// Also converts the finished cave into floor rectangles and wall segments so the dungeon can build geometry for it
+////////////////////////////////////////////////////////////////////////////////
+class CaveGeneratorClass
+{
+public:
+	// A rectangle of open cells, in cells of the region (X1 and Y1 are exclusive)
+	struct CaveRect
+	{
+		int X0, Y0, X1, Y1;
+	};
+
+	// A straight wall along a cell boundary, in cells of the region
+	// Along X walls run from (Start, Line) to (End, Line), along Z walls run from (Line, Start) to (Line, End)
+	// OpenSide is the side of the wall the open floor is on (uses the CAVE_SIDE defines)
+	struct CaveSegment
+	{
+		bool AlongX;
+		int Line;
+		int Start, End;
+		int OpenSide;
+	};
+
+	// Function:		Cave Generator constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	CaveGeneratorClass();
+
+
+	// Placeholder destructor
+	~CaveGeneratorClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Allocates the packed grids for a region of the given size and seeds them with random rock using rand
+	// Takes in:		int - Width of the region in cells, int - Height of the region in cells,
+	//					int - FillChance, the chance out of 100 for a cell to start as rock
+	// Returns:			True if the grids were created, false if not
+	bool Initialise(int Width, int Height, int FillChance);
+
+
+	// Function:		Step function
+	// What it does:	Applies the automata rule to the whole region the amount of times passed in. A cell becomes rock
+	//					if 5 or more of the 9 cells in its 3x3 block (itself and its neighbours) are rock. Cells outside the region count as rock
+	// Takes in:		int - Number of iterations
+	// Returns:			Nothing
+	void Step(int Iterations);
+
+
+	// Function:		Carve Entrance function
+	// What it does:	Opens a straight tunnel from the middle of one side of the region to its center so the cave can be joined
+	//					to a door of a dungeon piece. The side is remembered so no wall is built across the tunnel's mouth
+	// Takes in:		int - Side of the region (CAVE_SIDE defines), int - Position of the tunnel along that side in cells,
+	//					int - Half width of the tunnel in cells
+	// Returns:			Nothing
+	void CarveEntrance(int Side, int Position, int HalfWidth);
+
+
+	// Function:		Keep Connected function
+	// What it does:	Flood fills the open cells from the given cell and turns every open cell that wasn't reached into rock,
+	//					so that the player can walk to every part of the cave from the entrance
+	// Takes in:		int - X cell to fill from, int - Y cell to fill from
+	// Returns:			The number of open cells left in the cave
+	int KeepConnected(int StartX, int StartY);
+
+
+	// Function:		Build Floor Rects function
+	// What it does:	Merges the open cells into as few rectangles as it can by joining matching runs of open cells on neighbouring rows
+	// Takes in:		vector<CaveRect> - Reference to the list to add the rectangles to
+	// Returns:			Nothing
+	void BuildFloorRects(vector<CaveRect> &Rects);
+
+
+	// Function:		Build Wall Segments function
+	// What it does:	Finds every boundary between an open cell and rock and joins neighbouring boundaries facing the same way
+	//					into one straight wall segment
+	// Takes in:		vector<CaveSegment> - Reference to the list to add the segments to
+	// Returns:			Nothing
+	void BuildWallSegments(vector<CaveSegment> &Segments);
+
+
+	// Function:		Is Open function
+	// What it does:	Checks if a cell of the region is open floor. Cells outside of the region are rock
+	// Takes in:		int - X cell, int - Y cell
+	// Returns:			True if the cell is open floor, false if it is rock
+	bool IsOpen(int x, int y);
+
+
+	// Function:		Get Open Cell Count function
+	// What it does:	Counts the open cells in the region a word at a time
+	// Takes in:		Nothing
+	// Returns:			int - Number of open cells
+	int GetOpenCellCount();
+
+
+	// Functions to get the size of the region in cells
+	int GetWidth();
+	int GetHeight();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the packed grids
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// Function:		Step Row function
+	// What it does:	Works out the next state of one row of words using the rows above and below it
+	// Takes in:		CaveWord - Pointer to the row above, CaveWord - Pointer to this row, CaveWord - Pointer to the row below,
+	//					CaveWord - Pointer to the row to write the result into
+	// Returns:			Nothing
+	void StepRow(const CaveWord* Above, const CaveWord* Row, const CaveWord* Below, CaveWord* Result);
+
+
+	// Function:		Is Entrance function
+	// What it does:	Checks if a cell just outside the region is the mouth of the entrance tunnel
+	// Takes in:		int - X cell, int - Y cell
+	// Returns:			True if the cell is part of the tunnel mouth
+	bool IsEntrance(int x, int y);
+
+
+	// Function:		Set Cell function
+	// What it does:	Sets a cell of the region to rock or to open floor
+	// Takes in:		int - X cell, int - Y cell, bool - true for rock, false for open floor
+	// Returns:			Nothing
+	void SetCell(int x, int y, bool Solid);
+
+private:
+	// Packed grids, one bit per cell. Each row is padded to a whole number of words and the padding is always rock
+	vector<CaveWord> m_Cells;
+	vector<CaveWord> m_NextCells;
+	vector<CaveWord> m_SolidRow;
+	CaveWord m_PaddingMask;
+	int m_Width;
+	int m_Height;
+	int m_WordsPerRow;
+
+	// Entrance tunnel variables
+	int m_EntranceSide;
+	int m_EntranceStart;
+	int m_EntranceEnd;
+};
+
+
+#endif
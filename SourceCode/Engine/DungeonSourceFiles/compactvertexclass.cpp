@@ -0,0 +1,59 @@
+#include "compactvertexclass.h"
+
+// The normals a compact vertex can have. These need to match the tables in light.vs and texture.vs
+static const D3DXVECTOR3 CompactNormals[COMPACT_NORMALS] = { D3DXVECTOR3(0.0f, 1.0f, 0.0f), D3DXVECTOR3(0.0f, -1.0f, 0.0f), D3DXVECTOR3(0.0f, 0.0f, -1.0f),
+															 D3DXVECTOR3(0.0f, 0.0f, 1.0f), D3DXVECTOR3(1.0f, 0.0f, 0.0f), D3DXVECTOR3(-1.0f, 0.0f, 0.0f) };
+
+
+// Function:		Pack function
+// What it does:	Packs a position, texture co-ordinates and normal into a compact vertex
+// Takes in:		D3DXVECTOR3 - The position, relative to the origin of its piece or mesh, D3DXVECTOR2 - The texture
+//					co-ordinates, D3DXVECTOR3 - The normal, VertexType - reference to the compact vertex to fill in
+// Returns:			True if successful, false if the normal isn't in the table or the vertex would move more than COMPACT_MAX_ERROR
+
+bool CompactVertexClass::Pack(D3DXVECTOR3 Position, D3DXVECTOR2 Texture, D3DXVECTOR3 Normal, VertexType &Vertex)
+{
+	int NormalIndex = FindNormal(Normal);
+	if (NormalIndex < 0)
+	{
+		return false;
+	}
+
+	// Small whole numbers are exact as half floats, so the index comes back out of the w unchanged
+	Vertex.position = D3DXVECTOR4_16F(Position.x, Position.y, Position.z, (float)NormalIndex);
+	Vertex.texture = D3DXVECTOR2_16F(Texture.x, Texture.y);
+
+	// Check how far each value moved when it was rounded, so the vertex is only packed if it stays within the error allowed
+	float Packed[5] = { Vertex.position.x, Vertex.position.y, Vertex.position.z, Vertex.texture.x, Vertex.texture.y };
+	float Unpacked[5] = { Position.x, Position.y, Position.z, Texture.x, Texture.y };
+	for (int i = 0; i < 5; i++)
+	{
+		if (fabsf(Packed[i] - Unpacked[i]) > COMPACT_MAX_ERROR)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// Function:		Find Normal function
+// What it does:	Finds the index of a normal in the table
+// Takes in:		D3DXVECTOR3 - The normal
+// Returns:			int - Index of the normal, or -1 if it isn't in the table
+
+int CompactVertexClass::FindNormal(D3DXVECTOR3 Normal)
+{
+	D3DXVec3Normalize(&Normal, &Normal);
+
+	for (int i = 0; i < COMPACT_NORMALS; i++)
+	{
+		if (D3DXVec3Dot(&Normal, &CompactNormals[i]) > 0.999f)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
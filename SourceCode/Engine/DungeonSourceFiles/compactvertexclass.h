@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: compactvertexclass.h
+// Compact Vertex Class
+// Packs the vertices of the dungeon pieces and meshes into half floats with the index of an axis aligned normal
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMPACT_VERTEX_CLASS_H
+#define COMPACT_VERTEX_CLASS_H
+
+#include <d3dx10math.h>
+
+// For fabsf
+#include <math.h>
+
+// Specify whether the dungeon pieces and meshes keep their vertices in the compact layout. Those with a normal that isn't
+// in the table keep the full layout either way
+#define COMPACT_VERTICES 1
+
+// The number of normals in the table (up, down, and the four walls)
+#define COMPACT_NORMALS 6
+
+// The furthest a position (in units) or texture co-ordinate (in repeats) can move when it is packed. Vertices that would move
+// further keep the full layout. Half floats are this close for values up to 16 from the origin they are packed around
+#define COMPACT_MAX_ERROR (1.0f / 256.0f)
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CompactVertexClass
+// A full vertex is 32 bytes, a float for each co-ordinate of its position, texture co-ordinates and normal. Every surface of
+// the dungeon faces along an axis, so a compact vertex keeps its position and texture co-ordinates as half floats and its
+// normal as an index into a table of the six axis directions, stored in the spare w of the position. That is 12 bytes a vertex.
+// Half floats keep 11 bits, which is too coarse for positions across the whole dungeon (a 32nd of a unit once they are 32 units
+// from the middle), so each piece or mesh packs its positions around its own middle and adds that back in its world matrix.
+// Positions and texture co-ordinates then move by at most COMPACT_MAX_ERROR, and a corner shared by two neighbouring pieces
+// can be up to twice that apart as each rounds around its own middle
+////////////////////////////////////////////////////////////////////////////////
+class CompactVertexClass
+{
+public:
+	// A compact vertex. The w of the position is the index of the normal in the table, which is the same in light.vs and texture.vs
+	struct VertexType
+	{
+		D3DXVECTOR4_16F position;
+		D3DXVECTOR2_16F texture;
+	};
+
+
+	// Function:		Pack function
+	// What it does:	Packs a position, texture co-ordinates and normal into a compact vertex
+	// Takes in:		D3DXVECTOR3 - The position, relative to the origin of its piece or mesh, D3DXVECTOR2 - The texture
+	//					co-ordinates, D3DXVECTOR3 - The normal, VertexType - reference to the compact vertex to fill in
+	// Returns:			True if successful, false if the normal isn't in the table or the vertex would move more than COMPACT_MAX_ERROR
+	static bool Pack(D3DXVECTOR3 Position, D3DXVECTOR2 Texture, D3DXVECTOR3 Normal, VertexType &Vertex);
+
+
+	// Function:		Find Normal function
+	// What it does:	Finds the index of a normal in the table
+	// Takes in:		D3DXVECTOR3 - The normal
+	// Returns:			int - Index of the normal, or -1 if it isn't in the table
+	static int FindNormal(D3DXVECTOR3 Normal);
+};
+
+
+#endif
@@ -0,0 +1,515 @@
+#include "distributionreportclass.h"
+
+// Names, first bins and bin widths of the distributions (in the order of the REPORT values)
+static const char* DistributionNames[REPORT_DISTRIBUTIONS] = { "Pieces per dungeon", "Rooms per dungeon", "Corridors per dungeon",
+	"Depth", "Dead ends per dungeon", "Map width", "Map height", "Generation time (ms)", "Room width", "Room height",
+	"Corridor length", "Doors per piece" };
+static const float DistributionStarts[REPORT_DISTRIBUTIONS] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f };
+static const float DistributionWidths[REPORT_DISTRIBUTIONS] = { 4.0f, 2.0f, 2.0f, 1.0f, 2.0f, 5.0f, 5.0f, 0.025f, 0.2f, 0.2f, 0.2f, 1.0f };
+
+
+// Function:		Distribution Report constructor
+// What it does:	Initialises all variables and objects to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+DistributionReportClass::DistributionReportClass()
+{
+	m_Workers = 0;
+	m_PrefabLibrary = 0;
+	m_FirstSeed = 0;
+	m_DungeonCount = 0;
+	m_Seconds = 0.0;
+	ResetDistributions(m_Total);
+}
+
+
+// Placeholder destructor
+DistributionReportClass::~DistributionReportClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Starts the worker threads and loads the prefab templates shared by every dungeon
+// Takes in:		int - Number of threads, char - Pointer to the prefab asset file name
+// Returns:			True if successful, false if not
+
+bool DistributionReportClass::Initialise(int ThreadCount, char* PrefabFile)
+{
+	bool result;
+
+	m_Workers = new WorkerPoolClass;
+	if (!m_Workers)
+	{
+		return false;
+	}
+
+	result = m_Workers->Initialise(ThreadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	// Load the templates without a device, as the prefab rooms are only needed for their masks and sockets
+	m_PrefabLibrary = new PrefabLibraryClass;
+	if (!m_PrefabLibrary)
+	{
+		return false;
+	}
+
+	result = m_PrefabLibrary->Initialise(0, 0, PrefabFile);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Generate function
+// What it does:	Lays out the dungeon for each seed in the range and measures it, replacing the last sample
+// Takes in:		unsigned int - First seed, int - Number of dungeons
+// Returns:			Nothing
+
+void DistributionReportClass::Generate(unsigned int FirstSeed, int DungeonCount)
+{
+	std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+	ResetDistributions(m_Total);
+	m_Seconds = 0.0;
+	if (DungeonCount <= 0)
+	{
+		return;
+	}
+
+	// Split the seeds into jobs and run them across the threads
+	m_FirstSeed = FirstSeed;
+	m_DungeonCount = DungeonCount;
+	int ChunkCount = (DungeonCount + REPORT_CHUNK - 1) / REPORT_CHUNK;
+	m_Chunks.clear();
+	m_Chunks.resize(ChunkCount);
+
+	m_Workers->Run(GenerateChunkJob, this, ChunkCount);
+
+	// Join the distributions of the jobs in seed order
+	for (int i = 0; i < ChunkCount; i++)
+	{
+		for (int j = 0; j < REPORT_DISTRIBUTIONS; j++)
+		{
+			Merge(m_Total.Distributions[j], m_Chunks[i].Distributions[j]);
+		}
+		for (int j = 0; j < REPORT_DEPTHS; j++)
+		{
+			Merge(m_Total.DepthPieces[j], m_Chunks[i].DepthPieces[j]);
+		}
+	}
+	m_Chunks.clear();
+
+	m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+
+// Function:		Write Report function
+// What it does:	Writes the mean, confidence interval and histogram of every distribution in the last sample to a text file
+// Takes in:		char - Pointer to the file name
+// Returns:			True if the file was written, false if not
+
+bool DistributionReportClass::WriteReport(char* Filename)
+{
+	ofstream fout;
+
+	fout.open(Filename);
+	if (fout.fail())
+	{
+		return false;
+	}
+
+	int Dungeons = m_Total.Distributions[REPORT_PIECES].Count;
+	fout << "Dungeon distribution report" << std::endl;
+	fout << "Dungeons: " << Dungeons << " (seeds " << m_FirstSeed << " to " << (m_FirstSeed + m_DungeonCount - 1) << ")" << std::endl;
+	fout << "Threads: " << m_Workers->GetThreadCount() << ", time: " << m_Seconds << " s";
+	if (m_Seconds > 0.0)
+	{
+		fout << ", dungeons per second: " << (Dungeons / m_Seconds);
+	}
+	fout << std::endl;
+	fout << "Intervals are " << REPORT_CONFIDENCE_Z << " standard errors either side of the mean" << std::endl << std::endl;
+
+	for (int i = 0; i < REPORT_DISTRIBUTIONS; i++)
+	{
+		WriteDistribution(fout, DistributionNames[i], m_Total.Distributions[i], true);
+	}
+
+	// The number of pieces at each depth shows where the generator runs out of room or stops branching
+	fout << "Pieces per dungeon at each depth" << std::endl;
+	for (int i = 0; i < REPORT_DEPTHS; i++)
+	{
+		char Name[32];
+		sprintf_s(Name, 32, "  Depth %d", i);
+		WriteDistribution(fout, Name, m_Total.DepthPieces[i], false);
+	}
+
+	fout.close();
+
+	return !fout.fail();
+}
+
+
+// Function:		Get Distribution function
+// What it does:	Returns one of the distributions of the last sample
+// Takes in:		int - Distribution (REPORT values)
+// Returns:			Pointer to the distribution
+
+DistributionReportClass::Distribution* DistributionReportClass::GetDistribution(int Index)
+{
+	return &m_Total.Distributions[Index];
+}
+
+
+// Function:		Get Mean function
+// What it does:	Returns the mean of a distribution
+// Takes in:		Distribution - reference to the distribution
+// Returns:			double - Mean
+
+double DistributionReportClass::GetMean(Distribution &Samples)
+{
+	if (Samples.Count == 0)
+	{
+		return 0.0;
+	}
+
+	return Samples.Sum / Samples.Count;
+}
+
+
+// Function:		Get Confidence function
+// What it does:	Returns half the width of the confidence interval of the mean of a distribution
+// Takes in:		Distribution - reference to the distribution
+// Returns:			double - Half the width of the interval
+
+double DistributionReportClass::GetConfidence(Distribution &Samples)
+{
+	if (Samples.Count < 2)
+	{
+		return 0.0;
+	}
+
+	// Use the sample variance, which can come out just below 0 from rounding when every sample is the same
+	double Mean = Samples.Sum / Samples.Count;
+	double Variance = (Samples.SumSquares - (Samples.Count * Mean * Mean)) / (Samples.Count - 1);
+	if (Variance < 0.0)
+	{
+		Variance = 0.0;
+	}
+
+	return REPORT_CONFIDENCE_Z * sqrt(Variance / Samples.Count);
+}
+
+
+// Function:		Get Seconds function
+// What it does:	Returns the time taken to generate the last sample
+// Takes in:		Nothing
+// Returns:			double - Time in seconds
+
+double DistributionReportClass::GetSeconds()
+{
+	return m_Seconds;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Stops the worker threads and releases the prefab library and the sample
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DistributionReportClass::Shutdown()
+{
+	if (m_Workers)
+	{
+		m_Workers->Shutdown();
+		delete m_Workers;
+		m_Workers = 0;
+	}
+
+	if (m_PrefabLibrary)
+	{
+		m_PrefabLibrary->Shutdown();
+		delete m_PrefabLibrary;
+		m_PrefabLibrary = 0;
+	}
+
+	m_Chunks.clear();
+	ResetDistributions(m_Total);
+}
+
+
+// Function:		Generate Chunk Job function
+// What it does:	Run by the worker pool to lay out and measure each dungeon of one job
+// Takes in:		void - pointer to the report, int - Index of the job
+// Returns:			Nothing
+
+void DistributionReportClass::GenerateChunkJob(void* Data, int Index)
+{
+	DistributionReportClass* Report = (DistributionReportClass*)Data;
+	ChunkResult &Result = Report->m_Chunks[Index];
+
+	ResetDistributions(Result);
+
+	int First = Index * REPORT_CHUNK;
+	int Last = First + REPORT_CHUNK;
+	if (Last > Report->m_DungeonCount)
+	{
+		Last = Report->m_DungeonCount;
+	}
+
+	// The dungeon is too large for the stack because of its grid, so one is made for the job and reset after each seed
+	DungeonClass* Dungeon = new DungeonClass;
+	if (!Dungeon)
+	{
+		return;
+	}
+
+	for (int i = First; i < Last; i++)
+	{
+		// Lay out the dungeon the same way the game does for this seed, on this thread and with no time limit
+		Dungeon->SetSeed(Report->m_FirstSeed + i);
+		Dungeon->SetGenerationBudget(0);
+		Dungeon->SetThreadCount(1);
+		Dungeon->SetSharedPrefabLibrary(Report->m_PrefabLibrary);
+
+		std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+		bool result = Dungeon->Initialise(0, 0, 0);
+		double Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+		// Dungeons that didn't fit in the grid aren't measured
+		if (result)
+		{
+			Report->MeasureDungeon(Dungeon, Milliseconds, Result);
+		}
+		Dungeon->Reset();
+	}
+
+	delete Dungeon;
+}
+
+
+// Function:		Measure Dungeon function
+// What it does:	Adds the measurements of a finished dungeon to the distributions of a job
+// Takes in:		DungeonClass - pointer to the dungeon, double - Time taken to generate it in milliseconds,
+//					ChunkResult - reference to the results of the job
+// Returns:			Nothing
+
+void DistributionReportClass::MeasureDungeon(DungeonClass* Dungeon, double Milliseconds, ChunkResult &Result)
+{
+	DungeonClass::LayoutMetrics Metrics;
+	int DepthPieces[REPORT_DEPTHS] = { 0 };
+
+	Dungeon->GetLayoutMetrics(Metrics);
+	AddSample(Result.Distributions[REPORT_PIECES], Metrics.Pieces);
+	AddSample(Result.Distributions[REPORT_ROOMS], Metrics.Rooms);
+	AddSample(Result.Distributions[REPORT_CORRIDORS], Metrics.Corridors);
+	AddSample(Result.Distributions[REPORT_DEPTH], Metrics.Depth);
+	AddSample(Result.Distributions[REPORT_DEAD_ENDS], Metrics.DeadEnds);
+	AddSample(Result.Distributions[REPORT_WIDTH], Metrics.MaxX - Metrics.MinX);
+	AddSample(Result.Distributions[REPORT_HEIGHT], Metrics.MaxY - Metrics.MinY);
+	AddSample(Result.Distributions[REPORT_TIME], Milliseconds);
+
+	// Measure each piece, and count the pieces at each depth
+	list<DungeonPieceClass*>* Pieces = Dungeon->GetDungeonPieces();
+	for (auto thisObject = Pieces->begin(); thisObject != Pieces->end(); ++thisObject)
+	{
+		DungeonPieceClass* Piece = *thisObject;
+		DungeonPieceClass::m_PieceType Type = Piece->GetPieceType();
+		float Width = Piece->m_HalfWidth * 2.0f;
+		float Height = Piece->m_HalfHeight * 2.0f;
+
+		if (Type == DungeonPieceClass::ROOM)
+		{
+			AddSample(Result.Distributions[REPORT_ROOM_WIDTH], Width);
+			AddSample(Result.Distributions[REPORT_ROOM_HEIGHT], Height);
+		}
+		if (Type == DungeonPieceClass::HORIZONTAL_CORRIDOR)
+		{
+			AddSample(Result.Distributions[REPORT_CORRIDOR_LENGTH], Width);
+		}
+		if (Type == DungeonPieceClass::VERTICAL_CORRIDOR)
+		{
+			AddSample(Result.Distributions[REPORT_CORRIDOR_LENGTH], Height);
+		}
+
+		int Doors = (int)Piece->m_LDoor + (int)Piece->m_RDoor + (int)Piece->m_UDoor + (int)Piece->m_DDoor;
+		AddSample(Result.Distributions[REPORT_DOORS], Doors);
+
+		if ((Piece->m_Depth >= 0) && (Piece->m_Depth < REPORT_DEPTHS))
+		{
+			DepthPieces[Piece->m_Depth]++;
+		}
+	}
+
+	for (int i = 0; i < REPORT_DEPTHS; i++)
+	{
+		AddSample(Result.DepthPieces[i], DepthPieces[i]);
+	}
+}
+
+
+// Function:		Reset Distributions function
+// What it does:	Empties the distributions of a job and sets the bins each one uses
+// Takes in:		ChunkResult - reference to the results
+// Returns:			Nothing
+
+void DistributionReportClass::ResetDistributions(ChunkResult &Result)
+{
+	for (int i = 0; i < REPORT_DISTRIBUTIONS + REPORT_DEPTHS; i++)
+	{
+		Distribution &Samples = (i < REPORT_DISTRIBUTIONS) ? Result.Distributions[i] : Result.DepthPieces[i - REPORT_DISTRIBUTIONS];
+
+		// The pieces at each depth use the same bins as the rooms per dungeon
+		int Setting = (i < REPORT_DISTRIBUTIONS) ? i : REPORT_ROOMS;
+		Samples.Start = DistributionStarts[Setting];
+		Samples.BinWidth = DistributionWidths[Setting];
+		for (int j = 0; j < REPORT_BINS; j++)
+		{
+			Samples.Bins[j] = 0;
+		}
+		Samples.Below = 0;
+		Samples.Above = 0;
+		Samples.Sum = 0.0;
+		Samples.SumSquares = 0.0;
+		Samples.Min = 0.0;
+		Samples.Max = 0.0;
+		Samples.Count = 0;
+	}
+}
+
+
+// Function:		Add Sample function
+// What it does:	Adds a sample to a distribution
+// Takes in:		Distribution - reference to the distribution, double - Sample
+// Returns:			Nothing
+
+void DistributionReportClass::AddSample(Distribution &Samples, double Value)
+{
+	// Sizes are made from whole tenths, so a small amount is added before finding the bin so that a sample on the edge of a
+	// bin isn't put in the bin below by rounding
+	double Bin = floor(((Value - Samples.Start) / Samples.BinWidth) + 0.0001);
+	if (Bin < 0.0)
+	{
+		Samples.Below++;
+	}
+	else if (Bin >= REPORT_BINS)
+	{
+		Samples.Above++;
+	}
+	else
+	{
+		Samples.Bins[(int)Bin]++;
+	}
+
+	if ((Samples.Count == 0) || (Value < Samples.Min))
+	{
+		Samples.Min = Value;
+	}
+	if ((Samples.Count == 0) || (Value > Samples.Max))
+	{
+		Samples.Max = Value;
+	}
+	Samples.Sum += Value;
+	Samples.SumSquares += Value * Value;
+	Samples.Count++;
+}
+
+
+// Function:		Merge function
+// What it does:	Adds the samples of one distribution to another with the same bins
+// Takes in:		Distribution - reference to the distribution to add to, Distribution - reference to the samples to add
+// Returns:			Nothing
+
+void DistributionReportClass::Merge(Distribution &Total, Distribution &Samples)
+{
+	if (Samples.Count == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < REPORT_BINS; i++)
+	{
+		Total.Bins[i] += Samples.Bins[i];
+	}
+	Total.Below += Samples.Below;
+	Total.Above += Samples.Above;
+
+	if ((Total.Count == 0) || (Samples.Min < Total.Min))
+	{
+		Total.Min = Samples.Min;
+	}
+	if ((Total.Count == 0) || (Samples.Max > Total.Max))
+	{
+		Total.Max = Samples.Max;
+	}
+	Total.Sum += Samples.Sum;
+	Total.SumSquares += Samples.SumSquares;
+	Total.Count += Samples.Count;
+}
+
+
+// Function:		Write Distribution function
+// What it does:	Writes the mean, confidence interval, range and histogram of a distribution
+// Takes in:		ofstream - reference to the file, char - Pointer to the name, Distribution - reference to the distribution,
+//					bool - True to draw the histogram
+// Returns:			Nothing
+
+void DistributionReportClass::WriteDistribution(ofstream &fout, const char* Name, Distribution &Samples, bool Histogram)
+{
+	char Line[256];
+	double Mean = GetMean(Samples);
+	double Confidence = GetConfidence(Samples);
+
+	sprintf_s(Line, 256, "%s: mean %.3f (%.3f to %.3f), range %.3f to %.3f, samples %d", Name, Mean, Mean - Confidence,
+		Mean + Confidence, Samples.Min, Samples.Max, Samples.Count);
+	fout << Line << std::endl;
+
+	if (!Histogram)
+	{
+		return;
+	}
+
+	// Scale the bars so that the largest bin fills the bar length
+	int Largest = 1;
+	for (int i = 0; i < REPORT_BINS; i++)
+	{
+		Largest = (Samples.Bins[i] > Largest) ? Samples.Bins[i] : Largest;
+	}
+
+	// Only draw the bins from the first to the last one used
+	int First = 0;
+	int Last = REPORT_BINS - 1;
+	while ((First < Last) && (Samples.Bins[First] == 0))
+	{
+		First++;
+	}
+	while ((Last > First) && (Samples.Bins[Last] == 0))
+	{
+		Last--;
+	}
+
+	if (Samples.Below > 0)
+	{
+		sprintf_s(Line, 256, "  %20s %8d", "below", Samples.Below);
+		fout << Line << std::endl;
+	}
+	for (int i = First; i <= Last; i++)
+	{
+		sprintf_s(Line, 256, "  %9.3f %10.3f %8d ", Samples.Start + (i * Samples.BinWidth), Samples.Start + ((i + 1) * Samples.BinWidth),
+			Samples.Bins[i]);
+		fout << Line << std::string((Samples.Bins[i] * REPORT_BAR_LENGTH) / Largest, '#') << std::endl;
+	}
+	if (Samples.Above > 0)
+	{
+		sprintf_s(Line, 256, "  %20s %8d", "above", Samples.Above);
+		fout << Line << std::endl;
+	}
+	fout << std::endl;
+}
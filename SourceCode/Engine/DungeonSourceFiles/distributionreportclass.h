@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: distributionreportclass.h
+// Distribution Report Class
+// Generates a large sample of dungeons across worker threads and reports the distributions of their sizes and costs
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISTRIBUTION_REPORT_CLASS_H
+#define DISTRIBUTION_REPORT_CLASS_H
+
+// For timing each dungeon and the whole sample
+#include <chrono>
+
+// For sqrt and sprintf_s
+#include <math.h>
+#include <stdio.h>
+
+// For writing the report
+#include <fstream>
+using std::ofstream;
+
+// For the bars of the histograms
+#include <string>
+
+// For vector
+#include <vector>
+using std::vector;
+
+#include "dungeonclass.h"
+#include "workerpoolclass.h"
+#include "prefablibraryclass.h"
+
+// Specify the number of dungeons generated by one job, the number of bins in each histogram and the longest bar drawn
+#define REPORT_CHUNK 128
+#define REPORT_BINS 24
+#define REPORT_BAR_LENGTH 50
+// Specify the z value used for the confidence intervals of the means (1.96 for 95%)
+#define REPORT_CONFIDENCE_Z 1.96
+
+// Specify the number of dungeons the application generates for a report before making the dungeon (0 for no report), the
+// threads used and the file the report is written to
+#define REPORT_DUNGEON_COUNT 0
+#define REPORT_THREADS 4
+#define REPORT_FILE "distribution_report.txt"
+
+// Distributions measured once for each dungeon
+#define REPORT_PIECES 0
+#define REPORT_ROOMS 1
+#define REPORT_CORRIDORS 2
+#define REPORT_DEPTH 3
+#define REPORT_DEAD_ENDS 4
+#define REPORT_WIDTH 5
+#define REPORT_HEIGHT 6
+#define REPORT_TIME 7
+// Distributions measured once for each piece
+#define REPORT_ROOM_WIDTH 8
+#define REPORT_ROOM_HEIGHT 9
+#define REPORT_CORRIDOR_LENGTH 10
+#define REPORT_DOORS 11
+#define REPORT_DISTRIBUTIONS 12
+
+// The most depths the number of pieces is counted for
+#define REPORT_DEPTHS (DUNGEON_DEPTH + 2)
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DistributionReportClass
+// Lays out a range of seeds without a device in the same way as the seed search (a dungeon per job, reset between seeds, and
+// a prefab library shared by every job), and measures each dungeon as it is finished. Each job keeps its own histograms and
+// sums, which are joined in seed order once every job has finished, so the report is the same on any number of threads
+// (apart from the generation times). The report gives the mean of each distribution with its confidence interval and a
+// histogram, so the chances and size limits of the piece generator can be tuned against both the layout and its cost
+////////////////////////////////////////////////////////////////////////////////
+class DistributionReportClass
+{
+public:
+	// A distribution of samples. Samples are counted in bins of BinWidth from Start, and the sums are used for the mean and
+	// the confidence interval
+	struct Distribution
+	{
+		float Start;
+		float BinWidth;
+		int Bins[REPORT_BINS];
+		int Below, Above;
+		double Sum, SumSquares;
+		double Min, Max;
+		int Count;
+	};
+
+	// Function:		Distribution Report constructor
+	// What it does:	Initialises all variables and objects to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	DistributionReportClass();
+
+
+	// Placeholder destructor
+	~DistributionReportClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Starts the worker threads and loads the prefab templates shared by every dungeon
+	// Takes in:		int - Number of threads, char - Pointer to the prefab asset file name
+	// Returns:			True if successful, false if not
+	bool Initialise(int ThreadCount, char* PrefabFile);
+
+
+	// Function:		Generate function
+	// What it does:	Lays out the dungeon for each seed in the range and measures it, replacing the last sample
+	// Takes in:		unsigned int - First seed, int - Number of dungeons
+	// Returns:			Nothing
+	void Generate(unsigned int FirstSeed, int DungeonCount);
+
+
+	// Function:		Write Report function
+	// What it does:	Writes the mean, confidence interval and histogram of every distribution in the last sample to a text file
+	// Takes in:		char - Pointer to the file name
+	// Returns:			True if the file was written, false if not
+	bool WriteReport(char* Filename);
+
+
+	// Function:		Get Distribution function
+	// What it does:	Returns one of the distributions of the last sample
+	// Takes in:		int - Distribution (REPORT values)
+	// Returns:			Pointer to the distribution
+	Distribution* GetDistribution(int Index);
+
+
+	// Function:		Get Mean function
+	// What it does:	Returns the mean of a distribution
+	// Takes in:		Distribution - reference to the distribution
+	// Returns:			double - Mean
+	static double GetMean(Distribution &Samples);
+
+
+	// Function:		Get Confidence function
+	// What it does:	Returns half the width of the confidence interval of the mean of a distribution
+	// Takes in:		Distribution - reference to the distribution
+	// Returns:			double - Half the width of the interval
+	static double GetConfidence(Distribution &Samples);
+
+
+	// Function:		Get Seconds function
+	// What it does:	Returns the time taken to generate the last sample
+	// Takes in:		Nothing
+	// Returns:			double - Time in seconds
+	double GetSeconds();
+
+
+	// Function:		Shutdown function
+	// What it does:	Stops the worker threads and releases the prefab library and the sample
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// The distributions measured by one job
+	struct ChunkResult
+	{
+		Distribution Distributions[REPORT_DISTRIBUTIONS];
+		Distribution DepthPieces[REPORT_DEPTHS];
+	};
+
+
+	// Function:		Generate Chunk Job function
+	// What it does:	Run by the worker pool to lay out and measure each dungeon of one job
+	// Takes in:		void - pointer to the report, int - Index of the job
+	// Returns:			Nothing
+	static void GenerateChunkJob(void* Data, int Index);
+
+
+	// Function:		Measure Dungeon function
+	// What it does:	Adds the measurements of a finished dungeon to the distributions of a job
+	// Takes in:		DungeonClass - pointer to the dungeon, double - Time taken to generate it in milliseconds,
+	//					ChunkResult - reference to the results of the job
+	// Returns:			Nothing
+	void MeasureDungeon(DungeonClass* Dungeon, double Milliseconds, ChunkResult &Result);
+
+
+	// Function:		Reset Distributions function
+	// What it does:	Empties the distributions of a job and sets the bins each one uses
+	// Takes in:		ChunkResult - reference to the results
+	// Returns:			Nothing
+	static void ResetDistributions(ChunkResult &Result);
+
+
+	// Function:		Add Sample function
+	// What it does:	Adds a sample to a distribution
+	// Takes in:		Distribution - reference to the distribution, double - Sample
+	// Returns:			Nothing
+	static void AddSample(Distribution &Samples, double Value);
+
+
+	// Function:		Merge function
+	// What it does:	Adds the samples of one distribution to another with the same bins
+	// Takes in:		Distribution - reference to the distribution to add to, Distribution - reference to the samples to add
+	// Returns:			Nothing
+	static void Merge(Distribution &Total, Distribution &Samples);
+
+
+	// Function:		Write Distribution function
+	// What it does:	Writes the mean, confidence interval, range and histogram of a distribution
+	// Takes in:		ofstream - reference to the file, char - Pointer to the name, Distribution - reference to the distribution,
+	//					bool - True to draw the histogram
+	// Returns:			Nothing
+	void WriteDistribution(ofstream &fout, const char* Name, Distribution &Samples, bool Histogram);
+
+private:
+	// Worker threads and the prefab templates shared by every dungeon
+	WorkerPoolClass* m_Workers;
+	PrefabLibraryClass* m_PrefabLibrary;
+
+	// The sample being generated
+	unsigned int m_FirstSeed;
+	int m_DungeonCount;
+	vector<ChunkResult> m_Chunks;
+
+	// The last sample
+	ChunkResult m_Total;
+	double m_Seconds;
+};
+
+
+#endif
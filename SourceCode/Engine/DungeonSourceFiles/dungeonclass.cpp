@@ -1,5 +1,8 @@
 #include "dungeonclass.h"
 
+// For sort
+#include <algorithm>
+
 
 // Function:		Dungeon class constructor
 // What it does:	Initialises all variables and objects to their defaults to set up the class
@@ -17,7 +20,6 @@ DungeonClass::DungeonClass()
 	m_DoorPosition = D3DXVECTOR2(0.0f, 0.0f);
 	m_DungeonDepth = 0;
 	m_WidthHeight = D3DXVECTOR2(0.0f, 0.0f);
-	m_NewCenter = D3DXVECTOR2(0.0f, 0.0f);
 	m_PlayerPosition = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	m_NextPlayerPosition = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	m_PlayerLastPosition = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
@@ -30,15 +32,55 @@ DungeonClass::DungeonClass()
 	m_RoomChanceAftCorridor = 0;
 	m_RoomsLimit = 4.0f;
 	m_PlayerMesh = 0;
+	m_CaveCount = 0;
+	m_PrefabLibrary = 0;
+	m_Generator = DUNGEON_GENERATOR;
+	m_Placement = PIECE_PLACEMENT;
+	m_EmptyRects = 0;
+	m_Occupancy = 0;
+	m_Graph = 0;
+	m_LoopBudget = DUNGEON_LOOP_BUDGET;
+	m_Workers = 0;
+	m_ThreadCount = GENERATION_THREADS;
+	m_TestBatch = 0;
+	m_PiecesPlaced = 0;
+	m_FrontierSize = 0;
+	m_GenerationBudget = GENERATION_BUDGET_MS;
+	m_GenerationStart = 0;
+	m_GenerationStopped = false;
+	m_GenerationOutOfTime = false;
+	m_CancelRequested = false;
+	m_ProgressCallback = 0;
+	m_ProgressUserData = 0;
+	m_Progress = LayoutMetrics();
+	m_ProgressBranches = 0;
+	m_ProgressBranchingPieces = 0;
+	m_Seed = 0;
+	m_SeedSet = false;
+	m_MaxDepth = 0;
+	m_SharedPrefabLibrary = false;
+	m_TextureCache = 0;
+	m_SharedTextureCache = false;
+	m_BufferPool = 0;
+	m_UsedStartX = DUNGEON_GRID_X;
+	m_UsedStartY = DUNGEON_GRID_Y;
+	m_UsedEndX = -1;
+	m_UsedEndY = -1;
 	DungeonFailed = false;
 
 	// Calculate the Grid offset
 	// The Grid offset is used so that the dungeon can begin at the position (0, 0, 0) 
 	// Array element IDs are positive only, therefore adding half of the grid amount will ensure the position relates to a positive grid element ID
+	// Initialise changes these to match the resolution of the grid it uses
+	m_GridSizeX = DUNGEON_GRID_X;
+	m_GridSizeY = DUNGEON_GRID_Y;
 	m_GridOffsetX = DUNGEON_GRID_X / 2;
 	m_GridOffsetZ = DUNGEON_GRID_Y / 2;
+	m_RequestedCellsPerUnit = GRID_CELLS_PER_UNIT;
+	m_CellsPerUnit = GRID_BASE_CELLS_PER_UNIT;
+	m_LayoutUnitsPerCell = LAYOUT_UNITS_PER_UNIT / GRID_BASE_CELLS_PER_UNIT;
 
-	// Each cell in the grid corresponds to 0.1 on the map
+	// Each cell in the grid corresponds to 0.1 on the map at the base resolution
 	// Initialise all base grid values to 0
 	for (int i = 0; i < DUNGEON_GRID_X; i ++)
 	{
@@ -56,9 +98,10 @@ DungeonClass::~DungeonClass()
 
 
 // Function:		Initialise function
-// What it does:	Initialises the dungeon - Initialises first dungeon piece and ceiling piece, the player mesh, and begins calling
+// What it does:	Initialises the dungeon - Initialises first dungeon piece, the player mesh, and begins calling
 //					PlaceNextPiece four times with four directions of doors so that the dungeon will spread from the entrance piece
-//					And will continue until the dungeon is fully created
+//					And will continue until the dungeon is fully created. Without a device only the layout is made, with no player
+//					mesh, geometry or caves
 // Takes in:		ID3D11Device pointer - Pointer to the DirectX device, ID3D11DeviceContext - Pointer to the DirectX device context
 // Returns:			True if dungeon has been initialised successfully, false if not
 
@@ -69,56 +112,213 @@ bool DungeonClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceC
 	m_DeviceContext = DeviceContext;
 	m_WindowHandle = hwnd;
 
-	// Seed the rand generator with the current time
-	srand(time(NULL));
+	// Seed the rand generator with the seed that was set, or with the current time if there isn't one
+	if (!m_SeedSet)
+	{
+		m_Seed = (unsigned int)time(NULL);
+	}
+	srand(m_Seed);
+
+	// Create the texture cache if the dungeon is going to be drawn, unless a shared cache has been set
+	if ((m_Device) && (!m_TextureCache))
+	{
+		m_TextureCache = new TextureCacheClass;
+		if (!m_TextureCache)
+		{
+			return false;
+		}
+
+		result = m_TextureCache->Initialise(m_Device);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Create the buffer pool the pieces and meshes are put in if the dungeon is going to be drawn
+	if (m_Device)
+	{
+		m_BufferPool = new BufferPoolClass;
+		if (!m_BufferPool)
+		{
+			return false;
+		}
+
+		result = m_BufferPool->Initialise(m_Device, m_DeviceContext);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Create the player mesh if the dungeon is going to be drawn
+	if (m_Device)
+	{
+		m_PlayerMesh = new MeshClass;
+		if (!m_PlayerMesh)
+		{
+			return false;
+		}
+
+		// Initialise the player mesh
+		result = m_PlayerMesh->Initialize(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, L"data/player_sprite.png", D3DXVECTOR3(0.0f, 0.0f, 0.0f), 2.0f, 2.0f, 1.0f);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Create the prefab library and load the prefab room templates, unless a shared library has been set
+	if (!m_PrefabLibrary)
+	{
+		m_PrefabLibrary = new PrefabLibraryClass;
+		if (!m_PrefabLibrary)
+		{
+			return false;
+		}
+
+		result = m_PrefabLibrary->Initialise(m_Device, m_TextureCache, PREFAB_FILE);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Pick the resolution of the grid, and use the part of the grid that covers the same area as the base resolution
+	m_CellsPerUnit = m_RequestedCellsPerUnit;
+	if (m_CellsPerUnit == GRID_CELLS_AUTO)
+	{
+		m_CellsPerUnit = FindCoarsestCellsPerUnit();
+	}
+	m_LayoutUnitsPerCell = LAYOUT_UNITS_PER_UNIT / m_CellsPerUnit;
+	m_GridSizeX = (DUNGEON_GRID_X * m_CellsPerUnit) / GRID_BASE_CELLS_PER_UNIT;
+	m_GridSizeY = (DUNGEON_GRID_Y * m_CellsPerUnit) / GRID_BASE_CELLS_PER_UNIT;
+	if (m_GridSizeX > DUNGEON_GRID_X)
+	{
+		m_GridSizeX = DUNGEON_GRID_X;
+	}
+	if (m_GridSizeY > DUNGEON_GRID_Y)
+	{
+		m_GridSizeY = DUNGEON_GRID_Y;
+	}
+	m_GridOffsetX = m_GridSizeX / 2;
+	m_GridOffsetZ = m_GridSizeY / 2;
+
+	// Create the index of the empty rectangles of the grid, which starts with the whole grid empty. Only best fit placement reads
+	// it, so it isn't kept up to date for random placement
+	if (m_Placement == PLACEMENT_BEST_FIT)
+	{
+		m_EmptyRects = new EmptyRectIndexClass;
+		if (!m_EmptyRects)
+		{
+			return false;
+		}
+
+		result = m_EmptyRects->Initialise(m_GridSizeX, m_GridSizeY);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Create the graph the rooms and doors are added to as they are placed
+	m_Graph = new DungeonGraphClass;
+	if (!m_Graph)
+	{
+		return false;
+	}
 
-	// Create the player mesh
-	m_PlayerMesh = new MeshClass;
-	if (!m_PlayerMesh)
+	// Create the occupancy pyramid used to check the grid, which also starts empty
+	m_Occupancy = new OccupancyPyramidClass;
+	if (!m_Occupancy)
 	{
 		return false;
 	}
 
-	// Initialise the player mesh
-	result = m_PlayerMesh->Initialize(m_Device, m_DeviceContext, L"data/player_sprite.png", D3DXVECTOR3(0.0f, 0.0f, 0.0f), 2.0f, 2.0f, 1.0f);
+	result = m_Occupancy->Initialise(m_GridSizeX, m_GridSizeY);
 	if (!result)
 	{
 		return false;
 	}
 
-	// Create the entrance piece (first piece of the dungeon)
-	m_EntrancePiece = new DungeonPieceClass(DungeonPieceClass::ENTRANCE, 0);
-	if (!m_EntrancePiece)
+	// Create the worker threads used to test placements
+	m_Workers = new WorkerPoolClass;
+	if (!m_Workers)
 	{
 		return false;
 	}
 
-	// Initialise the entrance piece
-	result = m_EntrancePiece->Initialise(m_Device, m_DeviceContext, D3DXVECTOR2(0.0f, 0.0f), 2.0f, 2.0f, 4);
+	result = m_Workers->Initialise(m_ThreadCount);
 	if (!result)
 	{
 		return false;
 	}
 
-	// Create the first ceiling piece of the dungeon
-	DungeonPieceClass *CeilingPiece = new DungeonPieceClass(DungeonPieceClass::CEILING, 0);
-	if (!CeilingPiece)
+	// Start timing the generation
+	m_GenerationStart = clock();
+	m_GenerationStopped = false;
+	m_GenerationOutOfTime = false;
+	m_PiecesPlaced = 0;
+	m_FrontierSize = 0;
+	m_MaxDepth = 0;
+	m_Progress = LayoutMetrics();
+	m_ProgressBranches = 0;
+	m_ProgressBranchingPieces = 0;
+
+	// If the wave collapse generator is being used, build the whole dungeon from its tile map
+	// If it couldn't find a map within its limits, carry on and place the pieces from the entrance instead
+	if (m_Generator == GENERATOR_WAVE_COLLAPSE)
+	{
+		if (PlaceWaveCollapsePieces())
+		{
+			m_Graph->Build();
+			return CloseLoops();
+		}
+		if (DungeonFailed)
+		{
+			return false;
+		}
+	}
+
+	// If the scatter generator is being used, build the whole dungeon from its layout
+	if (m_Generator == GENERATOR_SCATTER)
+	{
+		if (PlaceScatterPieces())
+		{
+			m_Graph->Build();
+			return CloseLoops();
+		}
+		if (DungeonFailed)
+		{
+			return false;
+		}
+	}
+
+	// Create the entrance piece (first piece of the dungeon)
+	m_EntrancePiece = new DungeonPieceClass(DungeonPieceClass::ENTRANCE, 0);
+	if (!m_EntrancePiece)
 	{
 		return false;
 	}
 
-	// Initialise the ceiling piece
-	result = CeilingPiece->Initialise(m_Device, m_DeviceContext, D3DXVECTOR2(0.0f, 0.0f), 2.0f, 2.0f, 4);
+	// Initialise the entrance piece, 2 units wide and high at the center of the dungeon
+	result = InitialiseLayoutPiece(m_EntrancePiece, 0, 0, 20, 20, 4);
 	if (!result)
 	{
 		return false;
 	}
 
 	// Fill the grid with the entrance piece at first
-	CheckGrid(2.0f, 2.0f, D3DXVECTOR2(0.0f, 0.0f));
-	// push_back entrance piece and ceiling piece as first dungeon pieces in their list
+	CheckGrid(20, 20, 0, 0);
+	// push_back entrance piece as the first dungeon piece in the list. Its ceiling is made from its floor by the static batch
 	m_DungeonPieces.push_back(m_EntrancePiece);
-	m_CeilingPieces.push_back(CeilingPiece);
+	m_Graph->AddNode(GRAPH_NODE_PIECE, m_EntrancePiece, m_EntrancePiece->m_Center);
+
+	// The entrance has been placed, and its four doors are waiting for pieces
+	m_PiecesPlaced = 1;
+	m_FrontierSize = 4;
+	CountProgressPiece(m_EntrancePiece, 0);
+	ReportProgress();
 
 	// Call PlaceNextPiece for each room available in the entrance using 0 as the first depth for each one
 	// This will then recursively call the same function for the room created, for the amount of times their are rooms available
@@ -147,236 +347,624 @@ bool DungeonClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceC
 		return false;
 	}
 
+	// Once all of the rooms have been placed, add cave regions behind some of the doors that were left unused
+	// If generation was stopped early, or only the layout is being made, the caves are left out as well
+	if ((!m_GenerationStopped) && (m_Device))
+	{
+		result = PlaceCaveRegions();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Sort the doors added while the dungeon was placed into the graph, and use it to join pieces that share a wall into loops
+	m_Graph->Build();
+	result = CloseLoops();
+	if (!result)
+	{
+		return false;
+	}
+
 	// Return true if everything is successful
 	return true;
 }
 
 
-// Function:		Place Next Piece function
-// What it does:	Loops through the number of attempts in order to find a suitable room leading off from the previous room, and initialises
-//					the room and calls PlaceNextPiece again for the available rooms leading from this new room.
-//					This is the main recursive function used for generating the dungeon as it calls itself based on what 
-//					rooms are available in the room it creates.
-// Takes in:		int - Depth value of the dungeon so that the dungeon can check how much it has generated,
-//					DungeonPieceClass - pointer to the current piece that is creating a new room off it
-//					int - DoorNumber value which uses defines of LEFT, RIGHT, UP, and DOWN to state the room side the next room is created from
+// Function:		Set Generation Budget function
+// What it does:	Sets the time the piece generator can take in Initialise before it stops placing pieces
+// Takes in:		int - Time in milliseconds (0 for no limit)
 // Returns:			Nothing
 
-bool DungeonClass::PlaceNextPiece(int Depth, DungeonPieceClass *Piece, int DoorNumber)
+void DungeonClass::SetGenerationBudget(int Milliseconds)
 {
-	// Loop through this function in the amount of piece attempts to try and place a new room
-	// If no rooms can be placed, skip this room
-	for (int i = 0; i < PIECE_ATTEMPTS; i++)
-	{
-		// Create a new dungeon piece and a ceiling piece
-		DungeonPieceClass* NewPiece;
-		DungeonPieceClass* NewCeilingPiece;
-		// Get the depth value for this call
-		m_DungeonDepth = Depth;
+	m_GenerationBudget = Milliseconds;
+}
 
-		// Set the chances of rooms based on the current depth
-		SetChances(Depth);
 
-		// Calculate the random next piece that will be placed at the door that is passed into this function
-		DungeonPieceClass::m_PieceType NewPieceType = CalculateNextPiece(Piece->GetPieceType(), DoorNumber);
-		
-		// Create the new dungeon piece
-		NewPiece = new DungeonPieceClass(NewPieceType, DoorNumber);
-		// Create the new ceiling piece
-		NewCeilingPiece = new DungeonPieceClass(DungeonPieceClass::CEILING, 0);
-		// Get the new randomised width and height depending on the type of room that has been chosen
-		m_WidthHeight = NewPiece->GetWidthAndHeight(NewPieceType);
-		// Get the new center of the room based on the direction this room is being created in, and the new width and height
-		m_NewCenter = GetNextCenter(DoorNumber, Piece, m_WidthHeight.x, m_WidthHeight.y);
+// Function:		Set Progress Callback function
+// What it does:	Sets the function called each time the piece generator places a piece
+// Takes in:		GenerationProgressCallback - the function (0 for none), void - pointer passed back to the function
+// Returns:			Nothing
 
-		// Check the grid to see if this dungeon piece can be placed, or if there is already a piece in that area
-		// If the function returns true, then create this piece. Otherwise, delete the objects and try again
-		if (CheckGrid(m_WidthHeight.x, m_WidthHeight.y, m_NewCenter))
-		{
-			// Initialise the new dungeon and ceiling pieces using the information already calculated for the room
-			NewPiece->Initialise(m_Device, m_DeviceContext, m_NewCenter, m_WidthHeight.x, m_WidthHeight.y, m_RoomsLimit);
-			m_DungeonPieces.push_back(NewPiece);
-			NewCeilingPiece->Initialise(m_Device, m_DeviceContext, m_NewCenter, m_WidthHeight.x, m_WidthHeight.y, 0);
-			m_CeilingPieces.push_back(NewCeilingPiece);
+void DungeonClass::SetProgressCallback(GenerationProgressCallback Callback, void* UserData)
+{
+	m_ProgressCallback = Callback;
+	m_ProgressUserData = UserData;
+}
 
-			// Update the room so that it knows which wall already has a door and which door direction is the previous room
-			// so that it doesn't try to create a new room in that place
-			UpdateRoom(NewPiece, DoorNumber);
-		
-			// Update the previous room so that it will draw a wall with a door between it and the new room
-			if (DoorNumber == LEFT)
-			{
-				Piece->m_LDoor = true;
-			}
-			if (DoorNumber == RIGHT)
-			{
-				Piece->m_RDoor = true;
-			}
-			if (DoorNumber == UP)
-			{
-				Piece->m_UDoor = true;
-			}
-			if (DoorNumber == DOWN)
-			{
-				Piece->m_DDoor = true;
-			}
 
-			// Create the new door sprite
-			DungeonPieceClass* NewDoor;
+// Function:		Cancel Generation function
+// What it does:	Asks the piece generator to stop placing pieces. Can be called from another thread while Initialise runs, and
+//					Initialise still finishes with a closed dungeon made from the pieces already placed. A cancel made before
+//					Initialise starts stops it straight away, and each cancel is used up when generation stops for it (or by Reset)
+// Takes in:		Nothing
+// Returns:			Nothing
 
-			// If the room is at the left or right of a room, set it to a vertical door and set the width and height
-			if ((DoorNumber == LEFT) || (DoorNumber == RIGHT))
-			{
-				m_WidthHeight = D3DXVECTOR2(0.55f, 1.1f);
-				m_DoorDirection = VERTICAL_DOOR;
-			}
-			// If the room is at the top or bottom of a room, set it to the horizontal door and set the width and height
-			else if ((DoorNumber == UP) || (DoorNumber == DOWN))
-			{
-				m_WidthHeight = D3DXVECTOR2(1.1f, 0.55f);
-				m_DoorDirection = HORIZONTAL_DOOR;
-			}
+void DungeonClass::CancelGeneration()
+{
+	m_CancelRequested = true;
+}
 
-			// Create the new door piece and get the new door position based on the direction this room is created in
-			NewDoor = new DungeonPieceClass(DungeonPieceClass::DOOR, m_DoorDirection);
-			m_DoorPosition = NewDoor->GetDoorPosition(DoorNumber, NewPiece); 
 
-			// Initialise the new door with the position and set width and height
-			NewDoor->Initialise(m_Device, m_DeviceContext, m_DoorPosition, m_WidthHeight.x, m_WidthHeight.y, 0);
+// Function:		Was Generation Stopped function
+// What it does:	Returns whether the last generation stopped early because it ran out of time or was cancelled
+// Takes in:		Nothing
+// Returns:			True if it stopped early, false if every door was tried
 
-			// Add this door to the list of doors to be rendered
-			m_DoorPieces.push_back(NewDoor);
+bool DungeonClass::WasGenerationStopped()
+{
+	return m_GenerationStopped;
+}
 
-			// If this piece isn't at the dungeon depth limit, create new rooms for each of the available doors in this room
-			if (Depth < DUNGEON_DEPTH)
-			{
-				// The depth passed in is the current depth of this call plus one, this is so that it will call these functions 
-				// recursively until the generation reaches its maximum depth
 
-				// Check if this room has a door available, and create the new room
-				if (NewPiece->m_LAvailable)
-				{
-					PlaceNextPiece(Depth + 1, NewPiece, LEFT);
-				}
-				if (NewPiece->m_RAvailable)
-				{
-					PlaceNextPiece(Depth + 1, NewPiece, RIGHT);
-				}
-				if (NewPiece->m_DAvailable)
-				{
-					PlaceNextPiece(Depth + 1, NewPiece, DOWN);
-				}
-				if (NewPiece->m_UAvailable)
-				{
-					PlaceNextPiece(Depth + 1, NewPiece, UP);
-				}
-			}
+// Function:		Was Generation Out Of Time function
+// What it does:	Returns whether the last generation stopped early because it used up its time budget, so the dungeon
+//					made may not be the same as another run of the same seed
+// Takes in:		Nothing
+// Returns:			True if it ran out of time, false if not
 
-			// Break out the for loop because a room has been successfully placed
-			break;
-		}
-		else
-		{
-			if (DungeonFailed)
-			{
-				return false;
-			}
-			else
-			{
-				// Delete the new dungeon piece created and delete the new ceiling piece
-				delete NewPiece;
-				NewPiece = 0;
-				delete NewCeilingPiece;
-				NewCeilingPiece = 0;
-				// It will then either try again if it is below the number of room attempts or it will leave this room
-			}
-		}
+bool DungeonClass::WasGenerationOutOfTime()
+{
+	return m_GenerationOutOfTime;
+}
+
+
+// Function:		Set Thread Count function
+// What it does:	Sets the number of threads used to test placements in Initialise. With no generation budget the dungeon
+//					made from a seed is the same on any number of threads. A budget stops generation after a length of time,
+//					which the number of threads changes, so the dungeon is only the same with a budget of 0
+// Takes in:		int - Number of threads (1 tests everything on the thread calling Initialise)
+// Returns:			Nothing
+
+void DungeonClass::SetThreadCount(int ThreadCount)
+{
+	m_ThreadCount = ThreadCount;
+}
+
+
+// Function:		Set Seed function
+// What it does:	Sets the seed Initialise gives to rand, so the same dungeon can be made again. If it isn't set, Initialise
+//					seeds rand with the current time
+// Takes in:		unsigned int - Seed
+// Returns:			Nothing
+
+void DungeonClass::SetSeed(unsigned int Seed)
+{
+	m_Seed = Seed;
+	m_SeedSet = true;
+}
+
+
+// Function:		Get Seed function
+// What it does:	Returns the seed used by the last call to Initialise
+// Takes in:		Nothing
+// Returns:			unsigned int - Seed
+
+unsigned int DungeonClass::GetSeed()
+{
+	return m_Seed;
+}
 
+
+// Function:		Set Cells Per Unit function
+// What it does:	Sets the resolution of the grid used from the next call to Initialise
+// Takes in:		int - Number of grid cells along one unit, or GRID_CELLS_AUTO to pick the coarsest exact resolution
+// Returns:			True if the resolution can be used, false if it doesn't divide LAYOUT_UNITS_PER_UNIT (it isn't changed)
+
+bool DungeonClass::SetCellsPerUnit(int CellsPerUnit)
+{
+	if ((CellsPerUnit < 0) || ((CellsPerUnit != GRID_CELLS_AUTO) && ((LAYOUT_UNITS_PER_UNIT % CellsPerUnit) != 0)))
+	{
+		return false;
 	}
 
+	m_RequestedCellsPerUnit = CellsPerUnit;
 	return true;
 }
 
 
-// Function:		Calculate Next Piece function
-// What it does:	Creates a new piece type and uses a random number between 1 and 100 to decide the next room to place. 
-//					The next room to place uses chances based on the previous type of room, so that the dungeon will be varied
-//					and original every time. Uses the direction of the room to decide on the new piece.
-// Takes in:		DungeonPieceClass::m_PieceType - ParentPiece which is the dungeon piece that is creating the new room, 
-//					int - value for the door number that the room is following from
-// Returns:			DungeonPieceClass::m_PieceType - Type of piece generated by dungeon so it can be used to initialise the new dungeon piece
+// Function:		Get Cells Per Unit function
+// What it does:	Returns the resolution of the grid used by the last call to Initialise
+// Takes in:		Nothing
+// Returns:			int - Number of grid cells along one unit
 
-DungeonPieceClass::m_PieceType DungeonClass::CalculateNextPiece(DungeonPieceClass::m_PieceType ParentPieceType, int DoorNo)
+int DungeonClass::GetCellsPerUnit()
 {
-	// Check all chances and return the type of room it is
+	return m_CellsPerUnit;
+}
 
-	// Create a new room piece type & for now set the new room type to the INIT value
-	DungeonPieceClass::m_PieceType New_Room;
-	New_Room = DungeonPieceClass::INIT;
-	int RoomNumber = DoorNo;
 
-	// Get the chance value using rand between 1 and 100
-	// This is the value used in the following checks that decides what the next room should be
-	m_RoomChance = 0;
-	m_RoomChance = rand() % (100 - 1) + 1;
+// Function:		Set Loop Budget function
+// What it does:	Sets the most doors the loop closing pass adds at the end of Initialise
+// Takes in:		int - Number of doors (0 leaves the layout as the generator made it)
+// Returns:			Nothing
 
-	// If the parent room is a Horizontal Corridor 
-	if (ParentPieceType == DungeonPieceClass::HORIZONTAL_CORRIDOR)
+void DungeonClass::SetLoopBudget(int Doors)
+{
+	m_LoopBudget = Doors;
+}
+
+
+// Function:		Set Shared Prefab Library function
+// What it does:	Uses a prefab library that has already been loaded instead of loading one in Initialise. The library belongs
+//					to the caller and isn't released by Shutdown, so it can be shared by many dungeons
+// Takes in:		PrefabLibraryClass - pointer to the library
+// Returns:			Nothing
+
+void DungeonClass::SetSharedPrefabLibrary(PrefabLibraryClass* Library)
+{
+	m_PrefabLibrary = Library;
+	m_SharedPrefabLibrary = true;
+}
+
+
+// Function:		Set Shared Texture Cache function
+// What it does:	Loads the dungeon's textures through a cache that has already been made instead of making one in Initialise.
+//					The cache belongs to the caller and isn't released by Shutdown, so the textures stay loaded between dungeons
+// Takes in:		TextureCacheClass - pointer to the cache
+// Returns:			Nothing
+
+void DungeonClass::SetSharedTextureCache(TextureCacheClass* TextureCache)
+{
+	m_TextureCache = TextureCache;
+	m_SharedTextureCache = true;
+}
+
+
+// Function:		Get Layout Metrics function
+// What it does:	Measures the layout placed so far from the doors of each piece and the prefab rooms. Can be called from the
+//					progress callback while the pieces are placed
+// Takes in:		LayoutMetrics - reference to the metrics to fill in
+// Returns:			Nothing
+
+void DungeonClass::GetLayoutMetrics(LayoutMetrics &Metrics)
+{
+	int Branches = 0;
+	int BranchingPieces = 0;
+
+	Metrics.Pieces = 0;
+	Metrics.Rooms = 0;
+	Metrics.Corridors = 0;
+	Metrics.Prefabs = 0;
+	Metrics.Depth = m_MaxDepth;
+	Metrics.DeadEnds = 0;
+	Metrics.SmallDeadEnds = 0;
+	Metrics.MinX = 0.0f;
+	Metrics.MinY = 0.0f;
+	Metrics.MaxX = 0.0f;
+	Metrics.MaxY = 0.0f;
+	Metrics.BranchingFactor = 0.0f;
+	Metrics.Frontier = m_FrontierSize;
+
+	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
 	{
-		// Use Corridor chance after corridor. This is usually a low number that gets lower as the depth of the dungeon increases
-		// to make it less likely that a corridor is chosen after a corridor, because it makes more sense to have a room after it 
-		// however there might still be times when corridors follow corridors
-		if (m_RoomChance <= 0 + m_CorridorChanceAftCorridor)
+		DungeonPieceClass* Piece = *thisObject;
+		DungeonPieceClass::m_PieceType Type = Piece->GetPieceType();
+
+		if ((Type == DungeonPieceClass::HORIZONTAL_CORRIDOR) || (Type == DungeonPieceClass::VERTICAL_CORRIDOR))
 		{
-			New_Room = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+			Metrics.Corridors++;
 		}
-		// Use room chance after corridor. This is usually a high number that gets higher as the depth of the dungeon increases
-		// to make it more likely that a room is chosen after a corridor because it makes more sense to have a room after a corridor
-		if (m_RoomChance > 100 - m_RoomChanceAftCorridor)
+		else
 		{
-			New_Room = DungeonPieceClass::ROOM;
+			Metrics.Rooms++;
 		}
-	}
 
-	// If the parent of the room is a normal type room/entrace and the door is at the right or left side of the room
-	if ((ParentPieceType == DungeonPieceClass::ENTRANCE) || (ParentPieceType == DungeonPieceClass::ROOM))
-	{
-		if ((RoomNumber == RIGHT) || (RoomNumber == LEFT))
+		// Every door of a piece leads to another piece, and every piece but the entrance was reached through one of its doors
+		int Doors = (int)Piece->m_LDoor + (int)Piece->m_RDoor + (int)Piece->m_UDoor + (int)Piece->m_DDoor;
+		int Children = Doors;
+		if (Type != DungeonPieceClass::ENTRANCE)
 		{
-			// Use room chance after room for this check. This is usually a number a little less than 50% of 100 so that it is slightly less likely for a room
-			// to follow a room, and a little more likely that a corridor will follow
-			if (m_RoomChance <= 0 + m_RoomChanceAftRoom)
+			Children--;
+			if (Doors == 1)
 			{
-				New_Room = DungeonPieceClass::ROOM;
-			}
-			// Use corridor chance after room for this check. This is usually a number a little over than 50% of 100 so that it is slightly more likely that a 
-			// corridor will follow after a room.
-			if (m_RoomChance > 100 - m_CorridorChanceAftRoom)
-			{
-				New_Room = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+				Metrics.DeadEnds++;
+				if ((Piece->m_HalfWidth * Piece->m_HalfHeight * 4.0f) <= METRICS_SMALL_AREA)
+				{
+					Metrics.SmallDeadEnds++;
+				}
 			}
 		}
-	}
-
-	// If the parent of the room is a normal type room/entrace and the door is at the top or bottom side of the room
-	if ((ParentPieceType == DungeonPieceClass::ENTRANCE) || (ParentPieceType == DungeonPieceClass::ROOM))
-	{
-		if ((RoomNumber == UP) || (RoomNumber == DOWN))
-		if (m_RoomChance <= m_CorridorChanceAftRoom)
+		if (Children > 0)
 		{
-			New_Room = DungeonPieceClass::VERTICAL_CORRIDOR;
+			Branches += Children;
+			BranchingPieces++;
 		}
-		if (m_RoomChance > 100 - m_RoomChanceAftRoom)
+
+		// Grow the bounding box to hold the piece
+		float Left = Piece->m_Center.x - Piece->m_HalfWidth;
+		float Right = Piece->m_Center.x + Piece->m_HalfWidth;
+		float Bottom = Piece->m_Center.y - Piece->m_HalfHeight;
+		float Top = Piece->m_Center.y + Piece->m_HalfHeight;
+		if (Metrics.Pieces == 0)
 		{
-			New_Room = DungeonPieceClass::ROOM;
+			Metrics.MinX = Left;
+			Metrics.MaxX = Right;
+			Metrics.MinY = Bottom;
+			Metrics.MaxY = Top;
 		}
+		Metrics.MinX = (Left < Metrics.MinX) ? Left : Metrics.MinX;
+		Metrics.MaxX = (Right > Metrics.MaxX) ? Right : Metrics.MaxX;
+		Metrics.MinY = (Bottom < Metrics.MinY) ? Bottom : Metrics.MinY;
+		Metrics.MaxY = (Top > Metrics.MaxY) ? Top : Metrics.MaxY;
+		Metrics.Pieces++;
 	}
 
-	// Vertical Corridors
-	if (ParentPieceType == DungeonPieceClass::VERTICAL_CORRIDOR)
+	// Prefab rooms are rooms with only the door they were placed from
+	for (auto thisObject = m_PrefabInstances.begin(); thisObject != m_PrefabInstances.end(); ++thisObject)
 	{
-		if (m_RoomChance <= m_CorridorChanceAftCorridor)
-		{
+		PrefabLibraryClass::Template* Prefab = m_PrefabLibrary->GetTemplate(thisObject->Template);
+		float Left = thisObject->Origin.x;
+		float Right = thisObject->Origin.x + (Prefab->Width * PREFAB_CELL_SIZE);
+		float Bottom = thisObject->Origin.y;
+		float Top = thisObject->Origin.y + (Prefab->Height * PREFAB_CELL_SIZE);
+
+		Metrics.Rooms++;
+		Metrics.Prefabs++;
+		Metrics.DeadEnds++;
+		Metrics.MinX = (Left < Metrics.MinX) ? Left : Metrics.MinX;
+		Metrics.MaxX = (Right > Metrics.MaxX) ? Right : Metrics.MaxX;
+		Metrics.MinY = (Bottom < Metrics.MinY) ? Bottom : Metrics.MinY;
+		Metrics.MaxY = (Top > Metrics.MaxY) ? Top : Metrics.MaxY;
+		Metrics.Pieces++;
+	}
+
+	if (BranchingPieces > 0)
+	{
+		Metrics.BranchingFactor = (float)Branches / (float)BranchingPieces;
+	}
+}
+
+
+// Function:		Get Progress Metrics function
+// What it does:	Gives the metrics of the layout placed so far without walking the pieces, as they are counted by the piece
+//					generator as each piece is placed. This is what the progress callback should use, as it is called for every
+//					piece. While the piece generator runs these are the same as GetLayoutMetrics, which should be used once the
+//					layout is finished (the other generators and the doors closing loops only show up there)
+// Takes in:		LayoutMetrics - reference to the metrics to fill in
+// Returns:			Nothing
+
+void DungeonClass::GetProgressMetrics(LayoutMetrics &Metrics)
+{
+	Metrics = m_Progress;
+	Metrics.Depth = m_MaxDepth;
+	Metrics.Frontier = m_FrontierSize;
+	Metrics.BranchingFactor = 0.0f;
+	if (m_ProgressBranchingPieces > 0)
+	{
+		Metrics.BranchingFactor = (float)m_ProgressBranches / (float)m_ProgressBranchingPieces;
+	}
+}
+
+
+// Function:		Place Next Piece function
+// What it does:	Loops through the number of attempts in order to find a suitable room leading off from the previous room, and initialises
+//					the room and calls PlaceNextPiece again for the available rooms leading from this new room.
+//					This is the main recursive function used for generating the dungeon as it calls itself based on what 
+//					rooms are available in the room it creates. The attempts are drawn and tested against the grid in batches.
+// Takes in:		int - Depth value of the dungeon so that the dungeon can check how much it has generated,
+//					DungeonPieceClass - pointer to the current piece that is creating a new room off it
+//					int - DoorNumber value which uses defines of LEFT, RIGHT, UP, and DOWN to state the room side the next room is created from
+// Returns:			Nothing
+
+bool DungeonClass::PlaceNextPiece(int Depth, DungeonPieceClass *Piece, int DoorNumber)
+{
+	// The batch of candidates being tested for this door
+	CandidateBatch Candidates;
+	int Attempts = 0;
+
+	// Get the depth value for this call
+	m_DungeonDepth = Depth;
+
+	// This door is no longer waiting for a piece
+	m_FrontierSize--;
+
+	// If generation has been cancelled or has run out of time, leave the door without a piece. No door is added to the parent room,
+	// so it is walled off in the same way as a door where no piece fits
+	if (ShouldStopGeneration())
+	{
+		return true;
+	}
+
+	// Loop through this function in the amount of piece attempts to try and place a new room
+	// The attempts are drawn in batches and each batch is tested against the grid in one go. The first candidate in the batch that fits
+	// is placed, so the dungeon made from a seed doesn't depend on how the batch is tested
+	// If no rooms can be placed, skip this room
+	while (Attempts < PIECE_ATTEMPTS)
+	{
+		// Create a new dungeon piece
+		DungeonPieceClass* NewPiece;
+		bool TryPrefab = false;
+
+		// Draw the candidates for this batch
+		Candidates.Count = 0;
+		while ((Candidates.Count < PIECE_BATCH_SIZE) && (Attempts < PIECE_ATTEMPTS))
+		{
+			Attempts++;
+
+			// Set the chances of rooms based on the current depth
+			SetChances(Depth);
+
+			// Calculate the random next piece that will be placed at the door that is passed into this function
+			DungeonPieceClass::m_PieceType NewPieceType = CalculateNextPiece(Piece->GetPieceType(), DoorNumber);
+
+			// Sometimes try a prefab room instead of a room. It is tried after the candidates drawn before it, and the batch stops here
+			if ((NewPieceType == DungeonPieceClass::ROOM) && ((rand() % 100) < PREFAB_CHANCE))
+			{
+				TryPrefab = true;
+				break;
+			}
+
+			// Get the new randomised width and height in tenths depending on the type of room that has been chosen. The piece is only
+			// used for its size limits, so it is made on the stack and the real piece is only created for the candidate that is placed
+			int Width, Height;
+			DungeonPieceClass SizePiece(NewPieceType, DoorNumber);
+			SizePiece.GetLayoutSize(Width, Height);
+
+			// When placing by best fit, change the size to the closest size that fits behind the door. If no size of this type fits,
+			// the attempt is used up without testing the grid
+			if (m_Placement == PLACEMENT_BEST_FIT)
+			{
+				if (!FindBestFit(Piece, DoorNumber, NewPieceType, Width, Height, Width, Height))
+				{
+					continue;
+				}
+			}
+
+			// Get the new center of the room based on the direction this room is being created in, and the new width and height
+			int Center_x, Center_y;
+			GetNextCenter(DoorNumber, Piece, Width, Height, Center_x, Center_y);
+
+			// Add the candidate to the batch
+			Candidates.Types[Candidates.Count] = NewPieceType;
+			Candidates.Widths[Candidates.Count] = Width;
+			Candidates.Heights[Candidates.Count] = Height;
+			Candidates.CentersX[Candidates.Count] = Center_x;
+			Candidates.CentersY[Candidates.Count] = Center_y;
+			Candidates.Count++;
+
+			// A best fit candidate is already known to fit, so there is no need to draw any more
+			if (m_Placement == PLACEMENT_BEST_FIT)
+			{
+				break;
+			}
+		}
+
+		// Check the grid to see which of the candidates can be placed, or if there is already a piece in the way of all of them
+		// If one fits, create this piece. Otherwise, try the prefab room if there is one and then draw a new batch
+		int Placed = CheckGridBatch(Candidates);
+		if (DungeonFailed)
+		{
+			return false;
+		}
+
+		if (Placed < 0)
+		{
+			if (TryPrefab && PlacePrefab(Piece, DoorNumber))
+			{
+				m_PiecesPlaced++;
+				if (Depth + 1 > m_MaxDepth)
+				{
+					m_MaxDepth = Depth + 1;
+				}
+				CountProgressPrefab(Piece);
+				ReportProgress();
+				break;
+			}
+			// It will then either try again if it is below the number of room attempts or it will leave this room
+			continue;
+		}
+
+		// Get the type of the candidate that was placed
+		DungeonPieceClass::m_PieceType NewPieceType = Candidates.Types[Placed];
+
+		// Create the new dungeon piece
+		NewPiece = new DungeonPieceClass(NewPieceType, DoorNumber);
+		NewPiece->m_Depth = Depth + 1;
+
+		// Initialise the new dungeon piece using the layout already calculated for the room. Its ceiling is made from its floor
+		// by the static batch, so it doesn't need a piece of its own
+		InitialiseLayoutPiece(NewPiece, Candidates.CentersX[Placed], Candidates.CentersY[Placed], Candidates.Widths[Placed], Candidates.Heights[Placed], m_RoomsLimit);
+		m_DungeonPieces.push_back(NewPiece);
+
+		// Update the room so that it knows which wall already has a door and which door direction is the previous room
+		// so that it doesn't try to create a new room in that place
+		UpdateRoom(NewPiece, DoorNumber);
+	
+		// Update the previous room so that it will draw a wall with a door between it and the new room
+		if (DoorNumber == LEFT)
+		{
+			Piece->m_LDoor = true;
+		}
+		if (DoorNumber == RIGHT)
+		{
+			Piece->m_RDoor = true;
+		}
+		if (DoorNumber == UP)
+		{
+			Piece->m_UDoor = true;
+		}
+		if (DoorNumber == DOWN)
+		{
+			Piece->m_DDoor = true;
+		}
+
+		// Create the new door sprite
+		DungeonPieceClass* NewDoor;
+
+		// If the room is at the left or right of a room, set it to a vertical door and set the width and height
+		if ((DoorNumber == LEFT) || (DoorNumber == RIGHT))
+		{
+			m_WidthHeight = D3DXVECTOR2(0.55f, 1.1f);
+			m_DoorDirection = VERTICAL_DOOR;
+		}
+		// If the room is at the top or bottom of a room, set it to the horizontal door and set the width and height
+		else if ((DoorNumber == UP) || (DoorNumber == DOWN))
+		{
+			m_WidthHeight = D3DXVECTOR2(1.1f, 0.55f);
+			m_DoorDirection = HORIZONTAL_DOOR;
+		}
+
+		// Create the new door piece and get the new door position based on the direction this room is created in
+		NewDoor = new DungeonPieceClass(DungeonPieceClass::DOOR, m_DoorDirection);
+		m_DoorPosition = NewDoor->GetDoorPosition(DoorNumber, NewPiece); 
+
+		// Initialise the new door with the position and set width and height
+		NewDoor->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, m_DoorPosition, m_WidthHeight.x, m_WidthHeight.y, 0);
+
+		// Add this door to the list of doors to be rendered
+		m_DoorPieces.push_back(NewDoor);
+
+		// Add the new piece to the graph, joined to this piece by the door
+		m_Graph->AddNode(GRAPH_NODE_PIECE, NewPiece, NewPiece->m_Center);
+		m_Graph->AddConnection(Piece->m_GraphNode, NewPiece->m_GraphNode, DoorNumber, NewDoor);
+
+		// Count the new piece, and the doors it will try to place pieces behind
+		m_PiecesPlaced++;
+		if (Depth + 1 > m_MaxDepth)
+		{
+			m_MaxDepth = Depth + 1;
+		}
+		if (Depth < DUNGEON_DEPTH)
+		{
+			m_FrontierSize += (int)NewPiece->m_LAvailable + (int)NewPiece->m_RAvailable + (int)NewPiece->m_UAvailable + (int)NewPiece->m_DAvailable;
+		}
+		CountProgressPiece(NewPiece, Piece);
+		ReportProgress();
+
+		// If this piece isn't at the dungeon depth limit, create new rooms for each of the available doors in this room
+		if (Depth < DUNGEON_DEPTH)
+		{
+			// The depth passed in is the current depth of this call plus one, this is so that it will call these functions 
+			// recursively until the generation reaches its maximum depth
+
+			// Check if this room has a door available, and create the new room
+			if (NewPiece->m_LAvailable)
+			{
+				PlaceNextPiece(Depth + 1, NewPiece, LEFT);
+			}
+			if (NewPiece->m_RAvailable)
+			{
+				PlaceNextPiece(Depth + 1, NewPiece, RIGHT);
+			}
+			if (NewPiece->m_DAvailable)
+			{
+				PlaceNextPiece(Depth + 1, NewPiece, DOWN);
+			}
+			if (NewPiece->m_UAvailable)
+			{
+				PlaceNextPiece(Depth + 1, NewPiece, UP);
+			}
+		}
+
+		// Break out the loop because a room has been successfully placed
+		break;
+	}
+
+	return true;
+}
+
+
+// Function:		Calculate Next Piece function
+// What it does:	Creates a new piece type and uses a random number between 1 and 100 to decide the next room to place. 
+//					The next room to place uses chances based on the previous type of room, so that the dungeon will be varied
+//					and original every time. Uses the direction of the room to decide on the new piece.
+// Takes in:		DungeonPieceClass::m_PieceType - ParentPiece which is the dungeon piece that is creating the new room, 
+//					int - value for the door number that the room is following from
+// Returns:			DungeonPieceClass::m_PieceType - Type of piece generated by dungeon so it can be used to initialise the new dungeon piece
+
+DungeonPieceClass::m_PieceType DungeonClass::CalculateNextPiece(DungeonPieceClass::m_PieceType ParentPieceType, int DoorNo)
+{
+	// Check all chances and return the type of room it is
+
+	// Create a new room piece type & for now set the new room type to the INIT value
+	DungeonPieceClass::m_PieceType New_Room;
+	New_Room = DungeonPieceClass::INIT;
+	int RoomNumber = DoorNo;
+
+	// Get the chance value using rand between 1 and 100
+	// This is the value used in the following checks that decides what the next room should be
+	m_RoomChance = 0;
+	m_RoomChance = rand() % (100 - 1) + 1;
+
+	// If the parent room is a Horizontal Corridor 
+	if (ParentPieceType == DungeonPieceClass::HORIZONTAL_CORRIDOR)
+	{
+		// Use Corridor chance after corridor. This is usually a low number that gets lower as the depth of the dungeon increases
+		// to make it less likely that a corridor is chosen after a corridor, because it makes more sense to have a room after it 
+		// however there might still be times when corridors follow corridors
+		if (m_RoomChance <= 0 + m_CorridorChanceAftCorridor)
+		{
+			New_Room = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+		}
+		// Use room chance after corridor. This is usually a high number that gets higher as the depth of the dungeon increases
+		// to make it more likely that a room is chosen after a corridor because it makes more sense to have a room after a corridor
+		if (m_RoomChance > 100 - m_RoomChanceAftCorridor)
+		{
+			New_Room = DungeonPieceClass::ROOM;
+		}
+	}
+
+	// If the parent of the room is a normal type room/entrace and the door is at the right or left side of the room
+	if ((ParentPieceType == DungeonPieceClass::ENTRANCE) || (ParentPieceType == DungeonPieceClass::ROOM))
+	{
+		if ((RoomNumber == RIGHT) || (RoomNumber == LEFT))
+		{
+			// Use room chance after room for this check. This is usually a number a little less than 50% of 100 so that it is slightly less likely for a room
+			// to follow a room, and a little more likely that a corridor will follow
+			if (m_RoomChance <= 0 + m_RoomChanceAftRoom)
+			{
+				New_Room = DungeonPieceClass::ROOM;
+			}
+			// Use corridor chance after room for this check. This is usually a number a little over than 50% of 100 so that it is slightly more likely that a 
+			// corridor will follow after a room.
+			if (m_RoomChance > 100 - m_CorridorChanceAftRoom)
+			{
+				New_Room = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+			}
+		}
+	}
+
+	// If the parent of the room is a normal type room/entrace and the door is at the top or bottom side of the room
+	if ((ParentPieceType == DungeonPieceClass::ENTRANCE) || (ParentPieceType == DungeonPieceClass::ROOM))
+	{
+		if ((RoomNumber == UP) || (RoomNumber == DOWN))
+		if (m_RoomChance <= m_CorridorChanceAftRoom)
+		{
+			New_Room = DungeonPieceClass::VERTICAL_CORRIDOR;
+		}
+		if (m_RoomChance > 100 - m_RoomChanceAftRoom)
+		{
+			New_Room = DungeonPieceClass::ROOM;
+		}
+	}
+
+	// Vertical Corridors
+	if (ParentPieceType == DungeonPieceClass::VERTICAL_CORRIDOR)
+	{
+		if (m_RoomChance <= m_CorridorChanceAftCorridor)
+		{
 			New_Room = DungeonPieceClass::VERTICAL_CORRIDOR;
 		}
 		if (m_RoomChance > 100 - m_RoomChanceAftCorridor)
@@ -392,47 +980,40 @@ DungeonPieceClass::m_PieceType DungeonClass::CalculateNextPiece(DungeonPieceClas
 
 // Function:		Get Next Center function
 // What it does:	Uses the direction the room is created in and the width/height of the new piece
-//					to find the center of the room leading off of the previous one
+//					to find the center of the room leading off of the previous one, in layout units
 // Takes in:		int - Direction of the room it is being created in, DungeonPieceClass - pointer to the piece that is being placed
-//					float - width value of the piece being created, float - height value of the piece being created
-// Returns:			D3DXVECTOR2 - The new center of the next dungeon piece so that it can be placed next to the previous piece in the correct position
+//					int - width of the piece being created in tenths, int - height of the piece being created in tenths,
+//					int - references to the new center
+// Returns:			Nothing
 
-D3DXVECTOR2 DungeonClass::GetNextCenter(int Direction, DungeonPieceClass* ThisPiece, float Width, float Height)
+void DungeonClass::GetNextCenter(int Direction, DungeonPieceClass* ThisPiece, int Width, int Height, int &Center_x, int &Center_y)
 {
-	// Half Width and height of This Piece
-	float Half_Height = ThisPiece->m_HalfHeight;
-	float Half_Width = ThisPiece->m_HalfWidth;
-	D3DXVECTOR2 Center = ThisPiece->m_Center;
+	// The distance between the centers is half the width (or height) of this piece plus half of the new one. Sizes are whole tenths,
+	// so this is always a whole number of layout units
+	int Distance_x = ((ThisPiece->m_LayoutWidth + Width) * LAYOUT_UNITS_PER_TENTH) / 2;
+	int Distance_y = ((ThisPiece->m_LayoutHeight + Height) * LAYOUT_UNITS_PER_TENTH) / 2;
 
-	// Half Width and Height of second piece
-	float New_Half_Height = (Height / 2.0);
-	float New_Half_Width = (Width / 2.0);
-	D3DXVECTOR2 NewCenter = D3DXVECTOR2(0.0f, 0.0f);
+	// Start from the center of this piece, keeping the x value for rooms above or below and the y value for rooms to the sides
+	Center_x = ThisPiece->m_LayoutX;
+	Center_y = ThisPiece->m_LayoutY;
 
-	// Check the direction that this room will be placed in after the last room, and get the new center position
+	// Check the direction that this room will be placed in after the last room, and move the center to the new position
 	if (Direction == LEFT)
 	{
-		// Takes away the new half width from the left side of the parent dungeon piece, with same y value to get new center
-		NewCenter = D3DXVECTOR2(Center.x - Half_Width - New_Half_Width, Center.y); 
+		Center_x -= Distance_x;
 	}
 	if (Direction == RIGHT)
 	{
-		// Adds new half width to the right side of the parent dungeon piece, with same y value to get new center
-		NewCenter = D3DXVECTOR2(Center.x + Half_Width + New_Half_Width, Center.y); 
+		Center_x += Distance_x;
 	}
 	if (Direction == UP)
 	{
-		// Keeps same x value, but adds new half height to the top side of the parent dungeon piece to get new center
-		NewCenter = D3DXVECTOR2(Center.x, Center.y + Half_Height + New_Half_Height); 
+		Center_y += Distance_y;
 	}
 	if (Direction == DOWN)
 	{
-		// Keeps same x value, but takes away new half height from the bottom of the parent dungeon piece to get new center
-		NewCenter = D3DXVECTOR2(Center.x, Center.y - Half_Height - New_Half_Height); 
+		Center_y -= Distance_y;
 	}
-
-	// Return this new center so the piece can be placed
-	return NewCenter;
 }
 
 
@@ -453,238 +1034,2122 @@ void DungeonClass::UpdateRoom(DungeonPieceClass* NewPiece, int Direction)
 		NewPiece->m_RDoor = true;
 	}
 
-	// If the room has been made to the left of the parent piece
-	if (Direction == RIGHT)
+	// If the room has been made to the left of the parent piece
+	if (Direction == RIGHT)
+	{
+		// The left door of this room isn't available to create a new room because this is the parent room
+		NewPiece->m_LAvailable = false;
+		// There is a left door in this room so update so room knows to build a wall with a door here
+		NewPiece->m_LDoor = true;
+	}
+
+	// If the room has been made to the left of the parent piece
+	if (Direction == UP)
+	{
+		// The bottom door of this room isn't available to create a new room because this is the parent room
+		NewPiece->m_DAvailable = false;
+		// There is a bottom door in this room so update so the room knows to build a wall with a door here
+		NewPiece->m_DDoor = true;
+	}
+
+	// If the room has been made to the left of the parent piece
+	if (Direction == DOWN)
+	{
+		// The top door of this room isn't available to create a new room because this is the parent room
+		NewPiece->m_UAvailable = false;
+		// There is a top door in this room so update so the room knows to build a wall with a door here
+		NewPiece->m_UDoor = true;
+	}
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases all objects when the application ends and deletes them, cleans resources
+// Takes in:		Nothing
+// Returns:			Nothing
+void DungeonClass::Shutdown()
+{
+	// Release dungeon pieces by iterating through the list and deleting each
+	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
+	{
+		DungeonPieceClass* Piece = *thisObject;
+		Piece->Shutdown();
+		delete Piece;
+	}
+
+	if (!m_DungeonPieces.empty())
+	{
+		m_DungeonPieces.clear();
+	}
+
+	// Release door pieces by iterating through the list and deleting each
+	for (auto thisObject = m_DoorPieces.begin(); thisObject != m_DoorPieces.end(); ++thisObject)
+	{
+		DungeonPieceClass* DoorPiece = *thisObject;
+		DoorPiece->Shutdown();
+		delete DoorPiece;
+	}
+
+	if (!m_DoorPieces.empty())
+	{
+		m_DoorPieces.clear();
+	}
+
+	// Clear the wall segments of the pieces
+	m_WallSegments.clear();
+
+	// Release the cave meshes by iterating through each list and deleting each
+	list<MeshClass*>* CaveLists[3] = { &m_CaveFloors, &m_CaveCeilings, &m_CaveWalls };
+	for (int i = 0; i < 3; i++)
+	{
+		for (auto thisObject = CaveLists[i]->begin(); thisObject != CaveLists[i]->end(); ++thisObject)
+		{
+			MeshClass* CaveMesh = *thisObject;
+			CaveMesh->Shutdown();
+			delete CaveMesh;
+		}
+
+		CaveLists[i]->clear();
+	}
+
+	// Release the prefab library and the prefab rooms that use it. A shared library belongs to whoever set it
+	m_PrefabInstances.clear();
+	if ((m_PrefabLibrary) && (!m_SharedPrefabLibrary))
+	{
+		m_PrefabLibrary->Shutdown();
+		delete m_PrefabLibrary;
+		m_PrefabLibrary = 0;
+	}
+
+	// Release the empty rectangle index
+	if (m_EmptyRects)
+	{
+		m_EmptyRects->Shutdown();
+		delete m_EmptyRects;
+		m_EmptyRects = 0;
+	}
+
+	// Release the occupancy pyramid
+	if (m_Occupancy)
+	{
+		m_Occupancy->Shutdown();
+		delete m_Occupancy;
+		m_Occupancy = 0;
+	}
+
+	// Release the graph, and any layout doors left by a generator that failed
+	m_LayoutDoors.clear();
+	if (m_Graph)
+	{
+		m_Graph->Shutdown();
+		delete m_Graph;
+		m_Graph = 0;
+	}
+
+	// Stop the worker threads
+	if (m_Workers)
+	{
+		m_Workers->Shutdown();
+		delete m_Workers;
+		m_Workers = 0;
+	}
+
+	// Release player mesh object
+	if (m_PlayerMesh)
+	{
+		m_PlayerMesh->Shutdown();
+		delete m_PlayerMesh;
+		m_PlayerMesh = 0;
+	}
+
+	// Release the buffer pool once every piece and mesh has given its vertices back
+	if (m_BufferPool)
+	{
+		m_BufferPool->Shutdown();
+		delete m_BufferPool;
+		m_BufferPool = 0;
+	}
+
+	// Release the texture cache once everything using it has given its textures back. A shared cache belongs to whoever set it
+	if ((m_TextureCache) && (!m_SharedTextureCache))
+	{
+		m_TextureCache->Shutdown();
+		delete m_TextureCache;
+		m_TextureCache = 0;
+	}
+}
+
+
+// Function:		Reset function
+// What it does:	Releases the dungeon and clears the part of the grid it used, so the dungeon can be initialised again (with
+//					another seed) without clearing the whole grid. The seed, settings and shared prefab library are kept
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonClass::Reset()
+{
+	Shutdown();
+
+	// Only the area that was filled in needs clearing, as walls only ever set cells back to collision
+	for (int i = m_UsedStartX; i <= m_UsedEndX; i++)
+	{
+		for (int j = m_UsedStartY; j <= m_UsedEndY; j++)
+		{
+			DungeonGrid[i][j] = COLLISION;
+		}
+	}
+	m_UsedStartX = DUNGEON_GRID_X;
+	m_UsedStartY = DUNGEON_GRID_Y;
+	m_UsedEndX = -1;
+	m_UsedEndY = -1;
+
+	m_EntrancePiece = 0;
+	m_CaveCount = 0;
+	m_CancelRequested = false;
+	DungeonFailed = false;
+}
+
+
+// Function:		Check Grid function
+// What it does:	It uses the new center, width and height of the new piece and checks to see if there is room available for it on the dungeon grid
+//					The value on the grid if not available will be 1, and value will be 0 if available
+//					If it doesn't return false, will fill in the grid for the new room 
+// Takes in:		int - Width and height of new piece in tenths, int - Center of new piece in layout units
+// Returns:			True if the dungeon piece using this width, height and center can be placed in the dungeon grid, false if not
+
+bool DungeonClass::CheckGrid(int Width, int Height, int Center_x, int Center_y)
+{
+	// Get the grid values needed to check if this room can be placed in the dungeon grid
+	int Start_x, Start_y, End_x, End_y;
+	GetGridArea(Width, Height, Center_x, Center_y, Start_x, Start_y, End_x, End_y);
+
+	// If the piece goes outside of the dungeon grid return false straight away
+	if ((!InBounds(Start_x, Start_y)) || (!InBounds(End_x, End_y)))
+	{
+		// Dungeon grid too small for the dungeon to generate therefore need to exit program
+		DungeonFailed = true;
+		return false;
+	}
+
+	// Check from the start x and y values of the room's dimensions to the end x and y values. If anything is there the room can't
+	// be placed, therefore return false. The occupancy pyramid answers this from a few large cells, only checking single positions
+	// along the edges of the room
+	if (!m_Occupancy->IsEmpty(Start_x + 1, Start_y + 1, End_x - 2, End_y - 2))
+	{
+		return false;
+	}
+
+	// If not, fill in data using these values so grid knows a new piece is there
+	FillGridArea(Start_x, Start_y, End_x, End_y);
+	
+	// Return that the piece has been placed successfully
+	return true;
+}
+
+
+// Function:		Check Grid Batch function
+// What it does:	Does the same test as CheckGrid for the candidates in a batch in the order they were drawn, and fills in the grid
+//					for the first candidate that fits
+// Takes in:		CandidateBatch - reference to the candidates
+// Returns:			int - Index of the candidate placed, or -1 if none fit (DungeonFailed is set if a candidate leaves the grid)
+
+int DungeonClass::CheckGridBatch(CandidateBatch &Batch)
+{
+	int Start_x, Start_y, End_x, End_y;
+	int Placed = -1;
+
+	if (m_Workers->GetThreadCount() > 1)
+	{
+		// Test every candidate at once on the worker threads. The tests only read the grid, so the results are the same as testing
+		// them one at a time, and the first candidate that fits is placed in the same way
+		m_TestBatch = &Batch;
+		m_Workers->Run(TestCandidateJob, this, Batch.Count);
+		m_TestBatch = 0;
+
+		for (int k = 0; (k < Batch.Count) && (Placed < 0); k++)
+		{
+			if (m_CandidateResults[k] == CANDIDATE_OUTSIDE)
+			{
+				// Dungeon grid too small for the dungeon to generate therefore need to exit program
+				DungeonFailed = true;
+				return -1;
+			}
+			if (m_CandidateResults[k] == CANDIDATE_FITS)
+			{
+				Placed = k;
+			}
+		}
+	}
+	else
+	{
+		// Check each candidate in the order they were drawn, stopping at the first one that fits
+		for (int k = 0; (k < Batch.Count) && (Placed < 0); k++)
+		{
+			int Result = TestCandidate(Batch, k);
+			if (Result == CANDIDATE_OUTSIDE)
+			{
+				// Dungeon grid too small for the dungeon to generate therefore need to exit program
+				DungeonFailed = true;
+				return -1;
+			}
+			if (Result == CANDIDATE_FITS)
+			{
+				Placed = k;
+			}
+		}
+	}
+
+	// None of the candidates fit
+	if (Placed < 0)
+	{
+		return -1;
+	}
+
+	// Fill in the grid for the candidate that was placed
+	GetGridArea(Batch.Widths[Placed], Batch.Heights[Placed], Batch.CentersX[Placed], Batch.CentersY[Placed], Start_x, Start_y, End_x, End_y);
+	FillGridArea(Start_x, Start_y, End_x, End_y);
+	return Placed;
+}
+
+
+// Function:		Test Candidate function
+// What it does:	Does the same test as CheckGrid for one candidate in a batch without filling in the grid. Only reads the grid, so
+//					candidates can be tested at the same time
+// Takes in:		CandidateBatch - reference to the candidates, int - Index of the candidate
+// Returns:			int - CANDIDATE_FITS, CANDIDATE_BLOCKED if something is in the way, or CANDIDATE_OUTSIDE if it leaves the grid
+
+int DungeonClass::TestCandidate(CandidateBatch &Batch, int Index)
+{
+	int Start_x, Start_y, End_x, End_y;
+	GetGridArea(Batch.Widths[Index], Batch.Heights[Index], Batch.CentersX[Index], Batch.CentersY[Index], Start_x, Start_y, End_x, End_y);
+
+	// If a candidate goes outside of the dungeon grid, the grid is too small for the dungeon
+	if ((!InBounds(Start_x, Start_y)) || (!InBounds(End_x, End_y)))
+	{
+		return CANDIDATE_OUTSIDE;
+	}
+
+	// Use the occupancy pyramid to check nothing is inside the candidate
+	if (m_Occupancy->IsEmpty(Start_x + 1, Start_y + 1, End_x - 2, End_y - 2))
+	{
+		return CANDIDATE_FITS;
+	}
+
+	return CANDIDATE_BLOCKED;
+}
+
+
+// Function:		Test Candidate Job function
+// What it does:	Job run by the worker pool for each candidate in the batch being tested
+// Takes in:		void - pointer to the dungeon, int - Index of the candidate
+// Returns:			Nothing
+
+void DungeonClass::TestCandidateJob(void* Data, int Index)
+{
+	DungeonClass* Dungeon = (DungeonClass*)Data;
+	Dungeon->m_CandidateResults[Index] = Dungeon->TestCandidate(*Dungeon->m_TestBatch, Index);
+}
+
+
+// Function:		Fill Grid Area function
+// What it does:	Fills in an area of the dungeon grid so the grid knows a piece is there, and updates the occupancy pyramid and
+//					the empty rectangles to match
+// Takes in:		int - Start and end positions of the area (the end positions are filled as well, and all must be in the grid)
+// Returns:			Nothing
+
+void DungeonClass::FillGridArea(int Start_x, int Start_y, int End_x, int End_y)
+{
+	for (int i = Start_x; i <= End_x; i++)
+	{
+		for (int j = Start_y; j <= End_y; j++)
+		{
+			DungeonGrid[i][j] = DUNGEON_ROOM;
+		}
+	}
+
+	MarkGridUsed(Start_x, Start_y, End_x, End_y);
+	m_Occupancy->Occupy(Start_x, Start_y, End_x, End_y);
+	if (m_EmptyRects)
+	{
+		m_EmptyRects->Occupy(Start_x, Start_y, End_x, End_y);
+	}
+}
+
+
+// Function:		Mark Grid Used function
+// What it does:	Grows the area of the grid that has been filled in to hold the given area, so Reset knows what to clear
+// Takes in:		int - Start and end positions of the area (included in the area)
+// Returns:			Nothing
+
+void DungeonClass::MarkGridUsed(int Start_x, int Start_y, int End_x, int End_y)
+{
+	m_UsedStartX = (Start_x < m_UsedStartX) ? Start_x : m_UsedStartX;
+	m_UsedStartY = (Start_y < m_UsedStartY) ? Start_y : m_UsedStartY;
+	m_UsedEndX = (End_x > m_UsedEndX) ? End_x : m_UsedEndX;
+	m_UsedEndY = (End_y > m_UsedEndY) ? End_y : m_UsedEndY;
+}
+
+
+// Function:		Should Stop Generation function
+// What it does:	Checks if generation has been cancelled or has used up its time, and remembers that it stopped
+// Takes in:		Nothing
+// Returns:			True if no more pieces should be placed, false if not
+
+bool DungeonClass::ShouldStopGeneration()
+{
+	if (m_GenerationStopped)
+	{
+		return true;
+	}
+
+	// Use up the cancel once generation has stopped for it, so it doesn't stop the next generation as well
+	if (m_CancelRequested.exchange(false))
+	{
+		m_GenerationStopped = true;
+	}
+
+	if (m_GenerationBudget > 0)
+	{
+		clock_t TimeLimit = (clock_t)(((long long)m_GenerationBudget * CLOCKS_PER_SEC) / 1000);
+		if ((clock() - m_GenerationStart) > TimeLimit)
+		{
+			m_GenerationStopped = true;
+			m_GenerationOutOfTime = true;
+		}
+	}
+
+	return m_GenerationStopped;
+}
+
+
+// Function:		Report Progress function
+// What it does:	Calls the progress callback, if there is one, with the pieces placed and the doors waiting
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonClass::ReportProgress()
+{
+	if (m_ProgressCallback)
+	{
+		m_ProgressCallback(m_PiecesPlaced, m_FrontierSize, m_ProgressUserData);
+	}
+}
+
+
+// Function:		Count Progress Piece function
+// What it does:	Adds a new piece to the progress metrics, with the door to the piece it was placed from
+// Takes in:		DungeonPieceClass - pointer to the new piece, DungeonPieceClass - pointer to the piece it was placed from (0 for
+//					the entrance)
+// Returns:			Nothing
+
+void DungeonClass::CountProgressPiece(DungeonPieceClass* Piece, DungeonPieceClass* Parent)
+{
+	DungeonPieceClass::m_PieceType Type = Piece->GetPieceType();
+	if ((Type == DungeonPieceClass::HORIZONTAL_CORRIDOR) || (Type == DungeonPieceClass::VERTICAL_CORRIDOR))
+	{
+		m_Progress.Corridors++;
+	}
+	else
+	{
+		m_Progress.Rooms++;
+	}
+
+	// A new piece only has the door it was reached through, so every piece but the entrance starts as a dead end
+	int Doors = (int)Piece->m_LDoor + (int)Piece->m_RDoor + (int)Piece->m_UDoor + (int)Piece->m_DDoor;
+	if ((Type != DungeonPieceClass::ENTRANCE) && (Doors == 1))
+	{
+		m_Progress.DeadEnds++;
+		if ((Piece->m_HalfWidth * Piece->m_HalfHeight * 4.0f) <= METRICS_SMALL_AREA)
+		{
+			m_Progress.SmallDeadEnds++;
+		}
+	}
+
+	// Grow the bounding box to hold the piece
+	float Left = Piece->m_Center.x - Piece->m_HalfWidth;
+	float Right = Piece->m_Center.x + Piece->m_HalfWidth;
+	float Bottom = Piece->m_Center.y - Piece->m_HalfHeight;
+	float Top = Piece->m_Center.y + Piece->m_HalfHeight;
+	if (m_Progress.Pieces == 0)
+	{
+		m_Progress.MinX = Left;
+		m_Progress.MaxX = Right;
+		m_Progress.MinY = Bottom;
+		m_Progress.MaxY = Top;
+	}
+	m_Progress.MinX = (Left < m_Progress.MinX) ? Left : m_Progress.MinX;
+	m_Progress.MaxX = (Right > m_Progress.MaxX) ? Right : m_Progress.MaxX;
+	m_Progress.MinY = (Bottom < m_Progress.MinY) ? Bottom : m_Progress.MinY;
+	m_Progress.MaxY = (Top > m_Progress.MaxY) ? Top : m_Progress.MaxY;
+	m_Progress.Pieces++;
+
+	if (Parent)
+	{
+		CountProgressDoor(Parent);
+	}
+}
+
+
+// Function:		Count Progress Prefab function
+// What it does:	Adds the prefab room placed last to the progress metrics, with the door to the piece it was placed from
+// Takes in:		DungeonPieceClass - pointer to the piece the prefab room was placed from
+// Returns:			Nothing
+
+void DungeonClass::CountProgressPrefab(DungeonPieceClass* Parent)
+{
+	// Prefab rooms are rooms with only the door they were placed from
+	PrefabLibraryClass::Instance &Instance = m_PrefabInstances.back();
+	PrefabLibraryClass::Template* Prefab = m_PrefabLibrary->GetTemplate(Instance.Template);
+	float Left = Instance.Origin.x;
+	float Right = Instance.Origin.x + (Prefab->Width * PREFAB_CELL_SIZE);
+	float Bottom = Instance.Origin.y;
+	float Top = Instance.Origin.y + (Prefab->Height * PREFAB_CELL_SIZE);
+
+	m_Progress.Rooms++;
+	m_Progress.Prefabs++;
+	m_Progress.DeadEnds++;
+	m_Progress.MinX = (Left < m_Progress.MinX) ? Left : m_Progress.MinX;
+	m_Progress.MaxX = (Right > m_Progress.MaxX) ? Right : m_Progress.MaxX;
+	m_Progress.MinY = (Bottom < m_Progress.MinY) ? Bottom : m_Progress.MinY;
+	m_Progress.MaxY = (Top > m_Progress.MaxY) ? Top : m_Progress.MaxY;
+	m_Progress.Pieces++;
+
+	CountProgressDoor(Parent);
+}
+
+
+// Function:		Count Progress Door function
+// What it does:	Adds a new door of a piece to the progress metrics once it has been added to the piece, taking the piece off
+//					the dead ends if it was one
+// Takes in:		DungeonPieceClass - pointer to the piece
+// Returns:			Nothing
+
+void DungeonClass::CountProgressDoor(DungeonPieceClass* Piece)
+{
+	// Every door of a piece but the one it was reached through leads to a piece placed from it
+	bool Entrance = (Piece->GetPieceType() == DungeonPieceClass::ENTRANCE);
+	int Doors = (int)Piece->m_LDoor + (int)Piece->m_RDoor + (int)Piece->m_UDoor + (int)Piece->m_DDoor;
+	int Children = Entrance ? Doors : Doors - 1;
+
+	// A piece with only the door it was reached through before this one was a dead end
+	if ((!Entrance) && (Doors == 2))
+	{
+		m_Progress.DeadEnds--;
+		if ((Piece->m_HalfWidth * Piece->m_HalfHeight * 4.0f) <= METRICS_SMALL_AREA)
+		{
+			m_Progress.SmallDeadEnds--;
+		}
+	}
+
+	m_ProgressBranches++;
+	if (Children == 1)
+	{
+		m_ProgressBranchingPieces++;
+	}
+}
+
+
+// Function:		Get Grid Area function
+// What it does:	Finds the positions on the dungeon grid filled by a piece, in the same way for every grid check
+// Takes in:		int - Width and height of the piece in tenths, int - Center of the piece in layout units,
+//					int - references to the start and end positions (the end positions are filled as well)
+// Returns:			Nothing
+
+void DungeonClass::GetGridArea(int Width, int Height, int Center_x, int Center_y, int &Start_x, int &Start_y, int &End_x, int &End_y)
+{
+	// Half the size of the piece in layout units
+	int HalfWidth = (Width * LAYOUT_UNITS_PER_TENTH) / 2;
+	int HalfHeight = (Height * LAYOUT_UNITS_PER_TENTH) / 2;
+
+	// Each edge is in the grid position it falls in. Two pieces next to each other share the grid positions along their edge on
+	// every side, which the grid checks allow for
+	Start_x = FloorDivide(Center_x - HalfWidth, m_LayoutUnitsPerCell) + m_GridOffsetX;
+	Start_y = FloorDivide(Center_y - HalfHeight, m_LayoutUnitsPerCell) + m_GridOffsetZ;
+	End_x = FloorDivide(Center_x + HalfWidth, m_LayoutUnitsPerCell) + m_GridOffsetX;
+	End_y = FloorDivide(Center_y + HalfHeight, m_LayoutUnitsPerCell) + m_GridOffsetZ;
+}
+
+
+// Function:		Initialise Layout Piece function
+// What it does:	Gives a piece its layout and initialises it in world space. This is where the layout of a placed piece is
+//					changed into world space
+// Takes in:		DungeonPieceClass - pointer to the piece, int - Center in layout units, int - Width and height in tenths,
+//					int - The door limit passed to the piece
+// Returns:			True if the piece was initialised, false if not
+
+bool DungeonClass::InitialiseLayoutPiece(DungeonPieceClass* Piece, int Center_x, int Center_y, int Width, int Height, int RoomLimit)
+{
+	// Keep the layout on the piece so the pieces placed next to it are found from it, rather than from its world space values
+	Piece->m_LayoutX = Center_x;
+	Piece->m_LayoutY = Center_y;
+	Piece->m_LayoutWidth = Width;
+	Piece->m_LayoutHeight = Height;
+
+	D3DXVECTOR2 Center = D3DXVECTOR2(LayoutToWorld(Center_x), LayoutToWorld(Center_y));
+	return Piece->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, Center, LayoutToWorld(Width * LAYOUT_UNITS_PER_TENTH), LayoutToWorld(Height * LAYOUT_UNITS_PER_TENTH), RoomLimit);
+}
+
+
+// Function:		Layout To World function
+// What it does:	Changes a position or length in layout units into world space
+// Takes in:		int - Position in layout units
+// Returns:			float - Position in world space
+
+float DungeonClass::LayoutToWorld(int Position)
+{
+	return (float)Position / LAYOUT_UNITS_PER_UNIT;
+}
+
+
+// Function:		World To Layout function
+// What it does:	Changes a position or length in world space into the nearest layout unit
+// Takes in:		float - Position in world space
+// Returns:			int - Position in layout units
+
+int DungeonClass::WorldToLayout(float Position)
+{
+	return (int)floor((Position * LAYOUT_UNITS_PER_UNIT) + 0.5f);
+}
+
+
+// Function:		World To Grid function
+// What it does:	Finds the grid position a position in world space falls in, in the same way as GetGridArea finds the edges of
+//					a piece, so that things on the edge of a piece are in the same grid position as the edge
+// Takes in:		float - Position in world space, int - Grid offset of the axis
+// Returns:			int - Position on the grid
+
+int DungeonClass::WorldToGrid(float Position, int Offset)
+{
+	// Positions made from the layout are a float close to a layout unit, so they are put back on it before finding the grid position
+	return FloorDivide(WorldToLayout(Position), m_LayoutUnitsPerCell) + Offset;
+}
+
+
+// Function:		Find Coarsest Cells Per Unit function
+// What it does:	Finds the fewest grid cells along one unit that still hold every size the generator can make exactly, from
+//					the size limits and step of each piece, the entrance, the doors, and the prefab and cave cells used
+// Takes in:		Nothing
+// Returns:			int - Number of grid cells along one unit (a divisor of GRID_BASE_CELLS_PER_UNIT)
+
+int DungeonClass::FindCoarsestCellsPerUnit()
+{
+	D3DXVECTOR2 Lower, Upper;
+	DungeonPieceClass::m_PieceType Types[3] = { DungeonPieceClass::ROOM, DungeonPieceClass::VERTICAL_CORRIDOR, DungeonPieceClass::HORIZONTAL_CORRIDOR };
+
+	// Find the largest number of tenths every size is a whole number of, starting from a whole unit and the 2 unit entrance
+	int Tenths = GreatestCommonDivisor(GRID_BASE_CELLS_PER_UNIT, 20);
+
+	// Every size a piece can be is its lower size limit plus a number of steps
+	for (int i = 0; i < 3; i++)
+	{
+		DungeonPieceClass SizePiece(Types[i], 0);
+		SizePiece.GetSizeLimits(Lower, Upper);
+		Tenths = GreatestCommonDivisor(Tenths, (int)Lower.x);
+		Tenths = GreatestCommonDivisor(Tenths, (int)Lower.y);
+		if ((Upper.x != Lower.x) || (Upper.y != Lower.y))
+		{
+			Tenths = GreatestCommonDivisor(Tenths, PIECE_SIZE_STEP);
+		}
+	}
+
+	// The gap left in a wall for a door runs from the middle of the wall
+	Tenths = GreatestCommonDivisor(Tenths, (int)floor((DOOR_HALF_WIDTH * 10) + 0.5f));
+
+	// Prefab rooms and caves are laid out in their own cells
+	if (PREFAB_CHANCE > 0)
+	{
+		Tenths = GreatestCommonDivisor(Tenths, (int)(PREFAB_CELL_SIZE * 10));
+	}
+	if ((CAVE_REGIONS > 0) && (CAVE_CHANCE > 0))
+	{
+		Tenths = GreatestCommonDivisor(Tenths, CAVE_CELL_SIZE);
+	}
+
+	// The other generators make their own sizes. Wave collapse tiles are whole sizes, and scatter rooms can be any number of tenths
+	if (m_Generator == GENERATOR_WAVE_COLLAPSE)
+	{
+		Tenths = GreatestCommonDivisor(Tenths, (int)floor((WAVE_TILE_SIZE * 10) + 0.5f));
+		Tenths = GreatestCommonDivisor(Tenths, (int)floor((WAVE_CORRIDOR_WIDTH * 10) + 0.5f));
+	}
+	if (m_Generator == GENERATOR_SCATTER)
+	{
+		Tenths = 1;
+	}
+
+	// As the search started from a whole unit, the number of tenths always divides it
+	return GRID_BASE_CELLS_PER_UNIT / Tenths;
+}
+
+
+// Function:		Get Cave Cell Size function
+// What it does:	Finds the number of grid cells along one cave cell at the resolution of the grid
+// Takes in:		Nothing
+// Returns:			int - Number of grid cells (at least 1)
+
+int DungeonClass::GetCaveCellSize()
+{
+	int CaveCell = (CAVE_CELL_SIZE * LAYOUT_UNITS_PER_TENTH) / m_LayoutUnitsPerCell;
+	if (CaveCell < 1)
+	{
+		CaveCell = 1;
+	}
+
+	return CaveCell;
+}
+
+
+// Function:		Greatest Common Divisor function
+// What it does:	Finds the largest whole number that divides both numbers
+// Takes in:		int - The two numbers (0 is divided by anything)
+// Returns:			int - The greatest common divisor
+
+int DungeonClass::GreatestCommonDivisor(int a, int b)
+{
+	while (b != 0)
+	{
+		int Remainder = a % b;
+		a = b;
+		b = Remainder;
+	}
+
+	return a;
+}
+
+
+// Function:		Floor Divide function
+// What it does:	Divides two whole numbers, rounding down for negative numbers as well as positive ones
+// Takes in:		int - Value, int - Divisor (greater than 0)
+// Returns:			int - Value divided by the divisor, rounded down
+
+int DungeonClass::FloorDivide(int Value, int Divisor)
+{
+	int Result = Value / Divisor;
+	if (((Value % Divisor) != 0) && (Value < 0))
+	{
+		Result--;
+	}
+
+	return Result;
+}
+
+
+// Function:		Find Best Fit function
+// What it does:	Goes through every size a piece of this type can be and uses the empty rectangles of the grid to find the one
+//					closest to the size wanted that fits behind the door, picking the larger one if two are as close
+// Takes in:		DungeonPieceClass - pointer to the piece with the door, int - Door direction, DungeonPieceClass::m_PieceType - Type
+//					of the new piece, int - Width and height wanted in tenths, int - references to the width and height found
+// Returns:			True if a piece of this type fits behind the door, false if not (or if there is no empty rectangle index,
+//					which is only made for best fit placement)
+
+bool DungeonClass::FindBestFit(DungeonPieceClass* Piece, int DoorNumber, DungeonPieceClass::m_PieceType Type, int Wanted_x, int Wanted_y, int &Width, int &Height)
+{
+	D3DXVECTOR2 Lower, Upper;
+	int Start_x, Start_y, End_x, End_y;
+	int Center_x, Center_y;
+
+	if (!m_EmptyRects)
+	{
+		return false;
+	}
+
+	// Get the sizes this type of piece can be, in tenths in the same way as GetLayoutSize
+	DungeonPieceClass SizePiece(Type, DoorNumber);
+	SizePiece.GetSizeLimits(Lower, Upper);
+	int Lowest_x = (int)Lower.x;
+	int Lowest_y = (int)Lower.y;
+	int Highest_x = (Upper.x != Lower.x) ? Lowest_x + ((((int)Upper.x - 1 - Lowest_x) / PIECE_SIZE_STEP) * PIECE_SIZE_STEP) : Lowest_x;
+	int Highest_y = (Upper.y != Lower.y) ? Lowest_y + ((((int)Upper.y - 1 - Lowest_y) / PIECE_SIZE_STEP) * PIECE_SIZE_STEP) : Lowest_y;
+	int Widths = ((Highest_x - Lowest_x) / PIECE_SIZE_STEP) + 1;
+
+	// Find the empty rectangles holding the inside of the smallest piece. A larger piece behind the door covers this area as well, so
+	// it only needs to be checked against these rectangles
+	GetNextCenter(DoorNumber, Piece, Lowest_x, Lowest_y, Center_x, Center_y);
+	GetGridArea(Lowest_x, Lowest_y, Center_x, Center_y, Start_x, Start_y, End_x, End_y);
+	m_EmptyRects->FindContaining(Start_x + 1, Start_y + 1, End_x - 2, End_y - 2, m_DoorRects);
+	if (m_DoorRects.empty())
+	{
+		return false;
+	}
+
+	// Search each width of piece for its best height, on the worker threads if there are any
+	m_FitSearch.Piece = Piece;
+	m_FitSearch.DoorNumber = DoorNumber;
+	m_FitSearch.Lowest_x = Lowest_x;
+	m_FitSearch.Lowest_y = Lowest_y;
+	m_FitSearch.Highest_y = Highest_y;
+	m_FitSearch.Wanted_x = Wanted_x;
+	m_FitSearch.Wanted_y = Wanted_y;
+	m_FitSearch.Step = PIECE_SIZE_STEP;
+	m_FitSearch.Columns.resize(Widths);
+	m_Workers->Run(FindBestFitJob, this, Widths);
+
+	// Take the best of the widths in order, only replacing it with a later width that is closer or as close and larger. This gives
+	// the same size however many threads searched the widths
+	int BestDistance = -1;
+	int BestArea = 0;
+	for (int x = Lowest_x; x <= Highest_x; x += PIECE_SIZE_STEP)
+	{
+		FitColumn &Column = m_FitSearch.Columns[(x - Lowest_x) / PIECE_SIZE_STEP];
+		if (Column.Distance < 0)
+		{
+			continue;
+		}
+
+		if ((BestDistance < 0) || (Column.Distance < BestDistance) || ((Column.Distance == BestDistance) && (Column.Area > BestArea)))
+		{
+			BestDistance = Column.Distance;
+			BestArea = Column.Area;
+			Width = x;
+			Height = Column.Height;
+		}
+	}
+
+	return (BestDistance >= 0);
+}
+
+
+// Function:		Find Best Fit Column function
+// What it does:	Finds the height closest to the size wanted that fits behind the door for one width in the best fit search, picking
+//					the larger one if two are as close. Only reads the grid indexes, so columns can be searched at the same time
+// Takes in:		int - Width in tenths
+// Returns:			Nothing
+
+void DungeonClass::FindBestFitColumn(int x)
+{
+	int Start_x, Start_y, End_x, End_y;
+	int Center_x, Center_y;
+	FitColumn &Column = m_FitSearch.Columns[(x - m_FitSearch.Lowest_x) / m_FitSearch.Step];
+	Column.Distance = -1;
+	Column.Area = 0;
+	Column.Height = 0;
+
+	for (int y = m_FitSearch.Lowest_y; y <= m_FitSearch.Highest_y; y += m_FitSearch.Step)
+	{
+		// Skip sizes further from the size wanted than the best found so far
+		int Distance = abs(x - m_FitSearch.Wanted_x) + abs(y - m_FitSearch.Wanted_y);
+		if ((Column.Distance >= 0) && ((Distance > Column.Distance) || ((Distance == Column.Distance) && ((x * y) <= Column.Area))))
+		{
+			continue;
+		}
+
+		// Get the grid area of a piece of this size behind the door, and check its inside is held by one of the rectangles
+		GetNextCenter(m_FitSearch.DoorNumber, m_FitSearch.Piece, x, y, Center_x, Center_y);
+		GetGridArea(x, y, Center_x, Center_y, Start_x, Start_y, End_x, End_y);
+		if ((!InBounds(Start_x, Start_y)) || (!InBounds(End_x, End_y)))
+		{
+			continue;
+		}
+
+		bool Fits = ((Start_x + 1) > (End_x - 2)) || ((Start_y + 1) > (End_y - 2));
+		for (unsigned int r = 0; (r < m_DoorRects.size()) && (!Fits); r++)
+		{
+			Fits = EmptyRectIndexClass::Holds(m_DoorRects[r], Start_x + 1, Start_y + 1, End_x - 2, End_y - 2);
+		}
+
+		if (Fits)
+		{
+			Column.Distance = Distance;
+			Column.Area = x * y;
+			Column.Height = y;
+		}
+	}
+}
+
+
+// Function:		Find Best Fit Job function
+// What it does:	Job run by the worker pool for each width in the best fit search
+// Takes in:		void - pointer to the dungeon, int - Index of the width from the smallest width
+// Returns:			Nothing
+
+void DungeonClass::FindBestFitJob(void* Data, int Index)
+{
+	DungeonClass* Dungeon = (DungeonClass*)Data;
+	Dungeon->FindBestFitColumn(Dungeon->m_FitSearch.Lowest_x + (Index * Dungeon->m_FitSearch.Step));
+}
+
+
+// Function:		Set Chances function
+// What it does:	Changes the chances available for the dungeon as the depth of the dungeon increases
+//					It is called in PlaceNextPiece and changes the chance values based on the depth, to make it more likely or less likely
+//					That certain types of rooms will be created closer to the end of the dungeon
+// Takes in:		int - Depth value
+// Returns:			Nothing
+
+void DungeonClass::SetChances(int depth)
+{
+	// If the depth reaches the max dungeon depth
+	if (depth == DUNGEON_DEPTH)
+	{
+		// Reduce the chance for a corridor to 0, so that there aren't corridors at the end of the dungeon that don't lead to a room
+		m_CorridorChanceAftRoom = 0.0f;
+		m_CorridorChanceAftCorridor = 0.0f;
+		// Increase the chance for a corridor to 100%, so that at the end of the dungeon only rooms will be created
+		m_RoomChanceAftRoom = 100.0f;
+		m_RoomChanceAftCorridor = 100.0f;
+		// Room limit is set to 1 so that the room won't create a new room
+		m_RoomsLimit = 1.0f;
+	}
+	else
+	{
+		// Set the chance for the corridors after a room to a number just above 50% to make it more likely a corridor 
+		// is made after a room
+		m_CorridorChanceAftRoom = 60;
+
+		// Set the chance for a corridor after a corridor to 10T so that it is less likely to produce two corridors in a row
+		m_CorridorChanceAftCorridor = 10;
+
+		// Set the chance for a room after a room to a number just below 50% to make it less likely a room is made 
+		// after a room
+		m_RoomChanceAftRoom = 40;
+
+		// Set the chance for a room after a corridor to 90% so that it is more likely to produce a room after a corridor is placed
+		m_RoomChanceAftCorridor = 90;
+
+		// Change the rooms limit to 3 so that less rooms are available to be created than at the start of the dungeon
+		m_RoomsLimit = 4.0f;
+	}
+	// If near the start of the dungeon, set the rooms limit to 4 so that the rooms will have more doors available at the start so
+	// dungeon will branch off nicely
+	if ((depth == 0) || (depth == 1))
+	{
+		m_RoomsLimit = 4.0f;
+	}
+}
+
+
+// Function:		Place Cave Regions function
+// What it does:	Called at the end of Initialise. Looks through the dungeon pieces for doors that were available but had no room
+//					placed behind them, and randomly tries to place a cave region behind them up to the cave limit
+// Takes in:		Nothing
+// Returns:			True if there were no errors, false if the geometry for a cave couldn't be created
+
+bool DungeonClass::PlaceCaveRegions()
+{
+	bool result;
+
+	for (auto ThisPiece = m_DungeonPieces.begin(); ThisPiece != m_DungeonPieces.end(); ++ThisPiece)
+	{
+		DungeonPieceClass* Piece = *ThisPiece;
+
+		// A door is unused if a room could have been created there but there is no door in the wall
+		int Directions[4] = { LEFT, RIGHT, UP, DOWN };
+		bool Unused[4] = {	Piece->m_LAvailable && !Piece->m_LDoor, Piece->m_RAvailable && !Piece->m_RDoor,
+							Piece->m_UAvailable && !Piece->m_UDoor, Piece->m_DAvailable && !Piece->m_DDoor };
+
+		for (int i = 0; i < 4; i++)
+		{
+			// Stop once the dungeon has all of its caves
+			if (m_CaveCount >= CAVE_REGIONS)
+			{
+				return true;
+			}
+
+			// Use rand so that caves only appear behind some of the unused doors
+			if ((Unused[i]) && ((rand() % 100) < CAVE_CHANCE))
+			{
+				result = PlaceCave(Piece, Directions[i]);
+				if (!result)
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// Function:		Place Cave function
+// What it does:	Generates a cave with the cave generator on the far side of the given door of a piece. Checks the dungeon grid
+//					is free for the region, marks the open cells of the cave in the grid so the player can walk in it, creates the
+//					floor, ceiling and wall meshes from the cave and adds the door between the piece and the cave
+//					If there is no room for the region or the cave is too small, nothing is placed
+// Takes in:		DungeonPieceClass - pointer to the piece the cave leads off, int - Door direction (LEFT, RIGHT, UP, DOWN)
+// Returns:			True if there were no errors (even if no cave was placed), false if the cave's meshes couldn't be created
+
+bool DungeonClass::PlaceCave(DungeonPieceClass* Piece, int DoorNumber)
+{
+	bool result;
+	CaveGeneratorClass Cave;
+	int CaveCell = GetCaveCellSize();
+	int RegionSize = CAVE_REGION_SIZE * CaveCell;
+
+	// Find the edges of the piece in the grid in the same way as CheckGrid, and the position of its doors
+	int Start_x, Start_y, End_x, End_y;
+	GetGridArea(Piece->m_LayoutWidth, Piece->m_LayoutHeight, Piece->m_LayoutX, Piece->m_LayoutY, Start_x, Start_y, End_x, End_y);
+	int Door_x = FloorDivide(Piece->m_LayoutX, m_LayoutUnitsPerCell) + m_GridOffsetX;
+	int Door_y = FloorDivide(Piece->m_LayoutY, m_LayoutUnitsPerCell) + m_GridOffsetZ;
+
+	// Find the corner of the cave region so that it starts at the wall of the piece with the door in the middle of its side,
+	// and the side of the cave the tunnel to the door should be carved from
+	int GridX = 0;
+	int GridY = 0;
+	int Side = 0;
+	int EntranceX = CAVE_REGION_SIZE / 2;
+	int EntranceY = CAVE_REGION_SIZE / 2;
+
+	if (DoorNumber == RIGHT)
+	{
+		GridX = End_x;
+		GridY = Door_y - (RegionSize / 2);
+		Side = CAVE_SIDE_LEFT;
+		EntranceX = 0;
+	}
+	if (DoorNumber == LEFT)
+	{
+		GridX = Start_x - RegionSize;
+		GridY = Door_y - (RegionSize / 2);
+		Side = CAVE_SIDE_RIGHT;
+		EntranceX = CAVE_REGION_SIZE - 1;
+	}
+	if (DoorNumber == UP)
+	{
+		GridX = Door_x - (RegionSize / 2);
+		GridY = End_y;
+		Side = CAVE_SIDE_DOWN;
+		EntranceY = 0;
+	}
+	if (DoorNumber == DOWN)
+	{
+		GridX = Door_x - (RegionSize / 2);
+		GridY = Start_y - RegionSize;
+		Side = CAVE_SIDE_UP;
+		EntranceY = CAVE_REGION_SIZE - 1;
+	}
+
+	// If the region is outside of the dungeon grid, don't place a cave here
+	if ((!InBounds(GridX, GridY)) || (!InBounds(GridX + RegionSize - 1, GridY + RegionSize - 1)))
+	{
+		return true;
+	}
+
+	// Check the region is empty (apart from its edges, which may be shared with the walls of other pieces)
+	if (!m_Occupancy->IsEmpty(GridX + 1, GridY + 1, GridX + RegionSize - 2, GridY + RegionSize - 2))
+	{
+		return true;
+	}
+
+	// Generate the cave, then join it to the door and remove any parts that can't be reached from the door
+	result = Cave.Initialise(CAVE_REGION_SIZE, CAVE_REGION_SIZE, CAVE_FILL_CHANCE);
+	if (!result)
+	{
+		return true;
+	}
+
+	Cave.Step(CAVE_ITERATIONS);
+	Cave.CarveEntrance(Side, CAVE_REGION_SIZE / 2, CAVE_ENTRANCE_HALF_WIDTH);
+	if (Cave.KeepConnected(EntranceX, EntranceY) < CAVE_MIN_OPEN_CELLS)
+	{
+		return true;
+	}
+
+	// Fill in the open cells of the cave in the grid so the player can walk there. Rock cells are left as they are so they
+	// are collided with in the same way as walls
+	for (int y = 0; y < CAVE_REGION_SIZE; y++)
+	{
+		for (int x = 0; x < CAVE_REGION_SIZE; x++)
+		{
+			if (Cave.IsOpen(x, y))
+			{
+				for (int i = 0; i < CaveCell; i++)
+				{
+					for (int j = 0; j < CaveCell; j++)
+					{
+						DungeonGrid[GridX + (x * CaveCell) + i][GridY + (y * CaveCell) + j] = DUNGEON_ROOM;
+					}
+				}
+			}
+		}
+	}
+
+	// The whole region is taken out of the occupancy pyramid and the empty rectangles, as the rock between the open cells can't
+	// be used by other pieces or caves
+	MarkGridUsed(GridX, GridY, GridX + RegionSize - 1, GridY + RegionSize - 1);
+	m_Occupancy->Occupy(GridX, GridY, GridX + RegionSize - 1, GridY + RegionSize - 1);
+	if (m_EmptyRects)
+	{
+		m_EmptyRects->Occupy(GridX, GridY, GridX + RegionSize - 1, GridY + RegionSize - 1);
+	}
+
+	// Create the floor, ceiling and wall meshes for the cave
+	result = CreateCaveMeshes(Cave, GridX, GridY);
+	if (!result)
+	{
+		return false;
+	}
+
+	// Add the cave to the graph at the center of its region, and the door between the piece and the cave
+	float RegionCenterX = LayoutToWorld((GridX + (RegionSize / 2) - m_GridOffsetX) * m_LayoutUnitsPerCell);
+	float RegionCenterZ = LayoutToWorld((GridY + (RegionSize / 2) - m_GridOffsetZ) * m_LayoutUnitsPerCell);
+	int CaveNode = m_Graph->AddNode(GRAPH_NODE_CAVE, 0, D3DXVECTOR2(RegionCenterX, RegionCenterZ));
+	result = AddDoor(Piece, DoorNumber, CaveNode);
+	if (!result)
+	{
+		return false;
+	}
+
+	m_CaveCount++;
+
+	return true;
+}
+
+
+// Function:		Create Cave Meshes function
+// What it does:	Turns the floor rectangles and wall segments of a finished cave into meshes in world space
+// Takes in:		CaveGeneratorClass - reference to the finished cave, int - X grid cell of the region's corner, int - Y grid cell of the region's corner
+// Returns:			True if all meshes were created, false if not
+
+bool DungeonClass::CreateCaveMeshes(CaveGeneratorClass &Cave, int GridX, int GridY)
+{
+	bool result;
+	vector<CaveGeneratorClass::CaveRect> Rects;
+	vector<CaveGeneratorClass::CaveSegment> Segments;
+
+	Cave.BuildFloorRects(Rects);
+	Cave.BuildWallSegments(Segments);
+
+	// Get the size of a cave cell and the corner of the region in world space
+	float CellSize = LayoutToWorld(GetCaveCellSize() * m_LayoutUnitsPerCell);
+	float OriginX = LayoutToWorld((GridX - m_GridOffsetX) * m_LayoutUnitsPerCell);
+	float OriginZ = LayoutToWorld((GridY - m_GridOffsetZ) * m_LayoutUnitsPerCell);
+
+	// Create a floor and a ceiling mesh for each rectangle of open cells
+	for (unsigned int i = 0; i < Rects.size(); i++)
+	{
+		float x0 = OriginX + (Rects[i].X0 * CellSize);
+		float x1 = OriginX + (Rects[i].X1 * CellSize);
+		float z0 = OriginZ + (Rects[i].Y0 * CellSize);
+		float z1 = OriginZ + (Rects[i].Y1 * CellSize);
+
+		// Repeat the texture once per unit so the floors of the rectangles line up with each other
+		D3DXVECTOR2 TextureScale = D3DXVECTOR2(x1 - x0, z1 - z0);
+
+		// The floor is drawn the same way as the floor of a dungeon piece, facing up
+		MeshClass* Floor = new MeshClass();
+		if (!Floor)
+		{
+			return false;
+		}
+		m_CaveFloors.push_back(Floor);
+
+		result = Floor->Initialize(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, L"data/wooden_floors.png",	D3DXVECTOR3(x0, 0.0f, z0),		// Bottom Left
+																											D3DXVECTOR3(x0, 0.0f, z1),		// Top Left
+																											D3DXVECTOR3(x1, 0.0f, z1),		// Top Right
+																											D3DXVECTOR3(x1, 0.0f, z0),		// Bottom Right
+																											D3DXVECTOR3(0.0f, 1.0f, 0.0f), TextureScale);
+		if (!result)
+		{
+			return false;
+		}
+
+		// The ceiling is drawn anti clockwise like the ceilings of the pieces so that it can be seen from beneath
+		MeshClass* Ceiling = new MeshClass();
+		if (!Ceiling)
+		{
+			return false;
+		}
+		m_CaveCeilings.push_back(Ceiling);
+
+		result = Ceiling->Initialize(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, L"data/wooden_floors.png",	D3DXVECTOR3(x0, 0.0f, z0),		// Bottom Left
+																											D3DXVECTOR3(x1, 0.0f, z0),		// Bottom Right
+																											D3DXVECTOR3(x1, 0.0f, z1),		// Top Right
+																											D3DXVECTOR3(x0, 0.0f, z1),		// Top Left
+																											D3DXVECTOR3(0.0f, -1.0f, 0.0f), TextureScale);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Create a wall mesh for each wall segment, facing the open side of the cave
+	for (unsigned int i = 0; i < Segments.size(); i++)
+	{
+		CaveGeneratorClass::CaveSegment &Segment = Segments[i];
+		D3DXVECTOR3 Start, End, Normal;
+
+		if (Segment.AlongX)
+		{
+			float z = OriginZ + (Segment.Line * CellSize);
+			float x0 = OriginX + (Segment.Start * CellSize);
+			float x1 = OriginX + (Segment.End * CellSize);
+
+			// Open below the wall faces the same way as a north wall, open above faces the same way as a south wall
+			if (Segment.OpenSide == CAVE_SIDE_DOWN)
+			{
+				Start = D3DXVECTOR3(x0, 0.0f, z);
+				End = D3DXVECTOR3(x1, 0.0f, z);
+				Normal = D3DXVECTOR3(0.0f, 0.0f, -1.0f);
+			}
+			else
+			{
+				Start = D3DXVECTOR3(x1, 0.0f, z);
+				End = D3DXVECTOR3(x0, 0.0f, z);
+				Normal = D3DXVECTOR3(0.0f, 0.0f, 1.0f);
+			}
+		}
+		else
+		{
+			float x = OriginX + (Segment.Line * CellSize);
+			float z0 = OriginZ + (Segment.Start * CellSize);
+			float z1 = OriginZ + (Segment.End * CellSize);
+
+			// Open to the left of the wall faces the same way as an east wall, open to the right faces the same way as a west wall
+			if (Segment.OpenSide == CAVE_SIDE_LEFT)
+			{
+				Start = D3DXVECTOR3(x, 0.0f, z1);
+				End = D3DXVECTOR3(x, 0.0f, z0);
+				Normal = D3DXVECTOR3(-1.0f, 0.0f, 0.0f);
+			}
+			else
+			{
+				Start = D3DXVECTOR3(x, 0.0f, z0);
+				End = D3DXVECTOR3(x, 0.0f, z1);
+				Normal = D3DXVECTOR3(1.0f, 0.0f, 0.0f);
+			}
+		}
+
+		// Repeat the texture along the length of the wall so short walls aren't stretched
+		float Length = (Segment.End - Segment.Start) * CellSize;
+		D3DXVECTOR2 TextureScale = D3DXVECTOR2(Length, 2.0f);
+
+		MeshClass* Wall = new MeshClass();
+		if (!Wall)
+		{
+			return false;
+		}
+		m_CaveWalls.push_back(Wall);
+
+		result = Wall->Initialize(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, L"data/stone_walls.png",	Start,										// Bottom Left
+																										D3DXVECTOR3(Start.x, 1.5f, Start.z),		// Top Left
+																										D3DXVECTOR3(End.x, 1.5f, End.z),			// Top Right
+																										End,										// Bottom Right
+																										Normal, TextureScale);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// Function:		Place Prefab function
+// What it does:	Picks a prefab template with a socket facing the given door of a piece and lines the socket up with the door.
+//					Checks the template's mask against the dungeon grid, and if it is free fills in the grid, adds the door to the piece
+//					and adds an instance of the template. Prefab rooms are dead ends, so their other sockets are plugged
+// Takes in:		DungeonPieceClass - pointer to the piece the prefab leads off, int - Door direction (LEFT, RIGHT, UP, DOWN)
+// Returns:			True if a prefab room was placed, false if there wasn't room for it
+
+bool DungeonClass::PlacePrefab(DungeonPieceClass* Piece, int DoorNumber)
+{
+	int TemplateIndex = 0;
+	int SocketIndex = 0;
+
+	// The prefab needs a socket on the side facing the piece, and the door is in the middle of the piece's side (in layout units)
+	int Side = 0;
+	int Door_x = Piece->m_LayoutX;
+	int Door_y = Piece->m_LayoutY;
+	if (DoorNumber == LEFT)
+	{
+		Side = PREFAB_SIDE_RIGHT;
+		Door_x -= (Piece->m_LayoutWidth * LAYOUT_UNITS_PER_TENTH) / 2;
+	}
+	if (DoorNumber == RIGHT)
+	{
+		Side = PREFAB_SIDE_LEFT;
+		Door_x += (Piece->m_LayoutWidth * LAYOUT_UNITS_PER_TENTH) / 2;
+	}
+	if (DoorNumber == UP)
+	{
+		Side = PREFAB_SIDE_DOWN;
+		Door_y += (Piece->m_LayoutHeight * LAYOUT_UNITS_PER_TENTH) / 2;
+	}
+	if (DoorNumber == DOWN)
+	{
+		Side = PREFAB_SIDE_UP;
+		Door_y -= (Piece->m_LayoutHeight * LAYOUT_UNITS_PER_TENTH) / 2;
+	}
+
+	if (!m_PrefabLibrary->PickSocket(Side, TemplateIndex, SocketIndex))
+	{
+		return false;
+	}
+
+	// Find where the socket is in the template, and place the template so the socket is on the door
+	PrefabLibraryClass::Template* Prefab = m_PrefabLibrary->GetTemplate(TemplateIndex);
+	PrefabLibraryClass::Socket &PrefabSocket = Prefab->Sockets[SocketIndex];
+	int CellUnits = PREFAB_CELL_SIZE * LAYOUT_UNITS_PER_UNIT;
+	int CellSize = CellUnits / m_LayoutUnitsPerCell;
+	int SocketCenter = (PrefabSocket.Cell * CellUnits) + (CellUnits / 2);
+	int Socket_x = 0;
+	int Socket_y = SocketCenter;
+	if (Side == PREFAB_SIDE_RIGHT)
+	{
+		Socket_x = Prefab->Width * CellUnits;
+	}
+	if ((Side == PREFAB_SIDE_DOWN) || (Side == PREFAB_SIDE_UP))
+	{
+		Socket_x = SocketCenter;
+		Socket_y = (Side == PREFAB_SIDE_UP) ? Prefab->Height * CellUnits : 0;
+	}
+	int Origin_x = Door_x - Socket_x;
+	int Origin_y = Door_y - Socket_y;
+
+	// Check the inside of each floor cell of the mask is free in the same way as CheckGrid. If the prefab goes outside of the grid
+	// it isn't placed, so that a normal room can be tried instead
+	int Start_x = FloorDivide(Origin_x, m_LayoutUnitsPerCell) + m_GridOffsetX;
+	int Start_y = FloorDivide(Origin_y, m_LayoutUnitsPerCell) + m_GridOffsetZ;
+	if ((!InBounds(Start_x, Start_y)) || (!InBounds(Start_x + (Prefab->Width * CellSize), Start_y + (Prefab->Height * CellSize))))
+	{
+		return false;
+	}
+
+	for (int y = 0; y < Prefab->Height; y++)
+	{
+		for (int x = 0; x < Prefab->Width; x++)
+		{
+			if (!m_PrefabLibrary->IsOccupied(TemplateIndex, x, y))
+			{
+				continue;
+			}
+
+			int Cell_x = Start_x + (x * CellSize);
+			int Cell_y = Start_y + (y * CellSize);
+			if (!m_Occupancy->IsEmpty(Cell_x + 1, Cell_y + 1, Cell_x + CellSize - 1, Cell_y + CellSize - 1))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Fill in each run of floor cells along a row of the mask so the grid knows the prefab is there
+	for (int y = 0; y < Prefab->Height; y++)
+	{
+		int x = 0;
+		while (x < Prefab->Width)
+		{
+			if (!m_PrefabLibrary->IsOccupied(TemplateIndex, x, y))
+			{
+				x++;
+				continue;
+			}
+
+			int RunStart = x;
+			while ((x < Prefab->Width) && m_PrefabLibrary->IsOccupied(TemplateIndex, x, y))
+			{
+				x++;
+			}
+			FillGridArea(Start_x + (RunStart * CellSize), Start_y + (y * CellSize), Start_x + (x * CellSize), Start_y + ((y + 1) * CellSize));
+		}
+	}
+
+	// Add the prefab to the graph, the door between the piece and the prefab, and the instance of the template
+	D3DXVECTOR2 PrefabCenter = D3DXVECTOR2(LayoutToWorld(Origin_x + ((Prefab->Width * CellUnits) / 2)), LayoutToWorld(Origin_y + ((Prefab->Height * CellUnits) / 2)));
+	int PrefabNode = m_Graph->AddNode(GRAPH_NODE_PREFAB, 0, PrefabCenter);
+	if (!AddDoor(Piece, DoorNumber, PrefabNode))
+	{
+		return false;
+	}
+
+	PrefabLibraryClass::Instance NewInstance;
+	NewInstance.Template = TemplateIndex;
+	NewInstance.Origin = D3DXVECTOR2(LayoutToWorld(Origin_x), LayoutToWorld(Origin_y));
+	NewInstance.OpenSocket = SocketIndex;
+	m_PrefabInstances.push_back(NewInstance);
+
+	return true;
+}
+
+
+// Function:		Add Door function
+// What it does:	Updates a piece so that it will draw a wall with a door on the given side, and creates the door sprite for the map.
+//					Used when something other than a new dungeon piece (a cave, a prefab room or a piece the door closes a loop
+//					with) is behind the door
+// Takes in:		DungeonPieceClass - pointer to the piece, int - Door direction (LEFT, RIGHT, UP, DOWN), int - Index of the
+//					graph node behind the door
+// Returns:			True if the door was created, false if not
+
+bool DungeonClass::AddDoor(DungeonPieceClass* Piece, int DoorNumber, int Node)
+{
+	// Update the piece so that it will draw a wall with a door in it
+	if (DoorNumber == LEFT)
+	{
+		Piece->m_LDoor = true;
+	}
+	if (DoorNumber == RIGHT)
+	{
+		Piece->m_RDoor = true;
+	}
+	if (DoorNumber == UP)
+	{
+		Piece->m_UDoor = true;
+	}
+	if (DoorNumber == DOWN)
+	{
+		Piece->m_DDoor = true;
+	}
+
+	// Create the door sprite for the map in the same way as PlaceNextPiece. The door position is found from the side of this piece,
+	// which is the opposite side to the one GetDoorPosition would use for a new piece
+	int OppositeDoor = 0;
+	if ((DoorNumber == LEFT) || (DoorNumber == RIGHT))
+	{
+		m_WidthHeight = D3DXVECTOR2(0.55f, 1.1f);
+		m_DoorDirection = VERTICAL_DOOR;
+		OppositeDoor = (DoorNumber == LEFT) ? RIGHT : LEFT;
+	}
+	else
+	{
+		m_WidthHeight = D3DXVECTOR2(1.1f, 0.55f);
+		m_DoorDirection = HORIZONTAL_DOOR;
+		OppositeDoor = (DoorNumber == UP) ? DOWN : UP;
+	}
+
+	DungeonPieceClass* NewDoor = new DungeonPieceClass(DungeonPieceClass::DOOR, m_DoorDirection);
+	if (!NewDoor)
+	{
+		return false;
+	}
+
+	m_DoorPosition = NewDoor->GetDoorPosition(OppositeDoor, Piece);
+	NewDoor->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, m_DoorPosition, m_WidthHeight.x, m_WidthHeight.y, 0);
+	m_DoorPieces.push_back(NewDoor);
+
+	m_Graph->AddConnection(Piece->m_GraphNode, Node, DoorNumber, NewDoor);
+
+	return true;
+}
+
+
+// Function:		Connect Layout Pieces function
+// What it does:	Adds the doors of the pieces made by a layout generator to the graph, joining each right and top door to the
+//					piece whose left or bottom edge meets it
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonClass::ConnectLayoutPieces()
+{
+	for (unsigned int i = 0; i < m_LayoutDoors.size(); i++)
+	{
+		DungeonPieceClass* Piece = m_LayoutDoors[i].Piece;
+		bool Right = (m_LayoutDoors[i].Direction == RIGHT);
+
+		// The door is in the middle of the right or top edge of the piece, in layout units. Half a size in tenths is the same
+		// number of layout units
+		int Door_x = Right ? Piece->m_LayoutX + Piece->m_LayoutWidth : Piece->m_LayoutX;
+		int Door_y = Right ? Piece->m_LayoutY : Piece->m_LayoutY + Piece->m_LayoutHeight;
+
+		// Find the piece with a door on its left or bottom edge at the same place. The layout of these pieces was rounded from
+		// world space, so the edges are allowed to be a layout unit apart
+		for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
+		{
+			DungeonPieceClass* Other = *thisObject;
+			if (Right && Other->m_LDoor && (abs((Other->m_LayoutX - Other->m_LayoutWidth) - Door_x) <= 1) &&
+				(abs(Other->m_LayoutY - Door_y) <= Other->m_LayoutHeight))
+			{
+				m_Graph->AddConnection(Piece->m_GraphNode, Other->m_GraphNode, RIGHT, m_LayoutDoors[i].Door);
+				break;
+			}
+			if ((!Right) && Other->m_DDoor && (abs((Other->m_LayoutY - Other->m_LayoutHeight) - Door_y) <= 1) &&
+				(abs(Other->m_LayoutX - Door_x) <= Other->m_LayoutWidth))
+			{
+				m_Graph->AddConnection(Piece->m_GraphNode, Other->m_GraphNode, UP, m_LayoutDoors[i].Door);
+				break;
+			}
+		}
+	}
+
+	m_LayoutDoors.clear();
+}
+
+
+// Function:		Close Loops function
+// What it does:	Finds the pairs of pieces sharing a long enough wall by sorting the sides of the pieces along each line and
+//					sweeping along them, and adds doors between the pairs furthest apart in the graph, up to the loop budget.
+//					Called once the layout is made and the graph is built, before the walls are built
+// Takes in:		Nothing
+// Returns:			True if successful, false if a door couldn't be created
+
+bool DungeonClass::CloseLoops()
+{
+	if ((m_LoopBudget <= 0) || (!m_EntrancePiece) || (m_EntrancePiece->m_GraphNode < 0))
+	{
+		return true;
+	}
+
+	// Collect the sides of the pieces that don't have a door yet. Half a size in tenths is the same number of layout units
+	vector<LoopWall> RightWalls, LeftWalls, TopWalls, BottomWalls;
+	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
+	{
+		DungeonPieceClass* Piece = *thisObject;
+		LoopWall Wall;
+		Wall.Piece = Piece;
+
+		Wall.Start = Piece->m_LayoutY - Piece->m_LayoutHeight;
+		Wall.End = Piece->m_LayoutY + Piece->m_LayoutHeight;
+		if (!Piece->m_RDoor)
+		{
+			Wall.Line = Piece->m_LayoutX + Piece->m_LayoutWidth;
+			RightWalls.push_back(Wall);
+		}
+		if (!Piece->m_LDoor)
+		{
+			Wall.Line = Piece->m_LayoutX - Piece->m_LayoutWidth;
+			LeftWalls.push_back(Wall);
+		}
+
+		Wall.Start = Piece->m_LayoutX - Piece->m_LayoutWidth;
+		Wall.End = Piece->m_LayoutX + Piece->m_LayoutWidth;
+		if (!Piece->m_UDoor)
+		{
+			Wall.Line = Piece->m_LayoutY + Piece->m_LayoutHeight;
+			TopWalls.push_back(Wall);
+		}
+		if (!Piece->m_DDoor)
+		{
+			Wall.Line = Piece->m_LayoutY - Piece->m_LayoutHeight;
+			BottomWalls.push_back(Wall);
+		}
+	}
+
+	// Sort the sides along each line, so the sides facing each other can be swept along together
+	std::sort(RightWalls.begin(), RightWalls.end(), CompareLoopWalls);
+	std::sort(LeftWalls.begin(), LeftWalls.end(), CompareLoopWalls);
+	std::sort(TopWalls.begin(), TopWalls.end(), CompareLoopWalls);
+	std::sort(BottomWalls.begin(), BottomWalls.end(), CompareLoopWalls);
+
+	// Find the number of doors between the pieces of each pair through the tree of shortest paths from the entrance
+	m_Graph->BuildTree(m_EntrancePiece->m_GraphNode);
+	vector<LoopCandidate> Candidates;
+	FindSharedWalls(RightWalls, LeftWalls, RIGHT, Candidates);
+	FindSharedWalls(TopWalls, BottomWalls, UP, Candidates);
+
+	// Add doors to the pairs furthest apart first. Each piece gets at most one of these doors, so the loops are spread out
+	std::sort(Candidates.begin(), Candidates.end(), CompareLoopCandidates);
+	vector<bool> Joined(m_Graph->GetNodeCount(), false);
+	int DoorsAdded = 0;
+	for (unsigned int i = 0; (i < Candidates.size()) && (DoorsAdded < m_LoopBudget); i++)
+	{
+		if ((Joined[Candidates[i].First->m_GraphNode]) || (Joined[Candidates[i].Second->m_GraphNode]))
+		{
+			continue;
+		}
+
+		if (!AddLoopDoor(Candidates[i]))
+		{
+			return false;
+		}
+		Joined[Candidates[i].First->m_GraphNode] = true;
+		Joined[Candidates[i].Second->m_GraphNode] = true;
+		DoorsAdded++;
+	}
+
+	// Sort the new doors into the graph
+	if (DoorsAdded > 0)
+	{
+		m_Graph->Build();
+	}
+
+	return true;
+}
+
+
+// Function:		Find Shared Walls function
+// What it does:	Sweeps along two sorted lists of sides facing each other and adds each pair sharing a long enough wall to the
+//					candidates. The sides in each list don't overlap, so this takes time in the length of the lists
+// Takes in:		LoopWall - references to the right (or top) sides and the left (or bottom) sides, int - Side of the first piece
+//					(RIGHT or UP), LoopCandidate - reference to the list of candidates
+// Returns:			Nothing
+
+void DungeonClass::FindSharedWalls(vector<LoopWall> &Low, vector<LoopWall> &High, int Direction, vector<LoopCandidate> &Candidates)
+{
+	unsigned int i = 0;
+	unsigned int j = 0;
+	while ((i < Low.size()) && (j < High.size()))
+	{
+		LoopWall &First = Low[i];
+		LoopWall &Second = High[j];
+
+		// Move past whichever side is behind the other, either on an earlier line or ending before the other starts
+		if ((First.Line < Second.Line) || ((First.Line == Second.Line) && (First.End <= Second.Start)))
+		{
+			i++;
+			continue;
+		}
+		if ((Second.Line < First.Line) || (Second.End <= First.Start))
+		{
+			j++;
+			continue;
+		}
+
+		// The sides are on the same line and overlap, so the pieces share the wall between the later start and earlier end
+		int Start = (First.Start > Second.Start) ? First.Start : Second.Start;
+		int End = (First.End < Second.End) ? First.End : Second.End;
+		if (End - Start >= LOOP_MIN_SHARED_WALL)
+		{
+			int Distance = m_Graph->GetTreeDistance(First.Piece->m_GraphNode, Second.Piece->m_GraphNode);
+			if (Distance >= LOOP_MIN_DISTANCE)
+			{
+				LoopCandidate Candidate;
+				Candidate.First = First.Piece;
+				Candidate.Second = Second.Piece;
+				Candidate.Direction = Direction;
+				Candidate.DoorCenter = FloorDivide(Start + End, 2);
+				Candidate.Distance = Distance;
+				Candidate.Order = (int)Candidates.size();
+				Candidates.push_back(Candidate);
+			}
+		}
+
+		// The side that ends first can't overlap anything further along the line
+		if (First.End < Second.End)
+		{
+			i++;
+		}
+		else
+		{
+			j++;
+		}
+	}
+}
+
+
+// Function:		Add Loop Door function
+// What it does:	Adds a door in the middle of the wall shared by the pieces of a candidate, on both pieces
+// Takes in:		LoopCandidate - reference to the candidate
+// Returns:			True if the door was created, false if not
+
+bool DungeonClass::AddLoopDoor(LoopCandidate &Candidate)
+{
+	DungeonPieceClass* First = Candidate.First;
+	DungeonPieceClass* Second = Candidate.Second;
+
+	// Move the door of both sides to the middle of the shared wall, so the gaps in the two walls line up
+	float DoorCenter = LayoutToWorld(Candidate.DoorCenter);
+	if (Candidate.Direction == RIGHT)
+	{
+		First->m_RDoorOffset = DoorCenter - First->m_Center.y;
+		Second->m_LDoorOffset = DoorCenter - Second->m_Center.y;
+		Second->m_LDoor = true;
+	}
+	else
+	{
+		First->m_UDoorOffset = DoorCenter - First->m_Center.x;
+		Second->m_DDoorOffset = DoorCenter - Second->m_Center.x;
+		Second->m_DDoor = true;
+	}
+
+	// Add the door to the first piece, with the door sprite and the connection in the graph
+	return AddDoor(First, Candidate.Direction, Second->m_GraphNode);
+}
+
+
+// Function:		Compare Loop Walls function
+// What it does:	Orders sides by their line and then by where they start, for sorting
+// Takes in:		LoopWall - references to the two sides
+// Returns:			True if the first side comes first
+
+bool DungeonClass::CompareLoopWalls(const LoopWall &First, const LoopWall &Second)
+{
+	if (First.Line != Second.Line)
+	{
+		return First.Line < Second.Line;
+	}
+
+	return First.Start < Second.Start;
+}
+
+
+// Function:		Compare Loop Candidates function
+// What it does:	Orders candidates by the most doors between their pieces first, then by the order they were found in
+// Takes in:		LoopCandidate - references to the two candidates
+// Returns:			True if the first candidate comes first
+
+bool DungeonClass::CompareLoopCandidates(const LoopCandidate &First, const LoopCandidate &Second)
+{
+	if (First.Distance != Second.Distance)
+	{
+		return First.Distance > Second.Distance;
+	}
+
+	return First.Order < Second.Order;
+}
+
+
+// Function:		Merge Walls function
+// What it does:	Sorts the walls of every piece along the lines they are on and sweeps along each line. The collision segments
+//					of walls that overlap or meet are joined whichever way they face, so a wall between two pieces (one wall
+//					facing into each piece) is one segment. Walls facing the same way with the same texture are joined where
+//					they overlap or meet, as the texture is placed from where each wall is along its line and so carries on
+//					across the join, and a wall inside another facing the same way is dropped. Walls back to back are both kept
+//					to be drawn, as each is only seen from the piece it faces into
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonClass::MergeWalls()
+{
+	// Take the walls off every piece, finding the line each is on in layout units so walls on the same line match exactly
+	vector<MergeWall> Walls;
+	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
+	{
+		DungeonPieceClass* Piece = *thisObject;
+		vector<DungeonPieceClass::Wall>* PieceWalls = Piece->GetWalls();
+		for (unsigned int i = 0; i < PieceWalls->size(); i++)
+		{
+			MergeWall Wall;
+			Wall.Piece = Piece;
+			Wall.Wall = (*PieceWalls)[i];
+
+			D3DXVECTOR2 Start = Wall.Wall.Start;
+			D3DXVECTOR2 End = Wall.Wall.End;
+			Wall.AlongXAxis = (WorldToLayout(Start.x) != WorldToLayout(End.x));
+			Wall.Line = WorldToLayout(Wall.AlongXAxis ? Start.y : Start.x);
+			Wall.Facing = ((Wall.AlongXAxis ? Wall.Wall.Normal.z : Wall.Wall.Normal.x) > 0.0f) ? 1 : -1;
+			Wall.Start = WorldToLayout(Wall.AlongXAxis ? Start.x : Start.y);
+			Wall.End = WorldToLayout(Wall.AlongXAxis ? End.x : End.y);
+			if (Wall.End < Wall.Start)
+			{
+				std::swap(Wall.Start, Wall.End);
+			}
+			Walls.push_back(Wall);
+		}
+		PieceWalls->clear();
+	}
+
+	// Join the collision segments of every wall on the same line that overlap or meet, whichever way they face
+	m_WallSegments.clear();
+	std::sort(Walls.begin(), Walls.end(), CompareWallLines);
+	for (unsigned int i = 0; i < Walls.size();)
+	{
+		// Keep the segment with its ends in increasing order along the line, as the collision grid is filled that way
+		DungeonPieceClass::WallSegment Segment;
+		Segment.AlongXAxis = Walls[i].AlongXAxis;
+		bool Reversed = Segment.AlongXAxis ? (Walls[i].Wall.End.x < Walls[i].Wall.Start.x) : (Walls[i].Wall.End.y < Walls[i].Wall.Start.y);
+		Segment.Start = Reversed ? Walls[i].Wall.End : Walls[i].Wall.Start;
+		Segment.End = Reversed ? Walls[i].Wall.Start : Walls[i].Wall.End;
+		int SegmentEnd = Walls[i].End;
+
+		unsigned int j = i + 1;
+		while ((j < Walls.size()) && (Walls[j].AlongXAxis == Walls[i].AlongXAxis) && (Walls[j].Line == Walls[i].Line) && (Walls[j].Start <= SegmentEnd))
+		{
+			if (Walls[j].End > SegmentEnd)
+			{
+				bool NextReversed = Segment.AlongXAxis ? (Walls[j].Wall.End.x < Walls[j].Wall.Start.x) : (Walls[j].Wall.End.y < Walls[j].Wall.Start.y);
+				Segment.End = NextReversed ? Walls[j].Wall.Start : Walls[j].Wall.End;
+				SegmentEnd = Walls[j].End;
+			}
+			j++;
+		}
+
+		m_WallSegments.push_back(Segment);
+		i = j;
+	}
+
+	// Join the walls facing the same way on each line and give each back to the piece it came from (the piece of the first wall
+	// for joined walls, as the batch finds the bounds of each piece's walls from their corners)
+	std::sort(Walls.begin(), Walls.end(), CompareMergeWalls);
+	for (unsigned int i = 0; i < Walls.size();)
+	{
+		MergeWall Current = Walls[i];
+
+		unsigned int j = i + 1;
+		while ((j < Walls.size()) && (Walls[j].AlongXAxis == Current.AlongXAxis) && (Walls[j].Line == Current.Line) && (Walls[j].Facing == Current.Facing))
+		{
+			MergeWall &Next = Walls[j];
+
+			// A wall inside the current one facing the same way is drawn over by it already
+			if (Next.End <= Current.End)
+			{
+				j++;
+				continue;
+			}
+
+			if ((Next.Start > Current.End) || (wcscmp(Current.Piece->GetWallTextureFile(), Next.Piece->GetWallTextureFile()) != 0))
+			{
+				break;
+			}
+
+			// Walls facing the same way run in the same direction, so the current wall is carried on to the far end of the next
+			// one, at its End if the walls run up the line and its Start if they run down it. Only the position along the line is
+			// taken, as the line of each piece's walls can be a rounding error apart in the world
+			bool RunsUpLine = Current.AlongXAxis ? (Current.Wall.End.x > Current.Wall.Start.x) : (Current.Wall.End.y > Current.Wall.Start.y);
+			D3DXVECTOR2 &FarEnd = RunsUpLine ? Current.Wall.End : Current.Wall.Start;
+			D3DXVECTOR2 NextFarEnd = RunsUpLine ? Next.Wall.End : Next.Wall.Start;
+			if (Current.AlongXAxis)
+			{
+				FarEnd.x = NextFarEnd.x;
+			}
+			else
+			{
+				FarEnd.y = NextFarEnd.y;
+			}
+			Current.End = Next.End;
+			j++;
+		}
+
+		Current.Piece->GetWalls()->push_back(Current.Wall);
+		i = j;
+	}
+}
+
+
+// Function:		Compare Wall Lines function
+// What it does:	Orders walls by their line and then by where they start, for sorting
+// Takes in:		MergeWall - references to the two walls
+// Returns:			True if the first wall comes first
+
+bool DungeonClass::CompareWallLines(const MergeWall &First, const MergeWall &Second)
+{
+	if (First.AlongXAxis != Second.AlongXAxis)
+	{
+		return First.AlongXAxis;
+	}
+
+	if (First.Line != Second.Line)
 	{
-		// The left door of this room isn't available to create a new room because this is the parent room
-		NewPiece->m_LAvailable = false;
-		// There is a left door in this room so update so room knows to build a wall with a door here
-		NewPiece->m_LDoor = true;
+		return First.Line < Second.Line;
 	}
 
-	// If the room has been made to the left of the parent piece
-	if (Direction == UP)
+	return First.Start < Second.Start;
+}
+
+
+// Function:		Compare Merge Walls function
+// What it does:	Orders walls by their line, then by the way they face, then by where they start, for sorting
+// Takes in:		MergeWall - references to the two walls
+// Returns:			True if the first wall comes first
+
+bool DungeonClass::CompareMergeWalls(const MergeWall &First, const MergeWall &Second)
+{
+	if ((First.AlongXAxis != Second.AlongXAxis) || (First.Line != Second.Line))
 	{
-		// The bottom door of this room isn't available to create a new room because this is the parent room
-		NewPiece->m_DAvailable = false;
-		// There is a bottom door in this room so update so the room knows to build a wall with a door here
-		NewPiece->m_DDoor = true;
+		return CompareWallLines(First, Second);
 	}
 
-	// If the room has been made to the left of the parent piece
-	if (Direction == DOWN)
+	if (First.Facing != Second.Facing)
 	{
-		// The top door of this room isn't available to create a new room because this is the parent room
-		NewPiece->m_UAvailable = false;
-		// There is a top door in this room so update so the room knows to build a wall with a door here
-		NewPiece->m_UDoor = true;
+		return First.Facing < Second.Facing;
 	}
+
+	return First.Start < Second.Start;
 }
 
 
-// Function:		Shutdown function
-// What it does:	Releases all objects when the application ends and deletes them, cleans resources
+// Function:		Place Wave Collapse Pieces function
+// What it does:	Builds the dungeon from a wave collapse tile map instead of placing pieces one at a time. Each tile is a room
+//					or corridor with doors on the sides its sockets are open, and the tile in the middle of the map is the entrance.
+//					Creates a dungeon piece and door sprites for each tile that can be reached from the entrance
 // Takes in:		Nothing
-// Returns:			Nothing
-void DungeonClass::Shutdown()
+// Returns:			True if the dungeon was built, false if the wave collapse couldn't find a map within its limits
+
+bool DungeonClass::PlaceWaveCollapsePieces()
 {
-	// Release dungeon pieces by iterating through the list and deleting each
-	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
-	{
-		DungeonPieceClass* Piece = *thisObject;
-		Piece->Shutdown();
-		delete Piece;
-	}
+	WaveCollapseClass Wave;
+	DungeonPieceClass::m_PieceType TileTypes[WAVE_MAX_TILES];
+	int EntranceTile = 0;
 
-	if (!m_DungeonPieces.empty())
+	if (!Wave.Initialise(WAVE_MAP_SIZE, WAVE_MAP_SIZE))
 	{
-		m_DungeonPieces.clear();
+		return false;
 	}
 
-	// Release ceiling pieces by iterating through the list and deleting each
-	for (auto thisObject = m_CeilingPieces.begin(); thisObject != m_CeilingPieces.end(); ++thisObject)
+	// Create the tile set - an empty tile, a room for every combination of doors, and a corridor in each direction
+	TileTypes[Wave.AddTile(0, WAVE_EMPTY_WEIGHT)] = DungeonPieceClass::INIT;
+	for (int Sockets = 1; Sockets < 16; Sockets++)
 	{
-		DungeonPieceClass* CeilingPiece = *thisObject;
-		CeilingPiece->Shutdown();
-		delete CeilingPiece;
+		int Tile = Wave.AddTile(Sockets, WAVE_ROOM_WEIGHT);
+		TileTypes[Tile] = DungeonPieceClass::ROOM;
+
+		// The entrance is the room with a door on every side, like the entrance made by the piece generator
+		if (Sockets == (WAVE_SOCKET_LEFT | WAVE_SOCKET_UP | WAVE_SOCKET_RIGHT | WAVE_SOCKET_DOWN))
+		{
+			EntranceTile = Tile;
+		}
 	}
+	TileTypes[Wave.AddTile(WAVE_SOCKET_LEFT | WAVE_SOCKET_RIGHT, WAVE_CORRIDOR_WEIGHT)] = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+	TileTypes[Wave.AddTile(WAVE_SOCKET_UP | WAVE_SOCKET_DOWN, WAVE_CORRIDOR_WEIGHT)] = DungeonPieceClass::VERTICAL_CORRIDOR;
 
-	if (!m_CeilingPieces.empty())
+	// Put the entrance in the middle of the map and collapse the rest of the tiles around it
+	int Middle = WAVE_MAP_SIZE / 2;
+	Wave.Reset();
+	if (!Wave.SetTile(Middle, Middle, EntranceTile))
 	{
-		m_CeilingPieces.clear();
+		return false;
 	}
 
-	// Release door pieces by iterating through the list and deleting each
-	for (auto thisObject = m_DoorPieces.begin(); thisObject != m_DoorPieces.end(); ++thisObject)
+	if (Wave.Run(WAVE_BACKTRACK_LIMIT, WAVE_TIMEOUT_MS) != WAVE_SOLVED)
 	{
-		DungeonPieceClass* DoorPiece = *thisObject;
-		DoorPiece->Shutdown();
-		delete DoorPiece;
+		return false;
 	}
 
-	if (!m_DoorPieces.empty())
+	// Find the tiles that can be reached from the entrance by walking through open sockets. Sockets always match their
+	// neighbour, so any tiles that can't be reached form closed off groups and are left out
+	int SideX[4] = { -1, 0, 1, 0 };
+	int SideY[4] = { 0, 1, 0, -1 };
+	vector<bool> Visited(WAVE_MAP_SIZE * WAVE_MAP_SIZE, false);
+	vector<int> Reached;
+	Reached.push_back((Middle * WAVE_MAP_SIZE) + Middle);
+	Visited[Reached[0]] = true;
+
+	for (unsigned int i = 0; i < Reached.size(); i++)
 	{
-		m_DoorPieces.clear();
+		int x = Reached[i] % WAVE_MAP_SIZE;
+		int y = Reached[i] / WAVE_MAP_SIZE;
+		int Sockets = Wave.GetTileSockets(Wave.GetTile(x, y));
+
+		for (int Side = 0; Side < 4; Side++)
+		{
+			int Cell = ((y + SideY[Side]) * WAVE_MAP_SIZE) + x + SideX[Side];
+			if ((Sockets & (1 << Side)) && (!Visited[Cell]))
+			{
+				Visited[Cell] = true;
+				Reached.push_back(Cell);
+			}
+		}
 	}
 
-	// Release player mesh object
-	if (m_PlayerMesh)
+	// Create a dungeon piece for each tile that was reached, starting with the entrance
+	for (unsigned int i = 0; i < Reached.size(); i++)
 	{
-		delete m_PlayerMesh;
-		m_PlayerMesh = 0;
+		int x = Reached[i] % WAVE_MAP_SIZE;
+		int y = Reached[i] / WAVE_MAP_SIZE;
+		int Tile = Wave.GetTile(x, y);
+		int Sockets = Wave.GetTileSockets(Tile);
+		DungeonPieceClass::m_PieceType NewPieceType = (i == 0) ? DungeonPieceClass::ENTRANCE : TileTypes[Tile];
+
+		// Rooms fill the whole tile, corridors run through the middle of it so their ends meet the sides of the tile
+		D3DXVECTOR2 Center = D3DXVECTOR2((x - Middle) * WAVE_TILE_SIZE, (y - Middle) * WAVE_TILE_SIZE);
+		D3DXVECTOR2 Size = D3DXVECTOR2(WAVE_TILE_SIZE, WAVE_TILE_SIZE);
+		if (NewPieceType == DungeonPieceClass::HORIZONTAL_CORRIDOR)
+		{
+			Size.y = WAVE_CORRIDOR_WIDTH;
+		}
+		if (NewPieceType == DungeonPieceClass::VERTICAL_CORRIDOR)
+		{
+			Size.x = WAVE_CORRIDOR_WIDTH;
+		}
+
+		// The doors of the piece come from the sockets of the tile
+		DungeonPieceClass* NewPiece = CreateLayoutPiece(NewPieceType, Center, Size, (Sockets & WAVE_SOCKET_LEFT) != 0, (Sockets & WAVE_SOCKET_UP) != 0,
+														(Sockets & WAVE_SOCKET_RIGHT) != 0, (Sockets & WAVE_SOCKET_DOWN) != 0);
+		if (!NewPiece)
+		{
+			return false;
+		}
+
+		if (i == 0)
+		{
+			m_EntrancePiece = NewPiece;
+		}
 	}
+
+	ConnectLayoutPieces();
+
+	return true;
 }
 
 
-// Function:		Check Grid function
-// What it does:	It uses the new center, width and height of the new piece and checks to see if there is room available for it on the dungeon grid
-//					The value on the grid if not available will be 1, and value will be 0 if available
-//					If it doesn't return false, will fill in the grid for the new room 
-// Takes in:		float - Width value of new piece, float - Height value of new piece, D3DXVECTOR2 - Vector of center of new piece
-// Returns:			True if the dungeon piece using this width, height and center can be placed in the dungeon grid, false if not
+// Function:		Place Scatter Pieces function
+// What it does:	Builds the dungeon from a scatter generator layout instead of placing pieces one at a time. Rooms are scattered across
+//					an area of the grid and joined by corridors, with the first room at the centre as the entrance
+// Takes in:		Nothing
+// Returns:			True if the dungeon was built, false if the layout couldn't be made
 
-bool DungeonClass::CheckGrid(float Width, float Height, D3DXVECTOR2 Center)
+bool DungeonClass::PlaceScatterPieces()
 {
-	// Multiply these values by 10 to get them into the grid values
-	Width = Width * 10;
-	Height = Height * 10;
-	float Center_X = (Center.x) * 10;
-	float Center_Y = (Center.y) * 10;
-
-	// Get the grid values needed to check if this room can be placed in the dungeon grid
-	float HalfWidthLeft = floor(0.5 * Width);
-	float HalfWidthRight = (0.5 * Width);
-	float HalfHeight = (0.5 * Height);
-	int Start_x = (Center_X - HalfWidthLeft) + m_GridOffsetX;
-	int Start_y = (Center_Y - HalfHeight) + m_GridOffsetZ;
-	int End_x = (Center_X + HalfWidthRight) + m_GridOffsetX;
-	int End_y = (Center_Y + HalfHeight) + m_GridOffsetZ;
+	ScatterGeneratorClass Scatter;
 
-	// If the starting position is outside of the dungeon grid return false straight away
-	if (!InBounds(Start_x, Start_y))
+	if (!Scatter.Generate(SCATTER_AREA_SIZE, SCATTER_AREA_SIZE, SCATTER_ROOM_SPACING, SCATTER_CORRIDOR_WIDTH, SCATTER_MAX_ROOMS, SCATTER_EXTRA_EDGE_CHANCE))
 	{
-		DungeonFailed = true;
 		return false;
 	}
 
-	// Check from the start x value of the room's dimensions to the end x value
-	for (int i = Start_x + 1; i < End_x - 1; i++)
+	vector<ScatterGeneratorClass::ScatterPiece>* Pieces = Scatter.GetPieces();
+	for (unsigned int i = 0; i < Pieces->size(); i++)
 	{
-		// Check from the start y value of the room's dimensions to the y value
-		for (int j = Start_y + 1; j < End_y - 1; j++)
+		ScatterGeneratorClass::ScatterPiece &Piece = (*Pieces)[i];
+
+		// The first room is the entrance, and corners are made as small rooms so that they can have doors on any side
+		DungeonPieceClass::m_PieceType NewPieceType = DungeonPieceClass::ROOM;
+		if (i == 0)
 		{
-			// If the position in the dungeon grid returns 1, this means there is something there and the room can't be placed,
-			// therefore return false
-			if (InBounds(i, j))
-			{
-				if (DungeonGrid[i][j] == DUNGEON_ROOM)
-				{
-					return false;
-				}
-			}
-			else
-			{
-				// Dungeon grid too small for the dungeon to generate therefore need to exit program
-				DungeonFailed = true;
-				return false;
-			}
+			NewPieceType = DungeonPieceClass::ENTRANCE;
+		}
+		if (Piece.Type == SCATTER_PIECE_HORIZONTAL)
+		{
+			NewPieceType = DungeonPieceClass::HORIZONTAL_CORRIDOR;
+		}
+		if (Piece.Type == SCATTER_PIECE_VERTICAL)
+		{
+			NewPieceType = DungeonPieceClass::VERTICAL_CORRIDOR;
 		}
-	}
 
-	// If not, fill in data using these values so grid knows a new piece is there
-	for (int i = Start_x; i <= End_x; i++)
-	{
-		for (int j = Start_y; j <= End_y; j++)
+		DungeonPieceClass* NewPiece = CreateLayoutPiece(NewPieceType, D3DXVECTOR2(Piece.X, Piece.Y), D3DXVECTOR2(Piece.Width, Piece.Height),
+														(Piece.Doors & SCATTER_DOOR_LEFT) != 0, (Piece.Doors & SCATTER_DOOR_UP) != 0,
+														(Piece.Doors & SCATTER_DOOR_RIGHT) != 0, (Piece.Doors & SCATTER_DOOR_DOWN) != 0);
+		if (!NewPiece)
 		{
-			if (InBounds(i, j))
-			{
-				// Set the value in these positions within the dimensions of the new piece to show there is now something there
-				DungeonGrid[i][j] = DUNGEON_ROOM;
-			}
-			else
-			{
-				// Dungeon grid too small for the dungeon to generate therefore need to exit program
-				DungeonFailed = true;
-				return false;
-			}
+			return false;
+		}
+
+		if (i == 0)
+		{
+			m_EntrancePiece = NewPiece;
 		}
 	}
-	
-	// Return that the piece has been placed successfully
+
+	Scatter.Shutdown();
+	ConnectLayoutPieces();
+
 	return true;
 }
 
 
-// Function:		Set Chances function
-// What it does:	Changes the chances available for the dungeon as the depth of the dungeon increases
-//					It is called in PlaceNextPiece and changes the chance values based on the depth, to make it more likely or less likely
-//					That certain types of rooms will be created closer to the end of the dungeon
-// Takes in:		int - Depth value
-// Returns:			Nothing
+// Function:		Create Layout Piece function
+// What it does:	Creates a dungeon piece for a piece of a layout made by one of the generators. Fills in the grid for it,
+//					sets its doors so no more rooms are placed off it, and adds the door sprites for its right and top doors
+//					(so that a door shared by two pieces is only added once)
+// Takes in:		DungeonPieceClass::m_PieceType - Type of piece, D3DXVECTOR2 - Center of the piece, D3DXVECTOR2 - Width and height of the piece,
+//					bool - Doors on the left, top, right and bottom sides
+// Returns:			Pointer to the new dungeon piece, or 0 if it couldn't be created
 
-void DungeonClass::SetChances(int depth)
+DungeonPieceClass* DungeonClass::CreateLayoutPiece(DungeonPieceClass::m_PieceType Type, D3DXVECTOR2 Center, D3DXVECTOR2 Size, bool LDoor, bool UDoor, bool RDoor, bool DDoor)
 {
-	// If the depth reaches the max dungeon depth
-	if (depth == DUNGEON_DEPTH)
+	// The generators make their layouts in world space, so the grid is filled using the nearest layout position and size
+	int Center_x = WorldToLayout(Center.x);
+	int Center_y = WorldToLayout(Center.y);
+	int Width = (WorldToLayout(Size.x) + 1) / LAYOUT_UNITS_PER_TENTH;
+	int Height = (WorldToLayout(Size.y) + 1) / LAYOUT_UNITS_PER_TENTH;
+
+	// Fill in the grid for the piece so the player can walk in it
+	CheckGrid(Width, Height, Center_x, Center_y);
+	if (DungeonFailed)
 	{
-		// Reduce the chance for a corridor to 0, so that there aren't corridors at the end of the dungeon that don't lead to a room
-		m_CorridorChanceAftRoom = 0.0f;
-		m_CorridorChanceAftCorridor = 0.0f;
-		// Increase the chance for a corridor to 100%, so that at the end of the dungeon only rooms will be created
-		m_RoomChanceAftRoom = 100.0f;
-		m_RoomChanceAftCorridor = 100.0f;
-		// Room limit is set to 1 so that the room won't create a new room
-		m_RoomsLimit = 1.0f;
+		return 0;
 	}
-	else
+
+	DungeonPieceClass* NewPiece = new DungeonPieceClass(Type, 0);
+	if (!NewPiece)
 	{
-		// Set the chance for the corridors after a room to a number just above 50% to make it more likely a corridor 
-		// is made after a room
-		m_CorridorChanceAftRoom = 60;
+		return 0;
+	}
 
-		// Set the chance for a corridor after a corridor to 10T so that it is less likely to produce two corridors in a row
-		m_CorridorChanceAftCorridor = 10;
+	// The piece keeps the size and position the generator gave it, as its edges have to meet the pieces next to it
+	NewPiece->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, Center, Size.x, Size.y, 1);
+	NewPiece->m_LayoutX = Center_x;
+	NewPiece->m_LayoutY = Center_y;
+	NewPiece->m_LayoutWidth = Width;
+	NewPiece->m_LayoutHeight = Height;
+
+	// Set the doors from the layout. None of the doors are available because the layout already has every piece in it
+	NewPiece->m_LDoor = LDoor;
+	NewPiece->m_UDoor = UDoor;
+	NewPiece->m_RDoor = RDoor;
+	NewPiece->m_DDoor = DDoor;
+	NewPiece->m_LAvailable = false;
+	NewPiece->m_UAvailable = false;
+	NewPiece->m_RAvailable = false;
+	NewPiece->m_DAvailable = false;
+
+	m_DungeonPieces.push_back(NewPiece);
+	m_Graph->AddNode(GRAPH_NODE_PIECE, NewPiece, NewPiece->m_Center);
+
+	// Create the door sprites for the right and top doors, in the same positions as PlaceNextPiece uses. They are joined to the
+	// pieces on their other side in the graph once the whole layout has been made
+	LayoutDoor NewLayoutDoor;
+	NewLayoutDoor.Piece = NewPiece;
+	if (RDoor)
+	{
+		DungeonPieceClass* NewDoor = new DungeonPieceClass(DungeonPieceClass::DOOR, VERTICAL_DOOR);
+		if (!NewDoor)
+		{
+			return 0;
+		}
+		NewDoor->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, NewDoor->GetDoorPosition(LEFT, NewPiece), 0.55f, 1.1f, 0);
+		m_DoorPieces.push_back(NewDoor);
+		NewLayoutDoor.Direction = RIGHT;
+		NewLayoutDoor.Door = NewDoor;
+		m_LayoutDoors.push_back(NewLayoutDoor);
+	}
+	if (UDoor)
+	{
+		DungeonPieceClass* NewDoor = new DungeonPieceClass(DungeonPieceClass::DOOR, HORIZONTAL_DOOR);
+		if (!NewDoor)
+		{
+			return 0;
+		}
+		NewDoor->Initialise(m_Device, m_DeviceContext, m_TextureCache, m_BufferPool, NewDoor->GetDoorPosition(DOWN, NewPiece), 1.1f, 0.55f, 0);
+		m_DoorPieces.push_back(NewDoor);
+		NewLayoutDoor.Direction = UP;
+		NewLayoutDoor.Door = NewDoor;
+		m_LayoutDoors.push_back(NewLayoutDoor);
+	}
 
-		// Set the chance for a room after a room to a number just below 50% to make it less likely a room is made 
-		// after a room
-		m_RoomChanceAftRoom = 40;
+	return NewPiece;
+}
 
-		// Set the chance for a room after a corridor to 90% so that it is more likely to produce a room after a corridor is placed
-		m_RoomChanceAftCorridor = 90;
 
-		// Change the rooms limit to 3 so that less rooms are available to be created than at the start of the dungeon
-		m_RoomsLimit = 4.0f;
-	}
-	// If near the start of the dungeon, set the rooms limit to 4 so that the rooms will have more doors available at the start so
-	// dungeon will branch off nicely
-	if ((depth == 0) || (depth == 1))
+// Function:		Build Walls function
+// What it does:	Called in ApplicationClass once the dungeon is initialised. Builds the walls of every dungeon piece, then merges
+//					them with the walls of the pieces around them (see MergeWalls) and makes the wall segments for the collision grid
+// Takes in:		Nothing
+// Returns:			True if the walls were built, false if not
+
+bool DungeonClass::BuildWalls()
+{
+	bool result;
+
+	// Build the walls of each piece now that all of the rooms and doors have been set
+	for (auto thisObject = m_DungeonPieces.begin(); thisObject != m_DungeonPieces.end(); ++thisObject)
 	{
-		m_RoomsLimit = 4.0f;
+		result = (*thisObject)->BuildWalls();
+		if (!result)
+		{
+			return false;
+		}
 	}
+
+	MergeWalls();
+
+	return true;
+}
+
+
+// Function:		Get Wall Segments function
+// What it does:	Returns the wall segments made by BuildWalls, with the walls shared by neighbouring pieces and the walls
+//					running on from each other joined, so each part of the collision grid is only filled once
+// Takes in:		Nothing
+// Returns:			vector<WallSegment> - pointer to the segments
+
+vector<DungeonPieceClass::WallSegment> *DungeonClass::GetWallSegments()
+{
+	return &m_WallSegments;
 }
 
 
 // Function:		Fill Grid With Wall function
-// What it does:	This is called for each wall belonging to a dungeon piece in ApplicationClass when the walls have been created so that 
+// What it does:	This is called for each wall segment of a dungeon piece in ApplicationClass when the walls have been created so that 
 //					the walls are present in the dungeon grid and can be collided with. Uses the start and end positions of the wall to fill 
 //					in the information in the grid
-// Takes in:		MeshClass - Pointer to the wall mesh that is passed in so that it can be checked
+// Takes in:		WallSegment - reference to the wall segment that is passed in so that it can be checked
 // Returns:			Nothing
 
-void DungeonClass::FillGridWithWall(MeshClass *Wall)
+void DungeonClass::FillGridWithWall(DungeonPieceClass::WallSegment &Wall)
 {
-	float start = 0.0f;
-	float end = 0.0f;
+	int start = 0;
+	int end = 0;
 
 	// If this wall is placed along the X axis, use the x values to find the start and end positions in the grid
-	if (Wall->m_MeshAlongXAxis)
+	if (Wall.AlongXAxis)
 	{
-		// Multiply the positions by 10 to get them into the grid values (Because one cell in the grid represents 0.1)
-		// Add the Grid offset in order to get positions into a positive value to correspond to that element in the grid array
-		start = (Wall->m_StartPos.x * 10) + m_GridOffsetX;
-		end = (Wall->m_EndPos.x * 10) + m_GridOffsetX;
+		// Find the grid positions of the ends of the wall (Because one cell in the grid represents 0.1)
+		// The Grid offset is added in order to get positions into a positive value to correspond to that element in the grid array
+		start = WorldToGrid(Wall.Start.x, m_GridOffsetX);
+		end = WorldToGrid(Wall.End.x, m_GridOffsetX);
 		// Get the fixed z position of the wall so it can be used for the grid
-		int z_pos = (Wall->m_StartPos.z * 10) + m_GridOffsetZ;
+		int z_pos = WorldToGrid(Wall.Start.y, m_GridOffsetZ);
 		// Fill the grid so that the dungeon knows there is a collision here
 		for (int i = start; i <= end; i++)
 		{
@@ -693,14 +3158,13 @@ void DungeonClass::FillGridWithWall(MeshClass *Wall)
 	}
 
 	// Else if this wall is placed along the z axis, use the z values to find the start and end positions int he grid
-	else if (Wall->m_MeshAlongZAxis)
+	else
 	{
-		// Multiply the positions by 10 to get them into the grid values
-		start = (Wall->m_StartPos.z * 10) + m_GridOffsetZ;
-		end = (Wall->m_EndPos.z * 10) + m_GridOffsetZ;
+		// Find the grid positions of the ends of the wall
+		start = WorldToGrid(Wall.Start.y, m_GridOffsetZ);
+		end = WorldToGrid(Wall.End.y, m_GridOffsetZ);
 		// Get the fixed x position of the wall so it can be used for the grid
-		int z_pos = (Wall->m_StartPos.z * 10) + m_GridOffsetZ;
-		int x_pos = (Wall->m_StartPos.x * 10) + m_GridOffsetX;
+		int x_pos = WorldToGrid(Wall.Start.x, m_GridOffsetX);
 		for (int i = start; i <= end; i++)
 		{
 			// Fill the grid so that the dungeon knows there is a collision here
@@ -710,6 +3174,61 @@ void DungeonClass::FillGridWithWall(MeshClass *Wall)
 }
 
 
+// Function:		Fill Grid With Prefab Walls function
+// What it does:	Called in ApplicationClass after the walls of the dungeon pieces have been added to the grid. Fills in the grid along the
+//					wall segments of each prefab room's template (and the plugs of the sockets it doesn't use) so they can be collided with
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonClass::FillGridWithPrefabWalls()
+{
+	for (auto Prefab = m_PrefabInstances.begin(); Prefab != m_PrefabInstances.end(); ++Prefab)
+	{
+		vector<PrefabLibraryClass::WallSegment> &Segments = m_PrefabLibrary->GetTemplate(Prefab->Template)->Segments;
+
+		for (unsigned int i = 0; i < Segments.size(); i++)
+		{
+			// Leave the plug of the socket joined to the piece out, so the player can walk through the door
+			if ((Segments[i].Socket != -1) && (Segments[i].Socket == Prefab->OpenSocket))
+			{
+				continue;
+			}
+
+			// Get the ends of the segment in grid values in the same way as FillGridWithWall
+			int Start_x = WorldToGrid(Prefab->Origin.x + Segments[i].StartX, m_GridOffsetX);
+			int Start_z = WorldToGrid(Prefab->Origin.y + Segments[i].StartY, m_GridOffsetZ);
+			int End_x = WorldToGrid(Prefab->Origin.x + Segments[i].EndX, m_GridOffsetX);
+			int End_z = WorldToGrid(Prefab->Origin.y + Segments[i].EndY, m_GridOffsetZ);
+
+			// Segments run along one axis, so this fills a single row or column of the grid
+			if (Start_x > End_x)
+			{
+				int Swap = Start_x;
+				Start_x = End_x;
+				End_x = Swap;
+			}
+			if (Start_z > End_z)
+			{
+				int Swap = Start_z;
+				Start_z = End_z;
+				End_z = Swap;
+			}
+
+			for (int x = Start_x; x <= End_x; x++)
+			{
+				for (int z = Start_z; z <= End_z; z++)
+				{
+					if (InBounds(x, z))
+					{
+						DungeonGrid[x][z] = COLLISION;
+					}
+				}
+			}
+		}
+	}
+}
+
+
 // Function:		Set Player Position function
 // What it does:	Takes in the position of the camera and uses matrix multiplication to convert it to the
 //					value it would be in the dungeon grid. This is because the dungeon has several transforms when rendered, therefore
@@ -777,9 +3296,9 @@ bool DungeonClass::CanMovePlayer(D3DXVECTOR3 lookat, int direction)
 		m_NextPlayerPosition = m_PlayerPosition - (0.1 * m_NextPlayerPosition);
 	}
 
-	// Get the next player position into the grid position by multiplying by 10 and adding the grid offset
-	int xpos = (m_NextPlayerPosition.x * 10) + m_GridOffsetX;
-	int ypos = (m_NextPlayerPosition.z * 10) + m_GridOffsetZ;
+	// Get the next player position into the grid position by multiplying by the cells along a unit and adding the grid offset
+	int xpos = (int)floor(m_NextPlayerPosition.x * m_CellsPerUnit) + m_GridOffsetX;
+	int ypos = (int)floor(m_NextPlayerPosition.z * m_CellsPerUnit) + m_GridOffsetZ;
 
 	// Check this position in the grid. If this position is a collision, return false so that player doesn't move in that direction
 	if (DungeonGrid[xpos][ypos] == COLLISION)
@@ -812,7 +3331,7 @@ bool DungeonClass::InBounds(int x, int y)
 	{
 		return false;
 	}
-	if ((x >= DUNGEON_GRID_X) || (y >= DUNGEON_GRID_Y))
+	if ((x >= m_GridSizeX) || (y >= m_GridSizeY))
 	{
 		return false;
 	}
@@ -833,25 +3352,92 @@ list<DungeonPieceClass*> *DungeonClass::GetDungeonPieces()
 }
 
 
-// Function:		Get Ceiling Piece List function
-// What it does:	Called in the Application Class so as to render the Ceiling pieces in the dungeon
+// Function:		Get Door Piece List function
+// What it does:	Called in the Application Class so as to render the Door pieces on the map
 // Takes in:		Nothing
-// Returns:			A pointer to the Ceiling Piece Class Pointer list
+// Returns:			A pointer to the Door Piece Class Pointer list
 
-list<DungeonPieceClass*> *DungeonClass::GetCeilingPieces()
+list<DungeonPieceClass*> *DungeonClass::GetDoorPieces()
 {
-	return &m_CeilingPieces;
+	return &m_DoorPieces;
 }
 
 
-// Function:		Get Door Piece List function
-// What it does:	Called in the Application Class so as to render the Door pieces on the map
+// Function:		Get Cave Floors function
+// What it does:	Called in the Application Class so as to render the floors of the cave regions in the dungeon and on the map
 // Takes in:		Nothing
-// Returns:			A pointer to the Door Piece Class Pointer list
+// Returns:			A pointer to the list of cave floor meshes
 
-list<DungeonPieceClass*> *DungeonClass::GetDoorPieces()
+list<MeshClass*> *DungeonClass::GetCaveFloors()
 {
-	return &m_DoorPieces;
+	return &m_CaveFloors;
+}
+
+
+// Function:		Get Cave Ceilings function
+// What it does:	Called in the Application Class so as to render the ceilings of the cave regions
+// Takes in:		Nothing
+// Returns:			A pointer to the list of cave ceiling meshes
+
+list<MeshClass*> *DungeonClass::GetCaveCeilings()
+{
+	return &m_CaveCeilings;
+}
+
+
+// Function:		Get Cave Walls function
+// What it does:	Called in the Application Class so as to render the walls around the edges of the cave regions
+// Takes in:		Nothing
+// Returns:			A pointer to the list of cave wall meshes
+
+list<MeshClass*> *DungeonClass::GetCaveWalls()
+{
+	return &m_CaveWalls;
+}
+
+
+// Function:		Get Prefab Library function
+// What it does:	Called in the Application Class so as to render the prefab rooms using their templates
+// Takes in:		Nothing
+// Returns:			A pointer to the prefab library
+
+PrefabLibraryClass *DungeonClass::GetPrefabLibrary()
+{
+	return m_PrefabLibrary;
+}
+
+
+// Function:		Get Texture Cache function
+// What it does:	Returns the cache the dungeon's textures are loaded through
+// Takes in:		Nothing
+// Returns:			A pointer to the texture cache (0 if the dungeon isn't drawn)
+
+TextureCacheClass *DungeonClass::GetTextureCache()
+{
+	return m_TextureCache;
+}
+
+
+// Function:		Get Prefab Instances function
+// What it does:	Called in the Application Class so as to render each prefab room placed in the dungeon and on the map
+// Takes in:		Nothing
+// Returns:			A pointer to the list of prefab instances
+
+list<PrefabLibraryClass::Instance> *DungeonClass::GetPrefabInstances()
+{
+	return &m_PrefabInstances;
+}
+
+
+// Function:		Get Graph function
+// What it does:	Returns the graph of the rooms of the dungeon (pieces, prefab rooms and caves) and the doors joining them,
+//					built at the end of Initialise
+// Takes in:		Nothing
+// Returns:			A pointer to the graph
+
+DungeonGraphClass *DungeonClass::GetGraph()
+{
+	return m_Graph;
 }
 
 
@@ -15,18 +15,70 @@
 #include <list>
 using std::list;
 
+// For the flag used to cancel generation from another thread
+#include <atomic>
+
 #include "dungeonpiececlass.h"
+#include "cavegeneratorclass.h"
+#include "wavecollapseclass.h"
+#include "scattergeneratorclass.h"
+#include "prefablibraryclass.h"
+#include "texturecacheclass.h"
+#include "bufferpoolclass.h"
+#include "emptyrectindexclass.h"
+#include "occupancypyramidclass.h"
+#include "workerpoolclass.h"
+#include "dungeongraphclass.h"
 #include "meshclass.h"
 #include "d3dclass.h"
 
-// The size of the map available for the dungeon
+// The size of the map available for the dungeon, in grid cells at GRID_BASE_CELLS_PER_UNIT
 #define DUNGEON_GRID_X 1000
 #define DUNGEON_GRID_Y 1000
+#define GRID_BASE_CELLS_PER_UNIT 10
+
+// Specify the number of grid cells along one unit of the dungeon, or GRID_CELLS_AUTO to use the coarsest grid that still holds
+// the size of every piece, door, prefab cell and cave cell exactly. It has to divide LAYOUT_UNITS_PER_UNIT, so each cell is a
+// whole number of layout units. The grid covers the same area at any resolution (up to DUNGEON_GRID_X by DUNGEON_GRID_Y cells),
+// so a coarser grid uses fewer cells and is quicker to check
+#define GRID_CELLS_AUTO 0
+#define GRID_CELLS_PER_UNIT 10
 
 // Specify the depth of the dungeon
 #define DUNGEON_DEPTH 5
 // Specify the amount of attempts the generation should try when picking a room
 #define PIECE_ATTEMPTS 50
+// Specify the amount of attempts drawn for a door and tested against the grid together
+#define PIECE_BATCH_SIZE 8
+
+// Define values for how the piece generator picks the size of a new piece
+#define PLACEMENT_RANDOM 0
+#define PLACEMENT_BEST_FIT 1
+// Specify how sizes are picked. Random sizes are tested against the grid and thrown away if they don't fit, best fit uses the
+// empty rectangles of the grid to change the random size to the closest size that fits behind the door
+#define PIECE_PLACEMENT PLACEMENT_RANDOM
+
+// Specify the time in milliseconds the piece generator can take before it stops placing pieces (0 for no limit). When it stops,
+// every door left without a piece is walled off so the dungeon is still closed. Where it stops depends on how fast the machine is,
+// so a seed only gives the same dungeon every time with no limit, which is the default
+#define GENERATION_BUDGET_MS 0
+
+// Specify the number of threads used to test placements. Placements are tested at the same time but always placed in the order
+// the generator draws them, so the dungeon made from a seed is the same on any number of threads. This only holds with no
+// generation budget (GENERATION_BUDGET_MS 0), as the number of threads changes how far the generator gets in its time
+#define GENERATION_THREADS 1
+
+// Results of testing a placement candidate
+#define CANDIDATE_BLOCKED 0
+#define CANDIDATE_FITS 1
+#define CANDIDATE_OUTSIDE 2
+
+// Specify the most doors added between pieces that share a wall once the layout is made, to turn the tree of pieces into loops
+// (0 for none). A door needs a shared wall at least LOOP_MIN_SHARED_WALL layout units long, and the path between the two pieces
+// has to go through at least LOOP_MIN_DISTANCE doors, so the loops added are the ones that cut the most backtracking
+#define DUNGEON_LOOP_BUDGET 4
+#define LOOP_MIN_SHARED_WALL 20
+#define LOOP_MIN_DISTANCE 4
 
 // The scale of the dungeon once it is generated (used for rendering)
 #define DUNGEON_SCALE 20
@@ -39,15 +91,84 @@ using std::list;
 #define DUNGEON_ROOM 1
 #define COLLISION 0
 
+// Specify the most cave regions the dungeon can have and the chance (out of 100) of a cave behind an unused door
+#define CAVE_REGIONS 2
+#define CAVE_CHANCE 25
+// The size of a cave region in cave cells, and the size of one cave cell in tenths (at least one grid cell is used for it)
+#define CAVE_REGION_SIZE 48
+#define CAVE_CELL_SIZE 2
+// Half the width of the tunnel joining a cave to its door, in cave cells
+#define CAVE_ENTRANCE_HALF_WIDTH 2
+// Caves with fewer open cells than this after removing unreachable areas are thrown away
+#define CAVE_MIN_OPEN_CELLS 200
+
+// Define values for the generators that can build the layout of the dungeon
+#define GENERATOR_PIECES 0
+#define GENERATOR_WAVE_COLLAPSE 1
+#define GENERATOR_SCATTER 2
+// Specify the generator used for the layout of the dungeon
+#define DUNGEON_GENERATOR GENERATOR_PIECES
+
+// Specify the size of the wave collapse map in tiles (odd so the entrance is in the middle), the size of a tile and the width of a corridor
+#define WAVE_MAP_SIZE 21
+#define WAVE_TILE_SIZE 2.0f
+#define WAVE_CORRIDOR_WIDTH 1.0f
+// Specify the weights used when the wave collapse picks between empty, room and corridor tiles
+#define WAVE_EMPTY_WEIGHT 30
+#define WAVE_ROOM_WEIGHT 2
+#define WAVE_CORRIDOR_WEIGHT 8
+// Specify the most backtracks and the time in milliseconds the wave collapse can take before falling back to placing pieces
+#define WAVE_BACKTRACK_LIMIT 100
+#define WAVE_TIMEOUT_MS 50
+
+// Specify the size of the area the scatter generator uses (inside the dungeon grid), the smallest distance between room centres
+// and the width of the corridors between them
+#define SCATTER_AREA_SIZE 90.0f
+#define SCATTER_ROOM_SPACING 9.0f
+#define SCATTER_CORRIDOR_WIDTH 1.0f
+// Specify the most rooms the scatter generator places, and the chance (out of 100) of extra corridors that make loops
+#define SCATTER_MAX_ROOMS 80
+#define SCATTER_EXTRA_EDGE_CHANCE 15
+
+// Specify the prefab room asset and the chance (out of 100) of trying a prefab room when the piece generator picks a room
+#define PREFAB_FILE "data/prefabs.dat"
+#define PREFAB_CHANCE 25
+
+// Specify the largest floor area of a dead end counted as a small dead end in the layout metrics
+#define METRICS_SMALL_AREA 4.0f
+
+// Called while the pieces are placed with the number of pieces placed so far, the number of doors still waiting for a piece
+// and the pointer passed to SetProgressCallback
+typedef void (*GenerationProgressCallback)(int PiecesPlaced, int FrontierSize, void* UserData);
+
 // Arrow texture from - http://icons.mysitemyway.com/legacy-icon-tags/triangle/page/3/
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: DungeonClass
-// Handles the creation of the procedural dungeon, holding lists for the dungeon pieces and ceilings
+// Handles the creation of the procedural dungeon, holding lists for the dungeon pieces and doors
 ////////////////////////////////////////////////////////////////////////////////
 class DungeonClass
 {
 public:
+	// Measurements of the layout made so far. Pieces counts the dungeon pieces and prefab rooms (not doors), Depth is
+	// the most pieces between the entrance and any other piece, and a dead end is a piece other than the entrance with only one door.
+	// The bounding box is in dungeon units, and the branching factor is the average number of pieces leading off each piece that
+	// has any. Frontier is the number of doors still waiting for a piece
+	struct LayoutMetrics
+	{
+		int Pieces;
+		int Rooms;
+		int Corridors;
+		int Prefabs;
+		int Depth;
+		int DeadEnds;
+		int SmallDeadEnds;
+		float MinX, MinY;
+		float MaxX, MaxY;
+		float BranchingFactor;
+		int Frontier;
+	};
+
 	// Function:		Dungeon class constructor
 	// What it does:	Initialises all variables and objects to their defaults to set up the class
 	// Takes in:		Nothing
@@ -66,8 +187,16 @@ public:
 	void Shutdown();
 
 
+	// Function:		Reset function
+	// What it does:	Releases the dungeon and clears the part of the grid it used, so the dungeon can be initialised again (with
+	//					another seed) without clearing the whole grid. The seed, settings and shared prefab library are kept
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Reset();
+
+
 	// Function:		Initialise function
-	// What it does:	Initialises the dungeon - Initialises first dungeon piece and ceiling piece, the player mesh, and begins calling
+	// What it does:	Initialises the dungeon - Initialises first dungeon piece, the player mesh, and begins calling
 	//					PlaceNextPiece four times with four directions of doors so that the dungeon will spread from the entrance piece
 	//					And will continue until the dungeon is fully created
 	// Takes in:		ID3D11Device pointer - Pointer to the DirectX device, ID3D11DeviceContext - Pointer to the DirectX device context
@@ -75,13 +204,153 @@ public:
 	bool Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, HWND *hwnd);
 
 
+	// Function:		Set Generation Budget function
+	// What it does:	Sets the time the piece generator can take in Initialise before it stops placing pieces
+	// Takes in:		int - Time in milliseconds (0 for no limit)
+	// Returns:			Nothing
+	void SetGenerationBudget(int Milliseconds);
+
+
+	// Function:		Set Progress Callback function
+	// What it does:	Sets the function called each time the piece generator places a piece
+	// Takes in:		GenerationProgressCallback - the function (0 for none), void - pointer passed back to the function
+	// Returns:			Nothing
+	void SetProgressCallback(GenerationProgressCallback Callback, void* UserData);
+
+
+	// Function:		Cancel Generation function
+	// What it does:	Asks the piece generator to stop placing pieces. Can be called from another thread while Initialise runs, and
+	//					Initialise still finishes with a closed dungeon made from the pieces already placed. A cancel made before
+	//					Initialise starts stops it straight away, and each cancel is used up when generation stops for it (or by Reset)
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void CancelGeneration();
+
+
+	// Function:		Was Generation Stopped function
+	// What it does:	Returns whether the last generation stopped early because it ran out of time or was cancelled
+	// Takes in:		Nothing
+	// Returns:			True if it stopped early, false if every door was tried
+	bool WasGenerationStopped();
+
+
+	// Function:		Was Generation Out Of Time function
+	// What it does:	Returns whether the last generation stopped early because it used up its time budget, so the dungeon
+	//					made may not be the same as another run of the same seed
+	// Takes in:		Nothing
+	// Returns:			True if it ran out of time, false if not
+	bool WasGenerationOutOfTime();
+
+
+	// Function:		Set Thread Count function
+	// What it does:	Sets the number of threads used to test placements in Initialise. With no generation budget the dungeon
+	//					made from a seed is the same on any number of threads. A budget stops generation after a length of time,
+	//					which the number of threads changes, so the dungeon is only the same with a budget of 0
+	// Takes in:		int - Number of threads (1 tests everything on the thread calling Initialise)
+	// Returns:			Nothing
+	void SetThreadCount(int ThreadCount);
+
+
+	// Function:		Set Seed function
+	// What it does:	Sets the seed Initialise gives to rand, so the same dungeon can be made again. If it isn't set, Initialise
+	//					seeds rand with the current time
+	// Takes in:		unsigned int - Seed
+	// Returns:			Nothing
+	void SetSeed(unsigned int Seed);
+
+
+	// Function:		Get Seed function
+	// What it does:	Returns the seed used by the last call to Initialise
+	// Takes in:		Nothing
+	// Returns:			unsigned int - Seed
+	unsigned int GetSeed();
+
+
+	// Function:		Set Cells Per Unit function
+	// What it does:	Sets the resolution of the grid used from the next call to Initialise
+	// Takes in:		int - Number of grid cells along one unit, or GRID_CELLS_AUTO to pick the coarsest exact resolution
+	// Returns:			True if the resolution can be used, false if it doesn't divide LAYOUT_UNITS_PER_UNIT (it isn't changed)
+	bool SetCellsPerUnit(int CellsPerUnit);
+
+
+	// Function:		Get Cells Per Unit function
+	// What it does:	Returns the resolution of the grid used by the last call to Initialise
+	// Takes in:		Nothing
+	// Returns:			int - Number of grid cells along one unit
+	int GetCellsPerUnit();
+
+
+	// Function:		Set Loop Budget function
+	// What it does:	Sets the most doors the loop closing pass adds at the end of Initialise
+	// Takes in:		int - Number of doors (0 leaves the layout as the generator made it)
+	// Returns:			Nothing
+	void SetLoopBudget(int Doors);
+
+
+	// Function:		Set Shared Prefab Library function
+	// What it does:	Uses a prefab library that has already been loaded instead of loading one in Initialise. The library belongs
+	//					to the caller and isn't released by Shutdown, so it can be shared by many dungeons
+	// Takes in:		PrefabLibraryClass - pointer to the library
+	// Returns:			Nothing
+	void SetSharedPrefabLibrary(PrefabLibraryClass* Library);
+
+
+	// Function:		Set Shared Texture Cache function
+	// What it does:	Loads the dungeon's textures through a cache that has already been made instead of making one in Initialise.
+	//					The cache belongs to the caller and isn't released by Shutdown, so the textures stay loaded between dungeons
+	// Takes in:		TextureCacheClass - pointer to the cache
+	// Returns:			Nothing
+	void SetSharedTextureCache(TextureCacheClass* TextureCache);
+
+
+	// Function:		Get Layout Metrics function
+	// What it does:	Measures the layout placed so far. Can be called from the progress callback while the pieces are placed
+	// Takes in:		LayoutMetrics - reference to the metrics to fill in
+	// Returns:			Nothing
+	void GetLayoutMetrics(LayoutMetrics &Metrics);
+
+
+	// Function:		Get Progress Metrics function
+	// What it does:	Gives the metrics of the layout placed so far without walking the pieces, as they are counted by the piece
+	//					generator as each piece is placed. This is what the progress callback should use, as it is called for every
+	//					piece. While the piece generator runs these are the same as GetLayoutMetrics, which should be used once the
+	//					layout is finished (the other generators and the doors closing loops only show up there)
+	// Takes in:		LayoutMetrics - reference to the metrics to fill in
+	// Returns:			Nothing
+	void GetProgressMetrics(LayoutMetrics &Metrics);
+
+
+	// Function:		Build Walls function
+	// What it does:	Called in ApplicationClass once the dungeon is initialised. Builds the walls of every dungeon piece, then merges
+	//					them with the walls of the pieces around them (see MergeWalls) and makes the wall segments for the collision grid
+	// Takes in:		Nothing
+	// Returns:			True if the walls were built, false if not
+	bool BuildWalls();
+
+
+	// Function:		Get Wall Segments function
+	// What it does:	Returns the wall segments made by BuildWalls, with the walls shared by neighbouring pieces and the walls
+	//					running on from each other joined, so each part of the collision grid is only filled once
+	// Takes in:		Nothing
+	// Returns:			vector<WallSegment> - pointer to the segments
+	vector<DungeonPieceClass::WallSegment> *GetWallSegments();
+
+
 	// Function:		Fill Grid With Wall function
-	// What it does:	This is called for each wall belonging to a dungeon piece in ApplicationClass when the walls have been created so that 
+	// What it does:	This is called for each wall segment of a dungeon piece in ApplicationClass when the walls have been created so that 
 	//					the walls are present in the dungeon grid and can be collided with. Uses the start and end positions of the wall to fill 
 	//					in the information in the grid
-	// Takes in:		MeshClass - Pointer to the wall mesh that is passed in so that it can be checked
+	// Takes in:		WallSegment - reference to the wall segment that is passed in so that it can be checked
+	// Returns:			Nothing
+	void FillGridWithWall(DungeonPieceClass::WallSegment &Wall);
+
+
+	// Function:		Fill Grid With Prefab Walls function
+	// What it does:	Called in ApplicationClass after the walls of the dungeon pieces have been added to the grid. Fills in the grid along the
+	//					wall segments of each prefab room's template (and the plugs of the sockets it doesn't use) so they can be collided with
+	// Takes in:		Nothing
 	// Returns:			Nothing
-	void FillGridWithWall(MeshClass *Wall);
+	void FillGridWithPrefabWalls();
 
 
 	// Function:		Set Player Position function
@@ -111,13 +380,6 @@ public:
 	list<DungeonPieceClass*> *GetDungeonPieces();
 
 
-	// Function:		Get Ceiling Piece List function
-	// What it does:	Called in the Application Class so as to render the Ceiling pieces in the dungeon
-	// Takes in:		Nothing
-	// Returns:			A pointer to the Ceiling Piece Class Pointer list
-	list<DungeonPieceClass*> *GetCeilingPieces();
-
-
 	// Function:		Get Door Piece List function
 	// What it does:	Called in the Application Class so as to render the Door pieces on the map
 	// Takes in:		Nothing
@@ -125,6 +387,56 @@ public:
 	list<DungeonPieceClass*> *GetDoorPieces();
 
 
+	// Function:		Get Cave Floors function
+	// What it does:	Called in the Application Class so as to render the floors of the cave regions in the dungeon and on the map
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of cave floor meshes
+	list<MeshClass*> *GetCaveFloors();
+
+
+	// Function:		Get Cave Ceilings function
+	// What it does:	Called in the Application Class so as to render the ceilings of the cave regions
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of cave ceiling meshes
+	list<MeshClass*> *GetCaveCeilings();
+
+
+	// Function:		Get Cave Walls function
+	// What it does:	Called in the Application Class so as to render the walls around the edges of the cave regions
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of cave wall meshes
+	list<MeshClass*> *GetCaveWalls();
+
+
+	// Function:		Get Prefab Library function
+	// What it does:	Called in the Application Class so as to render the prefab rooms using their templates
+	// Takes in:		Nothing
+	// Returns:			A pointer to the prefab library
+	PrefabLibraryClass *GetPrefabLibrary();
+
+
+	// Function:		Get Texture Cache function
+	// What it does:	Returns the cache the dungeon's textures are loaded through
+	// Takes in:		Nothing
+	// Returns:			A pointer to the texture cache (0 if the dungeon isn't drawn)
+	TextureCacheClass *GetTextureCache();
+
+
+	// Function:		Get Prefab Instances function
+	// What it does:	Called in the Application Class so as to render each prefab room placed in the dungeon and on the map
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of prefab instances
+	list<PrefabLibraryClass::Instance> *GetPrefabInstances();
+
+
+	// Function:		Get Graph function
+	// What it does:	Returns the graph of the rooms of the dungeon (pieces, prefab rooms and caves) and the doors joining them,
+	//					built at the end of Initialise
+	// Takes in:		Nothing
+	// Returns:			A pointer to the graph
+	DungeonGraphClass *GetGraph();
+
+
 	// Function:		Get Player Mesh function
 	// What it does:	Called in the Application Class to render the player mesh arrow
 	// Takes in:		Nothing
@@ -152,11 +464,85 @@ public:
 	bool DungeonFailed;
 
 private:
+	// A batch of candidate pieces for one door, in the order they were drawn, with each value kept in its own array. Sizes are
+	// in tenths and centers in layout units
+	struct CandidateBatch
+	{
+		int Count;
+		DungeonPieceClass::m_PieceType Types[PIECE_BATCH_SIZE];
+		int Widths[PIECE_BATCH_SIZE];
+		int Heights[PIECE_BATCH_SIZE];
+		int CentersX[PIECE_BATCH_SIZE];
+		int CentersY[PIECE_BATCH_SIZE];
+	};
+
+	// The best height found for one width by the best fit search (Distance is -1 if no height fits)
+	struct FitColumn
+	{
+		int Distance;
+		int Area;
+		int Height;
+	};
+
+	// A door of a piece made by one of the layout generators, waiting to be joined to the piece on the other side
+	struct LayoutDoor
+	{
+		DungeonPieceClass* Piece;
+		int Direction;
+		DungeonPieceClass* Door;
+	};
+
+	// A side of a piece without a door, used by the loop closing pass. Line is the x (for left and right sides) or y (for top and
+	// bottom sides) of the side, and Start and End are where it starts and ends along it, all in layout units
+	struct LoopWall
+	{
+		int Line;
+		int Start, End;
+		DungeonPieceClass* Piece;
+	};
+
+	// A door that could close a loop between the right or top side of First and the left or bottom side of Second. DoorCenter is
+	// the middle of the shared wall in layout units, Distance the number of doors between the pieces, and Order the order the
+	// pair was found in (so ties are always broken in the same way)
+	struct LoopCandidate
+	{
+		DungeonPieceClass* First;
+		DungeonPieceClass* Second;
+		int Direction;
+		int DoorCenter;
+		int Distance;
+		int Order;
+	};
+
+	// A wall of a piece, used by the wall merging pass. Line is the z (for walls along the x axis) or x (for walls along the z
+	// axis) of the wall, and Start and End are where it starts and ends along the line, all in layout units. Facing is the
+	// direction of the wall's normal across the line (1 or -1)
+	struct MergeWall
+	{
+		bool AlongXAxis;
+		int Line;
+		int Facing;
+		int Start, End;
+		DungeonPieceClass* Piece;
+		DungeonPieceClass::Wall Wall;
+	};
+
+	// The settings of the best fit search being run, and the best height found for each width
+	struct FitSearch
+	{
+		DungeonPieceClass* Piece;
+		int DoorNumber;
+		int Lowest_x, Lowest_y, Highest_y;
+		int Step;
+		int Wanted_x, Wanted_y;
+		vector<FitColumn> Columns;
+	};
+
 	// Function:		Place Next Piece function
 	// What it does:	Loops through the number of attempts in order to find a suitable room leading off from the previous room, and initialises
 	//					the room and calls PlaceNextPiece again for the available rooms leading from this new room.
 	//					This is the main recursive function used for generating the dungeon as it calls itself based on what 
-	//					rooms are available in the room it creates.
+	//					rooms are available in the room it creates. The attempts are drawn and tested against the grid in batches.
 	// Takes in:		int - Depth value of the dungeon so that the dungeon can check how much it has generated,
 	//					DungeonPieceClass - pointer to the current piece that is creating a new room off it
 	//					int - DoorNumber value which uses defines of LEFT, RIGHT, UP, and DOWN to state the room side the next room is created from
@@ -176,11 +562,12 @@ private:
 
 	// Function:		Get Next Center function
 	// What it does:	Uses the direction the room is created in and the width/height of the new piece
-	//					to find the center of the room leading off of the previous one
+	//					to find the center of the room leading off of the previous one, in layout units
 	// Takes in:		int - Direction of the room it is being created in, DungeonPieceClass - pointer to the piece that is being placed
-	//					float - width value of the piece being created, float - height value of the piece being created
-	// Returns:			D3DXVECTOR2 - The new center of the next dungeon piece so that it can be placed next to the previous piece in the correct position
-	D3DXVECTOR2 GetNextCenter(int Direction, DungeonPieceClass* ThisPiece, float Width, float Height); 
+	//					int - width of the piece being created in tenths, int - height of the piece being created in tenths,
+	//					int - references to the new center
+	// Returns:			Nothing
+	void GetNextCenter(int Direction, DungeonPieceClass* ThisPiece, int Width, int Height, int &Center_x, int &Center_y);
 
 
 	// Function:		In Bounds function
@@ -203,9 +590,166 @@ private:
 	// What it does:	It uses the new center, width and height of the new piece and checks to see if there is room available for it on the dungeon grid
 	//					The value on the grid if not available will be 1, and value will be 0 if available
 	//					If it doesn't return false, will fill in the grid for the new room 
-	// Takes in:		float - Width value of new piece, float - Height value of new piece, D3DXVECTOR2 - Vector of center of new piece
+	// Takes in:		int - Width and height of new piece in tenths, int - Center of new piece in layout units
 	// Returns:			True if the dungeon piece using this width, height and center can be placed in the dungeon grid, false if not
-	bool CheckGrid(float Width, float Height, D3DXVECTOR2 Center);
+	bool CheckGrid(int Width, int Height, int Center_x, int Center_y);
+
+
+	// Function:		Check Grid Batch function
+	// What it does:	Does the same test as CheckGrid for the candidates in a batch in the order they were drawn, and fills in the grid
+	//					for the first candidate that fits
+	// Takes in:		CandidateBatch - reference to the candidates
+	// Returns:			int - Index of the candidate placed, or -1 if none fit (DungeonFailed is set if a candidate leaves the grid)
+	int CheckGridBatch(CandidateBatch &Batch);
+
+
+	// Function:		Test Candidate function
+	// What it does:	Does the same test as CheckGrid for one candidate in a batch without filling in the grid. Only reads the grid, so
+	//					candidates can be tested at the same time
+	// Takes in:		CandidateBatch - reference to the candidates, int - Index of the candidate
+	// Returns:			int - CANDIDATE_FITS, CANDIDATE_BLOCKED if something is in the way, or CANDIDATE_OUTSIDE if it leaves the grid
+	int TestCandidate(CandidateBatch &Batch, int Index);
+
+
+	// Function:		Test Candidate Job function
+	// What it does:	Job run by the worker pool for each candidate in the batch being tested
+	// Takes in:		void - pointer to the dungeon, int - Index of the candidate
+	// Returns:			Nothing
+	static void TestCandidateJob(void* Data, int Index);
+
+
+	// Function:		Fill Grid Area function
+	// What it does:	Fills in an area of the dungeon grid so the grid knows a piece is there, and updates the occupancy pyramid and
+	//					the empty rectangles to match
+	// Takes in:		int - Start and end positions of the area (the end positions are filled as well, and all must be in the grid)
+	// Returns:			Nothing
+	void FillGridArea(int Start_x, int Start_y, int End_x, int End_y);
+
+
+	// Function:		Mark Grid Used function
+	// What it does:	Grows the area of the grid that has been filled in to hold the given area, so Reset knows what to clear
+	// Takes in:		int - Start and end positions of the area (included in the area)
+	// Returns:			Nothing
+	void MarkGridUsed(int Start_x, int Start_y, int End_x, int End_y);
+
+
+	// Function:		Should Stop Generation function
+	// What it does:	Checks if generation has been cancelled or has used up its time, and remembers that it stopped
+	// Takes in:		Nothing
+	// Returns:			True if no more pieces should be placed, false if not
+	bool ShouldStopGeneration();
+
+
+	// Function:		Report Progress function
+	// What it does:	Calls the progress callback, if there is one, with the pieces placed and the doors waiting
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void ReportProgress();
+
+
+	// Function:		Count Progress Piece, Count Progress Prefab and Count Progress Door functions
+	// What it does:	Keep the progress metrics up to date as the piece generator places pieces. A new piece or prefab room is
+	//					counted with the door to the piece it was placed from, and Count Progress Door counts a new door of a piece
+	//					(after it has been added), taking the piece off the dead ends if it was one
+	// Takes in:		DungeonPieceClass - pointer to the new piece (with the piece it was placed from, or 0 for the entrance), or to
+	//					the piece the prefab room or door was added to
+	// Returns:			Nothing
+	void CountProgressPiece(DungeonPieceClass* Piece, DungeonPieceClass* Parent);
+	void CountProgressPrefab(DungeonPieceClass* Parent);
+	void CountProgressDoor(DungeonPieceClass* Piece);
+
+
+	// Function:		Get Grid Area function
+	// What it does:	Finds the positions on the dungeon grid filled by a piece, in the same way for every grid check
+	// Takes in:		int - Width and height of the piece in tenths, int - Center of the piece in layout units,
+	//					int - references to the start and end positions (the end positions are filled as well)
+	// Returns:			Nothing
+	void GetGridArea(int Width, int Height, int Center_x, int Center_y, int &Start_x, int &Start_y, int &End_x, int &End_y);
+
+
+	// Function:		Initialise Layout Piece function
+	// What it does:	Gives a piece its layout and initialises it in world space. This is where the layout of a placed piece is
+	//					changed into world space
+	// Takes in:		DungeonPieceClass - pointer to the piece, int - Center in layout units, int - Width and height in tenths,
+	//					int - The door limit passed to the piece
+	// Returns:			True if the piece was initialised, false if not
+	bool InitialiseLayoutPiece(DungeonPieceClass* Piece, int Center_x, int Center_y, int Width, int Height, int RoomLimit);
+
+
+	// Function:		Layout To World function
+	// What it does:	Changes a position or length in layout units into world space
+	// Takes in:		int - Position in layout units
+	// Returns:			float - Position in world space
+	static float LayoutToWorld(int Position);
+
+
+	// Function:		World To Layout function
+	// What it does:	Changes a position or length in world space into the nearest layout unit
+	// Takes in:		float - Position in world space
+	// Returns:			int - Position in layout units
+	static int WorldToLayout(float Position);
+
+
+	// Function:		World To Grid function
+	// What it does:	Finds the grid position a position in world space falls in, in the same way as GetGridArea finds the edges of
+	//					a piece, so that things on the edge of a piece are in the same grid position as the edge
+	// Takes in:		float - Position in world space, int - Grid offset of the axis
+	// Returns:			int - Position on the grid
+	int WorldToGrid(float Position, int Offset);
+
+
+	// Function:		Find Coarsest Cells Per Unit function
+	// What it does:	Finds the fewest grid cells along one unit that still hold every size the generator can make exactly, from
+	//					the size limits and step of each piece, the entrance, the doors, and the prefab and cave cells used
+	// Takes in:		Nothing
+	// Returns:			int - Number of grid cells along one unit (a divisor of GRID_BASE_CELLS_PER_UNIT)
+	int FindCoarsestCellsPerUnit();
+
+
+	// Function:		Get Cave Cell Size function
+	// What it does:	Finds the number of grid cells along one cave cell at the resolution of the grid
+	// Takes in:		Nothing
+	// Returns:			int - Number of grid cells (at least 1)
+	int GetCaveCellSize();
+
+
+	// Function:		Greatest Common Divisor function
+	// What it does:	Finds the largest whole number that divides both numbers
+	// Takes in:		int - The two numbers (0 is divided by anything)
+	// Returns:			int - The greatest common divisor
+	static int GreatestCommonDivisor(int a, int b);
+
+
+	// Function:		Floor Divide function
+	// What it does:	Divides two whole numbers, rounding down for negative numbers as well as positive ones
+	// Takes in:		int - Value, int - Divisor (greater than 0)
+	// Returns:			int - Value divided by the divisor, rounded down
+	static int FloorDivide(int Value, int Divisor);
+
+
+	// Function:		Find Best Fit function
+	// What it does:	Goes through every size a piece of this type can be and uses the empty rectangles of the grid to find the one
+	//					closest to the size wanted that fits behind the door, picking the larger one if two are as close
+	// Takes in:		DungeonPieceClass - pointer to the piece with the door, int - Door direction, DungeonPieceClass::m_PieceType - Type
+	//					of the new piece, int - Width and height wanted in tenths, int - references to the width and height found
+	// Returns:			True if a piece of this type fits behind the door, false if not (or if there is no empty rectangle index,
+	//					which is only made for best fit placement)
+	bool FindBestFit(DungeonPieceClass* Piece, int DoorNumber, DungeonPieceClass::m_PieceType Type, int Wanted_x, int Wanted_y, int &Width, int &Height);
+
+
+	// Function:		Find Best Fit Column function
+	// What it does:	Finds the height closest to the size wanted that fits behind the door for one width in the best fit search, picking
+	//					the larger one if two are as close. Only reads the grid indexes, so columns can be searched at the same time
+	// Takes in:		int - Width in tenths
+	// Returns:			Nothing
+	void FindBestFitColumn(int x);
+
+
+	// Function:		Find Best Fit Job function
+	// What it does:	Job run by the worker pool for each width in the best fit search
+	// Takes in:		void - pointer to the dungeon, int - Index of the width from the smallest width
+	// Returns:			Nothing
+	static void FindBestFitJob(void* Data, int Index);
 
 
 	// Function:		Set Chances function
@@ -216,7 +760,146 @@ private:
 	// Returns:			Nothing
 	void SetChances(int depth);
 
-	
+
+	// Function:		Place Cave Regions function
+	// What it does:	Called at the end of Initialise. Looks through the dungeon pieces for doors that were available but had no room
+	//					placed behind them, and randomly tries to place a cave region behind them up to the cave limit
+	// Takes in:		Nothing
+	// Returns:			True if there were no errors, false if the geometry for a cave couldn't be created
+	bool PlaceCaveRegions();
+
+
+	// Function:		Place Cave function
+	// What it does:	Generates a cave with the cave generator on the far side of the given door of a piece. Checks the dungeon grid
+	//					is free for the region, marks the open cells of the cave in the grid so the player can walk in it, creates the
+	//					floor, ceiling and wall meshes from the cave and adds the door between the piece and the cave
+	//					If there is no room for the region or the cave is too small, nothing is placed
+	// Takes in:		DungeonPieceClass - pointer to the piece the cave leads off, int - Door direction (LEFT, RIGHT, UP, DOWN)
+	// Returns:			True if there were no errors (even if no cave was placed), false if the cave's meshes couldn't be created
+	bool PlaceCave(DungeonPieceClass* Piece, int DoorNumber);
+
+
+	// Function:		Create Cave Meshes function
+	// What it does:	Turns the floor rectangles and wall segments of a finished cave into meshes in world space
+	// Takes in:		CaveGeneratorClass - reference to the finished cave, int - X grid cell of the region's corner, int - Y grid cell of the region's corner
+	// Returns:			True if all meshes were created, false if not
+	bool CreateCaveMeshes(CaveGeneratorClass &Cave, int GridX, int GridY);
+
+
+	// Function:		Place Prefab function
+	// What it does:	Picks a prefab template with a socket facing the given door of a piece and lines the socket up with the door.
+	//					Checks the template's mask against the dungeon grid, and if it is free fills in the grid, adds the door to the piece
+	//					and adds an instance of the template. Prefab rooms are dead ends, so their other sockets are plugged
+	// Takes in:		DungeonPieceClass - pointer to the piece the prefab leads off, int - Door direction (LEFT, RIGHT, UP, DOWN)
+	// Returns:			True if a prefab room was placed, false if there wasn't room for it
+	bool PlacePrefab(DungeonPieceClass* Piece, int DoorNumber);
+
+
+	// Function:		Add Door function
+	// What it does:	Updates a piece so that it will draw a wall with a door on the given side, and creates the door sprite for the map.
+	//					Used when something other than a new dungeon piece (a cave, a prefab room or a piece the door closes a loop
+	//					with) is behind the door
+	// Takes in:		DungeonPieceClass - pointer to the piece, int - Door direction (LEFT, RIGHT, UP, DOWN), int - Index of the
+	//					graph node behind the door
+	// Returns:			True if the door was created, false if not
+	bool AddDoor(DungeonPieceClass* Piece, int DoorNumber, int Node);
+
+
+	// Function:		Connect Layout Pieces function
+	// What it does:	Adds the doors of the pieces made by a layout generator to the graph, joining each right and top door to the
+	//					piece whose left or bottom edge meets it
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void ConnectLayoutPieces();
+
+
+	// Function:		Close Loops function
+	// What it does:	Finds the pairs of pieces sharing a long enough wall by sorting the sides of the pieces along each line and
+	//					sweeping along them, and adds doors between the pairs furthest apart in the graph, up to the loop budget.
+	//					Called once the layout is made and the graph is built, before the walls are built
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if a door couldn't be created
+	bool CloseLoops();
+
+
+	// Function:		Find Shared Walls function
+	// What it does:	Sweeps along two sorted lists of sides facing each other and adds each pair sharing a long enough wall to the
+	//					candidates. The sides in each list don't overlap, so this takes time in the length of the lists
+	// Takes in:		LoopWall - references to the right (or top) sides and the left (or bottom) sides, int - Side of the first piece
+	//					(RIGHT or UP), LoopCandidate - reference to the list of candidates
+	// Returns:			Nothing
+	void FindSharedWalls(vector<LoopWall> &Low, vector<LoopWall> &High, int Direction, vector<LoopCandidate> &Candidates);
+
+
+	// Function:		Add Loop Door function
+	// What it does:	Adds a door in the middle of the wall shared by the pieces of a candidate, on both pieces
+	// Takes in:		LoopCandidate - reference to the candidate
+	// Returns:			True if the door was created, false if not
+	bool AddLoopDoor(LoopCandidate &Candidate);
+
+
+	// Function:		Compare Loop Walls function
+	// What it does:	Orders sides by their line and then by where they start, for sorting
+	// Takes in:		LoopWall - references to the two sides
+	// Returns:			True if the first side comes first
+	static bool CompareLoopWalls(const LoopWall &First, const LoopWall &Second);
+
+
+	// Function:		Compare Loop Candidates function
+	// What it does:	Orders candidates by the most doors between their pieces first, then by the order they were found in
+	// Takes in:		LoopCandidate - references to the two candidates
+	// Returns:			True if the first candidate comes first
+	static bool CompareLoopCandidates(const LoopCandidate &First, const LoopCandidate &Second);
+
+
+	// Function:		Merge Walls function
+	// What it does:	Sorts the walls of every piece along the lines they are on and sweeps along each line. The collision segments
+	//					of walls that overlap or meet are joined whichever way they face, so a wall between two pieces (one wall
+	//					facing into each piece) is one segment. Walls facing the same way with the same texture are joined where
+	//					they overlap or meet, as the texture is placed from where each wall is along its line and so carries on
+	//					across the join, and a wall inside another facing the same way is dropped. Walls back to back are both kept
+	//					to be drawn, as each is only seen from the piece it faces into
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void MergeWalls();
+
+
+	// Function:		Compare Wall Lines and Compare Merge Walls functions
+	// What it does:	Order walls by their line and then by where they start, for sorting. Compare Merge Walls also keeps the walls
+	//					facing each way on a line apart
+	// Takes in:		MergeWall - references to the two walls
+	// Returns:			True if the first wall comes first
+	static bool CompareWallLines(const MergeWall &First, const MergeWall &Second);
+	static bool CompareMergeWalls(const MergeWall &First, const MergeWall &Second);
+
+
+	// Function:		Place Wave Collapse Pieces function
+	// What it does:	Builds the dungeon from a wave collapse tile map instead of placing pieces one at a time. Each tile is a room
+	//					or corridor with doors on the sides its sockets are open, and the tile in the middle of the map is the entrance.
+	//					Creates a dungeon piece and door sprites for each tile that can be reached from the entrance
+	// Takes in:		Nothing
+	// Returns:			True if the dungeon was built, false if the wave collapse couldn't find a map within its limits
+	bool PlaceWaveCollapsePieces();
+
+
+	// Function:		Place Scatter Pieces function
+	// What it does:	Builds the dungeon from a scatter generator layout instead of placing pieces one at a time. Rooms are scattered across
+	//					an area of the grid and joined by corridors, with the first room at the centre as the entrance
+	// Takes in:		Nothing
+	// Returns:			True if the dungeon was built, false if the layout couldn't be made
+	bool PlaceScatterPieces();
+
+
+	// Function:		Create Layout Piece function
+	// What it does:	Creates a dungeon piece for a piece of a layout made by one of the generators. Fills in the grid for it,
+	//					sets its doors so no more rooms are placed off it, and adds the door sprites for its right and top doors
+	//					(so that a door shared by two pieces is only added once)
+	// Takes in:		DungeonPieceClass::m_PieceType - Type of piece, D3DXVECTOR2 - Center of the piece, D3DXVECTOR2 - Width and height of the piece,
+	//					bool - Doors on the left, top, right and bottom sides
+	// Returns:			Pointer to the new dungeon piece, or 0 if it couldn't be created
+	DungeonPieceClass* CreateLayoutPiece(DungeonPieceClass::m_PieceType Type, D3DXVECTOR2 Center, D3DXVECTOR2 Size, bool LDoor, bool UDoor, bool RDoor, bool DDoor);
+
+
 
 
 // Private member variables
@@ -237,18 +920,88 @@ private:
 	int m_RoomsLimit;
 	int m_GridOffsetX;
 	int m_GridOffsetZ;
+	int m_GridSizeX, m_GridSizeY;
+	int m_CellsPerUnit;
+	int m_RequestedCellsPerUnit;
+	int m_LayoutUnitsPerCell;
+	int m_UsedStartX, m_UsedStartY;
+	int m_UsedEndX, m_UsedEndY;
+	int m_Generator;
+	int m_Placement;
+
+	// Generation progress, time limit and cancelling
+	int m_PiecesPlaced;
+	int m_FrontierSize;
+	int m_GenerationBudget;
+	clock_t m_GenerationStart;
+	bool m_GenerationStopped;
+	bool m_GenerationOutOfTime;
+	std::atomic<bool> m_CancelRequested;
+	GenerationProgressCallback m_ProgressCallback;
+	void* m_ProgressUserData;
+
+	// The metrics of the layout counted as each piece is placed, with the pieces leading off other pieces for the branching factor
+	LayoutMetrics m_Progress;
+	int m_ProgressBranches;
+	int m_ProgressBranchingPieces;
+
+	// The seed given to rand, and the deepest piece placed so far
+	unsigned int m_Seed;
+	bool m_SeedSet;
+	int m_MaxDepth;
+
+	// Index of the empty rectangles of the grid (only made for best fit placement), and the rectangles found behind the door being
+	// checked
+	EmptyRectIndexClass* m_EmptyRects;
+	vector<EmptyRectIndexClass::Rect> m_DoorRects;
+
+	// Pyramid of the filled positions in the grid, used to check areas of the grid quickly
+	OccupancyPyramidClass* m_Occupancy;
+
+	// Worker threads used to test placements, and the work shared with them
+	WorkerPoolClass* m_Workers;
+	int m_ThreadCount;
+	CandidateBatch* m_TestBatch;
+	int m_CandidateResults[PIECE_BATCH_SIZE];
+	FitSearch m_FitSearch;
 
 	// Dungeon piece pointer lists
 	list<DungeonPieceClass*> m_DungeonPieces;
-	list<DungeonPieceClass*> m_CeilingPieces;
 	list<DungeonPieceClass*> m_DoorPieces;
 
+	// The collision segments of the walls of the pieces, made by BuildWalls
+	vector<DungeonPieceClass::WallSegment> m_WallSegments;
+
+	// Cave mesh pointer lists
+	list<MeshClass*> m_CaveFloors;
+	list<MeshClass*> m_CaveCeilings;
+	list<MeshClass*> m_CaveWalls;
+	int m_CaveCount;
+
+	// Prefab room library and the prefab rooms placed in the dungeon
+	PrefabLibraryClass* m_PrefabLibrary;
+	bool m_SharedPrefabLibrary;
+	list<PrefabLibraryClass::Instance> m_PrefabInstances;
+
+	// Cache the textures of the pieces, meshes and prefab rooms are shared through
+	TextureCacheClass* m_TextureCache;
+	bool m_SharedTextureCache;
+
+	// Pool the vertices of the pieces and meshes are kept in, with the index buffer they all share
+	BufferPoolClass* m_BufferPool;
+
+	// Graph of the rooms and the doors joining them, and the doors of a generated layout waiting to be added to it
+	DungeonGraphClass* m_Graph;
+	vector<LayoutDoor> m_LayoutDoors;
+
+	// The most doors the loop closing pass can add
+	int m_LoopBudget;
+
 	// Room variables
 	int m_RoomChance;
 	int m_DoorDirection;	
 	D3DXVECTOR2 m_DoorPosition;
 	D3DXVECTOR2 m_WidthHeight;
-	D3DXVECTOR2	m_NewCenter;
 
 	// Player variables
 	D3DXVECTOR3 m_NextPlayerPosition;
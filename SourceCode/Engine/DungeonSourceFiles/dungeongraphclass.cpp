@@ -0,0 +1,356 @@
+#include "dungeongraphclass.h"
+
+
+// Function:		Dungeon Graph constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+DungeonGraphClass::DungeonGraphClass()
+{
+	m_TreeLevels = 0;
+}
+
+
+// Placeholder destructor
+DungeonGraphClass::~DungeonGraphClass()
+{
+}
+
+
+// Function:		Add Node function
+// What it does:	Adds a room to the graph
+// Takes in:		int - Kind of node (GRAPH_NODE values), DungeonPieceClass - pointer to the piece (or 0), D3DXVECTOR2 - Center
+// Returns:			int - Index of the new node
+
+int DungeonGraphClass::AddNode(int Kind, DungeonPieceClass* Piece, D3DXVECTOR2 Center)
+{
+	Node NewNode;
+	NewNode.Kind = Kind;
+	NewNode.Piece = Piece;
+	NewNode.Center = Center;
+	m_Nodes.push_back(NewNode);
+
+	// Let the piece know its node, so the doors placed off it can be added without searching for it
+	if (Piece)
+	{
+		Piece->m_GraphNode = (int)m_Nodes.size() - 1;
+	}
+
+	return (int)m_Nodes.size() - 1;
+}
+
+
+// Function:		Add Connection function
+// What it does:	Adds a door between two nodes. The graph has to be built again before the door can be found
+// Takes in:		int - Index of the node the door leaves from, int - Index of the node behind the door, int - Side of the first
+//					node the door is on, DungeonPieceClass - pointer to the door sprite (or 0)
+// Returns:			Nothing
+
+void DungeonGraphClass::AddConnection(int From, int To, int Direction, DungeonPieceClass* Door)
+{
+	// The side of the second node the door is on is the opposite side (LEFT and RIGHT, UP and DOWN)
+	int Opposite = (Direction % 4) + 1;
+	Opposite = (Opposite % 4) + 1;
+
+	Connection NewConnection;
+	NewConnection.From = From;
+	NewConnection.Door.To = To;
+	NewConnection.Door.Direction = Direction;
+	NewConnection.Door.Door = Door;
+	m_Connections.push_back(NewConnection);
+
+	NewConnection.From = To;
+	NewConnection.Door.To = From;
+	NewConnection.Door.Direction = Opposite;
+	m_Connections.push_back(NewConnection);
+}
+
+
+// Function:		Build function
+// What it does:	Sorts the doors added so far into the rows of each node
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonGraphClass::Build()
+{
+	int NodeCount = (int)m_Nodes.size();
+
+	// Count the doors leaving each node, and turn the counts into the offset of each node's first door
+	m_Offsets.assign(NodeCount + 1, 0);
+	for (unsigned int i = 0; i < m_Connections.size(); i++)
+	{
+		m_Offsets[m_Connections[i].From + 1]++;
+	}
+	for (int i = 0; i < NodeCount; i++)
+	{
+		m_Offsets[i + 1] += m_Offsets[i];
+	}
+
+	// Put each door in the next free place of its node's row. The doors of a node stay in the order they were added
+	vector<int> Next(m_Offsets.begin(), m_Offsets.end() - 1);
+	m_Edges.resize(m_Connections.size());
+	for (unsigned int i = 0; i < m_Connections.size(); i++)
+	{
+		m_Edges[Next[m_Connections[i].From]++] = m_Connections[i].Door;
+	}
+}
+
+
+// Function:		Get Node Count function
+// What it does:	Returns the number of nodes in the graph
+// Takes in:		Nothing
+// Returns:			int - Number of nodes
+
+int DungeonGraphClass::GetNodeCount()
+{
+	return (int)m_Nodes.size();
+}
+
+
+// Function:		Get Node function
+// What it does:	Returns one of the nodes
+// Takes in:		int - Index of the node
+// Returns:			Pointer to the node
+
+DungeonGraphClass::Node* DungeonGraphClass::GetNode(int Index)
+{
+	return &m_Nodes[Index];
+}
+
+
+// Function:		Get Degree function
+// What it does:	Returns the number of doors leaving a node in the built graph
+// Takes in:		int - Index of the node
+// Returns:			int - Number of doors
+
+int DungeonGraphClass::GetDegree(int Index)
+{
+	if ((Index < 0) || (Index + 1 >= (int)m_Offsets.size()))
+	{
+		return 0;
+	}
+
+	return m_Offsets[Index + 1] - m_Offsets[Index];
+}
+
+
+// Function:		Get Edges function
+// What it does:	Returns the doors leaving a node in the built graph, which follow each other in memory
+// Takes in:		int - Index of the node
+// Returns:			Pointer to the first door (GetDegree gives the number), or 0 if there are none
+
+DungeonGraphClass::Edge* DungeonGraphClass::GetEdges(int Index)
+{
+	if (GetDegree(Index) == 0)
+	{
+		return 0;
+	}
+
+	return &m_Edges[m_Offsets[Index]];
+}
+
+
+// Function:		Find Node function
+// What it does:	Finds the node of a dungeon piece
+// Takes in:		DungeonPieceClass - pointer to the piece
+// Returns:			int - Index of the node, or -1 if the piece isn't in the graph
+
+int DungeonGraphClass::FindNode(DungeonPieceClass* Piece)
+{
+	if ((!Piece) || (Piece->m_GraphNode < 0) || (Piece->m_GraphNode >= (int)m_Nodes.size()))
+	{
+		return -1;
+	}
+
+	// The piece keeps its node, but check it in case the piece belongs to another graph
+	if (m_Nodes[Piece->m_GraphNode].Piece != Piece)
+	{
+		return -1;
+	}
+
+	return Piece->m_GraphNode;
+}
+
+
+// Function:		Find Path function
+// What it does:	Finds a path through the fewest doors between two nodes with a breadth first search of the built graph
+// Takes in:		int - Index of the start and end nodes, vector<int> - reference to the list to fill with the nodes of the path
+//					(from the start to the end)
+// Returns:			True if the nodes are joined, false if not
+
+bool DungeonGraphClass::FindPath(int Start, int End, vector<int> &Path)
+{
+	int NodeCount = (int)m_Nodes.size();
+	Path.clear();
+	if ((Start < 0) || (End < 0) || (Start >= NodeCount) || (End >= NodeCount) || ((int)m_Offsets.size() != NodeCount + 1))
+	{
+		return false;
+	}
+
+	// Search out from the start, remembering the node each node was first reached from. The path list is used as the queue
+	m_Previous.assign(NodeCount, -1);
+	m_Previous[Start] = Start;
+	Path.push_back(Start);
+	for (unsigned int i = 0; (i < Path.size()) && (m_Previous[End] < 0); i++)
+	{
+		int Current = Path[i];
+		for (int e = m_Offsets[Current]; e < m_Offsets[Current + 1]; e++)
+		{
+			int Next = m_Edges[e].To;
+			if (m_Previous[Next] < 0)
+			{
+				m_Previous[Next] = Current;
+				Path.push_back(Next);
+			}
+		}
+	}
+
+	Path.clear();
+	if (m_Previous[End] < 0)
+	{
+		return false;
+	}
+
+	// Follow the nodes back from the end, then put them in order from the start
+	for (int Current = End; Current != Start; Current = m_Previous[Current])
+	{
+		Path.push_back(Current);
+	}
+	Path.push_back(Start);
+	for (unsigned int i = 0; i < Path.size() / 2; i++)
+	{
+		int Swap = Path[i];
+		Path[i] = Path[Path.size() - 1 - i];
+		Path[Path.size() - 1 - i] = Swap;
+	}
+
+	return true;
+}
+
+
+// Function:		Build Tree function
+// What it does:	Finds the tree of the shortest paths from one node with a breadth first search of the built graph, and the
+//					ancestors of each node in the tree at every power of two above it, so tree distances take log time to find
+// Takes in:		int - Index of the root node
+// Returns:			Nothing
+
+void DungeonGraphClass::BuildTree(int Root)
+{
+	int NodeCount = (int)m_Nodes.size();
+	m_TreeDepths.assign(NodeCount, -1);
+	m_TreeLevels = 0;
+	m_Ancestors.clear();
+	if ((Root < 0) || (Root >= NodeCount) || ((int)m_Offsets.size() != NodeCount + 1))
+	{
+		return;
+	}
+
+	// Use enough levels for a jump of the deepest possible node
+	m_TreeLevels = 1;
+	while ((1 << m_TreeLevels) < NodeCount)
+	{
+		m_TreeLevels++;
+	}
+	m_Ancestors.assign(m_TreeLevels * NodeCount, Root);
+
+	// Search out from the root, keeping the node each node was first reached from as its parent. Nodes that can't be reached
+	// keep a depth of -1
+	vector<int> Queue;
+	Queue.reserve(NodeCount);
+	Queue.push_back(Root);
+	m_TreeDepths[Root] = 0;
+	for (unsigned int i = 0; i < Queue.size(); i++)
+	{
+		int Current = Queue[i];
+		for (int e = m_Offsets[Current]; e < m_Offsets[Current + 1]; e++)
+		{
+			int Next = m_Edges[e].To;
+			if (m_TreeDepths[Next] < 0)
+			{
+				m_TreeDepths[Next] = m_TreeDepths[Current] + 1;
+				m_Ancestors[Next] = Current;
+				Queue.push_back(Next);
+			}
+		}
+	}
+
+	// The ancestor 2^k levels up is the ancestor 2^(k-1) levels up of the ancestor 2^(k-1) levels up
+	for (int k = 1; k < m_TreeLevels; k++)
+	{
+		int* Previous = &m_Ancestors[(k - 1) * NodeCount];
+		int* Level = &m_Ancestors[k * NodeCount];
+		for (int i = 0; i < NodeCount; i++)
+		{
+			Level[i] = Previous[Previous[i]];
+		}
+	}
+}
+
+
+// Function:		Get Tree Distance function
+// What it does:	Finds the number of doors on the path between two nodes through the tree made by BuildTree
+// Takes in:		int - Index of the two nodes
+// Returns:			int - Number of doors, or -1 if either node can't be reached from the root
+
+int DungeonGraphClass::GetTreeDistance(int First, int Second)
+{
+	int NodeCount = (int)m_TreeDepths.size();
+	if ((First < 0) || (Second < 0) || (First >= NodeCount) || (Second >= NodeCount) ||
+		(m_TreeDepths[First] < 0) || (m_TreeDepths[Second] < 0))
+	{
+		return -1;
+	}
+
+	// Lift the deeper node up to the depth of the other, one power of two at a time
+	int A = First;
+	int B = Second;
+	if (m_TreeDepths[A] < m_TreeDepths[B])
+	{
+		int Swap = A;
+		A = B;
+		B = Swap;
+	}
+	int Difference = m_TreeDepths[A] - m_TreeDepths[B];
+	for (int k = 0; Difference > 0; k++, Difference >>= 1)
+	{
+		if (Difference & 1)
+		{
+			A = m_Ancestors[(k * NodeCount) + A];
+		}
+	}
+
+	// Lift both nodes up together to just below the lowest ancestor they share
+	if (A != B)
+	{
+		for (int k = m_TreeLevels - 1; k >= 0; k--)
+		{
+			if (m_Ancestors[(k * NodeCount) + A] != m_Ancestors[(k * NodeCount) + B])
+			{
+				A = m_Ancestors[(k * NodeCount) + A];
+				B = m_Ancestors[(k * NodeCount) + B];
+			}
+		}
+		A = m_Ancestors[A];
+	}
+
+	return m_TreeDepths[First] + m_TreeDepths[Second] - (2 * m_TreeDepths[A]);
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the nodes and doors
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void DungeonGraphClass::Shutdown()
+{
+	m_Nodes.clear();
+	m_Connections.clear();
+	m_Offsets.clear();
+	m_Edges.clear();
+	m_Previous.clear();
+	m_TreeDepths.clear();
+	m_Ancestors.clear();
+	m_TreeLevels = 0;
+}
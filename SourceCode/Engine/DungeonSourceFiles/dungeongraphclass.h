@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: dungeongraphclass.h
+// Dungeon Graph Class
+// Holds which rooms of the dungeon are joined by doors, so the connections of a room can be found without the geometry
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DUNGEON_GRAPH_CLASS_H
+#define DUNGEON_GRAPH_CLASS_H
+
+#include <d3dx10math.h>
+
+// For vector
+#include <vector>
+using std::vector;
+
+#include "dungeonpiececlass.h"
+
+// The kinds of node in the graph
+#define GRAPH_NODE_PIECE 0
+#define GRAPH_NODE_PREFAB 1
+#define GRAPH_NODE_CAVE 2
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DungeonGraphClass
+// Nodes (dungeon pieces, prefab rooms and caves) and the doors joining them are added while the dungeon is generated. Build then
+// sorts the doors by the node they leave from into one array, with each node keeping the offset of its first door (compressed
+// sparse rows), so the doors of a node are a run of the array and finding them takes time in the number of doors it has. Each
+// door is kept in both directions
+////////////////////////////////////////////////////////////////////////////////
+class DungeonGraphClass
+{
+public:
+	// A room of the dungeon. Piece is the dungeon piece for GRAPH_NODE_PIECE nodes and 0 for the others
+	struct Node
+	{
+		int Kind;
+		DungeonPieceClass* Piece;
+		D3DXVECTOR2 Center;
+	};
+
+	// A door leaving a node. Direction is the side of the node the door is on (LEFT, RIGHT, UP or DOWN), and Door is the door
+	// sprite for the map (0 if there isn't one)
+	struct Edge
+	{
+		int To;
+		int Direction;
+		DungeonPieceClass* Door;
+	};
+
+	// Function:		Dungeon Graph constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	DungeonGraphClass();
+
+
+	// Placeholder destructor
+	~DungeonGraphClass();
+
+
+	// Function:		Add Node function
+	// What it does:	Adds a room to the graph
+	// Takes in:		int - Kind of node (GRAPH_NODE values), DungeonPieceClass - pointer to the piece (or 0), D3DXVECTOR2 - Center
+	// Returns:			int - Index of the new node
+	int AddNode(int Kind, DungeonPieceClass* Piece, D3DXVECTOR2 Center);
+
+
+	// Function:		Add Connection function
+	// What it does:	Adds a door between two nodes. The graph has to be built again before the door can be found
+	// Takes in:		int - Index of the node the door leaves from, int - Index of the node behind the door, int - Side of the first
+	//					node the door is on, DungeonPieceClass - pointer to the door sprite (or 0)
+	// Returns:			Nothing
+	void AddConnection(int From, int To, int Direction, DungeonPieceClass* Door);
+
+
+	// Function:		Build function
+	// What it does:	Sorts the doors added so far into the rows of each node
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Build();
+
+
+	// Function:		Get Node Count function
+	// What it does:	Returns the number of nodes in the graph
+	// Takes in:		Nothing
+	// Returns:			int - Number of nodes
+	int GetNodeCount();
+
+
+	// Function:		Get Node function
+	// What it does:	Returns one of the nodes
+	// Takes in:		int - Index of the node
+	// Returns:			Pointer to the node
+	Node* GetNode(int Index);
+
+
+	// Function:		Get Degree function
+	// What it does:	Returns the number of doors leaving a node in the built graph
+	// Takes in:		int - Index of the node
+	// Returns:			int - Number of doors
+	int GetDegree(int Index);
+
+
+	// Function:		Get Edges function
+	// What it does:	Returns the doors leaving a node in the built graph, which follow each other in memory
+	// Takes in:		int - Index of the node
+	// Returns:			Pointer to the first door (GetDegree gives the number), or 0 if there are none
+	Edge* GetEdges(int Index);
+
+
+	// Function:		Find Node function
+	// What it does:	Finds the node of a dungeon piece
+	// Takes in:		DungeonPieceClass - pointer to the piece
+	// Returns:			int - Index of the node, or -1 if the piece isn't in the graph
+	int FindNode(DungeonPieceClass* Piece);
+
+
+	// Function:		Find Path function
+	// What it does:	Finds a path through the fewest doors between two nodes with a breadth first search of the built graph
+	// Takes in:		int - Index of the start and end nodes, vector<int> - reference to the list to fill with the nodes of the path
+	//					(from the start to the end)
+	// Returns:			True if the nodes are joined, false if not
+	bool FindPath(int Start, int End, vector<int> &Path);
+
+
+	// Function:		Build Tree function
+	// What it does:	Finds the tree of the shortest paths from one node with a breadth first search of the built graph, and the
+	//					ancestors of each node in the tree at every power of two above it, so tree distances take log time to find
+	// Takes in:		int - Index of the root node
+	// Returns:			Nothing
+	void BuildTree(int Root);
+
+
+	// Function:		Get Tree Distance function
+	// What it does:	Finds the number of doors on the path between two nodes through the tree made by BuildTree
+	// Takes in:		int - Index of the two nodes
+	// Returns:			int - Number of doors, or -1 if either node can't be reached from the root
+	int GetTreeDistance(int First, int Second);
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the nodes and doors
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// A door as it was added, before the graph is built
+	struct Connection
+	{
+		int From;
+		Edge Door;
+	};
+
+	// The nodes, and the doors added to them
+	vector<Node> m_Nodes;
+	vector<Connection> m_Connections;
+
+	// The built graph. The doors of node i are m_Edges[m_Offsets[i]] up to m_Edges[m_Offsets[i + 1]]
+	vector<int> m_Offsets;
+	vector<Edge> m_Edges;
+
+	// The node each node was reached from in the last path search
+	vector<int> m_Previous;
+
+	// The tree made by BuildTree. The depth of each node, and its ancestor 2^k levels up at m_Ancestors[(k * node count) + node]
+	vector<int> m_TreeDepths;
+	vector<int> m_Ancestors;
+	int m_TreeLevels;
+};
+
+
+#endif
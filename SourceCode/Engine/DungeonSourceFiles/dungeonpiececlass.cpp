@@ -26,12 +26,18 @@ DungeonPieceClass::DungeonPieceClass(m_PieceType Type, int Direction)
 	m_UpperSizeLimit = D3DXVECTOR2(0.0f, 0.0f);
 	m_Device = 0;
 	m_DeviceContext = 0;
-	m_VertexBuffer = 0;
-	m_IndexBuffer = 0;
+	m_TextureCache = 0;
+	m_BufferPool = 0;
+	m_Vertices.Page = -1;
+	m_Vertices.Offset = 0;
+	m_Vertices.Bytes = 0;
 	m_VertexCount = 0;
 	m_IndexCount = 0;
+	m_CompactVertices = false;
+	m_CompactOrigin = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	m_MapTexture = 0;
 	m_DungeonTexture = 0;
+	m_DungeonTextureFile = 0;
 	m_TextureScale = D3DXVECTOR2(1.0f, 1.0f);
 	m_Normal = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	WallsGenerated = false;
@@ -43,6 +49,16 @@ DungeonPieceClass::DungeonPieceClass(m_PieceType Type, int Direction)
 	m_RDoor = false;
 	m_UDoor = false;
 	m_DDoor = false;
+	m_LDoorOffset = 0.0f;
+	m_RDoorOffset = 0.0f;
+	m_UDoorOffset = 0.0f;
+	m_DDoorOffset = 0.0f;
+	m_Depth = 0;
+	m_LayoutX = 0;
+	m_LayoutY = 0;
+	m_LayoutWidth = 0;
+	m_LayoutHeight = 0;
+	m_GraphNode = -1;
 
 	// Sets the door leading to the parent room to true, so that in MakeRoom function
 	// it doesn't try to create a door here because there is a room here already
@@ -80,11 +96,12 @@ DungeonPieceClass::~DungeonPieceClass()
 //					the dungeon piece was set to in the constructor, using the room limit passed into this function
 //					Calls the appropriate function for creating the room, and initialises for rendering
 // Takes in:		ID3D11Device - pointer to DirectX device, ID3D11DeviceContext - Pointer to DirectX device context,
-//					D3DXVECTOR2 - center of this piece, float - Width of this piece, float - Height of this piece
+//					TextureCacheClass - pointer to the cache the textures are shared from, BufferPoolClass - pointer to the pool
+//					the vertices are kept in, D3DXVECTOR2 - center of this piece, float - Width of this piece, float - Height of this piece
 //					int - The door limit for the amount of rooms that can be created leading from this room
 // Returns:			True if all initialisation has happened successfully, false if not
 
-bool DungeonPieceClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, D3DXVECTOR2 Center, float Width, float Height, int RoomLimit)
+bool DungeonPieceClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, TextureCacheClass* TextureCache, BufferPoolClass* BufferPool, D3DXVECTOR2 Center, float Width, float Height, int RoomLimit)
 {
 	bool result;		// For error checking
 	
@@ -99,15 +116,23 @@ bool DungeonPieceClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* De
 
 	// So these can be used in the mesh initialisation function without having to pass the device and context through
 	m_Device = Device;
-	if (!m_Device)
-	{
-		return false;
-	}
-
 	m_DeviceContext = DeviceContext;
-	if (!m_DeviceContext)
+	m_TextureCache = TextureCache;
+	m_BufferPool = BufferPool;
+
+	// If there is no device, only the layout of the piece is made. Rooms still pick their doors using rand in the same way, so the
+	// layout is the same as a dungeon made from the same seed with a device, but no textures or buffers are created
+	if ((!m_Device) || (!m_DeviceContext) || (!m_TextureCache) || (!m_BufferPool))
 	{
-		return false;
+		if ((m_TypeOfPiece == ROOM) && (m_RoomsLimit != 0))
+		{
+			ChooseDoors(rand() % m_RoomsLimit + 1);
+		}
+		if (m_TypeOfPiece == ENTRANCE)
+		{
+			ChooseDoors(4);
+		}
+		return true;
 	}
 
 	// If the type of room is a normal room, find a random number between 1 and the room limit 
@@ -153,12 +178,6 @@ bool DungeonPieceClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* De
 		result = MakeHorizontalCorridor();
 	}
 
-	// If the type of room is a ceiling, create the ceiling sprite (drawn anti clockwise so that it shows above the player)
-	if (m_TypeOfPiece == CEILING)
-	{
-		result = MakeCeiling();
-	}
-
 	// If the room creation fails, return false as this is an error
 	if (!result)
 	{
@@ -190,9 +209,8 @@ DungeonPieceClass::m_PieceType DungeonPieceClass::GetPieceType()
 
 
 // Function:		Make Room function 
-// What it does:	Loops through the number of rooms passed in, to decide the directions available for
-//					the new rooms randomly. Checks to see if a door isn't already in this place, then makes 
-//					a door in that place up until the room limit count. Also loads in the textures for the rooms and 
+// What it does:	Uses Choose Doors to decide the directions of the doors for the new rooms up until the room limit count.
+//					Also loads in the textures for the rooms and 
 //					sets the texture scale for normal rooms.
 // Takes in:		int - Number of rooms limit so that room only creates this amount of doors
 // Returns:			True if function has completed properly, false if not
@@ -201,6 +219,43 @@ bool DungeonPieceClass::MakeRoom(int NumOfRooms)
 {
 	bool result;		// For error checking
 
+	// Pick the directions of the doors
+	ChooseDoors(NumOfRooms);
+
+	// When placing a new piece in the dungeon, it checks to see which door directions are available, so the doors
+	// that are set above will be used to create a new room 
+
+	// Load the texture for the room piece
+	if (m_TypeOfPiece == ROOM)
+	{
+		// Loads in the texture used for the map and for the actual dungeon
+		result = LoadTextures(L"data/room.png", L"data/wooden_floors.png");
+	}
+	else if (m_TypeOfPiece == ENTRANCE)
+	{
+		result = LoadTextures(L"data/entrance.png", L"data/wooden_floors.png");
+	}
+	if (!result)
+	{
+		return false;
+	}
+
+	// Set the texture scale for the floor of the rooms so that the texture repeats twice in both u and v directions
+	m_TextureScale = D3DXVECTOR2(1.0f, 1.0f);
+
+	// Return true if there were no errors
+	return true;		
+}
+
+
+// Function:		Choose Doors function
+// What it does:	Loops through the number of rooms passed in, to decide the directions available for the new rooms randomly.
+//					Checks to see if a door isn't already in this place, then makes a door in that place up until the room limit count
+// Takes in:		int - Number of rooms limit so that room only creates this amount of doors
+// Returns:			Nothing
+
+void DungeonPieceClass::ChooseDoors(int NumOfRooms)
+{
 	int RoomCount = 0;
 
 	// While the exits created have not reached the number of exits to create
@@ -260,30 +315,6 @@ bool DungeonPieceClass::MakeRoom(int NumOfRooms)
 			}
 		}
 	}
-
-	// When placing a new piece in the dungeon, it checks to see which door directions are available, so the doors
-	// that are set above will be used to create a new room 
-
-	// Load the texture for the room piece
-	if (m_TypeOfPiece == ROOM)
-	{
-		// Loads in the texture used for the map and for the actual dungeon
-		result = LoadTextures(L"data/room.png", L"data/wooden_floors.png");
-	}
-	else if (m_TypeOfPiece == ENTRANCE)
-	{
-		result = LoadTextures(L"data/entrance.png", L"data/wooden_floors.png");
-	}
-	if (!result)
-	{
-		return false;
-	}
-
-	// Set the texture scale for the floor of the rooms so that the texture repeats twice in both u and v directions
-	m_TextureScale = D3DXVECTOR2(1.0f, 1.0f);
-
-	// Return true if there were no errors
-	return true;		
 }
 
 
@@ -380,195 +411,121 @@ bool DungeonPieceClass::MakeVerticalCorridor()
 }
 
 
-// Function:		Make Ceiling function
-// What it does:	Loads in the textures for the ceiling piece and sets the texture scale
-// Takes in:		Nothing
-// Returns:			True if textures loaded properly, false if not
-
-bool DungeonPieceClass::MakeCeiling()
-{
-	bool result;		// For error checking
-
-	// Load the texture for the ceiling piece
-	result = LoadTextures(L"data/room.png", L"data/wooden_floors.png");
-
-	// If texture loading wasn't successful, return false
-	if (!result)
-	{
-		return false;
-	}
-
-	// Set the texture scale so that it repeats in both the x and y axis twice
-	m_TextureScale = D3DXVECTOR2(2.0f, 2.0f);
-
-	return true;		// No errors
-}
-
-
 // Function:		Build Walls function
-// What it does:	Creates the meshes used for the walls, setting up two seperate walls with a space between
-//					for a wall with a door in the middle, and a single wall if a door is not present in that wall
+// What it does:	Creates the wall geometry of the piece, setting up two seperate walls with a space between for a wall with
+//					a door in it, and a single wall if a door is not present in that wall. Each wall is also added to the segment
+//					list used for the collision grid. The geometry is kept until it is added to the dungeon's static batch
 //					This function is called after all of the dungeon pieces have been created in the Application Class
 //					to make sure the walls are only created after all rooms and doors have been set 	
 // Takes in:		Nothing
-// Returns:			Nothing
+// Returns:			True if the walls were created, false if not
 
-void DungeonPieceClass::BuildWalls()
+bool DungeonPieceClass::BuildWalls()
 {
-	// Set the texture scales for walls without doors, and walls with doors
-	D3DXVECTOR2 DoorTextureScale = D3DXVECTOR2(1.0f, 2.0f);
-	D3DXVECTOR2 WallTextureScale = D3DXVECTOR2(2.0f, 2.0f);
-	
 	D3DXVECTOR3 Normal = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 
+	// Find the middle of the door in each wall
+	float NorthDoor = m_Center.x + m_UDoorOffset;
+	float EastDoor = m_Center.y + m_RDoorOffset;
+	float SouthDoor = m_Center.x + m_DDoorOffset;
+	float WestDoor = m_Center.y + m_LDoorOffset;
+
+	// The corners of the piece on the floor
+	float Left = m_Center.x - m_HalfWidth;
+	float Right = m_Center.x + m_HalfWidth;
+	float Top = m_Center.y + m_HalfHeight;
+	float Bottom = m_Center.y - m_HalfHeight;
+
+	// The walls are added to the piece's wall list, which is drawn from the dungeon's static batch
+	m_Walls.clear();
+	WallSegments.clear();
+
 	// Wall Initialisations
 
 	// North Wall
 	Normal = D3DXVECTOR3(0.0f, 0.0f, -1.0f);		// This is the normal for north walls
-	// If the north wall has a door, create two walls with a space between them for the door and add them to the wall list
+	// If the north wall has a door, add two walls with a space between them for the door
 	if (m_UDoor)
 	{
-		MeshClass *NorthLeftWall = new MeshClass();
-		NorthLeftWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),	// Bottom Left
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight), // Top Left
-																						D3DXVECTOR3(m_Center.x - 0.3f, 1.5f, m_Center.y + m_HalfHeight),		// Top Right
-																						D3DXVECTOR3(m_Center.x - 0.3f, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Right
-																						Normal, DoorTextureScale);
-		Walls.push_back(NorthLeftWall);
-
-
-		MeshClass *NorthRightWall = new MeshClass();
-		NorthRightWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + 0.3f, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Left
-																						D3DXVECTOR3(m_Center.x + 0.3f, 1.5f, m_Center.y + m_HalfHeight),		// Top Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),	// Top Right
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),	// Bottom Right
-																						Normal, DoorTextureScale);
-		Walls.push_back(NorthRightWall);
+		AddWall(D3DXVECTOR2(Left, Top), D3DXVECTOR2(NorthDoor - DOOR_HALF_WIDTH, Top), Normal);
+		AddWall(D3DXVECTOR2(NorthDoor + DOOR_HALF_WIDTH, Top), D3DXVECTOR2(Right, Top), Normal);
 	}
-	// Else create a single wall the width of the room in this position and add it to the walls list
+	// Else add a single wall the width of the room in this position
 	else
 	{
-		MeshClass *NorthWall = new MeshClass();
-		NorthWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Left
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),		// Top Left
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),		// Top Right
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Right
-																					Normal, WallTextureScale);
-		Walls.push_back(NorthWall);
+		AddWall(D3DXVECTOR2(Left, Top), D3DXVECTOR2(Right, Top), Normal);
 	}
 
 	// East wall
 	Normal = D3DXVECTOR3(-1.0f, 0.0f, 0.0f);		// This is the normal for east walls
-	// If the east wall has a door, create two walls with a space between them for the door and add them to the wall list
+	// If the east wall has a door, add two walls with a space between them for the door
 	if (m_RDoor)
 	{
-		MeshClass *EastLeftWall = new MeshClass();
-
-		EastLeftWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),	// Bottom Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),	// Top Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y + 0.3f),			// Top Right
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y + 0.3f),			// Bottom Right
-																						Normal, DoorTextureScale);	
-		Walls.push_back(EastLeftWall);
-
-		MeshClass *EastRightWall = new MeshClass();
-
-		EastRightWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y - 0.3f),			// Bottom Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y - 0.3f),			// Top Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),	// Top Right
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),	// Bottom Right
-																						Normal, DoorTextureScale);
-		Walls.push_back(EastRightWall);
+		AddWall(D3DXVECTOR2(Right, Top), D3DXVECTOR2(Right, EastDoor + DOOR_HALF_WIDTH), Normal);
+		AddWall(D3DXVECTOR2(Right, EastDoor - DOOR_HALF_WIDTH), D3DXVECTOR2(Right, Bottom), Normal);
 	}
-	// Else create a single wall the height of the room in this position and add it to the walls list
+	// Else add a single wall the height of the room in this position
 	else
 	{
-		MeshClass *EastWall = new MeshClass();
-
-		EastWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Left
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),		// Top Left
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),		// Top Right
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Right
-																					Normal, WallTextureScale);
-		Walls.push_back(EastWall);
+		AddWall(D3DXVECTOR2(Right, Top), D3DXVECTOR2(Right, Bottom), Normal);
 	}
 
 	// South wall
 	Normal = D3DXVECTOR3(0.0f, 0.0f, 1.0f);			// This is the normal for south walls
-	// If the south wall has a door, create two walls with a space between them for the door and add them to the wall list
+	// If the south wall has a door, add two walls with a space between them for the door
 	if (m_DDoor)
 	{
-		MeshClass *SouthLeftWall = new MeshClass();
-		SouthLeftWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),	// Bottom Left
-																						D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),	// Top Left
-																						D3DXVECTOR3(m_Center.x + 0.3f, 1.5f,  m_Center.y - m_HalfHeight),		// Top Right
-																						D3DXVECTOR3(m_Center.x + 0.3f, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Right
-																						Normal, DoorTextureScale);	
-
-		Walls.push_back(SouthLeftWall);
-
-		MeshClass *SouthRightWall = new MeshClass();
-		SouthRightWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - 0.3f, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Left
-																						D3DXVECTOR3(m_Center.x - 0.3f, 1.5f, m_Center.y - m_HalfHeight),		// Top Left
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),	// Top Right
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),	// Bottom Right
-																						Normal, DoorTextureScale);
-
-		Walls.push_back(SouthRightWall);
+		AddWall(D3DXVECTOR2(Right, Bottom), D3DXVECTOR2(SouthDoor + DOOR_HALF_WIDTH, Bottom), Normal);
+		AddWall(D3DXVECTOR2(SouthDoor - DOOR_HALF_WIDTH, Bottom), D3DXVECTOR2(Left, Bottom), Normal);
 	}
-	// Else create a single wall the width of the room in this position and add it to the walls list
+	// Else add a single wall the width of the room in this position
 	else
 	{
-		MeshClass *SouthWall = new MeshClass();
-
-		SouthWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x + m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Left
-																					D3DXVECTOR3(m_Center.x + m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),		// Top Left
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),		// Top Right
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Right
-																					Normal, WallTextureScale);
-
-		Walls.push_back(SouthWall);
+		AddWall(D3DXVECTOR2(Right, Bottom), D3DXVECTOR2(Left, Bottom), Normal);
 	}
 
 	// West wall
 	Normal = D3DXVECTOR3(1.0f, 0.0f, 0.0f);			// This is the normal for west walls
-	// If the west wall has a door, create two walls with a space between them for the door and add them to the wall list
+	// If the west wall has a door, add two walls with a space between them for the door
 	if (m_LDoor)
 	{
-		MeshClass *WestLeftWall = new MeshClass();
-		WestLeftWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),	// Bottom Left
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),	// Top Left
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y - 0.3f),			// Top Right
-																						D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y - 0.3f),			// Bottom Right
-																						Normal, DoorTextureScale);
-
-		Walls.push_back(WestLeftWall);
-
-		MeshClass *WestRightWall = new MeshClass();
-		WestRightWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y + 0.3f),			// Bottom Left
-																				D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y + 0.3f),					// Top Left
-																				D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),			// Top Right
-																				D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),			// Bottom Right
-																				Normal, DoorTextureScale);
-
-		Walls.push_back(WestRightWall);
+		AddWall(D3DXVECTOR2(Left, Bottom), D3DXVECTOR2(Left, WestDoor - DOOR_HALF_WIDTH), Normal);
+		AddWall(D3DXVECTOR2(Left, WestDoor + DOOR_HALF_WIDTH), D3DXVECTOR2(Left, Top), Normal);
 	}
-	// Else create a single wall the height of the room in this position and add it to the walls list
+	// Else add a single wall the height of the room in this position
 	else
 	{
-		MeshClass *WestWall = new MeshClass();
-
-		WestWall->Initialize(m_Device, m_DeviceContext, L"data/stone_walls.png",	D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y - m_HalfHeight),		// Bottom Left
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y - m_HalfHeight),		// Top Left
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 1.5f, m_Center.y + m_HalfHeight),		// Top Right
-																					D3DXVECTOR3(m_Center.x - m_HalfWidth, 0.0f, m_Center.y + m_HalfHeight),		// Bottom Right
-																					Normal, WallTextureScale);
-
-		Walls.push_back(WestWall);
+		AddWall(D3DXVECTOR2(Left, Bottom), D3DXVECTOR2(Left, Top), Normal);
 	}
 
 	// Set walls generated to true for this dungeon piece, so that the scene can now begin rendering them
 	WallsGenerated = true;
+
+	return true;
+}
+
+
+// Function:		Add Wall function
+// What it does:	Adds a wall quad to the wall list, and the wall's segment to the segment list
+// Takes in:		D3DXVECTOR2 - start and end of the wall on the floor (left to right when looked at from inside the piece),
+//					D3DXVECTOR3 - normal
+// Returns:			Nothing
+
+void DungeonPieceClass::AddWall(D3DXVECTOR2 Start, D3DXVECTOR2 End, D3DXVECTOR3 Normal)
+{
+	Wall NewWall;
+	NewWall.Start = Start;
+	NewWall.End = End;
+	NewWall.Normal = Normal;
+	m_Walls.push_back(NewWall);
+
+	// Keep the segment with its ends in increasing order along the axis it runs along, as the collision grid is filled that way
+	WallSegment Segment;
+	Segment.AlongXAxis = (Start.x != End.x);
+	bool Reversed = Segment.AlongXAxis ? (End.x < Start.x) : (End.y < Start.y);
+	Segment.Start = Reversed ? End : Start;
+	Segment.End = Reversed ? Start : End;
+	WallSegments.push_back(Segment);
 }
 
 
@@ -609,30 +566,51 @@ void DungeonPieceClass::SetSizeLimits()
 
 D3DXVECTOR2 DungeonPieceClass::GetWidthAndHeight(m_PieceType NewPieceType)
 {
-	D3DXVECTOR2 WidthHeight = D3DXVECTOR2(0.0f, 0.0f);
+	int Width, Height;
+
+	// Find the size in tenths, and change it into units
+	GetLayoutSize(Width, Height);
+
+	// Return the new randomised width and height
+	return D3DXVECTOR2((float)Width / 10, (float)Height / 10);
+}
+
+
+// Function:		Get Layout Size function
+// What it does:	Finds a random width and height in tenths between the size limits of this piece, in steps of PIECE_SIZE_STEP
+//					and using rand in the same way as GetWidthAndHeight
+// Takes in:		int - references to the width and height
+// Returns:			Nothing
 
-	// Set the rand values to the lower size limit at first
-	float RandValueX = m_LowerSizeLimit.x;
-	float RandValueY = m_UpperSizeLimit.y;
+void DungeonPieceClass::GetLayoutSize(int &Width, int &Height)
+{
+	// Set the sizes to the lower size limit at first
+	int Lower_x = (int)m_LowerSizeLimit.x;
+	int Lower_y = (int)m_LowerSizeLimit.y;
+	Width = Lower_x;
+	Height = (int)m_UpperSizeLimit.y;
 
-	// If the lower and upper limits don't match then find a random value between them
+	// If the lower and upper limits don't match then find a random value between them, rounded down to a whole step
 	if (m_UpperSizeLimit.x != m_LowerSizeLimit.x)
 	{
-		RandValueX = rand() % (int)(m_UpperSizeLimit.x - m_LowerSizeLimit.x) + m_LowerSizeLimit.x;
+		Width = (((rand() % ((int)m_UpperSizeLimit.x - Lower_x)) / PIECE_SIZE_STEP) * PIECE_SIZE_STEP) + Lower_x;
 	}
 	if (m_UpperSizeLimit.y != m_LowerSizeLimit.y)
 	{
-		RandValueY = rand() % (int)(m_UpperSizeLimit.y - m_LowerSizeLimit.y) + m_LowerSizeLimit.y;
+		Height = (((rand() % ((int)m_UpperSizeLimit.y - Lower_y)) / PIECE_SIZE_STEP) * PIECE_SIZE_STEP) + Lower_y;
 	}
+}
 
-	// Set the width and height vector to these values
-	WidthHeight.x = floor(RandValueX);
-	WidthHeight.x = WidthHeight.x / int(10);
-	WidthHeight.y = floor(RandValueY);
-	WidthHeight.y = WidthHeight.y / int(10);
 
-	// Return the new randomised width and height
-	return WidthHeight;
+// Function:		Get Size Limits function
+// What it does:	Gets the size limits used for this type of piece (in tenths, the same as GetWidthAndHeight uses)
+// Takes in:		D3DXVECTOR2 - references to the smallest and largest size limits
+// Returns:			Nothing
+
+void DungeonPieceClass::GetSizeLimits(D3DXVECTOR2 &Lower, D3DXVECTOR2 &Upper)
+{
+	Lower = m_LowerSizeLimit;
+	Upper = m_UpperSizeLimit;
 }
 
 
@@ -663,22 +641,22 @@ D3DXVECTOR2 DungeonPieceClass::GetDoorPosition(int DoorDirection, DungeonPieceCl
 	// By looking at the center, height and width of the dungeon piece
 	if (DoorDirection == LEFT)
 	{
-		D3DXVECTOR2 RightSide = D3DXVECTOR2((ThisPiece->m_Center.x + ThisPiece->m_HalfWidth), ThisPiece->m_Center.y); 
+		D3DXVECTOR2 RightSide = D3DXVECTOR2((ThisPiece->m_Center.x + ThisPiece->m_HalfWidth), ThisPiece->m_Center.y + ThisPiece->m_RDoorOffset);
 		center = RightSide;
 	}
 	if (DoorDirection == RIGHT)
 	{
-		D3DXVECTOR2 LeftSide = D3DXVECTOR2((ThisPiece->m_Center.x - ThisPiece->m_HalfWidth), ThisPiece->m_Center.y);
+		D3DXVECTOR2 LeftSide = D3DXVECTOR2((ThisPiece->m_Center.x - ThisPiece->m_HalfWidth), ThisPiece->m_Center.y + ThisPiece->m_LDoorOffset);
 		center = LeftSide;
 	}
 	if (DoorDirection == UP)
 	{
-		D3DXVECTOR2 DownSide = D3DXVECTOR2(ThisPiece->m_Center.x, (ThisPiece->m_Center.y - ThisPiece->m_HalfHeight));
+		D3DXVECTOR2 DownSide = D3DXVECTOR2(ThisPiece->m_Center.x + ThisPiece->m_DDoorOffset, (ThisPiece->m_Center.y - ThisPiece->m_HalfHeight));
 		center = DownSide;
 	}
 	if (DoorDirection == DOWN)
 	{
-		D3DXVECTOR2 UpSide = D3DXVECTOR2(ThisPiece->m_Center.x, (ThisPiece->m_Center.y + ThisPiece->m_HalfHeight));
+		D3DXVECTOR2 UpSide = D3DXVECTOR2(ThisPiece->m_Center.x + ThisPiece->m_UDoorOffset, (ThisPiece->m_Center.y + ThisPiece->m_HalfHeight));
 		center = UpSide;
 	}
 
@@ -698,6 +676,28 @@ int DungeonPieceClass::GetIndexCount()
 }
 
 
+// Function:		Is Compact function
+// What it does:	Returns whether the piece's vertex buffer holds compact vertices, so it is drawn with the compact shaders
+// Takes in:		Nothing
+// Returns:			bool - True if the vertices are compact
+
+bool DungeonPieceClass::IsCompact()
+{
+	return m_CompactVertices;
+}
+
+
+// Function:		Get Compact Origin function
+// What it does:	Returns the point the piece's compact vertices are packed around, which is added back in its world matrix
+// Takes in:		Nothing
+// Returns:			D3DXVECTOR3 - The origin (the middle of the piece)
+
+D3DXVECTOR3 DungeonPieceClass::GetCompactOrigin()
+{
+	return m_CompactOrigin;
+}
+
+
 // Function:		Get Map Texture function
 // What it does:	Returns the map texture needed for rendering
 // Takes in:		Nothing
@@ -720,6 +720,149 @@ ID3D11ShaderResourceView* DungeonPieceClass::GetDungeonTexture()
 }
 
 
+// Function:		Get Dungeon Texture File function
+// What it does:	Returns the name of the texture file used for the piece in the dungeon
+// Takes in:		Nothing
+// Returns:			WCHAR - Pointer to the file name, or 0 if the piece has no textures
+
+WCHAR* DungeonPieceClass::GetDungeonTextureFile()
+{
+	return m_DungeonTextureFile;
+}
+
+
+// Function:		Get Wall Texture File function
+// What it does:	Returns the name of the texture file used for the walls
+// Takes in:		Nothing
+// Returns:			WCHAR - Pointer to the file name
+
+WCHAR* DungeonPieceClass::GetWallTextureFile()
+{
+	return WALL_TEXTURE_FILE;
+}
+
+
+// Function:		Get Ceiling Texture File function
+// What it does:	Returns the name of the texture file used for the ceiling
+// Takes in:		Nothing
+// Returns:			WCHAR - Pointer to the file name
+
+WCHAR* DungeonPieceClass::GetCeilingTextureFile()
+{
+	return CEILING_TEXTURE_FILE;
+}
+
+
+// Function:		Add Geometry function
+// What it does:	Adds the floor quad of the piece to a vertex and index list, raised by the given height
+// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices,
+//					float - Height to raise the quad by
+// Returns:			Nothing
+
+void DungeonPieceClass::AddGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices, float Height)
+{
+	unsigned long First = Vertices.size();
+	VertexType Quad[4];
+
+	// Use the same quad as the piece's own buffers, with the same index order
+	float yPosition = (m_TypeOfPiece == DOOR) ? 0.005f : 0.0f;
+	FillVertices(Quad, yPosition + Height, false);
+	Vertices.insert(Vertices.end(), Quad, Quad + 4);
+
+	Indices.push_back(First);
+	Indices.push_back(First + 1);
+	Indices.push_back(First + 2);
+	Indices.push_back(First);
+	Indices.push_back(First + 2);
+	Indices.push_back(First + 3);
+}
+
+
+// Function:		Add Ceiling Geometry function
+// What it does:	Adds the ceiling of the piece to a vertex and index list. The ceiling is the floor's rectangle at the top of
+//					the walls, facing down with the ceiling texture
+// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices
+// Returns:			Nothing
+
+void DungeonPieceClass::AddCeilingGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices)
+{
+	unsigned long First = Vertices.size();
+	VertexType Quad[4];
+
+	// The ceiling is made from the floor's rectangle, so the piece doesn't need a second piece or buffer for it
+	FillVertices(Quad, WALL_HEIGHT, true);
+	Vertices.insert(Vertices.end(), Quad, Quad + 4);
+
+	Indices.push_back(First);
+	Indices.push_back(First + 1);
+	Indices.push_back(First + 2);
+	Indices.push_back(First);
+	Indices.push_back(First + 2);
+	Indices.push_back(First + 3);
+}
+
+
+// Function:		Add Wall Geometry function
+// What it does:	Adds the walls made by BuildWalls to a vertex and index list
+// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices
+// Returns:			Nothing
+
+void DungeonPieceClass::AddWallGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices)
+{
+	for (unsigned int i = 0; i < m_Walls.size(); i++)
+	{
+		unsigned long First = Vertices.size();
+		VertexType Vertex;
+		Vertex.normal = m_Walls[i].Normal;
+
+		// Place the texture across the wall from where its ends are along its line, counting up from Start to End, so walls on
+		// the same line facing the same way carry the texture on across where they meet
+		bool AlongXAxis = (m_Walls[i].Start.x != m_Walls[i].End.x);
+		float StartAlong = AlongXAxis ? m_Walls[i].Start.x : m_Walls[i].Start.y;
+		float EndAlong = AlongXAxis ? m_Walls[i].End.x : m_Walls[i].End.y;
+		float Direction = (EndAlong > StartAlong) ? 1.0f : -1.0f;
+		float StartU = Direction * StartAlong / WALL_TEXTURE_LENGTH;
+		float EndU = Direction * EndAlong / WALL_TEXTURE_LENGTH;
+
+		// Use the same index order as the wall meshes
+		Vertex.position = D3DXVECTOR3(m_Walls[i].Start.x, 0.0f, m_Walls[i].Start.y);				// Bottom Left
+		Vertex.texture = D3DXVECTOR2(StartU, WALL_TEXTURE_HEIGHT_SCALE);
+		Vertices.push_back(Vertex);
+
+		Vertex.position = D3DXVECTOR3(m_Walls[i].Start.x, WALL_HEIGHT, m_Walls[i].Start.y);		// Top Left
+		Vertex.texture = D3DXVECTOR2(StartU, 0.0f);
+		Vertices.push_back(Vertex);
+
+		Vertex.position = D3DXVECTOR3(m_Walls[i].End.x, WALL_HEIGHT, m_Walls[i].End.y);			// Top Right
+		Vertex.texture = D3DXVECTOR2(EndU, 0.0f);
+		Vertices.push_back(Vertex);
+
+		Vertex.position = D3DXVECTOR3(m_Walls[i].End.x, 0.0f, m_Walls[i].End.y);					// Bottom Right
+		Vertex.texture = D3DXVECTOR2(EndU, WALL_TEXTURE_HEIGHT_SCALE);
+		Vertices.push_back(Vertex);
+
+		Indices.push_back(First);			// Bottom left
+		Indices.push_back(First + 1);		// Top left
+		Indices.push_back(First + 2);		// Top right
+		Indices.push_back(First);			// Bottom left
+		Indices.push_back(First + 2);		// Top right
+		Indices.push_back(First + 3);		// Bottom right
+	}
+}
+
+
+// Function:		Get Walls function
+// What it does:	Returns the wall quads made by BuildWalls, so the dungeon can merge them with the walls of the pieces
+//					around it before they are added to the static batch
+// Takes in:		Nothing
+// Returns:			vector<Wall> - pointer to the walls
+
+vector<DungeonPieceClass::Wall> *DungeonPieceClass::GetWalls()
+{
+	return &m_Walls;
+}
+
+
 // Function:		Render function
 // What it does:	Puts the vertex and index buffers in the graphics pipeline by calling RenderBuffers
 // Takes in:		Nothing
@@ -741,30 +884,13 @@ void DungeonPieceClass::Render()
 
 void DungeonPieceClass::Shutdown()
 {
-	// Release the model texture.
+	// Give the map and dungeon textures back to the cache
 	ReleaseTexture();
-	
-	// Release the Map Texture
-	if (m_MapTexture)
-	{
-		m_MapTexture->Shutdown();
-		m_MapTexture = 0;
-	}
 
-	// Release the Dungeon Texture
-	if (m_DungeonTexture)
-	{
-		m_DungeonTexture->Shutdown();
-		m_DungeonTexture = 0;
-	}
-
-	// Release the Wall Meshes by iterating through the list and deleting each
-	for (auto thisObject = Walls.begin(); thisObject != Walls.end(); ++thisObject)
-	{
-		MeshClass* WallMesh = *thisObject;
-		WallMesh->Shutdown();
-		delete WallMesh;
-	}
+	// Release the wall geometry and segments
+	m_Walls.clear();
+	WallSegments.clear();
+	WallsGenerated = false;
 
 	// Release the vertex and index buffers.
 	ShutdownBuffers();
@@ -774,39 +900,22 @@ void DungeonPieceClass::Shutdown()
 
 
 // Function:		Initialise Buffers function 
-// What it does:	Sets up the vertex and index buffer based on the type of piece it is
+// What it does:	Puts the piece's vertices in the buffer pool, based on the type of piece it is. The piece is drawn with the
+//					pool's shared quad indices
 //					Sets the positions of the vertices and the texture scales and normals to set up the dungeon piece geometry 
 // Takes in:		Nothing
 // Returns:			Returns true if successful, false if not
 
 bool DungeonPieceClass::InitializeBuffers()
 {
-	// Set up the vertex and index buffers/arrays
-	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData, indexData;
-	HRESULT result;
-
-	// Set the number of vertices in the vertex array.
-	m_VertexCount = 4;
-
-	// Set the number of indices in the index array.
-	m_IndexCount = 6;
-
-	// Create the vertex array.
-	vertices = new VertexType[m_VertexCount];
-	if (!vertices)
-	{
-		return false;
-	}
+	// Set up the vertex arrays
+	VertexType vertices[QUAD_VERTEX_COUNT];
+	CompactVertexClass::VertexType compactVertices[QUAD_VERTEX_COUNT];
+	bool result;
 
-	// Create the index array.
-	indices = new unsigned long[m_IndexCount];
-	if (!indices)
-	{
-		return false;
-	}
+	// Set the number of vertices, and the number of indices of the shared quad index buffer
+	m_VertexCount = QUAD_VERTEX_COUNT;
+	m_IndexCount = QUAD_INDEX_COUNT;
 
 	// Use the default y position of 0 unless the type of piece is a door (slightly higher than dungeon piece
 	// so it draws in front of the map)
@@ -816,25 +925,62 @@ bool DungeonPieceClass::InitializeBuffers()
 		yPosition = 0.005;
 	}
 
-	// Ceiling pieces draw differently to all other pieces because they need to be drawn anti clockwise so player can view 
+	// Load the vertex array with data.
+	FillVertices(vertices, yPosition, false);
+
+	// Pack the vertices around the middle of the piece if the compact layout is being used, keeping the full vertices if any
+	// can't be packed
+	m_CompactOrigin = (vertices[0].position + vertices[1].position + vertices[2].position + vertices[3].position) * 0.25f;
+	m_CompactVertices = (COMPACT_VERTICES != 0);
+	for (int i = 0; (i < m_VertexCount) && (m_CompactVertices); i++)
+	{
+		m_CompactVertices = CompactVertexClass::Pack(vertices[i].position - m_CompactOrigin, vertices[i].texture, vertices[i].normal, compactVertices[i]);
+	}
+
+	// Put the vertices in the pool, in whichever layout they were packed in
+	if (m_CompactVertices)
+	{
+		result = m_BufferPool->Allocate(compactVertices, sizeof(compactVertices), m_Vertices);
+	}
+	else
+	{
+		result = m_BufferPool->Allocate(vertices, sizeof(vertices), m_Vertices);
+	}
+	if (!result)
+	{
+		return false;
+	}
+
+	// Return true if successful
+	return true;
+}
+
+
+// Function:		Fill Vertices function
+// What it does:	Sets the positions, texture co-ordinates and normals of the four vertices of the piece's quad, wound so the
+//					floor faces up and the ceiling faces down
+// Takes in:		VertexType - Pointer to the four vertices, float - Height of the quad, bool - True for the ceiling
+// Returns:			Nothing
+
+void DungeonPieceClass::FillVertices(VertexType* vertices, float yPosition, bool Ceiling)
+{
+	// Ceilings draw differently to the floors because they need to be drawn anti clockwise so player can view 
 	// the mesh from beneath it
-	if (m_TypeOfPiece == CEILING)
+	if (Ceiling)
 	{
 		// Load the vertex array with data.
 		// Ceiling normal is down the negative y axis
 		// Uses the ceiling texture scale here for setting texture U V co-ordinates
-		yPosition = 0;
-
 		vertices[0].position = D3DXVECTOR3(m_Center.x - m_HalfWidth, yPosition, m_Center.y - m_HalfHeight);  // Bottom left.
-		vertices[0].texture = D3DXVECTOR2(0.0f, m_TextureScale.y);
+		vertices[0].texture = D3DXVECTOR2(0.0f, CEILING_TEXTURE_SCALE);
 		vertices[0].normal = D3DXVECTOR3(0.0f, -1.0f, 0.0f);
 
 		vertices[1].position = D3DXVECTOR3(m_Center.x + m_HalfWidth, yPosition, m_Center.y - m_HalfHeight);  // Bottom right.
-		vertices[1].texture = D3DXVECTOR2(m_TextureScale.x, m_TextureScale.y);
+		vertices[1].texture = D3DXVECTOR2(CEILING_TEXTURE_SCALE, CEILING_TEXTURE_SCALE);
 		vertices[1].normal = D3DXVECTOR3(0.0f, -1.0f, 0.0f);
 	
 		vertices[2].position = D3DXVECTOR3(m_Center.x + m_HalfWidth, yPosition, m_Center.y + m_HalfHeight);  // Top right.
-		vertices[2].texture = D3DXVECTOR2(m_TextureScale.x, 0.0f);
+		vertices[2].texture = D3DXVECTOR2(CEILING_TEXTURE_SCALE, 0.0f);
 		vertices[2].normal = D3DXVECTOR3(0.0f, -1.0f, 0.0f);
 
 		vertices[3].position = D3DXVECTOR3(m_Center.x - m_HalfWidth, yPosition, m_Center.y + m_HalfHeight);  // Top left.
@@ -862,87 +1008,20 @@ bool DungeonPieceClass::InitializeBuffers()
 		vertices[3].texture = D3DXVECTOR2(m_TextureScale.x, m_TextureScale.y);
 		vertices[3].normal = D3DXVECTOR3(0.0f, 1.0f, 0.0f);
 	}
-
-	// Load the index array with data.
-	indices[0] = 0;			// Bottom left.
-	indices[1] = 1;			// Top left.
-	indices[2] = 2;			// Top right.
-
-	indices[3] = 0;			// bottom left
-	indices[4] = 2;			// top right
-	indices[5] = 3;			// bottom right
-
-	// Set up the description of the static vertex buffer.
-	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(VertexType) * m_VertexCount;
-	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = 0;
-	vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-	vertexData.pSysMem = vertices;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	// Now create the vertex buffer.
-	result = m_Device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_VertexBuffer);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	// Set up the description of the static index buffer.
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(unsigned long) * m_IndexCount;
-	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags = 0;
-	indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data.
-	indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer.
-	result = m_Device->CreateBuffer(&indexBufferDesc, &indexData, &m_IndexBuffer);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	// Release the arrays now that the vertex and index buffers have been created and loaded.
-	delete [] vertices;
-	vertices = 0;
-
-	delete [] indices;
-	indices = 0;
-
-	// Return true if successful
-	return true;
 }
 
 
 // Function:		Shutdown Buffers function
-// What it does:	Releases the buffer objects
+// What it does:	Gives the piece's vertices back to the buffer pool
 // Takes in:		Nothing
 // Returns:			Nothing
 
 void DungeonPieceClass::ShutdownBuffers()
 {
-	// Release the index buffer.
-	if(m_IndexBuffer)
+	// Give the vertices back to the pool, if the piece was made with one
+	if (m_BufferPool)
 	{
-		m_IndexBuffer->Release();
-		m_IndexBuffer = 0;
-	}
-
-	// Release the vertex buffer.
-	if(m_VertexBuffer)
-	{
-		m_VertexBuffer->Release();
-		m_VertexBuffer = 0;
+		m_BufferPool->Release(m_Vertices);
 	}
 
 	return;
@@ -957,21 +1036,13 @@ void DungeonPieceClass::ShutdownBuffers()
 void DungeonPieceClass::RenderBuffers()
 {
 	unsigned int stride;
-	unsigned int offset;
-
 
-	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType); 
-	offset = 0;
-    
-	// Set the vertex buffer to active in the input assembler so it can be rendered.
-	m_DeviceContext->IASetVertexBuffers(0, 1, &m_VertexBuffer, &stride, &offset);
 
-	// Set the index buffer to active in the input assembler so it can be rendered.
-	m_DeviceContext->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	// Set vertex buffer stride.
+	stride = m_CompactVertices ? sizeof(CompactVertexClass::VertexType) : sizeof(VertexType); 
 
-	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
-	m_DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Set the piece's part of the pool and the shared quad indices to active in the input assembler so it can be rendered.
+	m_BufferPool->Bind(m_DeviceContext, m_Vertices, stride);
 
 	return;
 }
@@ -979,43 +1050,31 @@ void DungeonPieceClass::RenderBuffers()
 
 // Function:		Load Textures function
 // What it does:	Takes in two file names and sets the first as the map texture, and second as the dungeon texture
-//					Then initialises these textures
+//					Then gets these textures from the texture cache
 // Takes in:		WCHAR - Pointer to map texture file name, WCHAR - Pointer to dungeon texture file name
 // Returns:			True if textures initialised successfully, false if not
 
 bool DungeonPieceClass::LoadTextures(WCHAR* MapFile, WCHAR* DungeonFile)
 {
-	bool result;
-
 	// Each dungeon piece has two textures, one for rendering the piece to the map and one for rendering in the dungeon
+	// Every piece uses the same few files, so they are shared through the cache instead of each piece loading its own
 
-	// Create the map texture object
-	m_MapTexture = new TextureClass;
+	// Get the map texture
+	m_MapTexture = m_TextureCache->Acquire(MapFile);
 	if (!m_MapTexture)
 	{
 		return false;
 	}
 
-	// Initialize the map texture object.
-	result = m_MapTexture->Initialize(m_Device, MapFile);
-	if (!result)
-	{
-		return false;
-	}
-
-	// Create the dungeon texture object.
-	m_DungeonTexture = new TextureClass;
+	// Get the dungeon texture
+	m_DungeonTexture = m_TextureCache->Acquire(DungeonFile);
 	if (!m_DungeonTexture)
 	{
 		return false;
 	}
 
-	// Initialize the dungeon texture object.
-	result = m_DungeonTexture->Initialize(m_Device, DungeonFile);
-	if(!result)
-	{
-		return false;
-	}
+	// Keep the file name, so the static batch can put geometry using the same texture together
+	m_DungeonTextureFile = DungeonFile;
 
 	// Return true if successful
 	return true;
@@ -1029,19 +1088,17 @@ bool DungeonPieceClass::LoadTextures(WCHAR* MapFile, WCHAR* DungeonFile)
 
 void DungeonPieceClass::ReleaseTexture()
 {
-	// Release the texture object.
+	// Give the textures back to the cache, which frees them when no other piece is using them
 	if(m_DungeonTexture)
 	{
-		m_DungeonTexture->Shutdown();
-		delete m_DungeonTexture;
+		m_TextureCache->Release(m_DungeonTexture);
 		m_DungeonTexture = 0;
 	}
+	m_DungeonTextureFile = 0;
 
-	// Release the texture object.
 	if(m_MapTexture)
 	{
-		m_MapTexture->Shutdown();
-		delete m_MapTexture;
+		m_TextureCache->Release(m_MapTexture);
 		m_MapTexture = 0;
 	}
 
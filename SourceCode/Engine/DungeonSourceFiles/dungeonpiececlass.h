@@ -8,7 +8,10 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 #include "textureclass.h"
+#include "texturecacheclass.h"
 #include "meshclass.h"
+#include "compactvertexclass.h"
+#include "bufferpoolclass.h"
 
 // For rand
 #include <stdlib.h>
@@ -18,6 +21,10 @@
 #include <list>
 using std::list;
 
+// For vector
+#include <vector>
+using std::vector;
+
 // Next Door Direction Definitions
 #define LEFT 1
 #define UP 2
@@ -34,8 +41,30 @@ using std::list;
 #define HORIZONTAL_DOOR 1
 #define VERTICAL_DOOR 2
 
+// The layout of the dungeon is made in whole numbers of layout units. Sizes are whole tenths of a unit, so the center of a piece
+// is always on a half tenth, which is used as the layout unit
+#define LAYOUT_UNITS_PER_TENTH 2
+#define LAYOUT_UNITS_PER_UNIT 20
+
+// Piece sizes are picked in steps of this many tenths from their lower size limit. Larger steps let the dungeon use a coarser grid
+#define PIECE_SIZE_STEP 1
+
+// Half the width of the gap left in a wall for a door, and the height of the walls
+#define DOOR_HALF_WIDTH 0.3f
+#define WALL_HEIGHT 1.5f
+
+// How far along a wall one repeat of the wall texture covers, and how many times it repeats up the wall. The texture is placed
+// from where the wall is along its line, so walls meeting end to end carry it on across the join
+#define WALL_TEXTURE_LENGTH 1.0f
+#define WALL_TEXTURE_HEIGHT_SCALE 2.0f
+
 // Stone Walls texture - http://www.sketchuptexture.com/p/stone-walls-and-paving-stone.html
+#define WALL_TEXTURE_FILE L"data/stone_walls.png"
 // Wooden Floors texture - http://www.sketchuptexture.com/p/wood-wood-floors-bambu-thatch-cork.html
+#define CEILING_TEXTURE_FILE L"data/wooden_floors.png"
+
+// How many times the ceiling texture repeats across a piece in the x and y axis
+#define CEILING_TEXTURE_SCALE 2.0f
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: DungeonPieceClass
@@ -46,7 +75,7 @@ using std::list;
 
 class DungeonPieceClass
 {
-private:
+public:
 	// A struct to hold all information about a Vertex to pass into a Vertex Shader
 	struct VertexType
 	{
@@ -55,9 +84,26 @@ private:
 		D3DXVECTOR3 normal;
 	};
 
-public:
 	// These are the types of rooms that can be created
-	enum m_PieceType{ INIT, DOOR, ENTRANCE, ROOM, HORIZONTAL_CORRIDOR, VERTICAL_CORRIDOR, CEILING };
+	enum m_PieceType{ INIT, DOOR, ENTRANCE, ROOM, HORIZONTAL_CORRIDOR, VERTICAL_CORRIDOR };
+
+	// A wall of the piece on the floor, used to fill in the collision grid. Start is the end with the smaller x (for walls along
+	// the x axis) or z (for walls along the z axis), with z kept in y
+	struct WallSegment
+	{
+		D3DXVECTOR2 Start;
+		D3DXVECTOR2 End;
+		bool AlongXAxis;
+	};
+
+	// A wall quad of the piece. Start and End are on the floor, left to right when looked at from the side the normal faces
+	// (with z kept in y), and the texture runs from Start to End, placed from where they are along the wall's line
+	struct Wall
+	{
+		D3DXVECTOR2 Start;
+		D3DXVECTOR2 End;
+		D3DXVECTOR3 Normal;
+	};
 
 	// Function:		Dungeon Piece Constructor
 	// What it does:	Sets type of piece to the passed in type and the door direction to the passed in direction
@@ -77,10 +123,11 @@ public:
 	//					the dungeon piece was set to in the constructor, using the room limit passed into this function
 	//					Calls the appropriate function for creating the room, and initialises for rendering
 	// Takes in:		ID3D11Device - pointer to DirectX device, ID3D11DeviceContext - Pointer to DirectX device context,
-	//					D3DXVECTOR2 - center of this piece, float - Width of this piece, float - Height of this piece
+	//					TextureCacheClass - pointer to the cache the textures are shared from, BufferPoolClass - pointer to the pool
+	//					the vertices are kept in, D3DXVECTOR2 - center of this piece, float - Width of this piece, float - Height of this piece
 	//					int - The door limit for the amount of rooms that can be created leading from this room
 	// Returns:			True if all initialisation has happened successfully, false if not
-	bool Initialise(ID3D11Device*, ID3D11DeviceContext*, D3DXVECTOR2 Center, float Width, float Height, int RoomLimit);
+	bool Initialise(ID3D11Device*, ID3D11DeviceContext*, TextureCacheClass*, BufferPoolClass*, D3DXVECTOR2 Center, float Width, float Height, int RoomLimit);
 
 
 	// Function:		Get Width and Height function
@@ -91,6 +138,21 @@ public:
 	D3DXVECTOR2 GetWidthAndHeight(m_PieceType NewPieceType);
 
 
+	// Function:		Get Layout Size function
+	// What it does:	Finds a random width and height in tenths between the size limits of this piece, in steps of PIECE_SIZE_STEP
+	//					and using rand in the same way as GetWidthAndHeight
+	// Takes in:		int - references to the width and height
+	// Returns:			Nothing
+	void GetLayoutSize(int &Width, int &Height);
+
+
+	// Function:		Get Size Limits function
+	// What it does:	Gets the size limits used for this type of piece (in tenths, the same as GetWidthAndHeight uses)
+	// Takes in:		D3DXVECTOR2 - references to the smallest and largest size limits
+	// Returns:			Nothing
+	void GetSizeLimits(D3DXVECTOR2 &Lower, D3DXVECTOR2 &Upper);
+
+
 	// Function:		Get Piece Type function
 	// What it does:	Returns the type of piece this dungeon piece is
 	// Takes in:		Nothing
@@ -106,13 +168,55 @@ public:
 
 
 	// Function:		Build Walls function
-	// What it does:	Creates the meshes used for the walls, setting up two seperate walls with a space between
-	//					for a wall with a door in the middle, and a single wall if a door is not present in that wall
+	// What it does:	Creates the wall geometry of the piece, setting up two seperate walls with a space between for a wall with
+	//					a door in it, and a single wall if a door is not present in that wall. Each wall is also added to the segment
+	//					list used for the collision grid. The geometry is kept until it is added to the dungeon's static batch
 	//					This function is called after all of the dungeon pieces have been created in the Application Class
 	//					to make sure the walls are only created after all rooms and doors have been set 	
 	// Takes in:		Nothing
+	// Returns:			True if the walls were created, false if not
+	bool BuildWalls();
+
+
+	// Function:		Add Geometry function
+	// What it does:	Adds the floor quad of the piece to a vertex and index list, raised by the given height
+	// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices,
+	//					float - Height to raise the quad by
 	// Returns:			Nothing
-	void BuildWalls();
+	void AddGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices, float Height);
+
+
+	// Function:		Add Ceiling Geometry function
+	// What it does:	Adds the ceiling of the piece to a vertex and index list. The ceiling is the floor's rectangle at the top of
+	//					the walls, facing down with the ceiling texture
+	// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices
+	// Returns:			Nothing
+	void AddCeilingGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices);
+
+
+	// Function:		Add Wall Geometry function
+	// What it does:	Adds the walls made by BuildWalls to a vertex and index list
+	// Takes in:		vector<VertexType> - reference to the vertices, vector<unsigned long> - reference to the indices
+	// Returns:			Nothing
+	void AddWallGeometry(vector<VertexType> &Vertices, vector<unsigned long> &Indices);
+
+
+	// Function:		Get Walls function
+	// What it does:	Returns the wall quads made by BuildWalls, so the dungeon can merge them with the walls of the pieces
+	//					around it before they are added to the static batch
+	// Takes in:		Nothing
+	// Returns:			vector<Wall> - pointer to the walls
+	vector<Wall> *GetWalls();
+
+
+	// Function:		Get Dungeon Texture File, Get Wall Texture File and Get Ceiling Texture File functions
+	// What it does:	Return the names of the texture files used for the piece, its walls and its ceiling in the dungeon, so geometry
+	//					using the same texture can be drawn together
+	// Takes in:		Nothing
+	// Returns:			WCHAR - Pointer to the file name (the dungeon texture file is 0 if the piece has no textures)
+	WCHAR* GetDungeonTextureFile();
+	WCHAR* GetWallTextureFile();
+	WCHAR* GetCeilingTextureFile();
 
 
 	// Function:		Get Map Texture function
@@ -143,6 +247,20 @@ public:
 	int GetIndexCount();
 
 
+	// Function:		Is Compact function
+	// What it does:	Returns whether the piece's vertex buffer holds compact vertices, so it is drawn with the compact shaders
+	// Takes in:		Nothing
+	// Returns:			bool - True if the vertices are compact
+	bool IsCompact();
+
+
+	// Function:		Get Compact Origin function
+	// What it does:	Returns the point the piece's compact vertices are packed around, which is added back in its world matrix
+	// Takes in:		Nothing
+	// Returns:			D3DXVECTOR3 - The origin (the middle of the piece)
+	D3DXVECTOR3 GetCompactOrigin();
+
+
 	// Function:		Shutdown function
 	// What it does:	Calls ReleaseTexture to release textures and ShutdownBuffers for when application ends		
 	// Takes in:		Nothing
@@ -165,15 +283,22 @@ private:
 
 
 	// Function:		Make Room function 
-	// What it does:	Loops through the number of rooms passed in, to decide the directions available for
-	//					the new rooms randomly. Checks to see if a door isn't already in this place, then makes 
-	//					a door in that place up until the room limit count. Also loads in the textures for the rooms and 
+	// What it does:	Uses Choose Doors to decide the directions of the doors for the new rooms up until the room limit count.
+	//					Also loads in the textures for the rooms and 
 	//					sets the texture scale for normal rooms.
 	// Takes in:		int - Number of rooms limit so that room only creates this amount of doors
 	// Returns:			True if function has completed properly, false if not
 	bool MakeRoom(int NumOfRooms);
 
 
+	// Function:		Choose Doors function
+	// What it does:	Loops through the number of rooms passed in, to decide the directions available for the new rooms randomly.
+	//					Checks to see if a door isn't already in this place, then makes a door in that place up until the room limit count
+	// Takes in:		int - Number of rooms limit so that room only creates this amount of doors
+	// Returns:			Nothing
+	void ChooseDoors(int NumOfRooms);
+
+
 	// Function:		Make Vertical Corridor
 	// What it does:	Sets up and down doors available to true, because it is a vertical corridor
 	//					and loads the texture
@@ -190,13 +315,6 @@ private:
 	bool MakeHorizontalCorridor();
 
 
-	// Function:		Make Ceiling function
-	// What it does:	Loads in the textures for the ceiling piece and sets the texture scale
-	// Takes in:		Nothing
-	// Returns:			True if textures loaded properly, false if not
-	bool MakeCeiling();
-
-
 	// Function:		Set Size Limits function 
 	// What it does:	Sets the size limits for this room based on the type it is 
 	//					Therefore each room can use these limits to find a random value between them and still hold their shape
@@ -207,22 +325,39 @@ private:
 
 	// Function:		Load Textures function
 	// What it does:	Takes in two file names and sets the first as the map texture, and second as the dungeon texture
-	//					Then initialises these textures
+	//					Then gets these textures from the texture cache
 	// Takes in:		WCHAR - Pointer to map texture file name, WCHAR - Pointer to dungeon texture file name
 	// Returns:			True if textures initialised successfully, false if not
 	bool LoadTextures(WCHAR*, WCHAR*);
 
 
 	// Function:		Initialise Buffers function 
-	// What it does:	Sets up the vertex and index buffer based on the type of piece it is
+	// What it does:	Puts the piece's vertices in the buffer pool, based on the type of piece it is. The piece is drawn with the
+	//					pool's shared quad indices
 	//					Sets the positions of the vertices and the texture scales and normals to set up the dungeon piece geometry 
 	// Takes in:		Nothing
 	// Returns:			Returns true if successful, false if not
 	bool InitializeBuffers();
 
 
+	// Function:		Fill Vertices function
+	// What it does:	Sets the positions, texture co-ordinates and normals of the four vertices of the piece's quad, wound so the
+	//					floor faces up and the ceiling faces down
+	// Takes in:		VertexType - Pointer to the four vertices, float - Height of the quad, bool - True for the ceiling
+	// Returns:			Nothing
+	void FillVertices(VertexType* vertices, float yPosition, bool Ceiling);
+
+
+	// Function:		Add Wall function
+	// What it does:	Adds a wall quad to the wall list, and the wall's segment to the segment list
+	// Takes in:		D3DXVECTOR2 - start and end of the wall on the floor (left to right when looked at from inside the piece),
+	//					D3DXVECTOR3 - normal
+	// Returns:			Nothing
+	void AddWall(D3DXVECTOR2 Start, D3DXVECTOR2 End, D3DXVECTOR3 Normal);
+
+
 	// Function:		Shutdown Buffers function
-	// What it does:	Releases the buffer objects
+	// What it does:	Gives the piece's vertices back to the buffer pool
 	// Takes in:		Nothing
 	// Returns:			Nothing
 	void ShutdownBuffers();
@@ -253,8 +388,23 @@ public:
 	bool m_LDoor, m_RDoor, m_UDoor, m_DDoor;
 	int m_DoorDirection;
 
+	// Distance of each door from the middle of its side, along x for the top and bottom doors and along y for the left and
+	// right doors. Doors made by the generators are in the middle, doors that close loops are in the middle of the shared wall
+	float m_LDoorOffset, m_RDoorOffset, m_UDoorOffset, m_DDoorOffset;
+
+	// Number of pieces between this piece and the entrance (set by the piece generator)
+	int m_Depth;
+
+	// Center of the piece in layout units and its size in tenths, set by the dungeon before the piece is initialised. The
+	// center, half width and half height above are made from these
+	int m_LayoutX, m_LayoutY;
+	int m_LayoutWidth, m_LayoutHeight;
+
+	// Index of the piece's node in the dungeon graph (-1 if it isn't in one)
+	int m_GraphNode;
+
 	// Wall variables
-	list<MeshClass*> Walls;
+	vector<WallSegment> WallSegments;
 	bool WallsGenerated;	
 
 private:
@@ -270,12 +420,20 @@ private:
 	// Rendering Variables
 	ID3D11Device* m_Device;
 	ID3D11DeviceContext* m_DeviceContext;
+	TextureCacheClass* m_TextureCache;
 	D3DXVECTOR2 m_TextureScale;
 	D3DXVECTOR3 m_Normal;
-	ID3D11Buffer *m_VertexBuffer, *m_IndexBuffer;
+	BufferPoolClass* m_BufferPool;
+	BufferPoolClass::Allocation m_Vertices;
 	int m_VertexCount, m_IndexCount;
+	bool m_CompactVertices;
+	D3DXVECTOR3 m_CompactOrigin;
 	TextureClass* m_MapTexture;
 	TextureClass* m_DungeonTexture;
+	WCHAR* m_DungeonTextureFile;
+
+	// The walls made by BuildWalls, drawn from the dungeon's static batch
+	vector<Wall> m_Walls;
 };
 
 
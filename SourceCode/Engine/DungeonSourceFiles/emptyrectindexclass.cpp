@@ -0,0 +1,207 @@
+#include "emptyrectindexclass.h"
+
+
+// Function:		Empty Rect Index constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+EmptyRectIndexClass::EmptyRectIndexClass()
+{
+}
+
+
+// Placeholder destructor
+EmptyRectIndexClass::~EmptyRectIndexClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Starts the index with one rectangle covering the whole of an empty grid
+// Takes in:		int - Width of the grid, int - Height of the grid
+// Returns:			True if the size is valid, false if not
+
+bool EmptyRectIndexClass::Initialise(int Width, int Height)
+{
+	if ((Width <= 0) || (Height <= 0))
+	{
+		return false;
+	}
+
+	Rect Grid;
+	Grid.StartX = 0;
+	Grid.StartY = 0;
+	Grid.EndX = Width - 1;
+	Grid.EndY = Height - 1;
+
+	m_Rects.clear();
+	m_Rects.push_back(Grid);
+
+	return true;
+}
+
+
+// Function:		Occupy function
+// What it does:	Updates the rectangles after an area of the grid has been filled
+// Takes in:		int - Start and end positions of the area (included in the area)
+// Returns:			Nothing
+
+void EmptyRectIndexClass::Occupy(int StartX, int StartY, int EndX, int EndY)
+{
+	if ((StartX > EndX) || (StartY > EndY))
+	{
+		return;
+	}
+
+	// Take out every rectangle that overlaps the area, and keep the parts of it to the left, right, bottom and top of the area.
+	// Each part is as large as it can be, so it may overlap the other parts
+	m_Parts.clear();
+	unsigned int Index = 0;
+	while (Index < m_Rects.size())
+	{
+		Rect Free = m_Rects[Index];
+		if ((Free.EndX < StartX) || (Free.StartX > EndX) || (Free.EndY < StartY) || (Free.StartY > EndY))
+		{
+			Index++;
+			continue;
+		}
+
+		m_Rects[Index] = m_Rects.back();
+		m_Rects.pop_back();
+
+		Rect Part = Free;
+		if (Free.StartX < StartX)
+		{
+			Part.EndX = StartX - 1;
+			m_Parts.push_back(Part);
+			Part.EndX = Free.EndX;
+		}
+		if (Free.EndX > EndX)
+		{
+			Part.StartX = EndX + 1;
+			m_Parts.push_back(Part);
+			Part.StartX = Free.StartX;
+		}
+		if (Free.StartY < StartY)
+		{
+			Part.EndY = StartY - 1;
+			m_Parts.push_back(Part);
+			Part.EndY = Free.EndY;
+		}
+		if (Free.EndY > EndY)
+		{
+			Part.StartY = EndY + 1;
+			m_Parts.push_back(Part);
+		}
+	}
+
+	// Only keep the parts that aren't held inside another rectangle. The rectangles that didn't overlap the area can't be inside
+	// any part, because each part is inside a rectangle that was maximal alongside them. If two parts are the same, the first is kept
+	for (unsigned int i = 0; i < m_Parts.size(); i++)
+	{
+		Rect &Part = m_Parts[i];
+		bool Inside = false;
+
+		for (unsigned int j = 0; (j < m_Parts.size()) && (!Inside); j++)
+		{
+			if ((j != i) && Holds(m_Parts[j], Part.StartX, Part.StartY, Part.EndX, Part.EndY))
+			{
+				// Parts that are the same hold each other, so only the later one is thrown away
+				if ((j < i) || (!Holds(Part, m_Parts[j].StartX, m_Parts[j].StartY, m_Parts[j].EndX, m_Parts[j].EndY)))
+				{
+					Inside = true;
+				}
+			}
+		}
+
+		for (unsigned int j = 0; (j < m_Rects.size()) && (!Inside); j++)
+		{
+			if (Holds(m_Rects[j], Part.StartX, Part.StartY, Part.EndX, Part.EndY))
+			{
+				Inside = true;
+			}
+		}
+
+		if (!Inside)
+		{
+			m_Rects.push_back(Part);
+		}
+	}
+}
+
+
+// Function:		Is Empty function
+// What it does:	Checks if one of the rectangles holds all of an area. An area with nothing in it is always empty
+// Takes in:		int - Start and end positions of the area (included in the area)
+// Returns:			True if nothing in the area has been filled, false if something has
+
+bool EmptyRectIndexClass::IsEmpty(int StartX, int StartY, int EndX, int EndY)
+{
+	if ((StartX > EndX) || (StartY > EndY))
+	{
+		return true;
+	}
+
+	for (unsigned int i = 0; i < m_Rects.size(); i++)
+	{
+		if (Holds(m_Rects[i], StartX, StartY, EndX, EndY))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// Function:		Find Containing function
+// What it does:	Finds the rectangles holding all of an area, so that areas larger than it can be checked against a short list
+// Takes in:		int - Start and end positions of the area, vector<Rect> - reference to the list to fill with the rectangles
+// Returns:			Nothing
+
+void EmptyRectIndexClass::FindContaining(int StartX, int StartY, int EndX, int EndY, vector<Rect> &Rects)
+{
+	Rects.clear();
+	for (unsigned int i = 0; i < m_Rects.size(); i++)
+	{
+		if (Holds(m_Rects[i], StartX, StartY, EndX, EndY))
+		{
+			Rects.push_back(m_Rects[i]);
+		}
+	}
+}
+
+
+// Function:		Get Rect Count function
+// What it does:	Returns the number of maximal empty rectangles
+// Takes in:		Nothing
+// Returns:			int - Number of rectangles
+
+int EmptyRectIndexClass::GetRectCount()
+{
+	return m_Rects.size();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the rectangles
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void EmptyRectIndexClass::Shutdown()
+{
+	m_Rects.clear();
+	m_Parts.clear();
+}
+
+
+// Function:		Holds function
+// What it does:	Checks if a rectangle holds all of an area
+// Takes in:		Rect - reference to the rectangle, int - Start and end positions of the area
+// Returns:			True if the area is inside the rectangle, false if not
+
+bool EmptyRectIndexClass::Holds(const Rect &Outer, int StartX, int StartY, int EndX, int EndY)
+{
+	return (Outer.StartX <= StartX) && (Outer.StartY <= StartY) && (Outer.EndX >= EndX) && (Outer.EndY >= EndY);
+}
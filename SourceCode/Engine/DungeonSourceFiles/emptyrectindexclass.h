@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: emptyrectindexclass.h
+// Empty Rect Index Class
+// Keeps the maximal empty rectangles of the dungeon grid so the space free behind a door can be found without testing the grid
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef EMPTY_RECT_INDEX_CLASS_H
+#define EMPTY_RECT_INDEX_CLASS_H
+
+// For vector
+#include <vector>
+using std::vector;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: EmptyRectIndexClass
+// Holds every maximal empty rectangle of the grid (an empty rectangle that can't grow in any direction without covering a
+// filled position). An area is empty only if one of these rectangles holds all of it, so checking an area is a search of the
+// rectangles instead of the grid. When an area is filled, each rectangle that overlaps it is split into the parts to its left,
+// right, bottom and top, and any part held inside another rectangle is thrown away
+////////////////////////////////////////////////////////////////////////////////
+class EmptyRectIndexClass
+{
+public:
+	// A rectangle of grid positions. The end positions are included in the rectangle
+	struct Rect
+	{
+		int StartX, StartY;
+		int EndX, EndY;
+	};
+
+	// Function:		Empty Rect Index constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	EmptyRectIndexClass();
+
+
+	// Placeholder destructor
+	~EmptyRectIndexClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Starts the index with one rectangle covering the whole of an empty grid
+	// Takes in:		int - Width of the grid, int - Height of the grid
+	// Returns:			True if the size is valid, false if not
+	bool Initialise(int Width, int Height);
+
+
+	// Function:		Occupy function
+	// What it does:	Updates the rectangles after an area of the grid has been filled
+	// Takes in:		int - Start and end positions of the area (included in the area)
+	// Returns:			Nothing
+	void Occupy(int StartX, int StartY, int EndX, int EndY);
+
+
+	// Function:		Is Empty function
+	// What it does:	Checks if one of the rectangles holds all of an area. An area with nothing in it is always empty
+	// Takes in:		int - Start and end positions of the area (included in the area)
+	// Returns:			True if nothing in the area has been filled, false if something has
+	bool IsEmpty(int StartX, int StartY, int EndX, int EndY);
+
+
+	// Function:		Find Containing function
+	// What it does:	Finds the rectangles holding all of an area, so that areas larger than it can be checked against a short list
+	// Takes in:		int - Start and end positions of the area, vector<Rect> - reference to the list to fill with the rectangles
+	// Returns:			Nothing
+	void FindContaining(int StartX, int StartY, int EndX, int EndY, vector<Rect> &Rects);
+
+
+	// Function:		Get Rect Count function
+	// What it does:	Returns the number of maximal empty rectangles
+	// Takes in:		Nothing
+	// Returns:			int - Number of rectangles
+	int GetRectCount();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the rectangles
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+
+	// Function:		Holds function
+	// What it does:	Checks if a rectangle holds all of an area
+	// Takes in:		Rect - reference to the rectangle, int - Start and end positions of the area
+	// Returns:			True if the area is inside the rectangle, false if not
+	static bool Holds(const Rect &Outer, int StartX, int StartY, int EndX, int EndY);
+
+private:
+	// The maximal empty rectangles
+	vector<Rect> m_Rects;
+	// Parts of rectangles split by the last area filled
+	vector<Rect> m_Parts;
+};
+
+
+#endif
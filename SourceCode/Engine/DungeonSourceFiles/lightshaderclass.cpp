@@ -12,6 +12,13 @@ LightShaderClass::LightShaderClass()
 	m_pixelShader = 0;
 	m_layout = 0;
 	m_sampleState = 0;
+	m_arrayVertexShader = 0;
+	m_arrayPixelShader = 0;
+	m_arrayLayout = 0;
+	m_instanceVertexShader = 0;
+	m_instanceLayout = 0;
+	m_compactVertexShader = 0;
+	m_compactLayout = 0;
 	m_matrixBuffer = 0;
 	m_lightBuffer = 0;
 }
@@ -77,14 +84,98 @@ bool LightShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount
 
 
 	// Set the shader parameters that it will use for rendering.
-	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, light, camera);
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, 0, light, camera);
 	if(!result)
 	{
 		return false;
 	}
 
 	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
+	RenderShader(deviceContext, indexCount, m_layout, m_vertexShader, m_pixelShader);
+
+	return true;
+}
+
+
+// Function:		Render Array function
+// What it does:	As Render, but for geometry whose vertices keep a texture array slice after their texture co-ordinates,
+//					so geometry using several textures can be drawn with one texture array bound
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the geometry, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix
+//					D3DXMATRIX - projection matrix, ID3D11ShaderResourceView - pointer to the texture array, LightClass - pointer to the light used to render with,
+//					CameraClass - pointer to the camera used
+// Returns:			True if successful, false if not 
+
+bool LightShaderClass::RenderArray(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, 
+			      D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* textureArray, LightClass* light, CameraClass* camera)
+{
+	bool result;
+
+
+	// Set the shader parameters with the texture array in its own register.
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, textureArray, 1, light, camera);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now render the prepared buffers with the texture array shaders.
+	RenderShader(deviceContext, indexCount, m_arrayLayout, m_arrayVertexShader, m_arrayPixelShader);
+
+	return true;
+}
+
+
+// Function:		Render Compact function
+// What it does:	As Render, but for geometry whose vertices are in the compact layout (the VertexType structure in the CompactVertexClass)
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the geometry, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix
+//					D3DXMATRIX - projection matrix, ID3D11ShaderResourceView - pointer to the texture, LightClass - pointer to the light used to render with,
+//					CameraClass - pointer to the camera used
+// Returns:			True if successful, false if not 
+
+bool LightShaderClass::RenderCompact(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, 
+			      D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, LightClass* light, CameraClass* camera)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, 0, light, camera);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now render the prepared buffers with the compact vertex shader and the light pixel shader.
+	RenderShader(deviceContext, indexCount, m_compactLayout, m_compactVertexShader, m_pixelShader);
+
+	return true;
+}
+
+
+// Function:		Render Instanced function
+// What it does:	As Render Array, but draws instances of one unit quad, with the quad's position, size, facing, texture scale,
+//					texture array slice and texture offset read from a second buffer of instances (the InstanceType structure in the StaticBatchClass)
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the unit quad, int - number of instances,
+//					int - first instance, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix, D3DXMATRIX - projection matrix,
+//					ID3D11ShaderResourceView - pointer to the texture array, LightClass - pointer to the light used to render with,
+//					CameraClass - pointer to the camera used
+// Returns:			True if successful, false if not 
+
+bool LightShaderClass::RenderInstanced(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount, int startInstance, D3DXMATRIX worldMatrix, 
+			      D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* textureArray, LightClass* light, CameraClass* camera)
+{
+	bool result;
+
+
+	// Set the shader parameters with the texture array in its own register.
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, textureArray, 1, light, camera);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now draw the instances with the instanced quad shaders.
+	RenderInstancedShader(deviceContext, indexCount, instanceCount, startInstance);
 
 	return true;
 }
@@ -93,7 +184,9 @@ bool LightShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCount
 // Function:		Initialize Shader function
 // What it does:	This function compiles the vertex and pixel shader code using the shader file names and create the shaders using the appropriate
 //					buffers. Also creates the vertex input layout for the information to be passed to the Vertex shader as input (position, texture co-ordinates,
-//					and normals). Sets up description of buffers and samplers and creates them. 
+//					and normals). Sets up description of buffers and samplers and creates them. The texture array shaders and their input layout
+//					(with three texture co-ordinates), the instanced quad vertex shader and the compact vertex shader, and their layouts,
+//					are made from the same files
 // Takes in:		ID3D11Device - pointer to device, HWND - window, WCHAR* - pointer to the vertex shader filename, WCHAR* - pointer to the pixel shader filename
 // Returns:			True if successful, false if not
 
@@ -105,6 +198,8 @@ bool LightShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR*
 	ID3D10Blob* pixelShaderBuffer;
 
 	D3D11_INPUT_ELEMENT_DESC polygonLayout[3];
+	D3D11_INPUT_ELEMENT_DESC instanceLayout[7];
+	D3D11_INPUT_ELEMENT_DESC compactLayout[2];
 	unsigned int numElements;
 	D3D11_SAMPLER_DESC samplerDesc;
 	D3D11_BUFFER_DESC matrixBufferDesc;
@@ -214,6 +309,216 @@ bool LightShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR*
 	pixelShaderBuffer->Release();
 	pixelShaderBuffer = 0;
 
+	// Compile the texture array vertex shader code from the same file.
+	result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "LightArrayVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, 
+				       &vertexShaderBuffer, &errorMessage, NULL);
+	if(FAILED(result))
+	{
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	// Compile the texture array pixel shader code from the same file.
+	result = D3DX11CompileFromFile(psFilename, NULL, NULL, "LightArrayPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, 
+				       &pixelShaderBuffer, &errorMessage, NULL);
+	if(FAILED(result))
+	{
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, psFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, psFilename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	// Create the texture array vertex and pixel shaders from the buffers.
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_arrayVertexShader);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), NULL, &m_arrayPixelShader);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// The texture array layout is the same apart from the third texture co-ordinate, which is the slice of the array.
+	// This needs to match the VertexType structure in the StaticBatchClass.
+	polygonLayout[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+
+	result = device->CreateInputLayout(polygonLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), 
+					   &m_arrayLayout);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = 0;
+
+	// Compile the instanced quad vertex shader code from the same file. It is drawn with the texture array pixel shader.
+	result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "LightInstanceVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, 
+				       &vertexShaderBuffer, &errorMessage, NULL);
+	if(FAILED(result))
+	{
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_instanceVertexShader);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// The corners of the unit quad come from the first buffer, and everything else from the instance buffer in the second.
+	// This needs to match the QuadVertexType and InstanceType structures in the StaticBatchClass.
+	instanceLayout[0].SemanticName = "POSITION";
+	instanceLayout[0].SemanticIndex = 0;
+	instanceLayout[0].Format = DXGI_FORMAT_R32G32_FLOAT;
+	instanceLayout[0].InputSlot = 0;
+	instanceLayout[0].AlignedByteOffset = 0;
+	instanceLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	instanceLayout[0].InstanceDataStepRate = 0;
+
+	instanceLayout[1].SemanticName = "TEXCOORD";
+	instanceLayout[1].SemanticIndex = 1;
+	instanceLayout[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	instanceLayout[1].InputSlot = 1;
+	instanceLayout[1].AlignedByteOffset = 0;
+	instanceLayout[1].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[1].InstanceDataStepRate = 1;
+
+	instanceLayout[2].SemanticName = "TEXCOORD";
+	instanceLayout[2].SemanticIndex = 2;
+	instanceLayout[2].Format = DXGI_FORMAT_R32G32_FLOAT;
+	instanceLayout[2].InputSlot = 1;
+	instanceLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	instanceLayout[2].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[2].InstanceDataStepRate = 1;
+
+	instanceLayout[3].SemanticName = "TEXCOORD";
+	instanceLayout[3].SemanticIndex = 3;
+	instanceLayout[3].Format = DXGI_FORMAT_R32_UINT;
+	instanceLayout[3].InputSlot = 1;
+	instanceLayout[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	instanceLayout[3].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[3].InstanceDataStepRate = 1;
+
+	instanceLayout[4].SemanticName = "TEXCOORD";
+	instanceLayout[4].SemanticIndex = 4;
+	instanceLayout[4].Format = DXGI_FORMAT_R32G32_FLOAT;
+	instanceLayout[4].InputSlot = 1;
+	instanceLayout[4].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	instanceLayout[4].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[4].InstanceDataStepRate = 1;
+
+	instanceLayout[5].SemanticName = "TEXCOORD";
+	instanceLayout[5].SemanticIndex = 5;
+	instanceLayout[5].Format = DXGI_FORMAT_R32_FLOAT;
+	instanceLayout[5].InputSlot = 1;
+	instanceLayout[5].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	instanceLayout[5].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[5].InstanceDataStepRate = 1;
+
+	instanceLayout[6].SemanticName = "TEXCOORD";
+	instanceLayout[6].SemanticIndex = 6;
+	instanceLayout[6].Format = DXGI_FORMAT_R32G32_FLOAT;
+	instanceLayout[6].InputSlot = 1;
+	instanceLayout[6].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	instanceLayout[6].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	instanceLayout[6].InstanceDataStepRate = 1;
+
+	numElements = sizeof(instanceLayout) / sizeof(instanceLayout[0]);
+
+	result = device->CreateInputLayout(instanceLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), 
+					   &m_instanceLayout);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
+	// Compile the compact vertex shader code from the same file. It is drawn with the light pixel shader.
+	result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "LightCompactVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, 
+				       &vertexShaderBuffer, &errorMessage, NULL);
+	if(FAILED(result))
+	{
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_compactVertexShader);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// The compact layout has half float positions (with the normal index in w) and texture co-ordinates.
+	// This needs to match the VertexType structure in the CompactVertexClass.
+	compactLayout[0].SemanticName = "POSITION";
+	compactLayout[0].SemanticIndex = 0;
+	compactLayout[0].Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+	compactLayout[0].InputSlot = 0;
+	compactLayout[0].AlignedByteOffset = 0;
+	compactLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	compactLayout[0].InstanceDataStepRate = 0;
+
+	compactLayout[1].SemanticName = "TEXCOORD";
+	compactLayout[1].SemanticIndex = 0;
+	compactLayout[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	compactLayout[1].InputSlot = 0;
+	compactLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	compactLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	compactLayout[1].InstanceDataStepRate = 0;
+
+	numElements = sizeof(compactLayout) / sizeof(compactLayout[0]);
+
+	result = device->CreateInputLayout(compactLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), 
+					   &m_compactLayout);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
 	// Create a texture sampler state description.
 	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
 	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
@@ -322,6 +627,51 @@ void LightShaderClass::ShutdownShader()
 		m_layout = 0;
 	}
 
+	// Release the compact layout and vertex shader.
+	if(m_compactLayout)
+	{
+		m_compactLayout->Release();
+		m_compactLayout = 0;
+	}
+
+	if(m_compactVertexShader)
+	{
+		m_compactVertexShader->Release();
+		m_compactVertexShader = 0;
+	}
+
+	// Release the instanced quad layout and vertex shader.
+	if(m_instanceLayout)
+	{
+		m_instanceLayout->Release();
+		m_instanceLayout = 0;
+	}
+
+	if(m_instanceVertexShader)
+	{
+		m_instanceVertexShader->Release();
+		m_instanceVertexShader = 0;
+	}
+
+	// Release the texture array layout and shaders.
+	if(m_arrayLayout)
+	{
+		m_arrayLayout->Release();
+		m_arrayLayout = 0;
+	}
+
+	if(m_arrayPixelShader)
+	{
+		m_arrayPixelShader->Release();
+		m_arrayPixelShader = 0;
+	}
+
+	if(m_arrayVertexShader)
+	{
+		m_arrayVertexShader->Release();
+		m_arrayVertexShader = 0;
+	}
+
 	// Release the pixel shader.
 	if(m_pixelShader)
 	{
@@ -387,11 +737,12 @@ void LightShaderClass::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND h
 //					the application and sets the constant buffers in their place in the shader. It also sets up the samplers and textures
 //					needed in the pixel shader. 
 // Takes in:		ID3D11DeviceContext - pointer to the device context, D3DXMATRIX - world matrix, D3DXMATRIX view matrix, D3DXMATRIX projection matrix
-//					ID3D11ShaderResourceView - pointer to the texture, LightClass - pointer to the light used to render with, CameraClass - pointer to the camera used
+//					ID3D11ShaderResourceView - pointer to the texture, unsigned int - texture register the texture is set in (0 for a texture,
+//					1 for a texture array), LightClass - pointer to the light used to render with, CameraClass - pointer to the camera used
 // Returns:			True if successful, false if not
 
 bool LightShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, 
-					   D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, LightClass* light, CameraClass* camera)
+					   D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, unsigned int textureSlot, LightClass* light, CameraClass* camera)
 {
 	HRESULT result;
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
@@ -431,7 +782,7 @@ bool LightShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext, D
 	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &m_matrixBuffer);
 
 	// Set shader texture resource in the pixel shader.
-	deviceContext->PSSetShaderResources(0, 1, &texture);
+	deviceContext->PSSetShaderResources(textureSlot, 1, &texture);
 
 	// Lock the light constant buffer so it can be written to.
 	result = deviceContext->Map(m_lightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
@@ -491,17 +842,19 @@ bool LightShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext, D
 
 // Function:		Render Shader function
 // What it does:	Sets the shaders and input layout in the device, and sets the samplers
-// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count, ID3D11InputLayout - pointer to the layout,
+//					ID3D11VertexShader - pointer to the vertex shader, ID3D11PixelShader - pointer to the pixel shader
 // Returns:			Nothing
 
-void LightShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
+void LightShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount, ID3D11InputLayout* layout, ID3D11VertexShader* vertexShader,
+									ID3D11PixelShader* pixelShader)
 {
 	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
+	deviceContext->IASetInputLayout(layout);
 
 	// Set the vertex and pixel shaders that will be used to render this triangle.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
-	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
+	deviceContext->VSSetShader(vertexShader, NULL, 0);
+	deviceContext->PSSetShader(pixelShader, NULL, 0);
 
 	// Set the sampler state in the pixel shader.
 	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
@@ -512,3 +865,25 @@ void LightShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int inde
 	return;
 }
 
+
+// Function:		Render Instanced Shader function
+// What it does:	Sets the instanced quad shaders and input layout in the device, sets the samplers and draws the instances
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count, int - number of instances, int - first instance
+// Returns:			Nothing
+
+void LightShaderClass::RenderInstancedShader(ID3D11DeviceContext* deviceContext, int indexCount, int instanceCount, int startInstance)
+{
+	// Set the instanced quad input layout and vertex shader, and light it with the texture array pixel shader.
+	deviceContext->IASetInputLayout(m_instanceLayout);
+	deviceContext->VSSetShader(m_instanceVertexShader, NULL, 0);
+	deviceContext->PSSetShader(m_arrayPixelShader, NULL, 0);
+
+	// Set the sampler state in the pixel shader.
+	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+
+	// Draw every instance of the quad.
+	deviceContext->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, startInstance);
+
+	return;
+}
+
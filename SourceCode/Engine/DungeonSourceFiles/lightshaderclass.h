@@ -86,11 +86,40 @@ public:
 	// Returns:			True if successful, false if not 
 	bool Render(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, LightClass* light, CameraClass*);
 
+	// Function:		Render Array function
+	// What it does:	As Render, but for geometry whose vertices keep a texture array slice after their texture co-ordinates,
+	//					so geometry using several textures can be drawn with one texture array bound
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the geometry, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix
+	//					D3DXMATRIX - projection matrix, ID3D11ShaderResourceView - pointer to the texture array, LightClass - pointer to the light used to render with,
+	//					CameraClass - pointer to the camera used
+	// Returns:			True if successful, false if not 
+	bool RenderArray(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, LightClass* light, CameraClass*);
+
+	// Function:		Render Compact function
+	// What it does:	As Render, but for geometry whose vertices are in the compact layout (the VertexType structure in the CompactVertexClass)
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the geometry, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix
+	//					D3DXMATRIX - projection matrix, ID3D11ShaderResourceView - pointer to the texture, LightClass - pointer to the light used to render with,
+	//					CameraClass - pointer to the camera used
+	// Returns:			True if successful, false if not 
+	bool RenderCompact(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, LightClass* light, CameraClass*);
+
+	// Function:		Render Instanced function
+	// What it does:	As Render Array, but draws instances of one unit quad, with the quad's position, size, facing, texture scale,
+	//					texture array slice and texture offset read from a second buffer of instances (the InstanceType structure in the StaticBatchClass)
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count of the unit quad, int - number of instances,
+	//					int - first instance, D3DXMATRIX - World Matrix, D3DXMATRIX, View Matrix, D3DXMATRIX - projection matrix,
+	//					ID3D11ShaderResourceView - pointer to the texture array, LightClass - pointer to the light used to render with,
+	//					CameraClass - pointer to the camera used
+	// Returns:			True if successful, false if not 
+	bool RenderInstanced(ID3D11DeviceContext*, int, int, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, LightClass* light, CameraClass*);
+
 private:
 	// Function:		Initialize Shader function
 	// What it does:	This function compiles the vertex and pixel shader code using the shader file names and create the shaders using the appropriate
 	//					buffers. Also creates the vertex input layout for the information to be passed to the Vertex shader as input (position, texture co-ordinates,
-	//					and normals). Sets up description of buffers and samplers and creates them. 
+	//					and normals). Sets up description of buffers and samplers and creates them. The texture array shaders and their input layout
+	//					(with three texture co-ordinates), the instanced quad vertex shader and the compact vertex shader, and their layouts,
+	//					are made from the same files
 	// Takes in:		ID3D11Device - pointer to device, HWND - window, WCHAR* - pointer to the vertex shader filename, WCHAR* - pointer to the pixel shader filename
 	// Returns:			True if successful, false if not
 	bool InitializeShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
@@ -113,15 +142,23 @@ private:
 	//					the application and sets the constant buffers in their place in the shader. It also sets up the samplers and textures
 	//					needed in the pixel shader. 
 	// Takes in:		ID3D11DeviceContext - pointer to the device context, D3DXMATRIX - world matrix, D3DXMATRIX view matrix, D3DXMATRIX projection matrix
-	//					ID3D11ShaderResourceView - pointer to the texture, LightClass - pointer to the light used to render with, CameraClass - pointer to the camera used
+	//					ID3D11ShaderResourceView - pointer to the texture, unsigned int - texture register the texture is set in (0 for a texture,
+	//					1 for a texture array), LightClass - pointer to the light used to render with, CameraClass - pointer to the camera used
 	// Returns:			True if successful, false if not
-	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, LightClass* light, CameraClass*);
+	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, unsigned int, LightClass* light, CameraClass*);
 	
 	// Function:		Render Shader function
 	// What it does:	Sets the shaders and input layout in the device, and sets the samplers
-	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count, ID3D11InputLayout - pointer to the layout,
+	//					ID3D11VertexShader - pointer to the vertex shader, ID3D11PixelShader - pointer to the pixel shader
+	// Returns:			Nothing
+	void RenderShader(ID3D11DeviceContext*, int, ID3D11InputLayout*, ID3D11VertexShader*, ID3D11PixelShader*);
+
+	// Function:		Render Instanced Shader function
+	// What it does:	Sets the instanced quad shaders and input layout in the device, sets the samplers and draws the instances
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - index count, int - number of instances, int - first instance
 	// Returns:			Nothing
-	void RenderShader(ID3D11DeviceContext*, int);
+	void RenderInstancedShader(ID3D11DeviceContext*, int, int, int);
 
 private:
 	// Shader Variables
@@ -130,6 +167,19 @@ private:
 	ID3D11InputLayout* m_layout;
 	ID3D11SamplerState* m_sampleState;
 
+	// Texture Array Shader Variables
+	ID3D11VertexShader* m_arrayVertexShader;
+	ID3D11PixelShader* m_arrayPixelShader;
+	ID3D11InputLayout* m_arrayLayout;
+
+	// Instanced Quad Shader Variables (drawn with the texture array pixel shader)
+	ID3D11VertexShader* m_instanceVertexShader;
+	ID3D11InputLayout* m_instanceLayout;
+
+	// Compact Vertex Shader Variables (drawn with the light pixel shader)
+	ID3D11VertexShader* m_compactVertexShader;
+	ID3D11InputLayout* m_compactLayout;
+
 	// Buffer Variables
 	ID3D11Buffer* m_matrixBuffer;
 	ID3D11Buffer* m_lightBuffer;
@@ -11,9 +11,14 @@
 
 MeshClass::MeshClass()
 {
-	m_vertexBuffer = 0;
-	m_indexBuffer = 0;
+	m_bufferPool = 0;
+	m_vertices.Page = -1;
+	m_vertices.Offset = 0;
+	m_vertices.Bytes = 0;
+	m_compactVertices = false;
+	m_compactOrigin = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	m_Texture = 0;
+	m_TextureCache = 0;
 	m_Width = 0.0f;
 	m_HalfWidth = 0.0f;
 	m_Height = 0.0f;
@@ -55,11 +60,13 @@ MeshClass::~MeshClass()
 // Function:		Initialise function
 // What it does:	Initialises the mesh and its center, width, height data as well as the vertices needed to draw the geometry
 //					Also loads the texture and initialises buffers
-// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context, WCHAR - Texture file name
+// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context,
+//					TextureCacheClass - pointer to the cache the texture is shared from, BufferPoolClass - pointer to the pool the
+//					vertices are kept in, WCHAR - Texture file name,
 //					D3DXVECTOR3 - center vector of the mesh, float - width of mesh, float - height of mesh, float - depth of mesh
 // Returns:			True if initialised properly, false if not
 
-bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_context, WCHAR* textureFilename, D3DXVECTOR3 Center, float Width, float Height, float Depth)
+bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_context, TextureCacheClass* textureCache, BufferPoolClass* bufferPool, WCHAR* textureFilename, D3DXVECTOR3 Center, float Width, float Height, float Depth)
 {
 	bool result;		// For error checking
 
@@ -81,14 +88,15 @@ bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_con
 	// Set texture scale to non repeat
 	m_TextureScale = D3DXVECTOR2(1.0f, 1.0f);
 
-	// Initialize the vertex and index buffer that hold the geometry for the triangle.
-	result = InitializeBuffers(device);
+	// Put the vertices that hold the geometry for the mesh in the pool.
+	result = InitializeBuffers(bufferPool);
 	if (!result)
 	{
 		return false;
 	}
 
 	// Load the texture for this model.
+	m_TextureCache = textureCache;
 	result = LoadTexture(device, device_context, textureFilename);
 	if (!result)
 	{
@@ -102,12 +110,14 @@ bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_con
 // Function:		Initialise Function
 // What it does:	Differs from the other Initialise because it takes in the vertex points instead of setting it up in the function
 //					Also takes in the normal and the texture scaling. This initialise is mostly used for the walls of the dungeon
-// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context, WCHAR - Texture file name
+// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context,
+//					TextureCacheClass - pointer to the cache the texture is shared from, BufferPoolClass - pointer to the pool the
+//					vertices are kept in, WCHAR - Texture file name,
 //					D3DXVECTOR3 - bottom left vertex position, D3DXVECTOR3 top left vertex position, D3DXVECTOR3 top right vertex position,
 //					D3DXVECTOR3 - bottom right vertex position, D3DXVECTOR3 - normal vector for this mesh, D3DXVECTOR3 - texture scale for this mesh
 // Returns:			True if initialised properly, false if not
 
-bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_context, WCHAR* textureFilename, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, 
+bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_context, TextureCacheClass* textureCache, BufferPoolClass* bufferPool, WCHAR* textureFilename, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, 
 							D3DXVECTOR3 BottomRight, D3DXVECTOR3 Normal, D3DXVECTOR2 TextureScale)
 {
 	bool result;		// For error checking
@@ -174,14 +184,15 @@ bool MeshClass::Initialize(ID3D11Device* device, ID3D11DeviceContext* device_con
 	m_Height = y_difference; 
 	m_Center.y = m_BottomLeft.y + (0.5 * y_difference);
 
-	// Initialize the vertex and index buffer that hold the geometry for the triangle.
-	result = InitializeBuffers(device);
+	// Put the vertices that hold the geometry for the mesh in the pool.
+	result = InitializeBuffers(bufferPool);
 	if (!result)
 	{
 		return false;
 	}
 
 	// Load the texture for this model.
+	m_TextureCache = textureCache;
 	result = LoadTexture(device, device_context, textureFilename);
 	if (!result)
 	{
@@ -235,6 +246,28 @@ int MeshClass::GetIndexCount()
 }
 
 
+// Function:		Is Compact function
+// What it does:	Returns whether the mesh's vertex buffer holds compact vertices, so it is drawn with the compact shaders
+// Takes in:		Nothing
+// Returns:			bool - True if the vertices are compact
+
+bool MeshClass::IsCompact()
+{
+	return m_compactVertices;
+}
+
+
+// Function:		Get Compact Origin function
+// What it does:	Returns the point the mesh's compact vertices are packed around, which is added back in its world matrix
+// Takes in:		Nothing
+// Returns:			D3DXVECTOR3 - The origin (the middle of the mesh)
+
+D3DXVECTOR3 MeshClass::GetCompactOrigin()
+{
+	return m_compactOrigin;
+}
+
+
 // Function:		Get Texture function
 // What it does:	Returns the first texture object of the mesh
 // Takes in:		Nothing
@@ -258,38 +291,23 @@ ID3D11ShaderResourceView* MeshClass::GetTexture2()
 
 
 // Function:		Initialise Buffers function 
-// What it does:	Sets up the vertex and index buffer based on the type of piece it is
+// What it does:	Puts the mesh's vertices in the buffer pool. The mesh is drawn with the pool's shared quad indices
 //					Sets the positions of the vertices and the texture co-ordinates and normals to set up the mesh geometry 
-// Takes in:		Nothing
+// Takes in:		BufferPoolClass - pointer to the pool
 // Returns:			Returns true if successful, false if not
 
-bool MeshClass::InitializeBuffers(ID3D11Device* device)
+bool MeshClass::InitializeBuffers(BufferPoolClass* bufferPool)
 {
-	VertexType* vertices;
-	unsigned long* indices;
-	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
-	D3D11_SUBRESOURCE_DATA vertexData, indexData;
-	HRESULT result;
-
-	// Set the number of vertices in the vertex array.
-	m_vertexCount = 4;
-
-	// Set the number of indices in the index array.
-	m_indexCount = 6;
+	VertexType vertices[QUAD_VERTEX_COUNT];
+	CompactVertexClass::VertexType compactVertices[QUAD_VERTEX_COUNT];
+	bool result;
 
-	// Create the vertex array.
-	vertices = new VertexType[m_vertexCount];
-	if(!vertices)
-	{
-		return false;
-	}
+	// Keep the pool so the vertices can be drawn from it and given back to it.
+	m_bufferPool = bufferPool;
 
-	// Create the index array.
-	indices = new unsigned long[m_indexCount];
-	if(!indices)
-	{
-		return false;
-	}
+	// Set the number of vertices, and the number of indices of the shared quad index buffer.
+	m_vertexCount = QUAD_VERTEX_COUNT;
+	m_indexCount = QUAD_INDEX_COUNT;
 
 	// Load the vertex array with data.
 	// Use the vertex positions, normal and texture scaling set in the initialise functions
@@ -309,86 +327,45 @@ bool MeshClass::InitializeBuffers(ID3D11Device* device)
 	vertices[3].texture = D3DXVECTOR2(m_TextureScale.x, m_TextureScale.y);
 	vertices[3].normal = m_Normal;
 
-	// Load the index array with data.
-	indices[0] = 0;  // Bottom left.
-	indices[1] = 1;  // Top left.
-	indices[2] = 2;  // Top right.
-
-	indices[3] = 0;	// bottom left
-	indices[4] = 2;	// top right
-	indices[5] = 3;	// bottom right
-
-	// Set up the description of the static vertex buffer.
-	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vertexBufferDesc.ByteWidth = sizeof(VertexType) * m_vertexCount;
-	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = 0;
-	vertexBufferDesc.MiscFlags = 0;
-	vertexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-	vertexData.pSysMem = vertices;
-	vertexData.SysMemPitch = 0;
-	vertexData.SysMemSlicePitch = 0;
-
-	// Now create the vertex buffer.
-	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &m_vertexBuffer);
-	if(FAILED(result))
+	// Pack the vertices around the middle of the mesh if the compact layout is being used, keeping the full vertices if any
+	// can't be packed
+	m_compactOrigin = (vertices[0].position + vertices[1].position + vertices[2].position + vertices[3].position) * 0.25f;
+	m_compactVertices = (COMPACT_VERTICES != 0);
+	for (int i = 0; (i < m_vertexCount) && (m_compactVertices); i++)
 	{
-		return false;
+		m_compactVertices = CompactVertexClass::Pack(vertices[i].position - m_compactOrigin, vertices[i].texture, vertices[i].normal, compactVertices[i]);
 	}
 
-	// Set up the description of the static index buffer.
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDesc.ByteWidth = sizeof(unsigned long) * m_indexCount;
-	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.CPUAccessFlags = 0;
-	indexBufferDesc.MiscFlags = 0;
-	indexBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the index data.
-	indexData.pSysMem = indices;
-	indexData.SysMemPitch = 0;
-	indexData.SysMemSlicePitch = 0;
-
-	// Create the index buffer.
-	result = device->CreateBuffer(&indexBufferDesc, &indexData, &m_indexBuffer);
-	if(FAILED(result))
+	// Put the vertices in the pool, in whichever layout they were packed in.
+	if(m_compactVertices)
+	{
+		result = m_bufferPool->Allocate(compactVertices, sizeof(compactVertices), m_vertices);
+	}
+	else
+	{
+		result = m_bufferPool->Allocate(vertices, sizeof(vertices), m_vertices);
+	}
+	if(!result)
 	{
 		return false;
 	}
 
-	// Release the arrays now that the vertex and index buffers have been created and loaded.
-	delete [] vertices;
-	vertices = 0;
-
-	delete [] indices;
-	indices = 0;
-
 	// Return true if successful
 	return true;
 }
 
 
 // Function:		Shutdown Buffers function
-// What it does:	Releases the buffer objects
+// What it does:	Gives the mesh's vertices back to the buffer pool
 // Takes in:		Nothing
 // Returns:			Nothing
 
 void MeshClass::ShutdownBuffers()
 {
-	// Release the index buffer.
-	if(m_indexBuffer)
+	// Give the vertices back to the pool.
+	if(m_bufferPool)
 	{
-		m_indexBuffer->Release();
-		m_indexBuffer = 0;
-	}
-
-	// Release the vertex buffer.
-	if(m_vertexBuffer)
-	{
-		m_vertexBuffer->Release();
-		m_vertexBuffer = 0;
+		m_bufferPool->Release(m_vertices);
 	}
 
 	return;
@@ -403,49 +380,31 @@ void MeshClass::ShutdownBuffers()
 void MeshClass::RenderBuffers(ID3D11DeviceContext* deviceContext)
 {
 	unsigned int stride;
-	unsigned int offset;
-
-	// Set vertex buffer stride and offset.
-	stride = sizeof(VertexType); 
-	offset = 0;
-    
-	// Set the vertex buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
 
-	// Set the index buffer to active in the input assembler so it can be rendered.
-	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	// Set vertex buffer stride.
+	stride = m_compactVertices ? sizeof(CompactVertexClass::VertexType) : sizeof(VertexType); 
 
-	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Set the mesh's part of the pool and the shared quad indices to active in the input assembler so it can be rendered.
+	m_bufferPool->Bind(deviceContext, m_vertices, stride);
 
 	return;
 }
 
 
 // Function:		Load Texture function
-// What it does:	Takes in a file name and sets it to the texture object and initialises
+// What it does:	Takes in a file name and gets its texture from the texture cache
 // Takes in:		ID3D11Device - pointer to the directx device, WCHAR - Pointer to the texture filename
 // Returns:			True if textures initialised successfully, false if not
 
 bool MeshClass::LoadTexture(ID3D11Device* device, ID3D11DeviceContext* device_context, WCHAR* filename)
 {
-	bool result;
-
-
-	// Create the texture object.
-	m_Texture = new TextureClass;
+	// Get the texture object, shared with every other mesh using the same file.
+	m_Texture = m_TextureCache->Acquire(filename);
 	if(!m_Texture)
 	{
 		return false;
 	}
 
-	// Initialize the texture object.
-	result = m_Texture->Initialize(device, filename);
-	if(!result)
-	{
-		return false;
-	}
-
 	return true;
 }
 
@@ -457,11 +416,10 @@ bool MeshClass::LoadTexture(ID3D11Device* device, ID3D11DeviceContext* device_co
 
 void MeshClass::ReleaseTexture()
 {
-	// Release the texture object.
+	// Give the texture object back to the cache.
 	if(m_Texture)
 	{
-		m_Texture->Shutdown();
-		delete m_Texture;
+		m_TextureCache->Release(m_Texture);
 		m_Texture = 0;
 	}
 
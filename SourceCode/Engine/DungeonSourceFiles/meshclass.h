@@ -11,6 +11,9 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 #include "textureclass.h"
+#include "texturecacheclass.h"
+#include "compactvertexclass.h"
+#include "bufferpoolclass.h"
 #include <stdlib.h>
 
 
@@ -45,19 +48,23 @@ public:
 	// Function:		Initialise function
 	// What it does:	Initialises the mesh and its center, width, height data as well as the vertices needed to draw the geometry
 	//					Also loads the texture and initialises buffers
-	// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context, WCHAR - Texture file name
+	// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context,
+	//					TextureCacheClass - pointer to the cache the texture is shared from, BufferPoolClass - pointer to the pool the
+	//					vertices are kept in, WCHAR - Texture file name,
 	//					D3DXVECTOR3 - center vector of the mesh, float - width of mesh, float - height of mesh, float - depth of mesh
 	// Returns:			True if initialised properly, false if not
-	bool Initialize(ID3D11Device*, ID3D11DeviceContext*, WCHAR*, D3DXVECTOR3 Center, float Width, float Height, float Depth);
+	bool Initialize(ID3D11Device*, ID3D11DeviceContext*, TextureCacheClass*, BufferPoolClass*, WCHAR*, D3DXVECTOR3 Center, float Width, float Height, float Depth);
 
 	// Function:		Initialise Function
 	// What it does:	Differs from the other Initialise because it takes in the vertex points instead of setting it up in the function
 	//					Also takes in the normal and the texture scaling. This initialise is mostly used for the walls of the dungeon
-	// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context, WCHAR - Texture file name
+	// Takes in:		ID3D11Device - pointer to device, ID3D11DeviceContext - pointer to device context,
+	//					TextureCacheClass - pointer to the cache the texture is shared from, BufferPoolClass - pointer to the pool the
+	//					vertices are kept in, WCHAR - Texture file name,
 	//					D3DXVECTOR3 - bottom left vertex position, D3DXVECTOR3 top left vertex position, D3DXVECTOR3 top right vertex position,
 	//					D3DXVECTOR3 - bottom right vertex position, D3DXVECTOR3 - normal vector for this mesh, D3DXVECTOR3 - texture scale for this mesh
 	// Returns:			True if initialised properly, false if not
-	bool Initialize(ID3D11Device*, ID3D11DeviceContext*, WCHAR*, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, 
+	bool Initialize(ID3D11Device*, ID3D11DeviceContext*, TextureCacheClass*, BufferPoolClass*, WCHAR*, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, 
 						D3DXVECTOR3 BottomRight, D3DXVECTOR3 Normal, D3DXVECTOR2 TextureScale);
 
 	// Function:		Shutdown function
@@ -78,6 +85,18 @@ public:
 	// Returns:			int - Index count
 	int GetIndexCount();
 
+	// Function:		Is Compact function
+	// What it does:	Returns whether the mesh's vertex buffer holds compact vertices, so it is drawn with the compact shaders
+	// Takes in:		Nothing
+	// Returns:			bool - True if the vertices are compact
+	bool IsCompact();
+
+	// Function:		Get Compact Origin function
+	// What it does:	Returns the point the mesh's compact vertices are packed around, which is added back in its world matrix
+	// Takes in:		Nothing
+	// Returns:			D3DXVECTOR3 - The origin (the middle of the mesh)
+	D3DXVECTOR3 GetCompactOrigin();
+
 	// Function:		Get Texture function
 	// What it does:	Returns the first texture object of the mesh
 	// Takes in:		Nothing
@@ -91,7 +110,7 @@ public:
 	ID3D11ShaderResourceView* GetTexture2();
 
 	// Function:		Load Texture function
-	// What it does:	Takes in a file name and sets it to the texture object and initialises
+	// What it does:	Takes in a file name and gets its texture from the texture cache
 	// Takes in:		ID3D11Device - pointer to the directx device, WCHAR - Pointer to the texture filename
 	// Returns:			True if textures initialised successfully, false if not
 	bool LoadTexture(ID3D11Device*, ID3D11DeviceContext*, WCHAR*);
@@ -104,14 +123,14 @@ public:
 	bool LoadTexture(ID3D11Device*, ID3D11DeviceContext*, WCHAR*, WCHAR*);
 
 	// Function:		Initialise Buffers function 
-	// What it does:	Sets up the vertex and index buffer based on the type of piece it is
+	// What it does:	Puts the mesh's vertices in the buffer pool. The mesh is drawn with the pool's shared quad indices
 	//					Sets the positions of the vertices and the texture co-ordinates and normals to set up the mesh geometry 
-	// Takes in:		Nothing
+	// Takes in:		BufferPoolClass - pointer to the pool
 	// Returns:			Returns true if successful, false if not
-	bool InitializeBuffers(ID3D11Device*);
+	bool InitializeBuffers(BufferPoolClass*);
 
 	// Function:		Shutdown Buffers function
-	// What it does:	Releases the buffer objects
+	// What it does:	Gives the mesh's vertices back to the buffer pool
 	// Takes in:		Nothing
 	// Returns:			Nothing
 	void ShutdownBuffers();
@@ -128,11 +147,15 @@ public:
 	// Returns:			Nothing
 	void ReleaseTexture();
 
-	ID3D11Buffer *m_vertexBuffer, *m_indexBuffer;
+	BufferPoolClass* m_bufferPool;
+	BufferPoolClass::Allocation m_vertices;
 	int m_vertexCount, m_indexCount;
+	bool m_compactVertices;
+	D3DXVECTOR3 m_compactOrigin;
 	bool m_twoTextures;
 	TextureClass* m_Texture;
 	TextureClass* m_Texture2;
+	TextureCacheClass* m_TextureCache;
 
 	D3DXVECTOR3 m_StartPos;
 	D3DXVECTOR3 m_EndPos;
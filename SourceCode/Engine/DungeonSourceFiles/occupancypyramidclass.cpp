@@ -0,0 +1,198 @@
+#include "occupancypyramidclass.h"
+
+
+// Function:		Occupancy Pyramid constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+OccupancyPyramidClass::OccupancyPyramidClass()
+{
+}
+
+
+// Placeholder destructor
+OccupancyPyramidClass::~OccupancyPyramidClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Creates the levels for an empty grid, adding levels until the top level is a single cell
+// Takes in:		int - Width of the grid, int - Height of the grid
+// Returns:			True if the size is valid, false if not
+
+bool OccupancyPyramidClass::Initialise(int Width, int Height)
+{
+	if ((Width <= 0) || (Height <= 0))
+	{
+		return false;
+	}
+
+	Shutdown();
+
+	// Each level is half the size of the one below it, rounded up so that every cell below has a cell above it
+	while (true)
+	{
+		m_Levels.push_back(vector<unsigned char>(Width * Height, 0));
+		m_Widths.push_back(Width);
+		m_Heights.push_back(Height);
+
+		if ((Width == 1) && (Height == 1))
+		{
+			break;
+		}
+
+		Width = (Width + 1) / 2;
+		Height = (Height + 1) / 2;
+	}
+
+	return true;
+}
+
+
+// Function:		Occupy function
+// What it does:	Fills an area of the first level and the cells above it in every other level
+// Takes in:		int - Start and end positions of the area (included in the area)
+// Returns:			Nothing
+
+void OccupancyPyramidClass::Occupy(int StartX, int StartY, int EndX, int EndY)
+{
+	if ((StartX > EndX) || (StartY > EndY) || m_Levels.empty())
+	{
+		return;
+	}
+
+	// Each level covers the same area with cells twice the size of the level below
+	for (unsigned int Level = 0; Level < m_Levels.size(); Level++)
+	{
+		int Width = m_Widths[Level];
+		for (int x = StartX >> Level; x <= (EndX >> Level); x++)
+		{
+			for (int y = StartY >> Level; y <= (EndY >> Level); y++)
+			{
+				m_Levels[Level][(y * Width) + x] = 1;
+			}
+		}
+	}
+}
+
+
+// Function:		Is Empty function
+// What it does:	Checks if anything in an area has been filled. An area with nothing in it is always empty
+// Takes in:		int - Start and end positions of the area (included in the area, and inside the grid)
+// Returns:			True if nothing in the area has been filled, false if something has
+
+bool OccupancyPyramidClass::IsEmpty(int StartX, int StartY, int EndX, int EndY)
+{
+	if ((StartX > EndX) || (StartY > EndY) || m_Levels.empty())
+	{
+		return true;
+	}
+
+	// Start from the highest level whose cells are no larger than half the area, so the area is covered by a few cells
+	int Level = 0;
+	int Size = ((EndX - StartX) < (EndY - StartY)) ? (EndX - StartX) + 1 : (EndY - StartY) + 1;
+	while (((2 << Level) <= (Size / 2)) && (Level + 1 < (int)m_Levels.size()))
+	{
+		Level++;
+	}
+
+	return IsLevelAreaEmpty(Level, StartX >> Level, StartY >> Level, EndX >> Level, EndY >> Level, StartX, StartY, EndX, EndY);
+}
+
+
+// Function:		Get Level Count function
+// What it does:	Returns the number of levels in the pyramid
+// Takes in:		Nothing
+// Returns:			int - Number of levels
+
+int OccupancyPyramidClass::GetLevelCount()
+{
+	return m_Levels.size();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the levels
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void OccupancyPyramidClass::Shutdown()
+{
+	m_Levels.clear();
+	m_Widths.clear();
+	m_Heights.clear();
+}
+
+
+// Function:		Is Level Area Empty function
+// What it does:	Checks the part of an area covered by a block of cells in a level. Any filled cell lying completely inside the area
+//					is looked for first, as it means the area isn't empty without going any further. Then each filled cell that only
+//					partly covers the area is followed down to the 2x2 cells below it
+// Takes in:		int - Level, int - First and last X and Y cells of the block in the level, int - Start and end positions of the area
+// Returns:			True if nothing in the part of the area covered by the block has been filled, false if something has
+
+bool OccupancyPyramidClass::IsLevelAreaEmpty(int Level, int FirstX, int FirstY, int LastX, int LastY, int StartX, int StartY, int EndX, int EndY)
+{
+	vector<unsigned char> &Cells = m_Levels[Level];
+	int Width = m_Widths[Level];
+
+	// Level 0 cells are always completely inside the area
+	if (Level == 0)
+	{
+		for (int y = FirstY; y <= LastY; y++)
+		{
+			for (int x = FirstX; x <= LastX; x++)
+			{
+				if (Cells[(y * Width) + x] != 0)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// The cells of the block lying completely inside the area
+	int InsideFirstX = (StartX + (1 << Level) - 1) >> Level;
+	int InsideFirstY = (StartY + (1 << Level) - 1) >> Level;
+	int InsideLastX = ((EndX + 1) >> Level) - 1;
+	int InsideLastY = ((EndY + 1) >> Level) - 1;
+
+	// A filled cell completely inside the area means something in the area has been filled
+	for (int y = FirstY; y <= LastY; y++)
+	{
+		for (int x = FirstX; x <= LastX; x++)
+		{
+			if ((Cells[(y * Width) + x] != 0) && (x >= InsideFirstX) && (x <= InsideLastX) && (y >= InsideFirstY) && (y <= InsideLastY))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Follow the filled cells on the edges of the area down to the level below, only checking the cells below that overlap the area
+	for (int y = FirstY; y <= LastY; y++)
+	{
+		for (int x = FirstX; x <= LastX; x++)
+		{
+			if (Cells[(y * Width) + x] == 0)
+			{
+				continue;
+			}
+
+			int BelowFirstX = ((x * 2) > (StartX >> (Level - 1))) ? (x * 2) : (StartX >> (Level - 1));
+			int BelowFirstY = ((y * 2) > (StartY >> (Level - 1))) ? (y * 2) : (StartY >> (Level - 1));
+			int BelowLastX = (((x * 2) + 1) < (EndX >> (Level - 1))) ? ((x * 2) + 1) : (EndX >> (Level - 1));
+			int BelowLastY = (((y * 2) + 1) < (EndY >> (Level - 1))) ? ((y * 2) + 1) : (EndY >> (Level - 1));
+
+			if (!IsLevelAreaEmpty(Level - 1, BelowFirstX, BelowFirstY, BelowLastX, BelowLastY, StartX, StartY, EndX, EndY))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: occupancypyramidclass.h
+// Occupancy Pyramid Class
+// Keeps levels of the dungeon grid at halving sizes so filled areas can be found without checking every position
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCCUPANCY_PYRAMID_CLASS_H
+#define OCCUPANCY_PYRAMID_CLASS_H
+
+// For vector
+#include <vector>
+using std::vector;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: OccupancyPyramidClass
+// The first level holds whether each position of the grid is filled. Each level above it is half the width and height of the
+// level below, and each of its cells is filled if any of the 2x2 cells below it are. An area is checked from the top level
+// down, starting from a level where a few cells cover the area - an empty cell means nothing below it is filled, and a filled
+// cell that lies completely inside the area means the area isn't empty, so only the cells on the edges of the area are followed
+// down to the first level
+////////////////////////////////////////////////////////////////////////////////
+class OccupancyPyramidClass
+{
+public:
+	// Function:		Occupancy Pyramid constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	OccupancyPyramidClass();
+
+
+	// Placeholder destructor
+	~OccupancyPyramidClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Creates the levels for an empty grid, adding levels until the top level is a single cell
+	// Takes in:		int - Width of the grid, int - Height of the grid
+	// Returns:			True if the size is valid, false if not
+	bool Initialise(int Width, int Height);
+
+
+	// Function:		Occupy function
+	// What it does:	Fills an area of the first level and the cells above it in every other level
+	// Takes in:		int - Start and end positions of the area (included in the area)
+	// Returns:			Nothing
+	void Occupy(int StartX, int StartY, int EndX, int EndY);
+
+
+	// Function:		Is Empty function
+	// What it does:	Checks if anything in an area has been filled. An area with nothing in it is always empty
+	// Takes in:		int - Start and end positions of the area (included in the area, and inside the grid)
+	// Returns:			True if nothing in the area has been filled, false if something has
+	bool IsEmpty(int StartX, int StartY, int EndX, int EndY);
+
+
+	// Function:		Get Level Count function
+	// What it does:	Returns the number of levels in the pyramid
+	// Takes in:		Nothing
+	// Returns:			int - Number of levels
+	int GetLevelCount();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the levels
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// Function:		Is Level Area Empty function
+	// What it does:	Checks the part of an area covered by a block of cells in a level. Any filled cell lying completely inside the area
+	//					is looked for first, as it means the area isn't empty without going any further. Then each filled cell that only
+	//					partly covers the area is followed down to the 2x2 cells below it
+	// Takes in:		int - Level, int - First and last X and Y cells of the block in the level, int - Start and end positions of the area
+	// Returns:			True if nothing in the part of the area covered by the block has been filled, false if something has
+	bool IsLevelAreaEmpty(int Level, int FirstX, int FirstY, int LastX, int LastY, int StartX, int StartY, int EndX, int EndY);
+
+private:
+	// The cells of each level, and the size of each level
+	vector< vector<unsigned char> > m_Levels;
+	vector<int> m_Widths;
+	vector<int> m_Heights;
+};
+
+
+#endif
@@ -0,0 +1,975 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: prefablibraryclass.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+#include "prefablibraryclass.h"
+
+
+// Function:		Prefab Library constructor
+// What it does:	Initialises all variables and objects to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+PrefabLibraryClass::PrefabLibraryClass()
+{
+	m_Device = 0;
+	m_TextureCache = 0;
+	m_FloorTexture = 0;
+	m_WallTexture = 0;
+	m_MapTexture = 0;
+}
+
+
+// Placeholder destructor
+
+PrefabLibraryClass::~PrefabLibraryClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Loads the templates from the asset file, building the default templates and writing the file if it can't be
+//					loaded. Then creates the vertex and index buffers for every template and loads the textures
+// Takes in:		ID3D11Device - pointer to DirectX device (0 to only load the templates), TextureCacheClass - pointer to the
+//					cache the textures are shared from (0 without a device), char - Pointer to the asset file name
+// Returns:			True if the library is ready to use, false if not
+
+bool PrefabLibraryClass::Initialise(ID3D11Device* Device, TextureCacheClass* TextureCache, char* Filename)
+{
+	bool result;
+	m_Device = Device;
+	m_TextureCache = TextureCache;
+
+	// If the asset can't be loaded, build the default templates and write them out so the asset is there next time.
+	// The library can still be used if the file can't be written
+	if (!LoadTemplates(Filename))
+	{
+		BuildDefaultTemplates();
+		SaveTemplates(Filename);
+	}
+
+	// Without a device only the templates are needed, to lay out a dungeon without drawing it
+	if ((!m_Device) || (!m_TextureCache))
+	{
+		return true;
+	}
+
+	// Create the buffers for each template. These are shared by every room placed from the template
+	for (unsigned int i = 0; i < m_Templates.size(); i++)
+	{
+		result = InitializeBuffers(m_Templates[i]);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Get the textures from the cache, which has usually loaded them for the dungeon pieces already
+	m_FloorTexture = m_TextureCache->Acquire(L"data/wooden_floors.png");
+	m_WallTexture = m_TextureCache->Acquire(L"data/stone_walls.png");
+	m_MapTexture = m_TextureCache->Acquire(L"data/room.png");
+	if ((!m_FloorTexture) || (!m_WallTexture) || (!m_MapTexture))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Load Templates function
+// What it does:	Reads the templates from a binary asset file, replacing any templates already in the library
+// Takes in:		char - Pointer to the asset file name
+// Returns:			True if the file was read, false if it couldn't be opened or isn't a valid prefab file
+
+bool PrefabLibraryClass::LoadTemplates(char* Filename)
+{
+	ifstream fin;
+	int Header[3];
+
+	fin.open(Filename, std::ios::in | std::ios::binary);
+	if (fin.fail())
+	{
+		return false;
+	}
+
+	// The header holds the file id, the version and the number of templates
+	fin.read((char*)Header, sizeof(Header));
+	if ((fin.fail()) || (Header[0] != PREFAB_FILE_ID) || (Header[1] != PREFAB_FILE_VERSION) || (Header[2] < 0) || (Header[2] > PREFAB_MAX_TEMPLATES))
+	{
+		return false;
+	}
+
+	vector<Template> Templates(Header[2]);
+	for (unsigned int i = 0; i < Templates.size(); i++)
+	{
+		Template &NewTemplate = Templates[i];
+		NewTemplate.VertexBuffer = 0;
+		NewTemplate.IndexBuffer = 0;
+
+		// Each template starts with its size and the number of sockets, segments, vertices, indices and parts
+		int Counts[7];
+		fin.read((char*)Counts, sizeof(Counts));
+		if (fin.fail())
+		{
+			return false;
+		}
+
+		NewTemplate.Width = Counts[0];
+		NewTemplate.Height = Counts[1];
+		if ((NewTemplate.Width < 1) || (NewTemplate.Width > PREFAB_MAX_SIZE) || (NewTemplate.Height < 1) || (NewTemplate.Height > PREFAB_MAX_SIZE))
+		{
+			return false;
+		}
+		for (int j = 2; j < 7; j++)
+		{
+			if ((Counts[j] < 0) || (Counts[j] > 0xFFFFFF))
+			{
+				return false;
+			}
+		}
+		if (Counts[6] != PREFAB_PART_PLUGS + Counts[2])
+		{
+			return false;
+		}
+
+		NewTemplate.Mask.resize(NewTemplate.Width * NewTemplate.Height);
+		NewTemplate.Sockets.resize(Counts[2]);
+		NewTemplate.Segments.resize(Counts[3]);
+		NewTemplate.Vertices.resize(Counts[4]);
+		NewTemplate.Indices.resize(Counts[5]);
+		NewTemplate.Parts.resize(Counts[6]);
+
+		fin.read((char*)&NewTemplate.Mask[0], NewTemplate.Mask.size());
+		if (!NewTemplate.Sockets.empty())
+		{
+			fin.read((char*)&NewTemplate.Sockets[0], NewTemplate.Sockets.size() * sizeof(Socket));
+		}
+		if (!NewTemplate.Segments.empty())
+		{
+			fin.read((char*)&NewTemplate.Segments[0], NewTemplate.Segments.size() * sizeof(WallSegment));
+		}
+		if (!NewTemplate.Vertices.empty())
+		{
+			fin.read((char*)&NewTemplate.Vertices[0], NewTemplate.Vertices.size() * sizeof(VertexType));
+		}
+		if (!NewTemplate.Indices.empty())
+		{
+			fin.read((char*)&NewTemplate.Indices[0], NewTemplate.Indices.size() * sizeof(unsigned int));
+		}
+		fin.read((char*)&NewTemplate.Parts[0], NewTemplate.Parts.size() * sizeof(Part));
+		if (fin.fail())
+		{
+			return false;
+		}
+
+		// Check the data can be used safely - sockets on the edge of the mask, indices inside the vertices and parts inside the indices
+		for (unsigned int j = 0; j < NewTemplate.Sockets.size(); j++)
+		{
+			Socket &ThisSocket = NewTemplate.Sockets[j];
+			int Length = ((ThisSocket.Side == PREFAB_SIDE_LEFT) || (ThisSocket.Side == PREFAB_SIDE_RIGHT)) ? NewTemplate.Height : NewTemplate.Width;
+			if ((ThisSocket.Side < PREFAB_SIDE_LEFT) || (ThisSocket.Side > PREFAB_SIDE_DOWN) || (ThisSocket.Cell < 0) || (ThisSocket.Cell >= Length))
+			{
+				return false;
+			}
+			if (NewTemplate.Parts[PREFAB_PART_PLUGS + j].IndexCount == 0)
+			{
+				return false;
+			}
+		}
+		for (unsigned int j = 0; j < NewTemplate.Indices.size(); j++)
+		{
+			if (NewTemplate.Indices[j] >= NewTemplate.Vertices.size())
+			{
+				return false;
+			}
+		}
+		for (unsigned int j = 0; j < NewTemplate.Parts.size(); j++)
+		{
+			Part &ThisPart = NewTemplate.Parts[j];
+			if ((ThisPart.StartIndex < 0) || (ThisPart.IndexCount < 0) || (ThisPart.StartIndex + ThisPart.IndexCount > (int)NewTemplate.Indices.size()))
+			{
+				return false;
+			}
+		}
+	}
+
+	fin.close();
+
+	// Replace the templates in the library with the ones that were loaded
+	ReleaseTemplates();
+	m_Templates.swap(Templates);
+	IndexSockets();
+
+	return true;
+}
+
+
+// Function:		Save Templates function
+// What it does:	Writes every template in the library to a binary asset file
+// Takes in:		char - Pointer to the asset file name
+// Returns:			True if the file was written, false if not
+
+bool PrefabLibraryClass::SaveTemplates(char* Filename)
+{
+	ofstream fout;
+	int Header[3] = { PREFAB_FILE_ID, PREFAB_FILE_VERSION, (int)m_Templates.size() };
+
+	fout.open(Filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (fout.fail())
+	{
+		return false;
+	}
+
+	fout.write((char*)Header, sizeof(Header));
+
+	for (unsigned int i = 0; i < m_Templates.size(); i++)
+	{
+		Template &ThisTemplate = m_Templates[i];
+		int Counts[7] = { ThisTemplate.Width, ThisTemplate.Height, (int)ThisTemplate.Sockets.size(), (int)ThisTemplate.Segments.size(),
+							(int)ThisTemplate.Vertices.size(), (int)ThisTemplate.Indices.size(), (int)ThisTemplate.Parts.size() };
+
+		fout.write((char*)Counts, sizeof(Counts));
+		fout.write((char*)&ThisTemplate.Mask[0], ThisTemplate.Mask.size());
+		if (!ThisTemplate.Sockets.empty())
+		{
+			fout.write((char*)&ThisTemplate.Sockets[0], ThisTemplate.Sockets.size() * sizeof(Socket));
+		}
+		if (!ThisTemplate.Segments.empty())
+		{
+			fout.write((char*)&ThisTemplate.Segments[0], ThisTemplate.Segments.size() * sizeof(WallSegment));
+		}
+		if (!ThisTemplate.Vertices.empty())
+		{
+			fout.write((char*)&ThisTemplate.Vertices[0], ThisTemplate.Vertices.size() * sizeof(VertexType));
+		}
+		if (!ThisTemplate.Indices.empty())
+		{
+			fout.write((char*)&ThisTemplate.Indices[0], ThisTemplate.Indices.size() * sizeof(unsigned int));
+		}
+		fout.write((char*)&ThisTemplate.Parts[0], ThisTemplate.Parts.size() * sizeof(Part));
+	}
+
+	if (fout.fail())
+	{
+		return false;
+	}
+
+	fout.close();
+
+	return true;
+}
+
+
+// Function:		Build Default Templates function
+// What it does:	Replaces the templates in the library with the built in set of prefab rooms
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void PrefabLibraryClass::BuildDefaultTemplates()
+{
+	ReleaseTemplates();
+
+	// Cross shaped room with a door at the end of each arm
+	char* Cross[] = {	".###.",
+						"#####",
+						"#####",
+						"#####",
+						".###." };
+	Socket CrossSockets[] = { { PREFAB_SIDE_LEFT, 2 }, { PREFAB_SIDE_UP, 2 }, { PREFAB_SIDE_RIGHT, 2 }, { PREFAB_SIDE_DOWN, 2 } };
+	AddTemplate(Cross, 5, 5, CrossSockets, 4);
+
+	// L shaped room
+	char* LShape[] = {	"##...",
+						"##...",
+						"#####",
+						"#####",
+						"#####" };
+	Socket LShapeSockets[] = { { PREFAB_SIDE_LEFT, 1 }, { PREFAB_SIDE_UP, 0 }, { PREFAB_SIDE_RIGHT, 1 }, { PREFAB_SIDE_DOWN, 2 } };
+	AddTemplate(LShape, 5, 5, LShapeSockets, 4);
+
+	// Room around a courtyard in the middle (the courtyard is walled off)
+	char* Ring[] = {	"######",
+						"######",
+						"##..##",
+						"##..##",
+						"######",
+						"######" };
+	Socket RingSockets[] = { { PREFAB_SIDE_LEFT, 1 }, { PREFAB_SIDE_UP, 1 }, { PREFAB_SIDE_RIGHT, 4 }, { PREFAB_SIDE_DOWN, 4 } };
+	AddTemplate(Ring, 6, 6, RingSockets, 4);
+
+	// T shaped room
+	char* TShape[] = {	"#####",
+						"#####",
+						".###.",
+						".###." };
+	Socket TShapeSockets[] = { { PREFAB_SIDE_LEFT, 2 }, { PREFAB_SIDE_RIGHT, 3 }, { PREFAB_SIDE_DOWN, 2 } };
+	AddTemplate(TShape, 5, 4, TShapeSockets, 3);
+
+	// U shaped room with two wings
+	char* UShape[] = {	"##.##",
+						"##.##",
+						"#####",
+						"#####",
+						"#####" };
+	Socket UShapeSockets[] = { { PREFAB_SIDE_LEFT, 1 }, { PREFAB_SIDE_UP, 0 }, { PREFAB_SIDE_UP, 4 }, { PREFAB_SIDE_RIGHT, 1 }, { PREFAB_SIDE_DOWN, 2 } };
+	AddTemplate(UShape, 5, 5, UShapeSockets, 5);
+
+	// Long hall with pillars
+	char* Hall[] = {	"#######",
+						"#.#.#.#",
+						"#######" };
+	Socket HallSockets[] = { { PREFAB_SIDE_LEFT, 1 }, { PREFAB_SIDE_UP, 3 }, { PREFAB_SIDE_RIGHT, 1 }, { PREFAB_SIDE_DOWN, 3 } };
+	AddTemplate(Hall, 7, 3, HallSockets, 4);
+}
+
+
+// Function:		Add Template function
+// What it does:	Builds a template from rows of text ('#' for a floor cell, anything else for empty, top row first) and a list
+//					of sockets. Works out the floor and ceiling from rectangles of the mask, and the walls from the edges between
+//					floor and empty cells, with a gap and a plug for each socket
+// Takes in:		char - Pointer to the rows of the mask, int - Width of the mask, int - Height of the mask,
+//					Socket - Pointer to the sockets, int - Number of sockets
+// Returns:			int - Index of the new template, or -1 if the mask or a socket isn't valid
+
+int PrefabLibraryClass::AddTemplate(char** Rows, int Width, int Height, Socket* Sockets, int SocketCount)
+{
+	if ((Width < 1) || (Width > PREFAB_MAX_SIZE) || (Height < 1) || (Height > PREFAB_MAX_SIZE))
+	{
+		return -1;
+	}
+
+	Template NewTemplate;
+	NewTemplate.Width = Width;
+	NewTemplate.Height = Height;
+	NewTemplate.VertexBuffer = 0;
+	NewTemplate.IndexBuffer = 0;
+
+	// The rows are given top first, but the mask starts from the bottom so it matches the grid
+	int FloorCells = 0;
+	NewTemplate.Mask.resize(Width * Height);
+	for (int y = 0; y < Height; y++)
+	{
+		for (int x = 0; x < Width; x++)
+		{
+			NewTemplate.Mask[(y * Width) + x] = (Rows[Height - 1 - y][x] == '#') ? 1 : 0;
+			FloorCells += NewTemplate.Mask[(y * Width) + x];
+		}
+	}
+
+	if (FloorCells == 0)
+	{
+		return -1;
+	}
+
+	// Sockets have to be on a floor cell on the outside edge of the mask, so that the room can sit against the piece it leads off
+	for (int i = 0; i < SocketCount; i++)
+	{
+		int x = 0;
+		int y = 0;
+		if (Sockets[i].Side == PREFAB_SIDE_LEFT)
+		{
+			y = Sockets[i].Cell;
+		}
+		else if (Sockets[i].Side == PREFAB_SIDE_RIGHT)
+		{
+			x = Width - 1;
+			y = Sockets[i].Cell;
+		}
+		else if (Sockets[i].Side == PREFAB_SIDE_UP)
+		{
+			x = Sockets[i].Cell;
+			y = Height - 1;
+		}
+		else if (Sockets[i].Side == PREFAB_SIDE_DOWN)
+		{
+			x = Sockets[i].Cell;
+		}
+		else
+		{
+			return -1;
+		}
+
+		if ((x < 0) || (x >= Width) || (y < 0) || (y >= Height) || (!NewTemplate.Mask[(y * Width) + x]))
+		{
+			return -1;
+		}
+
+		NewTemplate.Sockets.push_back(Sockets[i]);
+	}
+
+	BuildGeometry(NewTemplate);
+
+	m_Templates.push_back(NewTemplate);
+	IndexSockets();
+
+	return m_Templates.size() - 1;
+}
+
+
+// Function:		Build Geometry function
+// What it does:	Builds the floor, ceiling, wall and plug parts and the wall segments of a template from its mask and sockets
+// Takes in:		Template - reference to the template
+// Returns:			Nothing
+
+void PrefabLibraryClass::BuildGeometry(Template &NewTemplate)
+{
+	int Width = NewTemplate.Width;
+	int Height = NewTemplate.Height;
+	Part NewPart;
+
+	// Cover the floor cells with rectangles, growing each one right along its row and then up while the rows above match
+	vector<D3DXVECTOR4> Rects;
+	vector<bool> Covered(Width * Height, false);
+	for (int y = 0; y < Height; y++)
+	{
+		for (int x = 0; x < Width; x++)
+		{
+			if ((!NewTemplate.Mask[(y * Width) + x]) || (Covered[(y * Width) + x]))
+			{
+				continue;
+			}
+
+			int x1 = x;
+			while ((x1 < Width) && (NewTemplate.Mask[(y * Width) + x1]) && (!Covered[(y * Width) + x1]))
+			{
+				x1++;
+			}
+
+			int y1 = y + 1;
+			bool RowMatches = true;
+			while ((y1 < Height) && (RowMatches))
+			{
+				for (int i = x; i < x1; i++)
+				{
+					if ((!NewTemplate.Mask[(y1 * Width) + i]) || (Covered[(y1 * Width) + i]))
+					{
+						RowMatches = false;
+					}
+				}
+				if (RowMatches)
+				{
+					y1++;
+				}
+			}
+
+			for (int j = y; j < y1; j++)
+			{
+				for (int i = x; i < x1; i++)
+				{
+					Covered[(j * Width) + i] = true;
+				}
+			}
+
+			Rects.push_back(D3DXVECTOR4(x * PREFAB_CELL_SIZE, y * PREFAB_CELL_SIZE, x1 * PREFAB_CELL_SIZE, y1 * PREFAB_CELL_SIZE));
+		}
+	}
+
+	// Floor part - facing up, with the texture repeating every two units like the entrance piece
+	NewPart.StartIndex = NewTemplate.Indices.size();
+	for (unsigned int i = 0; i < Rects.size(); i++)
+	{
+		D3DXVECTOR4 &Rect = Rects[i];
+		AddQuad(NewTemplate,	D3DXVECTOR3(Rect.x, 0.0f, Rect.y),		// Bottom Left
+								D3DXVECTOR3(Rect.x, 0.0f, Rect.w),		// Top Left
+								D3DXVECTOR3(Rect.z, 0.0f, Rect.w),		// Top Right
+								D3DXVECTOR3(Rect.z, 0.0f, Rect.y),		// Bottom Right
+								D3DXVECTOR3(0.0f, 1.0f, 0.0f), D3DXVECTOR2((Rect.z - Rect.x) * 0.5f, (Rect.w - Rect.y) * 0.5f));
+	}
+	NewPart.IndexCount = NewTemplate.Indices.size() - NewPart.StartIndex;
+	NewTemplate.Parts.push_back(NewPart);
+
+	// Ceiling part - the same rectangles drawn the other way round so they can be seen from below
+	NewPart.StartIndex = NewTemplate.Indices.size();
+	for (unsigned int i = 0; i < Rects.size(); i++)
+	{
+		D3DXVECTOR4 &Rect = Rects[i];
+		AddQuad(NewTemplate,	D3DXVECTOR3(Rect.x, 0.0f, Rect.y),
+								D3DXVECTOR3(Rect.z, 0.0f, Rect.y),
+								D3DXVECTOR3(Rect.z, 0.0f, Rect.w),
+								D3DXVECTOR3(Rect.x, 0.0f, Rect.w),
+								D3DXVECTOR3(0.0f, -1.0f, 0.0f), D3DXVECTOR2((Rect.z - Rect.x), (Rect.w - Rect.y)));
+	}
+	NewPart.IndexCount = NewTemplate.Indices.size() - NewPart.StartIndex;
+	NewTemplate.Parts.push_back(NewPart);
+
+	// Walls part - find the runs of floor cells with an empty cell (or the outside of the mask) on each side
+	int SideX[4] = { -1, 0, 1, 0 };
+	int SideY[4] = { 0, 1, 0, -1 };
+	vector<WallSegment> Plugs;
+
+	NewPart.StartIndex = NewTemplate.Indices.size();
+	for (int Side = PREFAB_SIDE_LEFT; Side <= PREFAB_SIDE_DOWN; Side++)
+	{
+		// Left and right walls run along columns, top and bottom walls along rows
+		bool AlongColumn = (Side == PREFAB_SIDE_LEFT) || (Side == PREFAB_SIDE_RIGHT);
+		int Lines = AlongColumn ? Width : Height;
+		int Length = AlongColumn ? Height : Width;
+
+		for (int Line = 0; Line < Lines; Line++)
+		{
+			int RunStart = -1;
+			for (int i = 0; i <= Length; i++)
+			{
+				bool Edge = false;
+				if (i < Length)
+				{
+					int x = AlongColumn ? Line : i;
+					int y = AlongColumn ? i : Line;
+					Edge = IsCellFilled(NewTemplate, x, y) && (!IsCellFilled(NewTemplate, x + SideX[Side], y + SideY[Side]));
+				}
+
+				if ((Edge) && (RunStart < 0))
+				{
+					RunStart = i;
+				}
+				if ((!Edge) && (RunStart >= 0))
+				{
+					AddWallRun(NewTemplate, Side, Line, RunStart, i, Plugs);
+					RunStart = -1;
+				}
+			}
+		}
+	}
+	NewPart.IndexCount = NewTemplate.Indices.size() - NewPart.StartIndex;
+	NewTemplate.Parts.push_back(NewPart);
+
+	// Plug parts - one for each socket in socket order, so they can be drawn for the sockets that aren't used
+	for (unsigned int i = 0; i < NewTemplate.Sockets.size(); i++)
+	{
+		NewPart.StartIndex = NewTemplate.Indices.size();
+		for (unsigned int j = 0; j < Plugs.size(); j++)
+		{
+			if (Plugs[j].Socket == (int)i)
+			{
+				AddWall(NewTemplate, D3DXVECTOR2(Plugs[j].StartX, Plugs[j].StartY), D3DXVECTOR2(Plugs[j].EndX, Plugs[j].EndY),
+						D3DXVECTOR3(-SideX[NewTemplate.Sockets[i].Side], 0.0f, -SideY[NewTemplate.Sockets[i].Side]), i);
+			}
+		}
+		NewPart.IndexCount = NewTemplate.Indices.size() - NewPart.StartIndex;
+		NewTemplate.Parts.push_back(NewPart);
+	}
+}
+
+
+// Function:		Add Wall Run function
+// What it does:	Adds the walls for a run of edges along one side of the mask, leaving a gap in the walls for each socket on the
+//					run and adding the wall that fills the gap to the list of plugs
+// Takes in:		Template - reference to the template, int - Side the walls face away from (PREFAB_SIDE values),
+//					int - Row or column of cells the run is on, int - First cell of the run and the cell after its end,
+//					vector<WallSegment> - reference to the list of plugs
+// Returns:			Nothing
+
+void PrefabLibraryClass::AddWallRun(Template &NewTemplate, int Side, int Line, int RunStart, int RunEnd, vector<WallSegment> &Plugs)
+{
+	// Walls face into the room, away from the side they are on
+	int SideX[4] = { -1, 0, 1, 0 };
+	int SideY[4] = { 0, 1, 0, -1 };
+	D3DXVECTOR3 Normal = D3DXVECTOR3(-SideX[Side], 0.0f, -SideY[Side]);
+
+	// The line the walls are on, which is the far edge of the cells for right and top walls
+	float Fixed = Line * PREFAB_CELL_SIZE;
+	int OuterLine = 0;
+	if (Side == PREFAB_SIDE_RIGHT)
+	{
+		Fixed += PREFAB_CELL_SIZE;
+		OuterLine = NewTemplate.Width - 1;
+	}
+	if (Side == PREFAB_SIDE_UP)
+	{
+		Fixed += PREFAB_CELL_SIZE;
+		OuterLine = NewTemplate.Height - 1;
+	}
+
+	// Find the sockets in this run in order along it. Sockets can only be on the outside edge of the mask
+	vector<int> Gaps;
+	if (Line == OuterLine)
+	{
+		for (unsigned int i = 0; i < NewTemplate.Sockets.size(); i++)
+		{
+			Socket &ThisSocket = NewTemplate.Sockets[i];
+			if ((ThisSocket.Side == Side) && (ThisSocket.Cell >= RunStart) && (ThisSocket.Cell < RunEnd))
+			{
+				unsigned int j = 0;
+				while ((j < Gaps.size()) && (NewTemplate.Sockets[Gaps[j]].Cell < ThisSocket.Cell))
+				{
+					j++;
+				}
+				Gaps.insert(Gaps.begin() + j, i);
+			}
+		}
+	}
+
+	// Split the run into the walls between the gaps, and the plugs that fill the gaps
+	float Position = RunStart * PREFAB_CELL_SIZE;
+	for (unsigned int i = 0; i <= Gaps.size(); i++)
+	{
+		float WallEnd = RunEnd * PREFAB_CELL_SIZE;
+		float GapEnd = WallEnd;
+		if (i < Gaps.size())
+		{
+			float GapCenter = (NewTemplate.Sockets[Gaps[i]].Cell + 0.5f) * PREFAB_CELL_SIZE;
+			WallEnd = GapCenter - PREFAB_DOOR_HALF_WIDTH;
+			GapEnd = GapCenter + PREFAB_DOOR_HALF_WIDTH;
+		}
+
+		// Find the two ends of each piece so they go left to right when looked at from inside the room
+		for (int Piece = 0; Piece < 2; Piece++)
+		{
+			float From = (Piece == 0) ? Position : WallEnd;
+			float To = (Piece == 0) ? WallEnd : GapEnd;
+			if (To - From <= 0.0f)
+			{
+				continue;
+			}
+
+			D3DXVECTOR2 Start, End;
+			if (Side == PREFAB_SIDE_LEFT)
+			{
+				Start = D3DXVECTOR2(Fixed, From);
+				End = D3DXVECTOR2(Fixed, To);
+			}
+			if (Side == PREFAB_SIDE_RIGHT)
+			{
+				Start = D3DXVECTOR2(Fixed, To);
+				End = D3DXVECTOR2(Fixed, From);
+			}
+			if (Side == PREFAB_SIDE_UP)
+			{
+				Start = D3DXVECTOR2(From, Fixed);
+				End = D3DXVECTOR2(To, Fixed);
+			}
+			if (Side == PREFAB_SIDE_DOWN)
+			{
+				Start = D3DXVECTOR2(To, Fixed);
+				End = D3DXVECTOR2(From, Fixed);
+			}
+
+			if (Piece == 0)
+			{
+				AddWall(NewTemplate, Start, End, Normal, -1);
+			}
+			else
+			{
+				WallSegment Plug = { Start.x, Start.y, End.x, End.y, Gaps[i] };
+				Plugs.push_back(Plug);
+			}
+		}
+
+		Position = GapEnd;
+	}
+}
+
+
+// Function:		Add Wall function
+// What it does:	Adds a wall quad facing into the room along the given line, and its segment for the collision grid
+// Takes in:		Template - reference to the template, D3DXVECTOR2 - start and end of the wall on the floor (left to right
+//					when looking at it from inside the room), D3DXVECTOR3 - normal, int - Socket it plugs or -1
+// Returns:			Nothing
+
+void PrefabLibraryClass::AddWall(Template &NewTemplate, D3DXVECTOR2 Start, D3DXVECTOR2 End, D3DXVECTOR3 Normal, int SocketIndex)
+{
+	// Repeat the texture along the length of the wall so long walls aren't stretched
+	float Length = fabs(End.x - Start.x) + fabs(End.y - Start.y);
+
+	AddQuad(NewTemplate,	D3DXVECTOR3(Start.x, 0.0f, Start.y),					// Bottom Left
+							D3DXVECTOR3(Start.x, PREFAB_WALL_HEIGHT, Start.y),		// Top Left
+							D3DXVECTOR3(End.x, PREFAB_WALL_HEIGHT, End.y),			// Top Right
+							D3DXVECTOR3(End.x, 0.0f, End.y),						// Bottom Right
+							Normal, D3DXVECTOR2(Length, 2.0f));
+
+	WallSegment Segment = { Start.x, Start.y, End.x, End.y, SocketIndex };
+	NewTemplate.Segments.push_back(Segment);
+}
+
+
+// Function:		Add Quad function
+// What it does:	Adds the four vertices and six indices of a quad to a template
+// Takes in:		Template - reference to the template, D3DXVECTOR3 - bottom left, top left, top right and bottom right positions,
+//					D3DXVECTOR3 - normal, D3DXVECTOR2 - texture scale
+// Returns:			Nothing
+
+void PrefabLibraryClass::AddQuad(Template &NewTemplate, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, D3DXVECTOR3 BottomRight,
+									D3DXVECTOR3 Normal, D3DXVECTOR2 TextureScale)
+{
+	unsigned int First = NewTemplate.Vertices.size();
+	VertexType Vertex;
+	Vertex.normal = Normal;
+
+	// Use the same texture co-ordinates and index order as the meshes and dungeon pieces
+	Vertex.position = BottomLeft;
+	Vertex.texture = D3DXVECTOR2(0.0f, TextureScale.y);
+	NewTemplate.Vertices.push_back(Vertex);
+
+	Vertex.position = TopLeft;
+	Vertex.texture = D3DXVECTOR2(0.0f, 0.0f);
+	NewTemplate.Vertices.push_back(Vertex);
+
+	Vertex.position = TopRight;
+	Vertex.texture = D3DXVECTOR2(TextureScale.x, 0.0f);
+	NewTemplate.Vertices.push_back(Vertex);
+
+	Vertex.position = BottomRight;
+	Vertex.texture = D3DXVECTOR2(TextureScale.x, TextureScale.y);
+	NewTemplate.Vertices.push_back(Vertex);
+
+	NewTemplate.Indices.push_back(First);			// Bottom left
+	NewTemplate.Indices.push_back(First + 1);		// Top left
+	NewTemplate.Indices.push_back(First + 2);		// Top right
+	NewTemplate.Indices.push_back(First);			// Bottom left
+	NewTemplate.Indices.push_back(First + 2);		// Top right
+	NewTemplate.Indices.push_back(First + 3);		// Bottom right
+}
+
+
+// Function:		Is Cell Filled function
+// What it does:	Checks the mask of a template that may not be in the library yet
+// Takes in:		Template - reference to the template, int - X cell, int - Y cell
+// Returns:			True if the cell is part of the room, false if it is empty or outside the mask
+
+bool PrefabLibraryClass::IsCellFilled(Template &ThisTemplate, int x, int y)
+{
+	if ((x < 0) || (x >= ThisTemplate.Width) || (y < 0) || (y >= ThisTemplate.Height))
+	{
+		return false;
+	}
+
+	return ThisTemplate.Mask[(y * ThisTemplate.Width) + x] != 0;
+}
+
+
+// Function:		Index Sockets function
+// What it does:	Builds the lists of sockets on each side of the templates, used to pick sockets quickly
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void PrefabLibraryClass::IndexSockets()
+{
+	for (int Side = PREFAB_SIDE_LEFT; Side <= PREFAB_SIDE_DOWN; Side++)
+	{
+		m_SideSockets[Side].clear();
+	}
+
+	for (unsigned int i = 0; i < m_Templates.size(); i++)
+	{
+		for (unsigned int j = 0; j < m_Templates[i].Sockets.size(); j++)
+		{
+			SocketReference Reference = { (int)i, (int)j };
+			m_SideSockets[m_Templates[i].Sockets[j].Side].push_back(Reference);
+		}
+	}
+}
+
+
+// Function:		Pick Socket function
+// What it does:	Picks a random socket on the given side of any template
+// Takes in:		int - Side (PREFAB_SIDE values), int - references to the template and socket picked
+// Returns:			True if a socket was picked, false if no template has a socket on that side
+
+bool PrefabLibraryClass::PickSocket(int Side, int &TemplateIndex, int &SocketIndex)
+{
+	if ((Side < PREFAB_SIDE_LEFT) || (Side > PREFAB_SIDE_DOWN) || (m_SideSockets[Side].empty()))
+	{
+		return false;
+	}
+
+	SocketReference &Reference = m_SideSockets[Side][rand() % m_SideSockets[Side].size()];
+	TemplateIndex = Reference.Template;
+	SocketIndex = Reference.Socket;
+
+	return true;
+}
+
+
+// Function:		Is Occupied function
+// What it does:	Checks the mask of a template
+// Takes in:		int - Template index, int - X cell, int - Y cell
+// Returns:			True if the cell is part of the room, false if it is empty or outside the mask
+
+bool PrefabLibraryClass::IsOccupied(int TemplateIndex, int x, int y)
+{
+	return IsCellFilled(m_Templates[TemplateIndex], x, y);
+}
+
+
+// Function:		Get Template function
+// What it does:	Returns a template so its mask, sockets and segments can be read
+// Takes in:		int - Template index
+// Returns:			Pointer to the template
+
+PrefabLibraryClass::Template* PrefabLibraryClass::GetTemplate(int TemplateIndex)
+{
+	return &m_Templates[TemplateIndex];
+}
+
+
+// Function:		Get Template Count function
+// What it does:	Returns the number of templates in the library
+// Takes in:		Nothing
+// Returns:			int - Number of templates
+
+int PrefabLibraryClass::GetTemplateCount()
+{
+	return m_Templates.size();
+}
+
+
+// Function:		Initialise Buffers function
+// What it does:	Creates the vertex and index buffers of a template from its vertices and indices
+// Takes in:		Template - reference to the template
+// Returns:			True if successful, false if not
+
+bool PrefabLibraryClass::InitializeBuffers(Template &ThisTemplate)
+{
+	D3D11_BUFFER_DESC vertexBufferDesc, indexBufferDesc;
+	D3D11_SUBRESOURCE_DATA vertexData, indexData;
+	HRESULT result;
+
+	if ((ThisTemplate.Vertices.empty()) || (ThisTemplate.Indices.empty()))
+	{
+		return false;
+	}
+
+	// Set up the description of the static vertex buffer.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * ThisTemplate.Vertices.size();
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.CPUAccessFlags = 0;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the vertex data.
+	vertexData.pSysMem = &ThisTemplate.Vertices[0];
+	vertexData.SysMemPitch = 0;
+	vertexData.SysMemSlicePitch = 0;
+
+	// Now create the vertex buffer.
+	result = m_Device->CreateBuffer(&vertexBufferDesc, &vertexData, &ThisTemplate.VertexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Set up the description of the static index buffer.
+	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.ByteWidth = sizeof(unsigned int) * ThisTemplate.Indices.size();
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the index data.
+	indexData.pSysMem = &ThisTemplate.Indices[0];
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	// Create the index buffer.
+	result = m_Device->CreateBuffer(&indexBufferDesc, &indexData, &ThisTemplate.IndexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Render function
+// What it does:	Puts the template's vertex buffer and the range of its index buffer for one part in the graphics pipeline
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - Template index, int - Part (PREFAB_PART values)
+// Returns:			Nothing
+
+void PrefabLibraryClass::Render(ID3D11DeviceContext* DeviceContext, int TemplateIndex, int PartIndex)
+{
+	Template &ThisTemplate = m_Templates[TemplateIndex];
+	unsigned int stride = sizeof(VertexType);
+	unsigned int offset = 0;
+
+	// Set the vertex buffer to active in the input assembler so it can be rendered.
+	DeviceContext->IASetVertexBuffers(0, 1, &ThisTemplate.VertexBuffer, &stride, &offset);
+
+	// Set the index buffer starting at this part, so the shaders can draw it from the first index
+	DeviceContext->IASetIndexBuffer(ThisTemplate.IndexBuffer, DXGI_FORMAT_R32_UINT, ThisTemplate.Parts[PartIndex].StartIndex * sizeof(unsigned int));
+
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+
+// Function:		Get Index Count function
+// What it does:	Returns the index count needed to render one part of a template
+// Takes in:		int - Template index, int - Part (PREFAB_PART values)
+// Returns:			int - Index count
+
+int PrefabLibraryClass::GetIndexCount(int TemplateIndex, int PartIndex)
+{
+	return m_Templates[TemplateIndex].Parts[PartIndex].IndexCount;
+}
+
+
+// Functions to get the textures used for the floors and ceilings, the walls and the map
+
+ID3D11ShaderResourceView* PrefabLibraryClass::GetFloorTexture()
+{
+	return m_FloorTexture->GetTexture();
+}
+
+ID3D11ShaderResourceView* PrefabLibraryClass::GetWallTexture()
+{
+	return m_WallTexture->GetTexture();
+}
+
+ID3D11ShaderResourceView* PrefabLibraryClass::GetMapTexture()
+{
+	return m_MapTexture->GetTexture();
+}
+
+
+// Function:		Release Templates function
+// What it does:	Releases the buffers of every template and clears the templates
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void PrefabLibraryClass::ReleaseTemplates()
+{
+	// Release the buffers of each template
+	for (unsigned int i = 0; i < m_Templates.size(); i++)
+	{
+		if (m_Templates[i].IndexBuffer)
+		{
+			m_Templates[i].IndexBuffer->Release();
+			m_Templates[i].IndexBuffer = 0;
+		}
+
+		if (m_Templates[i].VertexBuffer)
+		{
+			m_Templates[i].VertexBuffer->Release();
+			m_Templates[i].VertexBuffer = 0;
+		}
+	}
+
+	m_Templates.clear();
+	IndexSockets();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the buffers and textures and clears the templates
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void PrefabLibraryClass::Shutdown()
+{
+	ReleaseTemplates();
+
+	// Give the textures back to the cache
+	TextureClass** Textures[3] = { &m_FloorTexture, &m_WallTexture, &m_MapTexture };
+	for (int i = 0; i < 3; i++)
+	{
+		if (*Textures[i])
+		{
+			m_TextureCache->Release(*Textures[i]);
+			*Textures[i] = 0;
+		}
+	}
+}
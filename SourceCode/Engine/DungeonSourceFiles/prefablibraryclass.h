@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: prefablibraryclass.h
+// Prefab Library Class
+// Holds the prefab room templates loaded from a binary asset, with their occupancy masks, geometry and door sockets
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PREFAB_LIBRARY_CLASS_H
+#define PREFAB_LIBRARY_CLASS_H
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include "textureclass.h"
+#include "texturecacheclass.h"
+
+// For rand and fabs
+#include <stdlib.h>
+#include <math.h>
+
+// For reading and writing the asset file
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+
+// For vector
+#include <vector>
+using std::vector;
+
+// Values used to check the asset file is a prefab file of the version this class reads
+#define PREFAB_FILE_ID 0x42465250
+#define PREFAB_FILE_VERSION 1
+// The most templates an asset file can hold
+#define PREFAB_MAX_TEMPLATES 1024
+
+// The largest width or height of a template mask in cells, and the size of a cell in dungeon units
+#define PREFAB_MAX_SIZE 16
+#define PREFAB_CELL_SIZE 1.0f
+// Specify the height of the walls and half the width of a door gap (the same as the walls built by the dungeon pieces)
+#define PREFAB_WALL_HEIGHT 1.5f
+#define PREFAB_DOOR_HALF_WIDTH 0.3f
+
+// Sides of a template that a socket can be on
+#define PREFAB_SIDE_LEFT 0
+#define PREFAB_SIDE_UP 1
+#define PREFAB_SIDE_RIGHT 2
+#define PREFAB_SIDE_DOWN 3
+
+// Parts of a template's geometry. Each socket has a plug part after the walls that closes its door gap when it isn't used
+#define PREFAB_PART_FLOOR 0
+#define PREFAB_PART_CEILING 1
+#define PREFAB_PART_WALLS 2
+#define PREFAB_PART_PLUGS 3
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: PrefabLibraryClass
+// Loads a library of prefab room templates from a binary asset. Everything a template needs is worked out when the asset
+// is built - the occupancy mask used to test the dungeon grid, the floor, ceiling and wall geometry (in one vertex and
+// index buffer shared by every room made from the template), the door sockets and the wall segments used for collision.
+// Placing a prefab is then a mask test and an instance that refers to its template, with no geometry created per room.
+// If the asset can't be found, the default templates are built and the asset is written so it can be loaded next time
+////////////////////////////////////////////////////////////////////////////////
+class PrefabLibraryClass
+{
+private:
+	// A struct to hold all information about a Vertex to pass into a Vertex Shader
+	struct VertexType
+	{
+		D3DXVECTOR3 position;
+		D3DXVECTOR2 texture;
+		D3DXVECTOR3 normal;
+	};
+
+	// A socket of one of the templates
+	struct SocketReference
+	{
+		int Template;
+		int Socket;
+	};
+
+public:
+	// A door socket on the edge of a template. Cell is the cell along the side the door is in the middle of
+	struct Socket
+	{
+		int Side;
+		int Cell;
+	};
+
+	// A wall segment along the edge of the mask in the template's space, used to fill in the collision grid.
+	// Socket is the socket the segment plugs, or -1 if it is always there
+	struct WallSegment
+	{
+		float StartX, StartY;
+		float EndX, EndY;
+		int Socket;
+	};
+
+	// A range of the index buffer drawn as one part of the template
+	struct Part
+	{
+		int StartIndex;
+		int IndexCount;
+	};
+
+	// A prefab room template. The mask is Width by Height cells starting from the bottom left, and the geometry is in
+	// the same space with the bottom left corner of the mask at (0, 0)
+	struct Template
+	{
+		int Width;
+		int Height;
+		vector<unsigned char> Mask;
+		vector<Socket> Sockets;
+		vector<WallSegment> Segments;
+		vector<VertexType> Vertices;
+		vector<unsigned int> Indices;
+		vector<Part> Parts;
+		ID3D11Buffer *VertexBuffer, *IndexBuffer;
+	};
+
+	// A prefab room placed in the dungeon. Origin is where the bottom left corner of the template's mask is placed, and
+	// OpenSocket is the socket joined to the piece it leads off (all other sockets are plugged)
+	struct Instance
+	{
+		int Template;
+		D3DXVECTOR2 Origin;
+		int OpenSocket;
+	};
+
+	// Function:		Prefab Library constructor
+	// What it does:	Initialises all variables and objects to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	PrefabLibraryClass();
+
+
+	// Placeholder destructor
+	~PrefabLibraryClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Loads the templates from the asset file, building the default templates and writing the file if it can't be
+	//					loaded. Then creates the vertex and index buffers for every template and loads the textures
+	// Takes in:		ID3D11Device - pointer to DirectX device (0 to only load the templates), TextureCacheClass - pointer to the
+	//					cache the textures are shared from (0 without a device), char - Pointer to the asset file name
+	// Returns:			True if the library is ready to use, false if not
+	bool Initialise(ID3D11Device* Device, TextureCacheClass* TextureCache, char* Filename);
+
+
+	// Function:		Load Templates function
+	// What it does:	Reads the templates from a binary asset file, replacing any templates already in the library
+	// Takes in:		char - Pointer to the asset file name
+	// Returns:			True if the file was read, false if it couldn't be opened or isn't a valid prefab file
+	bool LoadTemplates(char* Filename);
+
+
+	// Function:		Save Templates function
+	// What it does:	Writes every template in the library to a binary asset file
+	// Takes in:		char - Pointer to the asset file name
+	// Returns:			True if the file was written, false if not
+	bool SaveTemplates(char* Filename);
+
+
+	// Function:		Build Default Templates function
+	// What it does:	Replaces the templates in the library with the built in set of prefab rooms
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void BuildDefaultTemplates();
+
+
+	// Function:		Add Template function
+	// What it does:	Builds a template from rows of text ('#' for a floor cell, anything else for empty, top row first) and a list
+	//					of sockets. Works out the floor and ceiling from rectangles of the mask, and the walls from the edges between
+	//					floor and empty cells, with a gap and a plug for each socket
+	// Takes in:		char - Pointer to the rows of the mask, int - Width of the mask, int - Height of the mask,
+	//					Socket - Pointer to the sockets, int - Number of sockets
+	// Returns:			int - Index of the new template, or -1 if the mask or a socket isn't valid
+	int AddTemplate(char** Rows, int Width, int Height, Socket* Sockets, int SocketCount);
+
+
+	// Function:		Pick Socket function
+	// What it does:	Picks a random socket on the given side of any template
+	// Takes in:		int - Side (PREFAB_SIDE values), int - references to the template and socket picked
+	// Returns:			True if a socket was picked, false if no template has a socket on that side
+	bool PickSocket(int Side, int &TemplateIndex, int &SocketIndex);
+
+
+	// Function:		Is Occupied function
+	// What it does:	Checks the mask of a template
+	// Takes in:		int - Template index, int - X cell, int - Y cell
+	// Returns:			True if the cell is part of the room, false if it is empty or outside the mask
+	bool IsOccupied(int TemplateIndex, int x, int y);
+
+
+	// Function:		Get Template function
+	// What it does:	Returns a template so its mask, sockets and segments can be read
+	// Takes in:		int - Template index
+	// Returns:			Pointer to the template
+	Template* GetTemplate(int TemplateIndex);
+
+
+	// Function:		Get Template Count function
+	// What it does:	Returns the number of templates in the library
+	// Takes in:		Nothing
+	// Returns:			int - Number of templates
+	int GetTemplateCount();
+
+
+	// Function:		Render function
+	// What it does:	Puts the template's vertex buffer and the range of its index buffer for one part in the graphics pipeline
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - Template index, int - Part (PREFAB_PART values)
+	// Returns:			Nothing
+	void Render(ID3D11DeviceContext* DeviceContext, int TemplateIndex, int PartIndex);
+
+
+	// Function:		Get Index Count function
+	// What it does:	Returns the index count needed to render one part of a template
+	// Takes in:		int - Template index, int - Part (PREFAB_PART values)
+	// Returns:			int - Index count
+	int GetIndexCount(int TemplateIndex, int PartIndex);
+
+
+	// Functions to get the textures used for the floors and ceilings, the walls and the map
+	ID3D11ShaderResourceView* GetFloorTexture();
+	ID3D11ShaderResourceView* GetWallTexture();
+	ID3D11ShaderResourceView* GetMapTexture();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the buffers and textures and clears the templates
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// Function:		Add Quad function
+	// What it does:	Adds the four vertices and six indices of a quad to a template
+	// Takes in:		Template - reference to the template, D3DXVECTOR3 - bottom left, top left, top right and bottom right positions,
+	//					D3DXVECTOR3 - normal, D3DXVECTOR2 - texture scale
+	// Returns:			Nothing
+	void AddQuad(Template &NewTemplate, D3DXVECTOR3 BottomLeft, D3DXVECTOR3 TopLeft, D3DXVECTOR3 TopRight, D3DXVECTOR3 BottomRight,
+					D3DXVECTOR3 Normal, D3DXVECTOR2 TextureScale);
+
+
+	// Function:		Add Wall function
+	// What it does:	Adds a wall quad facing into the room along the given line, and its segment for the collision grid
+	// Takes in:		Template - reference to the template, D3DXVECTOR2 - start and end of the wall on the floor (left to right
+	//					when looking at it from inside the room), D3DXVECTOR3 - normal, int - Socket it plugs or -1
+	// Returns:			Nothing
+	void AddWall(Template &NewTemplate, D3DXVECTOR2 Start, D3DXVECTOR2 End, D3DXVECTOR3 Normal, int SocketIndex);
+
+
+	// Function:		Add Wall Run function
+	// What it does:	Adds the walls for a run of edges along one side of the mask, leaving a gap in the walls for each socket on the
+	//					run and adding the wall that fills the gap to the list of plugs
+	// Takes in:		Template - reference to the template, int - Side the walls face away from (PREFAB_SIDE values),
+	//					int - Row or column of cells the run is on, int - First cell of the run and the cell after its end,
+	//					vector<WallSegment> - reference to the list of plugs
+	// Returns:			Nothing
+	void AddWallRun(Template &NewTemplate, int Side, int Line, int RunStart, int RunEnd, vector<WallSegment> &Plugs);
+
+
+	// Function:		Build Geometry function
+	// What it does:	Builds the floor, ceiling, wall and plug parts and the wall segments of a template from its mask and sockets
+	// Takes in:		Template - reference to the template
+	// Returns:			Nothing
+	void BuildGeometry(Template &NewTemplate);
+
+
+	// Function:		Is Cell Filled function
+	// What it does:	Checks the mask of a template that may not be in the library yet
+	// Takes in:		Template - reference to the template, int - X cell, int - Y cell
+	// Returns:			True if the cell is part of the room, false if it is empty or outside the mask
+	bool IsCellFilled(Template &ThisTemplate, int x, int y);
+
+
+	// Function:		Initialise Buffers function
+	// What it does:	Creates the vertex and index buffers of a template from its vertices and indices
+	// Takes in:		Template - reference to the template
+	// Returns:			True if successful, false if not
+	bool InitializeBuffers(Template &ThisTemplate);
+
+
+	// Function:		Release Templates function
+	// What it does:	Releases the buffers of every template and clears the templates
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void ReleaseTemplates();
+
+
+	// Function:		Index Sockets function
+	// What it does:	Builds the lists of sockets on each side of the templates, used to pick sockets quickly
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void IndexSockets();
+
+private:
+	// Direct X objects, and the cache the textures come from
+	ID3D11Device* m_Device;
+	TextureCacheClass* m_TextureCache;
+
+	// The templates, and the template and socket of every socket on each side
+	vector<Template> m_Templates;
+	vector<SocketReference> m_SideSockets[4];
+
+	// Textures shared by every prefab room (and with the dungeon pieces through the cache)
+	TextureClass* m_FloorTexture;
+	TextureClass* m_WallTexture;
+	TextureClass* m_MapTexture;
+};
+
+
+#endif
@@ -0,0 +1,131 @@
+#include "renderrecorderclass.h"
+
+
+// Function:		Render Recorder constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+RenderRecorderClass::RenderRecorderClass()
+{
+	Reset();
+}
+
+
+// Placeholder destructor
+RenderRecorderClass::~RenderRecorderClass()
+{
+}
+
+
+// Function:		Reset function
+// What it does:	Sets every cost back to 0
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void RenderRecorderClass::Reset()
+{
+	m_Costs.Buffers = 0;
+	m_Costs.BufferBytes = 0;
+	m_Costs.Calls = 0;
+	m_Costs.Draws = 0;
+	m_Costs.Vertices = 0;
+	m_Costs.BytesRead = 0;
+}
+
+
+// Function:		Record Buffer function
+// What it does:	Records a buffer being made
+// Takes in:		unsigned long - Size of the buffer in bytes
+// Returns:			Nothing
+
+void RenderRecorderClass::RecordBuffer(unsigned long Bytes)
+{
+	m_Costs.Buffers++;
+	m_Costs.BufferBytes += Bytes;
+}
+
+
+// Function:		Record Call function
+// What it does:	Records a call on the device context that sets state (buffers, shaders, topology and so on)
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void RenderRecorderClass::RecordCall()
+{
+	m_Costs.Calls++;
+}
+
+
+// Function:		Record Draw function
+// What it does:	Records a draw call, with the vertices it runs the vertex shader on and the bytes it reads from buffers
+// Takes in:		unsigned long - Number of vertices shaded, unsigned long - Bytes of vertex, index and instance data read
+// Returns:			Nothing
+
+void RenderRecorderClass::RecordDraw(unsigned long Vertices, unsigned long BytesRead)
+{
+	// A draw is a call as well
+	m_Costs.Calls++;
+	m_Costs.Draws++;
+	m_Costs.Vertices += Vertices;
+	m_Costs.BytesRead += BytesRead;
+}
+
+
+// Function:		Get Costs function
+// What it does:	Returns the costs recorded since the last reset
+// Takes in:		Nothing
+// Returns:			Costs - the recorded costs
+
+RenderRecorderClass::Costs RenderRecorderClass::GetCosts()
+{
+	return m_Costs;
+}
+
+
+// Function:		Write Comparison function
+// What it does:	Writes two sets of costs side by side to a text file, with the change from the first to the second
+// Takes in:		char - Pointer to the file name, char - Pointers to the names of the two sets, Costs - the two sets
+// Returns:			True if the file was written, false if not
+
+bool RenderRecorderClass::WriteComparison(char* Filename, char* BeforeName, Costs Before, char* AfterName, Costs After)
+{
+	ofstream File;
+	File.open(Filename);
+	if (!File.is_open())
+	{
+		return false;
+	}
+
+	File << "Render costs: " << BeforeName << " against " << AfterName << "\n\n";
+
+	File << "Video memory\n";
+	WriteLine(File, "Buffers", Before.Buffers, After.Buffers);
+	WriteLine(File, "Buffer bytes", Before.BufferBytes, After.BufferBytes);
+
+	File << "\nSubmitted each frame\n";
+	WriteLine(File, "Context calls", Before.Calls, After.Calls);
+	WriteLine(File, "Draw calls", Before.Draws, After.Draws);
+	WriteLine(File, "Vertices shaded", Before.Vertices, After.Vertices);
+	WriteLine(File, "Bytes read", Before.BytesRead, After.BytesRead);
+
+	File.close();
+
+	return true;
+}
+
+
+// Function:		Write Line function
+// What it does:	Writes one cost of both sets and the change between them
+// Takes in:		ofstream - reference to the file, char - Pointer to the name of the cost, unsigned long - The cost in each set
+// Returns:			Nothing
+
+void RenderRecorderClass::WriteLine(ofstream &File, char* Name, unsigned long Before, unsigned long After)
+{
+	File << "  " << Name << ": " << Before << " -> " << After;
+	if (Before > 0)
+	{
+		File << " (" << (((double)After - (double)Before) * 100.0 / (double)Before) << "%)";
+	}
+	File << "\n";
+}
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: renderrecorderclass.h
+// Render Recorder Class
+// Records the buffers made and the calls submitted while drawing, in place of the device, so ways of drawing can be compared
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RENDER_RECORDER_CLASS_H
+#define RENDER_RECORDER_CLASS_H
+
+// For writing the report
+#include <fstream>
+using std::ofstream;
+
+// Specify whether the application writes a report comparing the costs of the ways the dungeon batch can be drawn, and the
+// file it is written to
+#define RENDER_COST_REPORT 0
+#define RENDER_COST_FILE "render_cost_report.txt"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: RenderRecorderClass
+// Code that draws can be given a recorder and tells it about each buffer it makes and each call it makes on the device
+// context. Without a device the calls are only recorded, so the costs of drawing a dungeon can be measured without drawing
+// it. Buffers are kept in video memory for as long as the geometry is drawn, and the calls and the data read from the
+// buffers are paid for every frame
+////////////////////////////////////////////////////////////////////////////////
+class RenderRecorderClass
+{
+public:
+	// The costs recorded since the last reset
+	struct Costs
+	{
+		int Buffers;
+		unsigned long BufferBytes;
+		int Calls;
+		int Draws;
+		unsigned long Vertices;
+		unsigned long BytesRead;
+	};
+
+	// Function:		Render Recorder constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	RenderRecorderClass();
+
+
+	// Placeholder destructor
+	~RenderRecorderClass();
+
+
+	// Function:		Reset function
+	// What it does:	Sets every cost back to 0
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Reset();
+
+
+	// Function:		Record Buffer function
+	// What it does:	Records a buffer being made
+	// Takes in:		unsigned long - Size of the buffer in bytes
+	// Returns:			Nothing
+	void RecordBuffer(unsigned long Bytes);
+
+
+	// Function:		Record Call function
+	// What it does:	Records a call on the device context that sets state (buffers, shaders, topology and so on)
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void RecordCall();
+
+
+	// Function:		Record Draw function
+	// What it does:	Records a draw call, with the vertices it runs the vertex shader on and the bytes it reads from buffers
+	// Takes in:		unsigned long - Number of vertices shaded, unsigned long - Bytes of vertex, index and instance data read
+	// Returns:			Nothing
+	void RecordDraw(unsigned long Vertices, unsigned long BytesRead);
+
+
+	// Function:		Get Costs function
+	// What it does:	Returns the costs recorded since the last reset
+	// Takes in:		Nothing
+	// Returns:			Costs - the recorded costs
+	Costs GetCosts();
+
+
+	// Function:		Write Comparison function
+	// What it does:	Writes two sets of costs side by side to a text file, with the change from the first to the second
+	// Takes in:		char - Pointer to the file name, char - Pointers to the names of the two sets, Costs - the two sets
+	// Returns:			True if the file was written, false if not
+	static bool WriteComparison(char* Filename, char* BeforeName, Costs Before, char* AfterName, Costs After);
+
+private:
+	// Function:		Write Line function
+	// What it does:	Writes one cost of both sets and the change between them
+	// Takes in:		ofstream - reference to the file, char - Pointer to the name of the cost, unsigned long - The cost in each set
+	// Returns:			Nothing
+	static void WriteLine(ofstream &File, char* Name, unsigned long Before, unsigned long After);
+
+private:
+	Costs m_Costs;
+};
+
+
+#endif
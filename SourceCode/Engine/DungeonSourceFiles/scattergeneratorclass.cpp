@@ -0,0 +1,891 @@
+#include "scattergeneratorclass.h"
+
+// For sort
+#include <algorithm>
+
+
+// Function:		Orient function
+// What it does:	Finds which side of the line from A to B the point P is on
+// Takes in:		double - X and Y of A, B and P
+// Returns:			double - Positive if P is to the left of the line, negative if it is to the right
+
+static double Orient(double ax, double ay, double bx, double by, double px, double py)
+{
+	return ((bx - ax) * (py - ay)) - ((by - ay) * (px - ax));
+}
+
+
+// Function:		In Circle function
+// What it does:	Checks if the point P is inside the circumcircle of the anticlockwise triangle A, B, C
+// Takes in:		double - X and Y of A, B, C and P
+// Returns:			double - Positive if P is inside the circle
+
+static double InCircle(double ax, double ay, double bx, double by, double cx, double cy, double px, double py)
+{
+	double adx = ax - px, ady = ay - py;
+	double bdx = bx - px, bdy = by - py;
+	double cdx = cx - px, cdy = cy - py;
+	double ad = (adx * adx) + (ady * ady);
+	double bd = (bdx * bdx) + (bdy * bdy);
+	double cd = (cdx * cdx) + (cdy * cdy);
+
+	return (adx * ((bdy * cd) - (bd * cdy))) - (ady * ((bdx * cd) - (bd * cdx))) + (ad * ((bdx * cdy) - (bdy * cdx)));
+}
+
+
+// Function:		Scatter Generator constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+ScatterGeneratorClass::ScatterGeneratorClass()
+{
+	m_AreaWidth = 0.0f;
+	m_AreaHeight = 0.0f;
+	m_Spacing = 0.0f;
+	m_CorridorWidth = 0.0f;
+	m_HashWidth = 0;
+	m_HashHeight = 0;
+	m_HashCellSize = 1.0f;
+	m_RoomCount = 0;
+}
+
+
+// Placeholder destructor
+ScatterGeneratorClass::~ScatterGeneratorClass()
+{
+}
+
+
+// Function:		Generate function
+// What it does:	Scatters rooms across an area centred on (0, 0) with the first room at the centre, joins them with corridors
+//					and keeps every room that can be reached from the first room
+// Takes in:		float - Width of the area, float - Height of the area, float - Smallest distance between room centres,
+//					float - Width of a corridor, int - Most rooms to scatter, int - Chance (out of 100) for each edge of the
+//					triangulation that isn't in the spanning tree to also become a corridor
+// Returns:			True if a layout was made, false if the settings aren't valid
+
+bool ScatterGeneratorClass::Generate(float AreaWidth, float AreaHeight, float Spacing, float CorridorWidth, int MaxRooms, int ExtraEdgeChance)
+{
+	if ((AreaWidth <= 0.0f) || (AreaHeight <= 0.0f) || (CorridorWidth <= 0.0f) || (MaxRooms <= 0))
+	{
+		return false;
+	}
+
+	// Rooms that are the spacing apart must always leave room for a corridor with a corner between them, which limits the room size
+	if ((Spacing / sqrtf(2.0f)) - CorridorWidth - (2.0f * SCATTER_MIN_CORRIDOR) < SCATTER_ROOM_MIN_SIZE)
+	{
+		return false;
+	}
+
+	m_AreaWidth = AreaWidth;
+	m_AreaHeight = AreaHeight;
+	m_Spacing = Spacing;
+	m_CorridorWidth = CorridorWidth;
+
+	m_Rooms.clear();
+	m_Triangles.clear();
+	m_Edges.clear();
+	m_Routes.clear();
+	m_Placed.clear();
+	m_Pieces.clear();
+	m_RoomCount = 0;
+
+	ScatterRooms(AreaWidth, AreaHeight, MaxRooms);
+
+	// Set up the spatial hash for the pieces, with cells the size of the spacing so each room covers only a few cells
+	m_HashCellSize = Spacing;
+	m_HashWidth = (int)ceilf(AreaWidth / m_HashCellSize) + 1;
+	m_HashHeight = (int)ceilf(AreaHeight / m_HashCellSize) + 1;
+	m_Hash.assign(m_HashWidth * m_HashHeight, vector<int>());
+
+	// The rooms are the first placed pieces, so a room's index is also its piece index
+	for (unsigned int i = 0; i < m_Rooms.size(); i++)
+	{
+		ScatterPiece NewRoom;
+		NewRoom.Type = SCATTER_PIECE_ROOM;
+		NewRoom.X = m_Rooms[i].X * m_CorridorWidth;
+		NewRoom.Y = m_Rooms[i].Y * m_CorridorWidth;
+		NewRoom.Width = m_Rooms[i].HalfWidth * 2.0f;
+		NewRoom.Height = m_Rooms[i].HalfHeight * 2.0f;
+		NewRoom.Doors = 0;
+		m_Placed.push_back(NewRoom);
+		AddToHash(NewRoom, i);
+	}
+
+	Triangulate();
+	ConnectRooms(ExtraEdgeChance);
+	KeepReachable();
+
+	return true;
+}
+
+
+// Function:		Scatter Rooms function
+// What it does:	Uses Poisson disk sampling to place room centres at least the spacing apart, then gives each room a random size
+// Takes in:		float - Width of the area, float - Height of the area, int - Most rooms to scatter
+// Returns:			Nothing
+
+void ScatterGeneratorClass::ScatterRooms(float AreaWidth, float AreaHeight, int MaxRooms)
+{
+	float Lattice = m_CorridorWidth;
+	float MaxSize = (m_Spacing / sqrtf(2.0f)) - m_CorridorWidth - (2.0f * SCATTER_MIN_CORRIDOR);
+	if (MaxSize > SCATTER_ROOM_MAX_SIZE)
+	{
+		MaxSize = SCATTER_ROOM_MAX_SIZE;
+	}
+
+	// Keep the centres far enough inside the area that the largest room still fits
+	float LimitX = (AreaWidth * 0.5f) - (MaxSize * 0.5f);
+	float LimitY = (AreaHeight * 0.5f) - (MaxSize * 0.5f);
+
+	// Each cell of the sampling grid is small enough that it can only ever hold one room, so the grid is the spatial hash
+	float CellSize = m_Spacing / sqrtf(2.0f);
+	int GridWidth = (int)ceilf(AreaWidth / CellSize) + 1;
+	int GridHeight = (int)ceilf(AreaHeight / CellSize) + 1;
+	vector<int> Grid(GridWidth * GridHeight, -1);
+	vector<int> Active;
+
+	// Start with a room at the centre of the area so the entrance is at (0, 0)
+	Room FirstRoom;
+	FirstRoom.X = 0;
+	FirstRoom.Y = 0;
+	m_Rooms.push_back(FirstRoom);
+	Grid[((int)((AreaHeight * 0.5f) / CellSize) * GridWidth) + (int)((AreaWidth * 0.5f) / CellSize)] = 0;
+	Active.push_back(0);
+
+	while ((!Active.empty()) && ((int)m_Rooms.size() < MaxRooms))
+	{
+		// Pick a random active room and try candidates in the ring between one and two spacings away from it
+		int ActiveIndex = rand() % Active.size();
+		Room Parent = m_Rooms[Active[ActiveIndex]];
+		bool Placed = false;
+
+		for (int Attempt = 0; Attempt < SCATTER_CANDIDATES; Attempt++)
+		{
+			float Angle = ((float)rand() / RAND_MAX) * 6.2831853f;
+			float Distance = m_Spacing * (1.0f + ((float)rand() / RAND_MAX));
+
+			// Snap the candidate to steps of the corridor width before checking it, so the spacing still holds afterwards
+			int CandidateX = (int)floorf(((Parent.X * Lattice) + (cosf(Angle) * Distance)) / Lattice + 0.5f);
+			int CandidateY = (int)floorf(((Parent.Y * Lattice) + (sinf(Angle) * Distance)) / Lattice + 0.5f);
+			float x = CandidateX * Lattice;
+			float y = CandidateY * Lattice;
+			if ((fabsf(x) > LimitX) || (fabsf(y) > LimitY))
+			{
+				continue;
+			}
+
+			// Only the cells two either side of the candidate's cell can hold a room closer than the spacing
+			int CellX = (int)((x + (AreaWidth * 0.5f)) / CellSize);
+			int CellY = (int)((y + (AreaHeight * 0.5f)) / CellSize);
+			bool TooClose = false;
+			for (int j = CellY - 2; (j <= CellY + 2) && (!TooClose); j++)
+			{
+				for (int i = CellX - 2; (i <= CellX + 2) && (!TooClose); i++)
+				{
+					if ((i < 0) || (j < 0) || (i >= GridWidth) || (j >= GridHeight))
+					{
+						continue;
+					}
+
+					int Other = Grid[(j * GridWidth) + i];
+					if (Other >= 0)
+					{
+						float dx = (m_Rooms[Other].X * Lattice) - x;
+						float dy = (m_Rooms[Other].Y * Lattice) - y;
+						TooClose = ((dx * dx) + (dy * dy)) < (m_Spacing * m_Spacing);
+					}
+				}
+			}
+
+			if (!TooClose)
+			{
+				Room NewRoom;
+				NewRoom.X = CandidateX;
+				NewRoom.Y = CandidateY;
+				Grid[(CellY * GridWidth) + CellX] = m_Rooms.size();
+				Active.push_back(m_Rooms.size());
+				m_Rooms.push_back(NewRoom);
+				Placed = true;
+				break;
+			}
+		}
+
+		// If no candidate fitted around this room, there is no more space near it
+		if (!Placed)
+		{
+			Active[ActiveIndex] = Active.back();
+			Active.pop_back();
+		}
+	}
+
+	// Give every room a random size in steps of 0.1, like the sizes of the pieces placed from doors
+	int SizeSteps = (int)((MaxSize - SCATTER_ROOM_MIN_SIZE) * 10.0f) + 1;
+	for (unsigned int i = 0; i < m_Rooms.size(); i++)
+	{
+		m_Rooms[i].HalfWidth = (SCATTER_ROOM_MIN_SIZE + ((rand() % SizeSteps) / 10.0f)) * 0.5f;
+		m_Rooms[i].HalfHeight = (SCATTER_ROOM_MIN_SIZE + ((rand() % SizeSteps) / 10.0f)) * 0.5f;
+	}
+}
+
+
+// Function:		Triangulate function
+// What it does:	Builds the Delaunay triangulation of the room centres by adding the rooms one at a time, walking to the triangle
+//					holding each new room and replacing the triangles whose circumcircles contain it. Fills the edge list
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void ScatterGeneratorClass::Triangulate()
+{
+	int RoomCount = m_Rooms.size();
+	if (RoomCount < 2)
+	{
+		return;
+	}
+
+	// Room centres followed by the three corners of a triangle large enough to hold all of them
+	vector<double> px(RoomCount + 3), py(RoomCount + 3);
+	for (int i = 0; i < RoomCount; i++)
+	{
+		px[i] = m_Rooms[i].X * (double)m_CorridorWidth;
+		py[i] = m_Rooms[i].Y * (double)m_CorridorWidth;
+	}
+	double Size = ((m_AreaWidth > m_AreaHeight) ? m_AreaWidth : m_AreaHeight) * 10.0;
+	px[RoomCount] = -Size;			py[RoomCount] = -Size;
+	px[RoomCount + 1] = Size;		py[RoomCount + 1] = -Size;
+	px[RoomCount + 2] = 0.0;		py[RoomCount + 2] = Size;
+
+	Triangle First;
+	First.V[0] = RoomCount;
+	First.V[1] = RoomCount + 1;
+	First.V[2] = RoomCount + 2;
+	First.N[0] = First.N[1] = First.N[2] = -1;
+	First.Alive = true;
+	m_Triangles.push_back(First);
+
+	// Lists reused for every room added
+	vector<int> Marks;
+	vector<int> Cavity;
+	vector<int> FreeTriangles;
+	vector<int> NewTriangles;
+	vector<BoundaryEdge> Boundary;
+	int Last = 0;
+
+	// The rooms were scattered outwards from the centre, so each one is usually close to the last and the walk is short
+	for (int Point = 0; Point < RoomCount; Point++)
+	{
+		double x = px[Point], y = py[Point];
+
+		// Walk towards the point until reaching the triangle that holds it
+		int Current = Last;
+		int Steps = 0;
+		while (true)
+		{
+			Triangle &T = m_Triangles[Current];
+			int Next = -1;
+			for (int k = 0; k < 3; k++)
+			{
+				// Start from a different edge each step so the walk can't go round in a circle
+				int Side = (k + Steps) % 3;
+				int a = T.V[(Side + 1) % 3], b = T.V[(Side + 2) % 3];
+				if (Orient(px[a], py[a], px[b], py[b], x, y) < 0.0)
+				{
+					Next = T.N[Side];
+					break;
+				}
+			}
+			if (Next < 0)
+			{
+				break;
+			}
+			Current = Next;
+			Steps++;
+		}
+
+		// Find every triangle whose circumcircle holds the point, starting from the triangle it is in
+		Marks.resize(m_Triangles.size(), -1);
+		Cavity.clear();
+		Cavity.push_back(Current);
+		Marks[Current] = Point;
+		for (unsigned int i = 0; i < Cavity.size(); i++)
+		{
+			Triangle &T = m_Triangles[Cavity[i]];
+			for (int k = 0; k < 3; k++)
+			{
+				int Other = T.N[k];
+				if ((Other >= 0) && (Marks[Other] != Point))
+				{
+					Triangle &O = m_Triangles[Other];
+					if (InCircle(px[O.V[0]], py[O.V[0]], px[O.V[1]], py[O.V[1]], px[O.V[2]], py[O.V[2]], x, y) > 0.0)
+					{
+						Marks[Other] = Point;
+						Cavity.push_back(Other);
+					}
+				}
+			}
+		}
+
+		// The edges of the cavity that border triangles being kept are joined to the point to make the new triangles
+		Boundary.clear();
+		for (unsigned int i = 0; i < Cavity.size(); i++)
+		{
+			Triangle &T = m_Triangles[Cavity[i]];
+			for (int k = 0; k < 3; k++)
+			{
+				if ((T.N[k] < 0) || (Marks[T.N[k]] != Point))
+				{
+					BoundaryEdge NewEdge;
+					NewEdge.A = T.V[(k + 1) % 3];
+					NewEdge.B = T.V[(k + 2) % 3];
+					NewEdge.Outside = T.N[k];
+					Boundary.push_back(NewEdge);
+				}
+			}
+		}
+
+		for (unsigned int i = 0; i < Cavity.size(); i++)
+		{
+			m_Triangles[Cavity[i]].Alive = false;
+			FreeTriangles.push_back(Cavity[i]);
+		}
+
+		NewTriangles.clear();
+		for (unsigned int i = 0; i < Boundary.size(); i++)
+		{
+			Triangle NewTriangle;
+			NewTriangle.V[0] = Boundary[i].A;
+			NewTriangle.V[1] = Boundary[i].B;
+			NewTriangle.V[2] = Point;
+			NewTriangle.N[0] = NewTriangle.N[1] = -1;
+			NewTriangle.N[2] = Boundary[i].Outside;
+			NewTriangle.Alive = true;
+
+			// Reuse the slots of removed triangles so the list doesn't keep growing
+			int Index;
+			if (!FreeTriangles.empty())
+			{
+				Index = FreeTriangles.back();
+				FreeTriangles.pop_back();
+				m_Triangles[Index] = NewTriangle;
+			}
+			else
+			{
+				Index = m_Triangles.size();
+				m_Triangles.push_back(NewTriangle);
+			}
+			NewTriangles.push_back(Index);
+
+			// Point the kept triangle on the other side of this edge at the new triangle
+			if (Boundary[i].Outside >= 0)
+			{
+				Triangle &O = m_Triangles[Boundary[i].Outside];
+				for (int k = 0; k < 3; k++)
+				{
+					if ((O.V[(k + 1) % 3] == Boundary[i].B) && (O.V[(k + 2) % 3] == Boundary[i].A))
+					{
+						O.N[k] = Index;
+					}
+				}
+			}
+		}
+
+		// Join the new triangles to each other around the point
+		for (unsigned int i = 0; i < NewTriangles.size(); i++)
+		{
+			Triangle &T = m_Triangles[NewTriangles[i]];
+			for (unsigned int j = 0; j < NewTriangles.size(); j++)
+			{
+				Triangle &O = m_Triangles[NewTriangles[j]];
+				if (O.V[0] == T.V[1])
+				{
+					T.N[0] = NewTriangles[j];
+				}
+				if (O.V[1] == T.V[0])
+				{
+					T.N[1] = NewTriangles[j];
+				}
+			}
+		}
+
+		Last = NewTriangles[0];
+	}
+
+	// Take each edge between two rooms once (the triangle on the other side holds it the other way round)
+	for (unsigned int i = 0; i < m_Triangles.size(); i++)
+	{
+		Triangle &T = m_Triangles[i];
+		if (!T.Alive)
+		{
+			continue;
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			int a = T.V[(k + 1) % 3], b = T.V[(k + 2) % 3];
+			if ((a < RoomCount) && (b < RoomCount) && (a < b))
+			{
+				Edge NewEdge;
+				NewEdge.A = a;
+				NewEdge.B = b;
+				float dx = (float)(px[a] - px[b]);
+				float dy = (float)(py[a] - py[b]);
+				NewEdge.Length = (dx * dx) + (dy * dy);
+				m_Edges.push_back(NewEdge);
+			}
+		}
+	}
+}
+
+
+// Function:		Connect Rooms function
+// What it does:	Sorts the edges by length and takes the minimum spanning tree with a union find, plus a random amount of
+//					the other edges, then routes a corridor for each of them
+// Takes in:		int - Chance (out of 100) for an edge outside the spanning tree to be used
+// Returns:			Nothing
+
+void ScatterGeneratorClass::ConnectRooms(int ExtraEdgeChance)
+{
+	std::sort(m_Edges.begin(), m_Edges.end(), CompareEdges);
+
+	m_Parents.resize(m_Rooms.size());
+	for (unsigned int i = 0; i < m_Parents.size(); i++)
+	{
+		m_Parents[i] = i;
+	}
+
+	// Route the spanning tree edges first so they get the space, and keep the extra edges for afterwards
+	vector<int> ExtraEdges;
+	for (unsigned int i = 0; i < m_Edges.size(); i++)
+	{
+		int RootA = FindRoot(m_Edges[i].A);
+		int RootB = FindRoot(m_Edges[i].B);
+		if (RootA != RootB)
+		{
+			m_Parents[RootA] = RootB;
+			RouteCorridor(m_Edges[i].A, m_Edges[i].B);
+		}
+		else if ((rand() % 100) < ExtraEdgeChance)
+		{
+			ExtraEdges.push_back(i);
+		}
+	}
+
+	// Extra edges make loops, and also join rooms back up if a spanning tree corridor couldn't be routed
+	for (unsigned int i = 0; i < ExtraEdges.size(); i++)
+	{
+		RouteCorridor(m_Edges[ExtraEdges[i]].A, m_Edges[ExtraEdges[i]].B);
+	}
+}
+
+
+// Function:		Route Corridor function
+// What it does:	Tries to route a corridor between two rooms, first along the axis the rooms are furthest apart in and then
+//					along the other. The corridor runs straight out of a door, turns at a corner room halfway between the rooms,
+//					and runs into a door of the other room
+// Takes in:		int - First room, int - Second room
+// Returns:			True if the corridor was placed, false if it would overlap something
+
+bool ScatterGeneratorClass::RouteCorridor(int A, int B)
+{
+	vector<ScatterPiece> Pieces;
+	int SideA = 0, SideB = 0;
+	bool Horizontal = abs(m_Rooms[A].X - m_Rooms[B].X) >= abs(m_Rooms[A].Y - m_Rooms[B].Y);
+
+	for (int Attempt = 0; Attempt < 2; Attempt++)
+	{
+		Pieces.clear();
+		if (BuildRoute(A, B, (Attempt == 0) ? Horizontal : !Horizontal, Pieces, SideA, SideB))
+		{
+			bool Free = true;
+			for (unsigned int i = 0; (i < Pieces.size()) && (Free); i++)
+			{
+				Free = IsFree(Pieces[i]);
+			}
+
+			if (Free)
+			{
+				Route NewRoute;
+				NewRoute.A = A;
+				NewRoute.B = B;
+				NewRoute.SideA = SideA;
+				NewRoute.SideB = SideB;
+				NewRoute.FirstPiece = m_Placed.size();
+				NewRoute.PieceCount = Pieces.size();
+				m_Routes.push_back(NewRoute);
+
+				for (unsigned int i = 0; i < Pieces.size(); i++)
+				{
+					AddToHash(Pieces[i], m_Placed.size());
+					m_Placed.push_back(Pieces[i]);
+				}
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+
+// Function:		Build Route function
+// What it does:	Creates the pieces of a corridor between two rooms along one axis, without placing them
+// Takes in:		int - First room, int - Second room, bool - True to leave the rooms through their left and right sides,
+//					vector<ScatterPiece> - reference to the list to add the pieces to, int - references to the sides of each room used
+// Returns:			True if the rooms are far enough apart for the corridor, false if not
+
+bool ScatterGeneratorClass::BuildRoute(int A, int B, bool Horizontal, vector<ScatterPiece> &Pieces, int &SideA, int &SideB)
+{
+	// Work along the route axis (u) and across it (v), so the same code builds horizontal and vertical routes
+	// The route always runs from the room with the lower u to the room with the higher u
+	int Low = A, High = B;
+	int LowU = Horizontal ? m_Rooms[A].X : m_Rooms[A].Y;
+	int HighU = Horizontal ? m_Rooms[B].X : m_Rooms[B].Y;
+	if (LowU > HighU)
+	{
+		Low = B;
+		High = A;
+	}
+
+	const Room &LowRoom = m_Rooms[Low];
+	const Room &HighRoom = m_Rooms[High];
+	float Width = m_CorridorWidth;
+	float u0 = Horizontal ? ((LowRoom.X * Width) + LowRoom.HalfWidth) : ((LowRoom.Y * Width) + LowRoom.HalfHeight);
+	float u1 = Horizontal ? ((HighRoom.X * Width) - HighRoom.HalfWidth) : ((HighRoom.Y * Width) - HighRoom.HalfHeight);
+	int LowV = Horizontal ? LowRoom.Y : LowRoom.X;
+	int HighV = Horizontal ? HighRoom.Y : HighRoom.X;
+	float v0 = LowV * Width;
+	float v1 = HighV * Width;
+	int Offset = HighV - LowV;
+
+	// Door bits for the sides along the route axis and across it
+	int LowDoor = Horizontal ? SCATTER_DOOR_LEFT : SCATTER_DOOR_DOWN;
+	int HighDoor = Horizontal ? SCATTER_DOOR_RIGHT : SCATTER_DOOR_UP;
+	int AcrossLow = Horizontal ? SCATTER_DOOR_DOWN : SCATTER_DOOR_LEFT;
+	int AcrossHigh = Horizontal ? SCATTER_DOOR_UP : SCATTER_DOOR_RIGHT;
+	int StraightType = Horizontal ? SCATTER_PIECE_HORIZONTAL : SCATTER_PIECE_VERTICAL;
+	int AcrossType = Horizontal ? SCATTER_PIECE_VERTICAL : SCATTER_PIECE_HORIZONTAL;
+
+	// Each piece is built in (u, v) and swapped into (x, y) for vertical routes
+	ScatterPiece Piece;
+	Piece.Type = StraightType;
+
+	if (Offset == 0)
+	{
+		// The doors line up, so a single straight corridor joins the rooms
+		if (u1 - u0 < SCATTER_MIN_CORRIDOR)
+		{
+			return false;
+		}
+
+		Piece.X = (u0 + u1) * 0.5f;		Piece.Y = v0;
+		Piece.Width = u1 - u0;			Piece.Height = Width;
+		Piece.Doors = LowDoor | HighDoor;
+		Pieces.push_back(Piece);
+	}
+	else
+	{
+		// Leave space for a straight part either side of the corner rooms
+		if (u1 - u0 < Width + (2.0f * SCATTER_MIN_CORRIDOR))
+		{
+			return false;
+		}
+
+		float Middle = (u0 + u1) * 0.5f;
+		int Toward = (Offset > 0) ? AcrossHigh : AcrossLow;
+		int Back = (Offset > 0) ? AcrossLow : AcrossHigh;
+
+		// Straight part out of the low room
+		Piece.Type = StraightType;
+		Piece.X = (u0 + Middle - (Width * 0.5f)) * 0.5f;		Piece.Y = v0;
+		Piece.Width = Middle - (Width * 0.5f) - u0;				Piece.Height = Width;
+		Piece.Doors = LowDoor | HighDoor;
+		Pieces.push_back(Piece);
+
+		// First corner
+		Piece.Type = SCATTER_PIECE_CORNER;
+		Piece.X = Middle;			Piece.Y = v0;
+		Piece.Width = Width;		Piece.Height = Width;
+		Piece.Doors = LowDoor | Toward;
+		Pieces.push_back(Piece);
+
+		// Corridor across between the corners, unless they are next to each other
+		if (abs(Offset) > 1)
+		{
+			Piece.Type = AcrossType;
+			Piece.X = Middle;				Piece.Y = (v0 + v1) * 0.5f;
+			Piece.Width = Width;			Piece.Height = fabsf(v1 - v0) - Width;
+			Piece.Doors = AcrossLow | AcrossHigh;
+			Pieces.push_back(Piece);
+		}
+
+		// Second corner
+		Piece.Type = SCATTER_PIECE_CORNER;
+		Piece.X = Middle;			Piece.Y = v1;
+		Piece.Width = Width;		Piece.Height = Width;
+		Piece.Doors = HighDoor | Back;
+		Pieces.push_back(Piece);
+
+		// Straight part into the high room
+		Piece.Type = StraightType;
+		Piece.X = (Middle + (Width * 0.5f) + u1) * 0.5f;		Piece.Y = v1;
+		Piece.Width = u1 - Middle - (Width * 0.5f);				Piece.Height = Width;
+		Piece.Doors = LowDoor | HighDoor;
+		Pieces.push_back(Piece);
+	}
+
+	// Swap the pieces of vertical routes back into (x, y)
+	if (!Horizontal)
+	{
+		for (unsigned int i = 0; i < Pieces.size(); i++)
+		{
+			float Temp = Pieces[i].X;
+			Pieces[i].X = Pieces[i].Y;
+			Pieces[i].Y = Temp;
+			Temp = Pieces[i].Width;
+			Pieces[i].Width = Pieces[i].Height;
+			Pieces[i].Height = Temp;
+		}
+	}
+
+	SideA = (Low == A) ? HighDoor : LowDoor;
+	SideB = (Low == A) ? LowDoor : HighDoor;
+
+	return true;
+}
+
+
+// Function:		Is Free function
+// What it does:	Checks the spatial hash for any placed piece overlapping the given piece (sharing an edge is allowed)
+// Takes in:		ScatterPiece - reference to the piece to check
+// Returns:			True if nothing overlaps the piece, false if something does
+
+bool ScatterGeneratorClass::IsFree(const ScatterPiece &Piece)
+{
+	// Pieces that only touch along an edge don't count as overlapping, allowing for float error
+	const float Tolerance = 0.05f;
+	float x0 = Piece.X - (Piece.Width * 0.5f);
+	float x1 = Piece.X + (Piece.Width * 0.5f);
+	float y0 = Piece.Y - (Piece.Height * 0.5f);
+	float y1 = Piece.Y + (Piece.Height * 0.5f);
+
+	int CellX0 = (int)((x0 + (m_AreaWidth * 0.5f)) / m_HashCellSize);
+	int CellX1 = (int)((x1 + (m_AreaWidth * 0.5f)) / m_HashCellSize);
+	int CellY0 = (int)((y0 + (m_AreaHeight * 0.5f)) / m_HashCellSize);
+	int CellY1 = (int)((y1 + (m_AreaHeight * 0.5f)) / m_HashCellSize);
+
+	for (int j = CellY0; j <= CellY1; j++)
+	{
+		for (int i = CellX0; i <= CellX1; i++)
+		{
+			if ((i < 0) || (j < 0) || (i >= m_HashWidth) || (j >= m_HashHeight))
+			{
+				return false;
+			}
+
+			vector<int> &Cell = m_Hash[(j * m_HashWidth) + i];
+			for (unsigned int k = 0; k < Cell.size(); k++)
+			{
+				const ScatterPiece &Other = m_Placed[Cell[k]];
+				float ox0 = Other.X - (Other.Width * 0.5f);
+				float ox1 = Other.X + (Other.Width * 0.5f);
+				float oy0 = Other.Y - (Other.Height * 0.5f);
+				float oy1 = Other.Y + (Other.Height * 0.5f);
+
+				if ((x0 < ox1 - Tolerance) && (ox0 < x1 - Tolerance) && (y0 < oy1 - Tolerance) && (oy0 < y1 - Tolerance))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// Function:		Add To Hash function
+// What it does:	Adds a placed piece to every cell of the spatial hash it covers
+// Takes in:		ScatterPiece - reference to the piece, int - Index of the piece
+// Returns:			Nothing
+
+void ScatterGeneratorClass::AddToHash(const ScatterPiece &Piece, int Index)
+{
+	int CellX0 = (int)((Piece.X - (Piece.Width * 0.5f) + (m_AreaWidth * 0.5f)) / m_HashCellSize);
+	int CellX1 = (int)((Piece.X + (Piece.Width * 0.5f) + (m_AreaWidth * 0.5f)) / m_HashCellSize);
+	int CellY0 = (int)((Piece.Y - (Piece.Height * 0.5f) + (m_AreaHeight * 0.5f)) / m_HashCellSize);
+	int CellY1 = (int)((Piece.Y + (Piece.Height * 0.5f) + (m_AreaHeight * 0.5f)) / m_HashCellSize);
+
+	for (int j = CellY0; j <= CellY1; j++)
+	{
+		for (int i = CellX0; i <= CellX1; i++)
+		{
+			if ((i >= 0) && (j >= 0) && (i < m_HashWidth) && (j < m_HashHeight))
+			{
+				m_Hash[(j * m_HashWidth) + i].push_back(Index);
+			}
+		}
+	}
+}
+
+
+// Function:		Find Root function
+// What it does:	Finds the root of a room in the union find, shortening the path as it goes
+// Takes in:		int - Room
+// Returns:			int - Root room
+
+int ScatterGeneratorClass::FindRoot(int Room)
+{
+	while (m_Parents[Room] != Room)
+	{
+		m_Parents[Room] = m_Parents[m_Parents[Room]];
+		Room = m_Parents[Room];
+	}
+
+	return Room;
+}
+
+
+// Function:		Keep Reachable function
+// What it does:	Finds the rooms that can be reached from the first room through the routed corridors and builds the final
+//					list of pieces from them and their corridors
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void ScatterGeneratorClass::KeepReachable()
+{
+	if (m_Rooms.empty())
+	{
+		return;
+	}
+
+	// List the routes leaving each room
+	vector< vector<int> > RoomRoutes(m_Rooms.size());
+	for (unsigned int i = 0; i < m_Routes.size(); i++)
+	{
+		RoomRoutes[m_Routes[i].A].push_back(i);
+		RoomRoutes[m_Routes[i].B].push_back(i);
+	}
+
+	// Walk out from the first room through the routes
+	vector<bool> Reached(m_Rooms.size(), false);
+	vector<int> Order;
+	Order.push_back(0);
+	Reached[0] = true;
+	for (unsigned int i = 0; i < Order.size(); i++)
+	{
+		int ThisRoom = Order[i];
+		for (unsigned int j = 0; j < RoomRoutes[ThisRoom].size(); j++)
+		{
+			const Route &ThisRoute = m_Routes[RoomRoutes[ThisRoom][j]];
+			int Other = (ThisRoute.A == ThisRoom) ? ThisRoute.B : ThisRoute.A;
+			if (!Reached[Other])
+			{
+				Reached[Other] = true;
+				Order.push_back(Other);
+			}
+		}
+	}
+
+	// Give each reached room a door for every route it has
+	for (unsigned int i = 0; i < m_Routes.size(); i++)
+	{
+		if (Reached[m_Routes[i].A])
+		{
+			m_Placed[m_Routes[i].A].Doors |= m_Routes[i].SideA;
+			m_Placed[m_Routes[i].B].Doors |= m_Routes[i].SideB;
+		}
+	}
+
+	// Rooms first (starting with the entrance), then the corridor pieces of the kept routes
+	for (unsigned int i = 0; i < Order.size(); i++)
+	{
+		m_Pieces.push_back(m_Placed[Order[i]]);
+	}
+	m_RoomCount = Order.size();
+
+	for (unsigned int i = 0; i < m_Routes.size(); i++)
+	{
+		if (Reached[m_Routes[i].A])
+		{
+			for (int j = 0; j < m_Routes[i].PieceCount; j++)
+			{
+				m_Pieces.push_back(m_Placed[m_Routes[i].FirstPiece + j]);
+			}
+		}
+	}
+}
+
+
+// Function:		Compare Edges function
+// What it does:	Used by sort to order the edges from shortest to longest
+// Takes in:		Edge - references to the two edges
+// Returns:			True if the first edge is shorter
+
+bool ScatterGeneratorClass::CompareEdges(const Edge &First, const Edge &Second)
+{
+	return First.Length < Second.Length;
+}
+
+
+// Function:		Get Pieces function
+// What it does:	Returns the pieces of the layout made by the last call to Generate
+// Takes in:		Nothing
+// Returns:			A pointer to the list of pieces
+
+vector<ScatterGeneratorClass::ScatterPiece> *ScatterGeneratorClass::GetPieces()
+{
+	return &m_Pieces;
+}
+
+
+// Function:		Get Room Count function
+// What it does:	Returns the number of rooms kept in the layout (the first pieces in the list)
+// Takes in:		Nothing
+// Returns:			int - Number of rooms
+
+int ScatterGeneratorClass::GetRoomCount()
+{
+	return m_RoomCount;
+}
+
+
+// Function:		Get Scattered Count function
+// What it does:	Returns the number of rooms that were scattered before any were removed for not being reachable
+// Takes in:		Nothing
+// Returns:			int - Number of scattered rooms
+
+int ScatterGeneratorClass::GetScatteredCount()
+{
+	return m_Rooms.size();
+}
+
+
+// Function:		Get Edge Count function
+// What it does:	Returns the number of edges in the triangulation of the scattered rooms
+// Takes in:		Nothing
+// Returns:			int - Number of edges
+
+int ScatterGeneratorClass::GetEdgeCount()
+{
+	return m_Edges.size();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the layout
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void ScatterGeneratorClass::Shutdown()
+{
+	vector<Room>().swap(m_Rooms);
+	vector<Triangle>().swap(m_Triangles);
+	vector<Edge>().swap(m_Edges);
+	vector<int>().swap(m_Parents);
+	vector<Route>().swap(m_Routes);
+	vector<ScatterPiece>().swap(m_Placed);
+	vector< vector<int> >().swap(m_Hash);
+	vector<ScatterPiece>().swap(m_Pieces);
+	m_RoomCount = 0;
+}
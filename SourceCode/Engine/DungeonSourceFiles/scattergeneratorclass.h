@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: scattergeneratorclass.h
+// Scatter Generator Class
+// Generates dungeon layouts by scattering rooms across an area and joining them with corridors
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SCATTER_GENERATOR_CLASS_H
+#define SCATTER_GENERATOR_CLASS_H
+
+// For rand
+#include <stdlib.h>
+#include <math.h>
+
+// For vector
+#include <vector>
+using std::vector;
+
+// Specify the amount of candidates tried around each room when scattering rooms
+#define SCATTER_CANDIDATES 30
+// Specify the smallest and largest room sizes
+#define SCATTER_ROOM_MIN_SIZE 1.5f
+#define SCATTER_ROOM_MAX_SIZE 4.0f
+// Specify the shortest length of a straight part of a corridor
+#define SCATTER_MIN_CORRIDOR 0.5f
+
+// Define values for the types of layout pieces
+#define SCATTER_PIECE_ROOM 0
+#define SCATTER_PIECE_CORNER 1
+#define SCATTER_PIECE_HORIZONTAL 2
+#define SCATTER_PIECE_VERTICAL 3
+
+// Door bits for the sides of a layout piece
+#define SCATTER_DOOR_LEFT 1
+#define SCATTER_DOOR_UP 2
+#define SCATTER_DOOR_RIGHT 4
+#define SCATTER_DOOR_DOWN 8
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ScatterGeneratorClass
+// Scatters room centres with Poisson disk sampling (using a grid of cells as a spatial hash so each new room only checks
+// the rooms near it), triangulates the centres with a Delaunay triangulation, then takes a minimum spanning tree of
+// the triangulation plus some of the left over edges as the corridors. Each corridor is routed as straight corridor
+// pieces joined by small corner rooms, and is only kept if it doesn't overlap anything already placed.
+// Every step is O(n log n) or better in the number of rooms
+////////////////////////////////////////////////////////////////////////////////
+class ScatterGeneratorClass
+{
+public:
+	// A piece of the finished layout. Rooms are the first pieces in the list, and the first room is the entrance
+	struct ScatterPiece
+	{
+		int Type;
+		float X, Y;
+		float Width, Height;
+		int Doors;
+	};
+
+	// Function:		Scatter Generator constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	ScatterGeneratorClass();
+
+
+	// Placeholder destructor
+	~ScatterGeneratorClass();
+
+
+	// Function:		Generate function
+	// What it does:	Scatters rooms across an area centred on (0, 0) with the first room at the centre, joins them with corridors
+	//					and keeps every room that can be reached from the first room
+	// Takes in:		float - Width of the area, float - Height of the area, float - Smallest distance between room centres,
+	//					float - Width of a corridor, int - Most rooms to scatter, int - Chance (out of 100) for each edge of the
+	//					triangulation that isn't in the spanning tree to also become a corridor
+	// Returns:			True if a layout was made, false if the settings aren't valid
+	bool Generate(float AreaWidth, float AreaHeight, float Spacing, float CorridorWidth, int MaxRooms, int ExtraEdgeChance);
+
+
+	// Function:		Get Pieces function
+	// What it does:	Returns the pieces of the layout made by the last call to Generate
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of pieces
+	vector<ScatterPiece> *GetPieces();
+
+
+	// Function:		Get Room Count function
+	// What it does:	Returns the number of rooms kept in the layout (the first pieces in the list)
+	// Takes in:		Nothing
+	// Returns:			int - Number of rooms
+	int GetRoomCount();
+
+
+	// Function:		Get Scattered Count function
+	// What it does:	Returns the number of rooms that were scattered before any were removed for not being reachable
+	// Takes in:		Nothing
+	// Returns:			int - Number of scattered rooms
+	int GetScatteredCount();
+
+
+	// Function:		Get Edge Count function
+	// What it does:	Returns the number of edges in the triangulation of the scattered rooms
+	// Takes in:		Nothing
+	// Returns:			int - Number of edges
+	int GetEdgeCount();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the layout
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// A scattered room. X and Y are the centre in steps of the corridor width so that doors can line up
+	struct Room
+	{
+		int X, Y;
+		float HalfWidth, HalfHeight;
+	};
+
+	// An edge between two rooms, with its squared length
+	struct Edge
+	{
+		int A, B;
+		float Length;
+	};
+
+	// A triangle of the triangulation. N holds the triangle across the edge opposite each vertex (-1 for none)
+	struct Triangle
+	{
+		int V[3];
+		int N[3];
+		bool Alive;
+	};
+
+	// An edge on the boundary of the triangles removed when adding a room, and the triangle on its other side
+	struct BoundaryEdge
+	{
+		int A, B;
+		int Outside;
+	};
+
+	// A corridor that has been routed between two rooms, and the pieces it uses
+	struct Route
+	{
+		int A, B;
+		int SideA, SideB;
+		int FirstPiece, PieceCount;
+	};
+
+
+	// Function:		Scatter Rooms function
+	// What it does:	Uses Poisson disk sampling to place room centres at least the spacing apart, then gives each room a random size
+	// Takes in:		float - Width of the area, float - Height of the area, int - Most rooms to scatter
+	// Returns:			Nothing
+	void ScatterRooms(float AreaWidth, float AreaHeight, int MaxRooms);
+
+
+	// Function:		Triangulate function
+	// What it does:	Builds the Delaunay triangulation of the room centres by adding the rooms one at a time, walking to the triangle
+	//					holding each new room and replacing the triangles whose circumcircles contain it. Fills the edge list
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Triangulate();
+
+
+	// Function:		Connect Rooms function
+	// What it does:	Sorts the edges by length and takes the minimum spanning tree with a union find, plus a random amount of
+	//					the other edges, then routes a corridor for each of them
+	// Takes in:		int - Chance (out of 100) for an edge outside the spanning tree to be used
+	// Returns:			Nothing
+	void ConnectRooms(int ExtraEdgeChance);
+
+
+	// Function:		Route Corridor function
+	// What it does:	Tries to route a corridor between two rooms, first along the axis the rooms are furthest apart in and then
+	//					along the other. The corridor runs straight out of a door, turns at a corner room halfway between the rooms,
+	//					and runs into a door of the other room
+	// Takes in:		int - First room, int - Second room
+	// Returns:			True if the corridor was placed, false if it would overlap something
+	bool RouteCorridor(int A, int B);
+
+
+	// Function:		Build Route function
+	// What it does:	Creates the pieces of a corridor between two rooms along one axis, without placing them
+	// Takes in:		int - First room, int - Second room, bool - True to leave the rooms through their left and right sides,
+	//					vector<ScatterPiece> - reference to the list to add the pieces to, int - references to the sides of each room used
+	// Returns:			True if the rooms are far enough apart for the corridor, false if not
+	bool BuildRoute(int A, int B, bool Horizontal, vector<ScatterPiece> &Pieces, int &SideA, int &SideB);
+
+
+	// Function:		Is Free function
+	// What it does:	Checks the spatial hash for any placed piece overlapping the given piece (sharing an edge is allowed)
+	// Takes in:		ScatterPiece - reference to the piece to check
+	// Returns:			True if nothing overlaps the piece, false if something does
+	bool IsFree(const ScatterPiece &Piece);
+
+
+	// Function:		Add To Hash function
+	// What it does:	Adds a placed piece to every cell of the spatial hash it covers
+	// Takes in:		ScatterPiece - reference to the piece, int - Index of the piece
+	// Returns:			Nothing
+	void AddToHash(const ScatterPiece &Piece, int Index);
+
+
+	// Function:		Compare Edges function
+	// What it does:	Used by sort to order the edges from shortest to longest
+	// Takes in:		Edge - references to the two edges
+	// Returns:			True if the first edge is shorter
+	static bool CompareEdges(const Edge &First, const Edge &Second);
+
+
+	// Function:		Find Root function
+	// What it does:	Finds the root of a room in the union find, shortening the path as it goes
+	// Takes in:		int - Room
+	// Returns:			int - Root room
+	int FindRoot(int Room);
+
+
+	// Function:		Keep Reachable function
+	// What it does:	Finds the rooms that can be reached from the first room through the routed corridors and builds the final
+	//					list of pieces from them and their corridors
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void KeepReachable();
+
+private:
+	// Generation settings
+	float m_AreaWidth;
+	float m_AreaHeight;
+	float m_Spacing;
+	float m_CorridorWidth;
+
+	// Scattered rooms and the triangulation
+	vector<Room> m_Rooms;
+	vector<Triangle> m_Triangles;
+	vector<Edge> m_Edges;
+	vector<int> m_Parents;
+
+	// Routed corridors and the pieces they use (the rooms are the first pieces)
+	vector<Route> m_Routes;
+	vector<ScatterPiece> m_Placed;
+
+	// Spatial hash of placed pieces
+	vector< vector<int> > m_Hash;
+	int m_HashWidth;
+	int m_HashHeight;
+	float m_HashCellSize;
+
+	// The finished layout
+	vector<ScatterPiece> m_Pieces;
+	int m_RoomCount;
+};
+
+
+#endif
@@ -0,0 +1,372 @@
+#include "seedsearchclass.h"
+
+
+// Function:		Seed Search constructor
+// What it does:	Initialises all variables and objects to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+SeedSearchClass::SeedSearchClass()
+{
+	m_Workers = 0;
+	m_PrefabLibrary = 0;
+	m_FirstSeed = 0;
+	m_SeedCount = 0;
+	m_Predicate = 0;
+	m_UserData = 0;
+	m_MatchCount = 0;
+	m_SeedsTested = 0;
+	m_SeedsStoppedEarly = 0;
+	m_Seconds = 0.0;
+}
+
+
+// Placeholder destructor
+SeedSearchClass::~SeedSearchClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Starts the worker threads and loads the prefab templates shared by every seed
+// Takes in:		int - Number of threads, char - Pointer to the prefab asset file name
+// Returns:			True if successful, false if not
+
+bool SeedSearchClass::Initialise(int ThreadCount, char* PrefabFile)
+{
+	bool result;
+
+	m_Workers = new WorkerPoolClass;
+	if (!m_Workers)
+	{
+		return false;
+	}
+
+	result = m_Workers->Initialise(ThreadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	// Load the templates without a device, as the prefab rooms are only needed for their masks and sockets
+	m_PrefabLibrary = new PrefabLibraryClass;
+	if (!m_PrefabLibrary)
+	{
+		return false;
+	}
+
+	result = m_PrefabLibrary->Initialise(0, 0, PrefabFile);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Search function
+// What it does:	Lays out the dungeon for each seed in the range and keeps the seeds that match, replacing the results of
+//					the last search
+// Takes in:		unsigned int - First seed, int - Number of seeds, SeedPredicate - the function checking each layout,
+//					void - pointer passed to the predicate
+// Returns:			int - Number of matches
+
+int SeedSearchClass::Search(unsigned int FirstSeed, int SeedCount, SeedPredicate Predicate, void* UserData)
+{
+	std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+	m_Matches.clear();
+	m_MatchCount = 0;
+	m_SeedsTested = 0;
+	m_SeedsStoppedEarly = 0;
+	m_Seconds = 0.0;
+	if ((SeedCount <= 0) || (!Predicate))
+	{
+		return 0;
+	}
+
+	// Split the seeds into jobs and run them across the threads
+	m_FirstSeed = FirstSeed;
+	m_SeedCount = SeedCount;
+	m_Predicate = Predicate;
+	m_UserData = UserData;
+	int ChunkCount = (SeedCount + SEED_SEARCH_CHUNK - 1) / SEED_SEARCH_CHUNK;
+	m_Chunks.clear();
+	m_Chunks.resize(ChunkCount);
+
+	m_Workers->Run(TestChunkJob, this, ChunkCount);
+
+	// Join the results of the jobs in seed order
+	for (int i = 0; i < ChunkCount; i++)
+	{
+		ChunkResult &Chunk = m_Chunks[i];
+		for (unsigned int j = 0; (j < Chunk.Matches.size()) && (m_Matches.size() < SEED_SEARCH_MAX_MATCHES); j++)
+		{
+			m_Matches.push_back(Chunk.Matches[j]);
+		}
+		m_MatchCount += Chunk.MatchCount;
+		m_SeedsTested += Chunk.Tested;
+		m_SeedsStoppedEarly += Chunk.StoppedEarly;
+	}
+	m_Chunks.clear();
+
+	m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	return m_MatchCount;
+}
+
+
+// Function:		Check Targets function
+// What it does:	A predicate checking a layout against a Targets struct. While the layout is placed it rejects as soon as the
+//					rooms, depth or size go over their limits (these only grow), and checks every target on the finished layout
+// Takes in:		LayoutMetrics - reference to the metrics, bool - True if the layout is finished, void - pointer to the Targets
+// Returns:			int - SEED_MATCH, SEED_REJECT or SEED_UNDECIDED
+
+int SeedSearchClass::CheckTargets(DungeonClass::LayoutMetrics &Metrics, bool Finished, void* UserData)
+{
+	Targets* Wanted = (Targets*)UserData;
+	float Width = Metrics.MaxX - Metrics.MinX;
+	float Height = Metrics.MaxY - Metrics.MinY;
+
+	// Pieces are never taken away, so once one of these is over its limit the seed can't match
+	if ((Wanted->MaxRooms > 0) && (Metrics.Rooms > Wanted->MaxRooms))
+	{
+		return SEED_REJECT;
+	}
+	if ((Wanted->MaxDepth > 0) && (Metrics.Depth > Wanted->MaxDepth))
+	{
+		return SEED_REJECT;
+	}
+	if (((Wanted->MaxWidth > 0.0f) && (Width > Wanted->MaxWidth)) || ((Wanted->MaxHeight > 0.0f) && (Height > Wanted->MaxHeight)))
+	{
+		return SEED_REJECT;
+	}
+
+	// Dead ends can still have pieces placed behind them, and the room count and depth can still grow, so the rest are only
+	// checked once the layout is finished
+	if (!Finished)
+	{
+		return SEED_UNDECIDED;
+	}
+
+	if ((Metrics.Rooms < Wanted->MinRooms) || (Metrics.Depth < Wanted->MinDepth) || (Metrics.BranchingFactor < Wanted->MinBranchingFactor))
+	{
+		return SEED_REJECT;
+	}
+	if ((Wanted->MaxSmallDeadEnds > 0) && (Metrics.SmallDeadEnds > Wanted->MaxSmallDeadEnds))
+	{
+		return SEED_REJECT;
+	}
+
+	return SEED_MATCH;
+}
+
+
+// Function:		Get Matches function
+// What it does:	Returns the matches of the last search in seed order, up to SEED_SEARCH_MAX_MATCHES
+// Takes in:		Nothing
+// Returns:			A pointer to the list of matches
+
+vector<SeedSearchClass::Match> *SeedSearchClass::GetMatches()
+{
+	return &m_Matches;
+}
+
+
+// Function:		Get Match Count function
+// What it does:	Returns the number of seeds that matched in the last search
+// Takes in:		Nothing
+// Returns:			int - Number of matches
+
+int SeedSearchClass::GetMatchCount()
+{
+	return m_MatchCount;
+}
+
+
+// Function:		Get Seeds Tested function
+// What it does:	Returns the number of seeds laid out in the last search
+// Takes in:		Nothing
+// Returns:			int - Number of seeds
+
+int SeedSearchClass::GetSeedsTested()
+{
+	return m_SeedsTested;
+}
+
+
+// Function:		Get Seeds Stopped Early function
+// What it does:	Returns the number of seeds rejected before their layout was finished in the last search
+// Takes in:		Nothing
+// Returns:			int - Number of seeds
+
+int SeedSearchClass::GetSeedsStoppedEarly()
+{
+	return m_SeedsStoppedEarly;
+}
+
+
+// Function:		Get Seconds function
+// What it does:	Returns the time the last search took
+// Takes in:		Nothing
+// Returns:			double - Time in seconds
+
+double SeedSearchClass::GetSeconds()
+{
+	return m_Seconds;
+}
+
+
+// Function:		Get Seeds Per Second function
+// What it does:	Returns the number of seeds tested each second in the last search
+// Takes in:		Nothing
+// Returns:			double - Seeds per second
+
+double SeedSearchClass::GetSeedsPerSecond()
+{
+	if (m_Seconds <= 0.0)
+	{
+		return 0.0;
+	}
+
+	return m_SeedsTested / m_Seconds;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Stops the worker threads and releases the prefab library and the results
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void SeedSearchClass::Shutdown()
+{
+	if (m_Workers)
+	{
+		m_Workers->Shutdown();
+		delete m_Workers;
+		m_Workers = 0;
+	}
+
+	if (m_PrefabLibrary)
+	{
+		m_PrefabLibrary->Shutdown();
+		delete m_PrefabLibrary;
+		m_PrefabLibrary = 0;
+	}
+
+	m_Chunks.clear();
+	m_Matches.clear();
+}
+
+
+// Function:		Test Chunk Job function
+// What it does:	Run by the worker pool to lay out and check each seed of one job
+// Takes in:		void - pointer to the seed search, int - Index of the job
+// Returns:			Nothing
+
+void SeedSearchClass::TestChunkJob(void* Data, int Index)
+{
+	SeedSearchClass* Search = (SeedSearchClass*)Data;
+	ChunkResult &Result = Search->m_Chunks[Index];
+
+	Result.MatchCount = 0;
+	Result.Tested = 0;
+	Result.StoppedEarly = 0;
+
+	int First = Index * SEED_SEARCH_CHUNK;
+	int Last = First + SEED_SEARCH_CHUNK;
+	if (Last > Search->m_SeedCount)
+	{
+		Last = Search->m_SeedCount;
+	}
+
+	// The dungeon is too large for the stack because of its grid, so one is made for the job and reset after each seed,
+	// which only clears the part of the grid the seed used
+	DungeonClass* Dungeon = new DungeonClass;
+	if (!Dungeon)
+	{
+		return;
+	}
+
+	for (int i = First; i < Last; i++)
+	{
+		Search->TestSeed(Dungeon, Search->m_FirstSeed + i, Result);
+		Dungeon->Reset();
+	}
+
+	delete Dungeon;
+}
+
+
+// Function:		Test Seed function
+// What it does:	Lays out the dungeon for one seed, stopping it as soon as the predicate rejects it
+// Takes in:		DungeonClass - pointer to an empty dungeon, unsigned int - Seed, ChunkResult - reference to the results of the job
+// Returns:			Nothing
+
+void SeedSearchClass::TestSeed(DungeonClass* Dungeon, unsigned int Seed, ChunkResult &Result)
+{
+	SeedState State;
+	DungeonClass::LayoutMetrics Metrics;
+
+	// Lay out the dungeon the same way the game does for this seed, on this thread and with no time limit
+	State.Dungeon = Dungeon;
+	State.Predicate = m_Predicate;
+	State.UserData = m_UserData;
+	State.Rejected = false;
+	Dungeon->SetSeed(Seed);
+	Dungeon->SetGenerationBudget(0);
+	Dungeon->SetThreadCount(1);
+	Dungeon->SetSharedPrefabLibrary(m_PrefabLibrary);
+	Dungeon->SetProgressCallback(CheckProgress, &State);
+
+	bool result = Dungeon->Initialise(0, 0, 0);
+	Result.Tested++;
+
+	if (State.Rejected)
+	{
+		Result.StoppedEarly++;
+	}
+	else if (result)
+	{
+		Dungeon->GetLayoutMetrics(Metrics);
+		if (m_Predicate(Metrics, true, m_UserData) == SEED_MATCH)
+		{
+			if (Result.Matches.size() < SEED_SEARCH_MAX_MATCHES)
+			{
+				Match NewMatch;
+				NewMatch.Seed = Seed;
+				NewMatch.Metrics = Metrics;
+				Result.Matches.push_back(NewMatch);
+			}
+			Result.MatchCount++;
+		}
+	}
+}
+
+
+// Function:		Check Progress function
+// What it does:	The progress callback of each dungeon. Checks the layout placed so far and cancels the generation if the
+//					predicate rejects it
+// Takes in:		int - Pieces placed, int - Doors waiting for a piece, void - pointer to the seed state
+// Returns:			Nothing
+
+void SeedSearchClass::CheckProgress(int PiecesPlaced, int FrontierSize, void* UserData)
+{
+	SeedState* State = (SeedState*)UserData;
+	DungeonClass::LayoutMetrics Metrics;
+
+	if (State->Rejected)
+	{
+		return;
+	}
+
+	// The progress metrics are counted as the pieces are placed, as walking every piece here would make each seed O(n^2) in
+	// its pieces
+	State->Dungeon->GetProgressMetrics(Metrics);
+	if (State->Predicate(Metrics, false, State->UserData) == SEED_REJECT)
+	{
+		State->Rejected = true;
+		State->Dungeon->CancelGeneration();
+	}
+}
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: seedsearchclass.h
+// Seed Search Class
+// Generates the layouts of many seeds across worker threads to find the seeds whose dungeons meet a set of targets
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SEED_SEARCH_CLASS_H
+#define SEED_SEARCH_CLASS_H
+
+// For timing the search
+#include <chrono>
+
+// For vector
+#include <vector>
+using std::vector;
+
+#include "dungeonclass.h"
+#include "workerpoolclass.h"
+#include "prefablibraryclass.h"
+
+// Specify the number of seeds tested by one job, and the most matches kept (every match is still counted)
+#define SEED_SEARCH_CHUNK 256
+#define SEED_SEARCH_MAX_MATCHES 1024
+
+// Specify the number of seeds the application searches before making the dungeon (0 to not search), the threads used and
+// the targets the dungeon has to meet (max values of 0 have no limit)
+#define SEED_SEARCH_COUNT 0
+#define SEED_SEARCH_THREADS 4
+#define SEED_TARGET_MIN_ROOMS 12
+#define SEED_TARGET_MAX_ROOMS 30
+#define SEED_TARGET_MIN_DEPTH 5
+#define SEED_TARGET_MAX_DEPTH 0
+#define SEED_TARGET_MAX_SIZE 40.0f
+#define SEED_TARGET_MAX_SMALL_DEAD_ENDS 2
+#define SEED_TARGET_MIN_BRANCHING 1.5f
+
+// Results of checking the layout of a seed against the targets
+#define SEED_UNDECIDED 0
+#define SEED_MATCH 1
+#define SEED_REJECT 2
+
+// Checks the layout of a seed. Called each time a piece is placed with Finished false, and once more when the layout is finished
+// with Finished true. Returning SEED_REJECT stops the seed straight away, so it should be returned as soon as the seed can't match.
+// Only SEED_MATCH returned for the finished layout counts as a match
+typedef int (*SeedPredicate)(DungeonClass::LayoutMetrics &Metrics, bool Finished, void* UserData);
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SeedSearchClass
+// Lays out the dungeon for each seed in a range without a device, so only the grid and the pieces are made, and checks each
+// layout against a predicate while it is placed. Seeds are split into jobs run across worker threads, with a dungeon per job
+// that is reset between seeds and a prefab library shared by all of them. Each thread has its own rand state (as the Visual
+// C++ runtime keeps it per thread) so the layout made for a seed is the same as the one made when the game starts with that
+// seed and no time limit.
+// The matches of each job are kept apart and joined in seed order, so the results are the same on any number of threads
+////////////////////////////////////////////////////////////////////////////////
+class SeedSearchClass
+{
+public:
+	// Targets used by the Check Targets predicate. Max values of 0 have no limit
+	struct Targets
+	{
+		int MinRooms, MaxRooms;
+		int MinDepth, MaxDepth;
+		float MaxWidth, MaxHeight;
+		int MaxSmallDeadEnds;
+		float MinBranchingFactor;
+	};
+
+	// A seed that matched, and the metrics of its finished layout
+	struct Match
+	{
+		unsigned int Seed;
+		DungeonClass::LayoutMetrics Metrics;
+	};
+
+	// Function:		Seed Search constructor
+	// What it does:	Initialises all variables and objects to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	SeedSearchClass();
+
+
+	// Placeholder destructor
+	~SeedSearchClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Starts the worker threads and loads the prefab templates shared by every seed
+	// Takes in:		int - Number of threads, char - Pointer to the prefab asset file name
+	// Returns:			True if successful, false if not
+	bool Initialise(int ThreadCount, char* PrefabFile);
+
+
+	// Function:		Search function
+	// What it does:	Lays out the dungeon for each seed in the range and keeps the seeds that match, replacing the results of
+	//					the last search
+	// Takes in:		unsigned int - First seed, int - Number of seeds, SeedPredicate - the function checking each layout,
+	//					void - pointer passed to the predicate
+	// Returns:			int - Number of matches
+	int Search(unsigned int FirstSeed, int SeedCount, SeedPredicate Predicate, void* UserData);
+
+
+	// Function:		Check Targets function
+	// What it does:	A predicate checking a layout against a Targets struct. While the layout is placed it rejects as soon as the
+	//					rooms, depth or size go over their limits (these only grow), and checks every target on the finished layout
+	// Takes in:		LayoutMetrics - reference to the metrics, bool - True if the layout is finished, void - pointer to the Targets
+	// Returns:			int - SEED_MATCH, SEED_REJECT or SEED_UNDECIDED
+	static int CheckTargets(DungeonClass::LayoutMetrics &Metrics, bool Finished, void* UserData);
+
+
+	// Function:		Get Matches function
+	// What it does:	Returns the matches of the last search in seed order, up to SEED_SEARCH_MAX_MATCHES
+	// Takes in:		Nothing
+	// Returns:			A pointer to the list of matches
+	vector<Match> *GetMatches();
+
+
+	// Functions to get the number of matches, seeds tested and seeds stopped before they were finished in the last search
+	int GetMatchCount();
+	int GetSeedsTested();
+	int GetSeedsStoppedEarly();
+
+
+	// Function:		Get Seconds function
+	// What it does:	Returns the time the last search took
+	// Takes in:		Nothing
+	// Returns:			double - Time in seconds
+	double GetSeconds();
+
+
+	// Function:		Get Seeds Per Second function
+	// What it does:	Returns the number of seeds tested each second in the last search
+	// Takes in:		Nothing
+	// Returns:			double - Seeds per second
+	double GetSeedsPerSecond();
+
+
+	// Function:		Shutdown function
+	// What it does:	Stops the worker threads and releases the prefab library and the results
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// The results of one job
+	struct ChunkResult
+	{
+		vector<Match> Matches;
+		int MatchCount;
+		int Tested;
+		int StoppedEarly;
+	};
+
+	// What the progress callback of one seed needs to check its layout
+	struct SeedState
+	{
+		DungeonClass* Dungeon;
+		SeedPredicate Predicate;
+		void* UserData;
+		bool Rejected;
+	};
+
+
+	// Function:		Test Chunk Job function
+	// What it does:	Run by the worker pool to lay out and check each seed of one job
+	// Takes in:		void - pointer to the seed search, int - Index of the job
+	// Returns:			Nothing
+	static void TestChunkJob(void* Data, int Index);
+
+
+	// Function:		Test Seed function
+	// What it does:	Lays out the dungeon for one seed, stopping it as soon as the predicate rejects it
+	// Takes in:		DungeonClass - pointer to an empty dungeon, unsigned int - Seed, ChunkResult - reference to the results of the job
+	// Returns:			Nothing
+	void TestSeed(DungeonClass* Dungeon, unsigned int Seed, ChunkResult &Result);
+
+
+	// Function:		Check Progress function
+	// What it does:	The progress callback of each dungeon. Checks the layout placed so far and cancels the generation if the
+	//					predicate rejects it
+	// Takes in:		int - Pieces placed, int - Doors waiting for a piece, void - pointer to the seed state
+	// Returns:			Nothing
+	static void CheckProgress(int PiecesPlaced, int FrontierSize, void* UserData);
+
+private:
+	// Worker threads and the prefab templates shared by every dungeon
+	WorkerPoolClass* m_Workers;
+	PrefabLibraryClass* m_PrefabLibrary;
+
+	// The search being run
+	unsigned int m_FirstSeed;
+	int m_SeedCount;
+	SeedPredicate m_Predicate;
+	void* m_UserData;
+	vector<ChunkResult> m_Chunks;
+
+	// Results of the last search
+	vector<Match> m_Matches;
+	int m_MatchCount;
+	int m_SeedsTested;
+	int m_SeedsStoppedEarly;
+	double m_Seconds;
+};
+
+
+#endif
@@ -0,0 +1,683 @@
+#include "staticbatchclass.h"
+
+// The ways a quad can face, as the directions the x and y of the unit quad run in and the normal. These need to match the table
+// in light.vs, which also turns the texture co-ordinates of ceilings the other way round
+static const D3DXVECTOR3 QuadAxisU[QUAD_ORIENTATIONS] = { D3DXVECTOR3(1.0f, 0.0f, 0.0f), D3DXVECTOR3(0.0f, 0.0f, 1.0f), D3DXVECTOR3(1.0f, 0.0f, 0.0f),
+														  D3DXVECTOR3(-1.0f, 0.0f, 0.0f), D3DXVECTOR3(0.0f, 0.0f, 1.0f), D3DXVECTOR3(0.0f, 0.0f, -1.0f) };
+static const D3DXVECTOR3 QuadAxisV[QUAD_ORIENTATIONS] = { D3DXVECTOR3(0.0f, 0.0f, -1.0f), D3DXVECTOR3(-1.0f, 0.0f, 0.0f), D3DXVECTOR3(0.0f, -1.0f, 0.0f),
+														  D3DXVECTOR3(0.0f, -1.0f, 0.0f), D3DXVECTOR3(0.0f, -1.0f, 0.0f), D3DXVECTOR3(0.0f, -1.0f, 0.0f) };
+static const D3DXVECTOR3 QuadNormal[QUAD_ORIENTATIONS] = { D3DXVECTOR3(0.0f, 1.0f, 0.0f), D3DXVECTOR3(0.0f, -1.0f, 0.0f), D3DXVECTOR3(0.0f, 0.0f, -1.0f),
+														   D3DXVECTOR3(0.0f, 0.0f, 1.0f), D3DXVECTOR3(1.0f, 0.0f, 0.0f), D3DXVECTOR3(-1.0f, 0.0f, 0.0f) };
+static const bool QuadTextureFlipped[QUAD_ORIENTATIONS] = { false, true, false, false, false, false };
+
+// The corners of the unit quad and its two triangles, wound the same way as the quads of the pieces
+static const float QuadCorners[4][2] = { { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+static const unsigned long QuadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+
+// Function:		Static Batch constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+StaticBatchClass::StaticBatchClass()
+{
+	m_Textures = 0;
+	m_Recorder = 0;
+	m_Layout = BATCH_INSTANCED;
+	m_VertexCount = 0;
+	m_IndexCount = 0;
+	m_InstanceCount = 0;
+	m_VertexBuffer = 0;
+	m_IndexBuffer = 0;
+	m_InstanceBuffer = 0;
+
+	for (int i = 0; i < BATCH_CATEGORIES; i++)
+	{
+		m_CategoryStart[i] = 0;
+		m_CategoryCount[i] = 0;
+	}
+}
+
+
+// Placeholder destructor
+StaticBatchClass::~StaticBatchClass()
+{
+}
+
+
+// Function:		Build function
+// What it does:	Adds the floors, then the walls, then the ceilings of the dungeon pieces to the batch with the slice of the
+//					texture each uses, then makes the buffers and starts loading the texture array. Without a device only the
+//					geometry and ranges are made, and the buffers are only recorded if there is a recorder
+// Takes in:		ID3D11Device - pointer to the device (or 0), ID3D11DeviceContext - pointer to the device context (or 0),
+//					TextureCacheClass - pointer to the cache the textures are loaded through, list<DungeonPieceClass*> -
+//					pointers to the dungeon pieces, int - BATCH_INDEXED or BATCH_INSTANCED,
+//					RenderRecorderClass - pointer to a recorder told about the buffers and calls of the batch (or 0)
+// Returns:			True if successful, false if not
+
+bool StaticBatchClass::Build(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, TextureCacheClass* TextureCache, list<DungeonPieceClass*>* Pieces,
+							 int Layout, RenderRecorderClass* Recorder)
+{
+	bool result;
+
+	Shutdown();
+
+	m_Layout = Layout;
+	m_Recorder = Recorder;
+
+	// Make the texture array first so the slices can be added to it as they are found
+	if ((Device) && (DeviceContext) && (TextureCache))
+	{
+		m_Textures = new TextureArrayClass;
+		if (!m_Textures)
+		{
+			return false;
+		}
+
+		result = m_Textures->Initialise(Device, DeviceContext, TextureCache);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// Add each category in turn so that each is kept together. The floors of every piece come first, then the walls of the
+	// pieces that have them, then the ceilings at the top of the walls, so they use the same world matrix as the floors. Every
+	// piece has a ceiling over its floor, so the ceilings are made from the pieces' floors here
+	for (int Category = 0; Category < BATCH_CATEGORIES; Category++)
+	{
+		m_CategoryStart[Category] = (m_Layout == BATCH_INSTANCED) ? m_Instances.size() : m_Indices.size();
+
+		for (auto Piece = Pieces->begin(); Piece != Pieces->end(); ++Piece)
+		{
+			if (Category == BATCH_WALLS)
+			{
+				if (!(*Piece)->WallsGenerated)
+				{
+					continue;
+				}
+
+				result = AddPieceGeometry(*Piece, (*Piece)->GetWallTextureFile(), Category);
+			}
+			else if (Category == BATCH_CEILINGS)
+			{
+				result = AddPieceGeometry(*Piece, (*Piece)->GetCeilingTextureFile(), Category);
+			}
+			else
+			{
+				result = AddPieceGeometry(*Piece, (*Piece)->GetDungeonTextureFile(), Category);
+			}
+
+			if (!result)
+			{
+				return false;
+			}
+		}
+
+		m_CategoryCount[Category] = ((m_Layout == BATCH_INSTANCED) ? m_Instances.size() : m_Indices.size()) - m_CategoryStart[Category];
+	}
+
+	m_VertexCount = m_Vertices.size();
+	m_IndexCount = m_Indices.size();
+	m_InstanceCount = m_Instances.size();
+	vector<DungeonPieceClass::VertexType>().swap(m_PieceVertices);
+	vector<unsigned long>().swap(m_PieceIndices);
+
+	if ((!m_Textures) && (!m_Recorder))
+	{
+		return true;
+	}
+
+	return InitializeBuffers(m_Textures ? Device : 0);
+}
+
+
+// Function:		Update function
+// What it does:	Makes the texture array once its textures have loaded. Called once a frame after the texture cache's Update
+// Takes in:		Nothing
+// Returns:			True if successful, false if not
+
+bool StaticBatchClass::Update()
+{
+	if (!m_Textures)
+	{
+		return true;
+	}
+
+	return m_Textures->Update();
+}
+
+
+// Function:		Add Piece Geometry function
+// What it does:	Adds the floor, walls or ceiling of a piece to the batch with the slice of its texture, and a range for it
+// Takes in:		DungeonPieceClass - pointer to the piece, WCHAR - Pointer to the texture file name, int - The category of
+//					geometry to add
+// Returns:			True if successful, false if a quad of the piece couldn't be made into an instance
+
+bool StaticBatchClass::AddPieceGeometry(DungeonPieceClass* Piece, WCHAR* TextureFile, int Category)
+{
+	// Get the piece's geometry on its own, numbered from its first vertex
+	m_PieceVertices.clear();
+	m_PieceIndices.clear();
+	if (Category == BATCH_WALLS)
+	{
+		Piece->AddWallGeometry(m_PieceVertices, m_PieceIndices);
+	}
+	else if (Category == BATCH_CEILINGS)
+	{
+		Piece->AddCeilingGeometry(m_PieceVertices, m_PieceIndices);
+	}
+	else
+	{
+		Piece->AddGeometry(m_PieceVertices, m_PieceIndices, 0.0f);
+	}
+
+	if (m_PieceIndices.empty())
+	{
+		return true;
+	}
+
+	float Slice = (float)FindSlice(TextureFile);
+
+	Range NewRange;
+	NewRange.Piece = Piece;
+	NewRange.Category = Category;
+	NewRange.StartIndex = 0;
+	NewRange.IndexCount = 0;
+	NewRange.StartInstance = 0;
+	NewRange.InstanceCount = 0;
+	NewRange.Min = m_PieceVertices[0].position;
+	NewRange.Max = NewRange.Min;
+
+	for (unsigned int i = 0; i < m_PieceVertices.size(); i++)
+	{
+		D3DXVec3Minimize(&NewRange.Min, &NewRange.Min, &m_PieceVertices[i].position);
+		D3DXVec3Maximize(&NewRange.Max, &NewRange.Max, &m_PieceVertices[i].position);
+	}
+
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		// Every six indices are the two triangles of a quad, so make each into an instance from its four corners
+		NewRange.StartInstance = m_Instances.size();
+		for (unsigned int i = 0; i + 5 < m_PieceIndices.size(); i += 6)
+		{
+			DungeonPieceClass::VertexType Corners[4] = { m_PieceVertices[m_PieceIndices[i]], m_PieceVertices[m_PieceIndices[i + 1]],
+														 m_PieceVertices[m_PieceIndices[i + 2]], m_PieceVertices[m_PieceIndices[i + 5]] };
+
+			InstanceType Instance;
+			if (!MakeInstance(Corners, Slice, Instance))
+			{
+				return false;
+			}
+			m_Instances.push_back(Instance);
+		}
+		NewRange.InstanceCount = m_Instances.size() - NewRange.StartInstance;
+	}
+	else
+	{
+		// Add it to the end of the batch with the slice after the texture co-ordinates
+		unsigned long FirstVertex = m_Vertices.size();
+		NewRange.StartIndex = m_Indices.size();
+		NewRange.IndexCount = m_PieceIndices.size();
+
+		for (unsigned int i = 0; i < m_PieceVertices.size(); i++)
+		{
+			VertexType Vertex;
+			Vertex.position = m_PieceVertices[i].position;
+			Vertex.texture = D3DXVECTOR3(m_PieceVertices[i].texture.x, m_PieceVertices[i].texture.y, Slice);
+			Vertex.normal = m_PieceVertices[i].normal;
+			m_Vertices.push_back(Vertex);
+		}
+
+		for (unsigned int i = 0; i < m_PieceIndices.size(); i++)
+		{
+			m_Indices.push_back(FirstVertex + m_PieceIndices[i]);
+		}
+	}
+
+	m_Ranges.push_back(NewRange);
+
+	return true;
+}
+
+
+// Function:		Make Instance function
+// What it does:	Finds the middle, size, facing, texture offset and texture scale of a quad from its corners
+// Takes in:		DungeonPieceClass::VertexType - the corners in the order they are drawn (the triangles are 0, 1, 2 and 0, 2, 3),
+//					float - slice of the quad's texture, InstanceType - reference to the instance to fill in
+// Returns:			True if successful, false if the quad doesn't face one of the ways in the table
+
+bool StaticBatchClass::MakeInstance(DungeonPieceClass::VertexType* Corners, float Slice, InstanceType &Instance)
+{
+	// The unit quad's x runs from the second corner to the third, and its y from the second corner to the first
+	D3DXVECTOR3 AxisU = Corners[2].position - Corners[1].position;
+	D3DXVECTOR3 AxisV = Corners[0].position - Corners[1].position;
+	D3DXVECTOR3 Normal;
+	float Width = D3DXVec3Length(&AxisU);
+	float Height = D3DXVec3Length(&AxisV);
+	if ((Width <= 0.0f) || (Height <= 0.0f))
+	{
+		return false;
+	}
+
+	D3DXVec3Normalize(&AxisU, &AxisU);
+	D3DXVec3Normalize(&AxisV, &AxisV);
+	D3DXVec3Normalize(&Normal, &Corners[0].normal);
+
+	for (unsigned int i = 0; i < QUAD_ORIENTATIONS; i++)
+	{
+		if ((D3DXVec3Dot(&AxisU, &QuadAxisU[i]) > 0.999f) && (D3DXVec3Dot(&AxisV, &QuadAxisV[i]) > 0.999f) && (D3DXVec3Dot(&Normal, &QuadNormal[i]) > 0.999f))
+		{
+			Instance.center = (Corners[0].position + Corners[2].position) * 0.5f;
+			Instance.extents = D3DXVECTOR2(Width * 0.5f, Height * 0.5f);
+			Instance.orientation = i;
+			Instance.slice = Slice;
+
+			// The texture co-ordinates start at the second corner and the scale is how far they go from there to the third corner
+			// across and the first corner down. Flipped quads start them at the fourth corner and reach both at the second
+			if (QuadTextureFlipped[i])
+			{
+				Instance.textureOffset = D3DXVECTOR2(Corners[3].texture.x, Corners[3].texture.y);
+				Instance.textureScale = D3DXVECTOR2(Corners[1].texture.x - Corners[3].texture.x, Corners[1].texture.y - Corners[3].texture.y);
+			}
+			else
+			{
+				Instance.textureOffset = D3DXVECTOR2(Corners[1].texture.x, Corners[1].texture.y);
+				Instance.textureScale = D3DXVECTOR2(Corners[2].texture.x - Corners[1].texture.x, Corners[0].texture.y - Corners[1].texture.y);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+// Function:		Find Slice function
+// What it does:	Finds the texture array slice of a texture file, giving it one if it hasn't got one yet
+// Takes in:		WCHAR - Pointer to the texture file name
+// Returns:			int - Index of the slice
+
+int StaticBatchClass::FindSlice(WCHAR* TextureFile)
+{
+	// There are only a few textures, so look through the slices in turn
+	for (unsigned int i = 0; i < m_SliceFiles.size(); i++)
+	{
+		WCHAR* SliceFile = m_SliceFiles[i];
+		if ((SliceFile == TextureFile) || ((SliceFile) && (TextureFile) && (wcscmp(SliceFile, TextureFile) == 0)))
+		{
+			return i;
+		}
+	}
+
+	// The array gives out slices in the same order, so both count the same
+	if (m_Textures)
+	{
+		m_Textures->AddTexture(TextureFile);
+	}
+	m_SliceFiles.push_back(TextureFile);
+
+	return m_SliceFiles.size() - 1;
+}
+
+
+// Function:		Initialise Buffers function
+// What it does:	Creates the buffers of the batch's layout, then releases its vertices, indices and instances
+// Takes in:		ID3D11Device - pointer to the device (or 0 to only record them)
+// Returns:			True if successful, false if not
+
+bool StaticBatchClass::InitializeBuffers(ID3D11Device* Device)
+{
+	bool result;
+
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		QuadVertexType QuadVertices[4];
+
+		if (m_Instances.empty())
+		{
+			return false;
+		}
+
+		// Every instance is drawn from the same unit quad
+		for (int i = 0; i < 4; i++)
+		{
+			QuadVertices[i].corner = D3DXVECTOR2(QuadCorners[i][0], QuadCorners[i][1]);
+		}
+
+		result = CreateBuffer(Device, D3D11_BIND_VERTEX_BUFFER, QuadVertices, sizeof(QuadVertices), &m_VertexBuffer);
+		if (!result)
+		{
+			return false;
+		}
+
+		result = CreateBuffer(Device, D3D11_BIND_INDEX_BUFFER, (void*)QuadIndices, sizeof(QuadIndices), &m_IndexBuffer);
+		if (!result)
+		{
+			return false;
+		}
+
+		// The instances are read from a second vertex buffer, one record for each instance
+		result = CreateBuffer(Device, D3D11_BIND_VERTEX_BUFFER, &m_Instances[0], sizeof(InstanceType) * m_Instances.size(), &m_InstanceBuffer);
+		if (!result)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if ((m_Vertices.empty()) || (m_Indices.empty()))
+		{
+			return false;
+		}
+
+		result = CreateBuffer(Device, D3D11_BIND_VERTEX_BUFFER, &m_Vertices[0], sizeof(VertexType) * m_Vertices.size(), &m_VertexBuffer);
+		if (!result)
+		{
+			return false;
+		}
+
+		result = CreateBuffer(Device, D3D11_BIND_INDEX_BUFFER, &m_Indices[0], sizeof(unsigned long) * m_Indices.size(), &m_IndexBuffer);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	// The geometry is on the card now, so the copies kept here aren't needed
+	vector<VertexType>().swap(m_Vertices);
+	vector<unsigned long>().swap(m_Indices);
+	vector<InstanceType>().swap(m_Instances);
+
+	return true;
+}
+
+
+// Function:		Create Buffer function
+// What it does:	Records a static buffer and creates it if there is a device
+// Takes in:		ID3D11Device - pointer to the device (or 0), unsigned int - bind flags, void - Pointer to the data,
+//					unsigned int - Size of the data in bytes, ID3D11Buffer - pointer to where the buffer is stored
+// Returns:			True if successful, false if not
+
+bool StaticBatchClass::CreateBuffer(ID3D11Device* Device, unsigned int BindFlags, void* Data, unsigned int Bytes, ID3D11Buffer** Buffer)
+{
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SUBRESOURCE_DATA bufferData;
+	HRESULT result;
+
+	if (m_Recorder)
+	{
+		m_Recorder->RecordBuffer(Bytes);
+	}
+
+	if (!Device)
+	{
+		return true;
+	}
+
+	// Set up the description of the static buffer.
+	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	bufferDesc.ByteWidth = Bytes;
+	bufferDesc.BindFlags = BindFlags;
+	bufferDesc.CPUAccessFlags = 0;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	// Give the subresource structure a pointer to the data.
+	bufferData.pSysMem = Data;
+	bufferData.SysMemPitch = 0;
+	bufferData.SysMemSlicePitch = 0;
+
+	// Now create the buffer.
+	result = Device->CreateBuffer(&bufferDesc, &bufferData, Buffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Get Range Count function
+// What it does:	Returns the number of ranges in the batch
+// Takes in:		Nothing
+// Returns:			int - Number of ranges
+
+int StaticBatchClass::GetRangeCount()
+{
+	return m_Ranges.size();
+}
+
+
+// Function:		Get Range function
+// What it does:	Returns one of the ranges
+// Takes in:		int - Index of the range
+// Returns:			Pointer to the range
+
+StaticBatchClass::Range* StaticBatchClass::GetRange(int RangeIndex)
+{
+	return &m_Ranges[RangeIndex];
+}
+
+
+// Function:		Get Category Start function
+// What it does:	Returns the first index (indexed layout) or instance (instanced layout) of a category of geometry
+// Takes in:		int - The category (BATCH_FLOORS, BATCH_WALLS or BATCH_CEILINGS)
+// Returns:			int - First index or instance
+
+int StaticBatchClass::GetCategoryStart(int Category)
+{
+	return m_CategoryStart[Category];
+}
+
+
+// Function:		Get Category Count function
+// What it does:	Returns the number of indices (indexed layout) or instances (instanced layout) in a category of geometry
+// Takes in:		int - The category (BATCH_FLOORS, BATCH_WALLS or BATCH_CEILINGS)
+// Returns:			int - Number of indices or instances
+
+int StaticBatchClass::GetCategoryCount(int Category)
+{
+	return m_CategoryCount[Category];
+}
+
+
+// Function:		Render function
+// What it does:	Puts the buffers of the batch in the graphics pipeline. With a recorder the calls are recorded, along with the
+//					draw of the whole batch the shader makes next, and without a device context they are only recorded
+// Takes in:		ID3D11DeviceContext - pointer to the device context (or 0)
+// Returns:			Nothing
+
+void StaticBatchClass::Render(ID3D11DeviceContext* DeviceContext)
+{
+	if (m_Recorder)
+	{
+		// Both layouts set their vertex buffers in one call, then the index buffer and the topology
+		m_Recorder->RecordCall();
+		m_Recorder->RecordCall();
+		m_Recorder->RecordCall();
+
+		// The indexed batch shades each vertex once and reads every vertex and index. An instance can't reuse the vertices
+		// shaded for another, so each shades the unit quad's four corners and reads them, its indices and its own record
+		if (m_Layout == BATCH_INSTANCED)
+		{
+			m_Recorder->RecordDraw(m_InstanceCount * 4, m_InstanceCount * (4 * sizeof(QuadVertexType) + sizeof(QuadIndices) + sizeof(InstanceType)));
+		}
+		else
+		{
+			m_Recorder->RecordDraw(m_VertexCount, m_VertexCount * sizeof(VertexType) + m_IndexCount * sizeof(unsigned long));
+		}
+	}
+
+	if (!DeviceContext)
+	{
+		return;
+	}
+
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		// Set the unit quad in the first slot and the instances in the second, matching the instanced input layout
+		ID3D11Buffer* buffers[2] = { m_VertexBuffer, m_InstanceBuffer };
+		unsigned int strides[2] = { sizeof(QuadVertexType), sizeof(InstanceType) };
+		unsigned int offsets[2] = { 0, 0 };
+
+		DeviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+	}
+	else
+	{
+		unsigned int stride = sizeof(VertexType);
+		unsigned int offset = 0;
+
+		// Set the vertex buffer to active in the input assembler so it can be rendered.
+		DeviceContext->IASetVertexBuffers(0, 1, &m_VertexBuffer, &stride, &offset);
+	}
+
+	// Set the index buffer to active in the input assembler so it can be rendered.
+	DeviceContext->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+	// Set the type of primitive that should be rendered from this vertex buffer, in this case triangles.
+	DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+
+// Function:		Render Range function
+// What it does:	Puts the buffers of the batch for one range in the graphics pipeline. For the indexed layout the index buffer
+//					starts at the range, and for the instanced layout the range is drawn from its first instance
+// Takes in:		ID3D11DeviceContext - pointer to the device context, int - Index of the range
+// Returns:			Nothing
+
+void StaticBatchClass::RenderRange(ID3D11DeviceContext* DeviceContext, int RangeIndex)
+{
+	// The instanced buffers are the same for every range
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		ID3D11Buffer* buffers[2] = { m_VertexBuffer, m_InstanceBuffer };
+		unsigned int strides[2] = { sizeof(QuadVertexType), sizeof(InstanceType) };
+		unsigned int offsets[2] = { 0, 0 };
+
+		DeviceContext->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+		DeviceContext->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		return;
+	}
+
+	unsigned int stride = sizeof(VertexType);
+	unsigned int offset = 0;
+
+	// Set the index buffer starting at the range, so the shaders can draw it from the first index
+	DeviceContext->IASetVertexBuffers(0, 1, &m_VertexBuffer, &stride, &offset);
+	DeviceContext->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, m_Ranges[RangeIndex].StartIndex * sizeof(unsigned long));
+	DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+
+// Function:		Get Layout function
+// What it does:	Returns the way the batch is laid out
+// Takes in:		Nothing
+// Returns:			int - BATCH_INDEXED or BATCH_INSTANCED
+
+int StaticBatchClass::GetLayout()
+{
+	return m_Layout;
+}
+
+
+// Function:		Get Index Count function
+// What it does:	Returns the index count needed to render the whole batch, or to render one instance of the unit quad
+// Takes in:		Nothing
+// Returns:			int - Index count
+
+int StaticBatchClass::GetIndexCount()
+{
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		return (m_InstanceCount > 0) ? (sizeof(QuadIndices) / sizeof(QuadIndices[0])) : 0;
+	}
+
+	return m_IndexCount;
+}
+
+
+// Function:		Get Instance Count function
+// What it does:	Returns the number of instances needed to render the whole batch (1 for the indexed layout if it isn't empty)
+// Takes in:		Nothing
+// Returns:			int - Instance count
+
+int StaticBatchClass::GetInstanceCount()
+{
+	if (m_Layout == BATCH_INSTANCED)
+	{
+		return m_InstanceCount;
+	}
+
+	return (m_IndexCount > 0) ? 1 : 0;
+}
+
+
+// Function:		Get Texture function
+// What it does:	Returns the texture array used by the batch
+// Takes in:		Nothing
+// Returns:			ID3D11ShaderResourceView - pointer to the texture array
+
+ID3D11ShaderResourceView* StaticBatchClass::GetTexture()
+{
+	if (!m_Textures)
+	{
+		return 0;
+	}
+
+	return m_Textures->GetTexture();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the buffers and texture array and clears the batch
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void StaticBatchClass::Shutdown()
+{
+	if (m_Textures)
+	{
+		m_Textures->Shutdown();
+		delete m_Textures;
+		m_Textures = 0;
+	}
+
+	if (m_InstanceBuffer)
+	{
+		m_InstanceBuffer->Release();
+		m_InstanceBuffer = 0;
+	}
+
+	if (m_IndexBuffer)
+	{
+		m_IndexBuffer->Release();
+		m_IndexBuffer = 0;
+	}
+
+	if (m_VertexBuffer)
+	{
+		m_VertexBuffer->Release();
+		m_VertexBuffer = 0;
+	}
+
+	m_SliceFiles.clear();
+	m_Vertices.clear();
+	m_Indices.clear();
+	m_Instances.clear();
+	m_Ranges.clear();
+	m_VertexCount = 0;
+	m_IndexCount = 0;
+	m_InstanceCount = 0;
+	m_Recorder = 0;
+
+	for (int i = 0; i < BATCH_CATEGORIES; i++)
+	{
+		m_CategoryStart[i] = 0;
+		m_CategoryCount[i] = 0;
+	}
+}
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: staticbatchclass.h
+// Static Batch Class
+// Merges the floors, walls and ceilings of the dungeon pieces into one batch drawn with a texture array
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef STATIC_BATCH_CLASS_H
+#define STATIC_BATCH_CLASS_H
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include "texturecacheclass.h"
+#include "texturearrayclass.h"
+#include "renderrecorderclass.h"
+
+// For wcscmp
+#include <wchar.h>
+
+// For list
+#include <list>
+using std::list;
+
+// For vector
+#include <vector>
+using std::vector;
+
+#include "dungeonpiececlass.h"
+
+// The ways the batch can be laid out
+#define BATCH_INDEXED 0			// Every corner of every quad in one vertex buffer, drawn with an index buffer
+#define BATCH_INSTANCED 1		// One unit quad drawn once for each quad, with the quads in an instance buffer
+
+// The categories of geometry in the batch. Each is kept together, so a whole category can be drawn with one call
+#define BATCH_FLOORS 0
+#define BATCH_WALLS 1
+#define BATCH_CEILINGS 2
+#define BATCH_CATEGORIES 3
+
+// The number of ways a quad can face (up, down, and the four walls)
+#define QUAD_ORIENTATIONS 6
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: StaticBatchClass
+// The dungeon doesn't move once it is made, so instead of a draw for every floor, wall and ceiling the geometry of every piece
+// is put into one batch and drawn with one call. Each texture the pieces use is a slice of a texture array, and each vertex
+// keeps the slice of its texture after its texture co-ordinates, so the batch doesn't have to be split by texture. Ceilings
+// are made from the floors of the pieces, raised to the top of the walls, so everything in the batch uses the same world
+// matrix. The batch keeps the range of its batch used by each piece with the bounds of the range, so a range can still be
+// drawn (or skipped) on its own.
+// Every floor, wall and ceiling is a rectangle facing along an axis, so instead of keeping its four corners the instanced layout
+// keeps one small record for it (its middle, half its width and height, which way it faces, how far its texture repeats and its
+// slice) and draws one shared unit quad for each record, with the light shader's instanced vertex shader moving the corners out
+// to the rectangle. The indexed layout is kept so the two can be compared through a render recorder
+////////////////////////////////////////////////////////////////////////////////
+class StaticBatchClass
+{
+public:
+	// A vertex of the indexed batch. The z of the texture co-ordinates is the slice of the texture array
+	struct VertexType
+	{
+		D3DXVECTOR3 position;
+		D3DXVECTOR3 texture;
+		D3DXVECTOR3 normal;
+	};
+
+	// A corner of the unit quad drawn for each instance, from 0 to 1 on each axis
+	struct QuadVertexType
+	{
+		D3DXVECTOR2 corner;
+	};
+
+	// One quad of the instanced batch. The orientation is the index of the way it faces in the table shared with light.vs, and
+	// the texture offset is where the texture co-ordinates start (walls start them from where they are along their line)
+	struct InstanceType
+	{
+		D3DXVECTOR3 center;
+		D3DXVECTOR2 extents;
+		unsigned int orientation;
+		D3DXVECTOR2 textureScale;
+		float slice;
+		D3DXVECTOR2 textureOffset;
+	};
+
+	// The part of the batch used by one piece (its floor, its walls or its ceiling), with the corners of the box around it. The
+	// indexed layout uses the index range and the instanced layout uses the instance range
+	struct Range
+	{
+		DungeonPieceClass* Piece;
+		int Category;
+		int StartIndex;
+		int IndexCount;
+		int StartInstance;
+		int InstanceCount;
+		D3DXVECTOR3 Min, Max;
+	};
+
+	// Function:		Static Batch constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	StaticBatchClass();
+
+
+	// Placeholder destructor
+	~StaticBatchClass();
+
+
+	// Function:		Build function
+	// What it does:	Adds the floors, then the walls, then the ceilings of the dungeon pieces to the batch with the slice of the
+	//					texture each uses, then makes the buffers and starts loading the texture array. Without a device only the
+	//					geometry and ranges are made, and the buffers are only recorded if there is a recorder
+	// Takes in:		ID3D11Device - pointer to the device (or 0), ID3D11DeviceContext - pointer to the device context (or 0),
+	//					TextureCacheClass - pointer to the cache the textures are loaded through, list<DungeonPieceClass*> -
+	//					pointers to the dungeon pieces, int - BATCH_INDEXED or BATCH_INSTANCED,
+	//					RenderRecorderClass - pointer to a recorder told about the buffers and calls of the batch (or 0)
+	// Returns:			True if successful, false if not
+	bool Build(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, TextureCacheClass* TextureCache, list<DungeonPieceClass*>* Pieces,
+			   int Layout, RenderRecorderClass* Recorder);
+
+
+	// Function:		Update function
+	// What it does:	Makes the texture array once its textures have loaded. Called once a frame after the texture cache's Update
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if not
+	bool Update();
+
+
+	// Function:		Get Range Count function
+	// What it does:	Returns the number of ranges in the batch
+	// Takes in:		Nothing
+	// Returns:			int - Number of ranges
+	int GetRangeCount();
+
+
+	// Function:		Get Range function
+	// What it does:	Returns one of the ranges
+	// Takes in:		int - Index of the range
+	// Returns:			Pointer to the range
+	Range* GetRange(int RangeIndex);
+
+
+	// Function:		Get Category Start function
+	// What it does:	Returns the first index (indexed layout) or instance (instanced layout) of a category of geometry
+	// Takes in:		int - The category (BATCH_FLOORS, BATCH_WALLS or BATCH_CEILINGS)
+	// Returns:			int - First index or instance
+	int GetCategoryStart(int Category);
+
+
+	// Function:		Get Category Count function
+	// What it does:	Returns the number of indices (indexed layout) or instances (instanced layout) in a category of geometry
+	// Takes in:		int - The category (BATCH_FLOORS, BATCH_WALLS or BATCH_CEILINGS)
+	// Returns:			int - Number of indices or instances
+	int GetCategoryCount(int Category);
+
+
+	// Function:		Render function
+	// What it does:	Puts the buffers of the batch in the graphics pipeline. With a recorder the calls are recorded, along with the
+	//					draw of the whole batch the shader makes next, and without a device context they are only recorded
+	// Takes in:		ID3D11DeviceContext - pointer to the device context (or 0)
+	// Returns:			Nothing
+	void Render(ID3D11DeviceContext* DeviceContext);
+
+
+	// Function:		Render Range function
+	// What it does:	Puts the buffers of the batch for one range in the graphics pipeline. For the indexed layout the index buffer
+	//					starts at the range, and for the instanced layout the range is drawn from its first instance
+	// Takes in:		ID3D11DeviceContext - pointer to the device context, int - Index of the range
+	// Returns:			Nothing
+	void RenderRange(ID3D11DeviceContext* DeviceContext, int RangeIndex);
+
+
+	// Function:		Get Layout function
+	// What it does:	Returns the way the batch is laid out
+	// Takes in:		Nothing
+	// Returns:			int - BATCH_INDEXED or BATCH_INSTANCED
+	int GetLayout();
+
+
+	// Function:		Get Index Count function
+	// What it does:	Returns the index count needed to render the whole batch, or to render one instance of the unit quad
+	// Takes in:		Nothing
+	// Returns:			int - Index count
+	int GetIndexCount();
+
+
+	// Function:		Get Instance Count function
+	// What it does:	Returns the number of instances needed to render the whole batch (1 for the indexed layout if it isn't empty)
+	// Takes in:		Nothing
+	// Returns:			int - Instance count
+	int GetInstanceCount();
+
+
+	// Function:		Get Texture function
+	// What it does:	Returns the texture array used by the batch
+	// Takes in:		Nothing
+	// Returns:			ID3D11ShaderResourceView - pointer to the texture array
+	ID3D11ShaderResourceView* GetTexture();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the buffers and texture array and clears the batch
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// Function:		Add Piece Geometry function
+	// What it does:	Adds the floor, walls or ceiling of a piece to the batch with the slice of its texture, and a range for it
+	// Takes in:		DungeonPieceClass - pointer to the piece, WCHAR - Pointer to the texture file name, int - The category of
+	//					geometry to add
+	// Returns:			True if successful, false if a quad of the piece couldn't be made into an instance
+	bool AddPieceGeometry(DungeonPieceClass* Piece, WCHAR* TextureFile, int Category);
+
+
+	// Function:		Make Instance function
+	// What it does:	Finds the middle, size, facing, texture offset and texture scale of a quad from its corners
+	// Takes in:		DungeonPieceClass::VertexType - the corners in the order they are drawn (the triangles are 0, 1, 2 and 0, 2, 3),
+	//					float - slice of the quad's texture, InstanceType - reference to the instance to fill in
+	// Returns:			True if successful, false if the quad doesn't face one of the ways in the table
+	bool MakeInstance(DungeonPieceClass::VertexType* Corners, float Slice, InstanceType &Instance);
+
+
+	// Function:		Find Slice function
+	// What it does:	Finds the texture array slice of a texture file, giving it one if it hasn't got one yet
+	// Takes in:		WCHAR - Pointer to the texture file name
+	// Returns:			int - Index of the slice
+	int FindSlice(WCHAR* TextureFile);
+
+
+	// Function:		Initialise Buffers function
+	// What it does:	Creates the buffers of the batch's layout, then releases its vertices, indices and instances
+	// Takes in:		ID3D11Device - pointer to the device (or 0 to only record them)
+	// Returns:			True if successful, false if not
+	bool InitializeBuffers(ID3D11Device* Device);
+
+
+	// Function:		Create Buffer function
+	// What it does:	Records a static buffer and creates it if there is a device
+	// Takes in:		ID3D11Device - pointer to the device (or 0), unsigned int - bind flags, void - Pointer to the data,
+	//					unsigned int - Size of the data in bytes, ID3D11Buffer - pointer to where the buffer is stored
+	// Returns:			True if successful, false if not
+	bool CreateBuffer(ID3D11Device* Device, unsigned int BindFlags, void* Data, unsigned int Bytes, ID3D11Buffer** Buffer);
+
+private:
+	TextureArrayClass* m_Textures;
+	RenderRecorderClass* m_Recorder;
+	int m_Layout;
+
+	// The texture files given slices so far. Without a device there is no array, so the slices are only counted here
+	vector<WCHAR*> m_SliceFiles;
+
+	// The geometry and ranges. The vertices, indices and instances are only kept until the buffers are made
+	vector<VertexType> m_Vertices;
+	vector<unsigned long> m_Indices;
+	vector<InstanceType> m_Instances;
+	int m_VertexCount, m_IndexCount, m_InstanceCount;
+	int m_CategoryStart[BATCH_CATEGORIES], m_CategoryCount[BATCH_CATEGORIES];
+	vector<Range> m_Ranges;
+
+	// The vertex and index buffers hold the batch (indexed layout) or the unit quad (instanced layout)
+	ID3D11Buffer *m_VertexBuffer, *m_IndexBuffer, *m_InstanceBuffer;
+
+	// The vertices of one piece, before the slice is added to them
+	vector<DungeonPieceClass::VertexType> m_PieceVertices;
+	vector<unsigned long> m_PieceIndices;
+};
+
+
+#endif
@@ -0,0 +1,329 @@
+#include "texturearrayclass.h"
+
+
+// Function:		Texture Array constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+TextureArrayClass::TextureArrayClass()
+{
+	m_Device = 0;
+	m_DeviceContext = 0;
+	m_TextureCache = 0;
+	m_Array = 0;
+	m_Placeholder = 0;
+}
+
+
+// Placeholder destructor
+TextureArrayClass::~TextureArrayClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Sets the device, device context and texture cache used to make the array, and makes the placeholder
+// Takes in:		ID3D11Device - pointer to the device, ID3D11DeviceContext - pointer to the device context,
+//					TextureCacheClass - pointer to the cache the files are loaded through
+// Returns:			True if successful, false if not
+
+bool TextureArrayClass::Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, TextureCacheClass* TextureCache)
+{
+	m_Device = Device;
+	m_DeviceContext = DeviceContext;
+	m_TextureCache = TextureCache;
+	if ((!m_Device) || (!m_DeviceContext) || (!m_TextureCache))
+	{
+		return false;
+	}
+
+	return CreatePlaceholder();
+}
+
+
+// Function:		Add Texture function
+// What it does:	Finds the slice for a texture file, adding a slice and starting to load the file if there isn't one yet.
+//					Slices can only be added before the array is made
+// Takes in:		WCHAR - Pointer to the texture file name
+// Returns:			int - Index of the slice, or -1 if it couldn't be added
+
+int TextureArrayClass::AddTexture(WCHAR* Filename)
+{
+	if (!Filename)
+	{
+		return -1;
+	}
+
+	// There are only a few textures, so look through the slices in turn
+	for (unsigned int i = 0; i < m_Slices.size(); i++)
+	{
+		if (m_Slices[i].Filename == Filename)
+		{
+			return i;
+		}
+	}
+
+	if ((m_Array) || (!m_TextureCache))
+	{
+		return -1;
+	}
+
+	Slice NewSlice;
+	NewSlice.Filename = Filename;
+	NewSlice.Texture = m_TextureCache->Acquire(Filename, TEXTURE_ARRAY_SIZE);
+	if (!NewSlice.Texture)
+	{
+		return -1;
+	}
+	m_Slices.push_back(NewSlice);
+
+	return m_Slices.size() - 1;
+}
+
+
+// Function:		Update function
+// What it does:	Makes the array once every file has finished loading. Called once a frame after the texture cache's Update
+// Takes in:		Nothing
+// Returns:			True if successful, false if the array couldn't be made
+
+bool TextureArrayClass::Update()
+{
+	bool result;
+
+	if ((m_Array) || (m_Slices.empty()))
+	{
+		return true;
+	}
+
+	// Wait for every slice, so the array is only made once
+	for (unsigned int i = 0; i < m_Slices.size(); i++)
+	{
+		if (m_TextureCache->IsLoading(m_Slices[i].Texture))
+		{
+			return true;
+		}
+	}
+
+	result = CreateArray();
+
+	// The slices have been copied into the array, so the cache can free its copies
+	ReleaseSliceTextures();
+
+	return result;
+}
+
+
+// Function:		Get Texture function
+// What it does:	Returns the array, or the placeholder if it hasn't been made yet
+// Takes in:		Nothing
+// Returns:			ID3D11ShaderResourceView - pointer to the array
+
+ID3D11ShaderResourceView* TextureArrayClass::GetTexture()
+{
+	if (m_Array)
+	{
+		return m_Array;
+	}
+
+	return m_Placeholder;
+}
+
+
+// Function:		Get Slice Count function
+// What it does:	Returns the number of slices (one for each texture file)
+// Takes in:		Nothing
+// Returns:			int - Number of slices
+
+int TextureArrayClass::GetSliceCount()
+{
+	return m_Slices.size();
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the array, the placeholder and any textures still held for slices
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void TextureArrayClass::Shutdown()
+{
+	ReleaseSliceTextures();
+	m_Slices.clear();
+
+	if (m_Array)
+	{
+		m_Array->Release();
+		m_Array = 0;
+	}
+
+	if (m_Placeholder)
+	{
+		m_Placeholder->Release();
+		m_Placeholder = 0;
+	}
+
+	m_Device = 0;
+	m_DeviceContext = 0;
+	m_TextureCache = 0;
+}
+
+
+// Function:		Create Array function
+// What it does:	Makes the array and copies each loaded texture and all its mip levels into its slice
+// Takes in:		Nothing
+// Returns:			True if successful, false if not
+
+bool TextureArrayClass::CreateArray()
+{
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC ArrayDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC ViewDesc;
+	ID3D11Texture2D* ArrayTexture = 0;
+
+	// Every mip level down to 1 by 1
+	unsigned int MipLevels = 1;
+	for (int Size = TEXTURE_ARRAY_SIZE; Size > 1; Size /= 2)
+	{
+		MipLevels++;
+	}
+
+	ArrayDesc.Width = TEXTURE_ARRAY_SIZE;
+	ArrayDesc.Height = TEXTURE_ARRAY_SIZE;
+	ArrayDesc.MipLevels = MipLevels;
+	ArrayDesc.ArraySize = m_Slices.size();
+	ArrayDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	ArrayDesc.SampleDesc.Count = 1;
+	ArrayDesc.SampleDesc.Quality = 0;
+	ArrayDesc.Usage = D3D11_USAGE_DEFAULT;
+	ArrayDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	ArrayDesc.CPUAccessFlags = 0;
+	ArrayDesc.MiscFlags = 0;
+
+	result = m_Device->CreateTexture2D(&ArrayDesc, NULL, &ArrayTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	// Copy each slice on the card. A file that couldn't be loaded still has the placeholder, which is the wrong size to copy,
+	// so its slice is left empty
+	for (unsigned int i = 0; i < m_Slices.size(); i++)
+	{
+		if (!m_TextureCache->IsLoaded(m_Slices[i].Texture))
+		{
+			continue;
+		}
+
+		ID3D11Resource* Source = 0;
+		D3D11_TEXTURE2D_DESC SourceDesc;
+		m_Slices[i].Texture->GetTexture()->GetResource(&Source);
+		if (!Source)
+		{
+			continue;
+		}
+
+		((ID3D11Texture2D*)Source)->GetDesc(&SourceDesc);
+		if ((SourceDesc.Width == TEXTURE_ARRAY_SIZE) && (SourceDesc.Height == TEXTURE_ARRAY_SIZE) && (SourceDesc.Format == ArrayDesc.Format))
+		{
+			for (unsigned int Mip = 0; (Mip < MipLevels) && (Mip < SourceDesc.MipLevels); Mip++)
+			{
+				m_DeviceContext->CopySubresourceRegion(ArrayTexture, D3D11CalcSubresource(Mip, i, MipLevels), 0, 0, 0,
+													   Source, D3D11CalcSubresource(Mip, 0, SourceDesc.MipLevels), NULL);
+			}
+		}
+		Source->Release();
+	}
+
+	ViewDesc.Format = ArrayDesc.Format;
+	ViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	ViewDesc.Texture2DArray.MostDetailedMip = 0;
+	ViewDesc.Texture2DArray.MipLevels = MipLevels;
+	ViewDesc.Texture2DArray.FirstArraySlice = 0;
+	ViewDesc.Texture2DArray.ArraySize = ArrayDesc.ArraySize;
+
+	result = m_Device->CreateShaderResourceView(ArrayTexture, &ViewDesc, &m_Array);
+	ArrayTexture->Release();
+	if (FAILED(result))
+	{
+		m_Array = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Create Placeholder function
+// What it does:	Makes the one slice grey array shown until the real one is made
+// Takes in:		Nothing
+// Returns:			True if successful, false if not
+
+bool TextureArrayClass::CreatePlaceholder()
+{
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC TextureDesc;
+	D3D11_SUBRESOURCE_DATA PixelData;
+	D3D11_SHADER_RESOURCE_VIEW_DESC ViewDesc;
+	ID3D11Texture2D* Texture = 0;
+
+	// One mid grey pixel. Slice numbers past the end of an array use its last slice, so every slice shows it
+	unsigned char Pixel[4] = { 128, 128, 128, 255 };
+
+	TextureDesc.Width = 1;
+	TextureDesc.Height = 1;
+	TextureDesc.MipLevels = 1;
+	TextureDesc.ArraySize = 1;
+	TextureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	TextureDesc.SampleDesc.Count = 1;
+	TextureDesc.SampleDesc.Quality = 0;
+	TextureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	TextureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	TextureDesc.CPUAccessFlags = 0;
+	TextureDesc.MiscFlags = 0;
+
+	PixelData.pSysMem = Pixel;
+	PixelData.SysMemPitch = sizeof(Pixel);
+	PixelData.SysMemSlicePitch = 0;
+
+	result = m_Device->CreateTexture2D(&TextureDesc, &PixelData, &Texture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	ViewDesc.Format = TextureDesc.Format;
+	ViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	ViewDesc.Texture2DArray.MostDetailedMip = 0;
+	ViewDesc.Texture2DArray.MipLevels = 1;
+	ViewDesc.Texture2DArray.FirstArraySlice = 0;
+	ViewDesc.Texture2DArray.ArraySize = 1;
+
+	result = m_Device->CreateShaderResourceView(Texture, &ViewDesc, &m_Placeholder);
+	Texture->Release();
+	if (FAILED(result))
+	{
+		m_Placeholder = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Release Slice Textures function
+// What it does:	Gives the textures loaded for the slices back to the cache
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void TextureArrayClass::ReleaseSliceTextures()
+{
+	for (unsigned int i = 0; i < m_Slices.size(); i++)
+	{
+		if ((m_Slices[i].Texture) && (m_TextureCache))
+		{
+			m_TextureCache->Release(m_Slices[i].Texture);
+		}
+		m_Slices[i].Texture = 0;
+	}
+}
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: texturearrayclass.h
+// Texture Array Class
+// Packs the textures used by the dungeon geometry into the slices of one texture array
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEXTURE_ARRAY_CLASS_H
+#define TEXTURE_ARRAY_CLASS_H
+
+#include <d3d11.h>
+#include "textureclass.h"
+#include "texturecacheclass.h"
+
+// For the file names of the slices
+#include <string>
+using std::wstring;
+
+// For vector
+#include <vector>
+using std::vector;
+
+// The width and height every texture is scaled to in the array
+#define TEXTURE_ARRAY_SIZE 512
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureArrayClass
+// Each texture file added is given a slice of the array, and the geometry using it keeps the slice number next to its texture
+// co-ordinates, so everything can be drawn with the array bound once. An array is used rather than an atlas because the
+// floors and walls repeat their textures across each quad, which wraps within a slice but would bleed into its neighbours
+// in an atlas. Every slice has to be the same size, so the files are loaded through the texture cache scaled to
+// TEXTURE_ARRAY_SIZE. The array is made on the card by copying the loaded textures in once all of them have finished
+// loading, and until then a grey placeholder array is shown
+////////////////////////////////////////////////////////////////////////////////
+class TextureArrayClass
+{
+public:
+	// Function:		Texture Array constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	TextureArrayClass();
+
+
+	// Placeholder destructor
+	~TextureArrayClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Sets the device, device context and texture cache used to make the array, and makes the placeholder
+	// Takes in:		ID3D11Device - pointer to the device, ID3D11DeviceContext - pointer to the device context,
+	//					TextureCacheClass - pointer to the cache the files are loaded through
+	// Returns:			True if successful, false if not
+	bool Initialise(ID3D11Device* Device, ID3D11DeviceContext* DeviceContext, TextureCacheClass* TextureCache);
+
+
+	// Function:		Add Texture function
+	// What it does:	Finds the slice for a texture file, adding a slice and starting to load the file if there isn't one yet.
+	//					Slices can only be added before the array is made
+	// Takes in:		WCHAR - Pointer to the texture file name
+	// Returns:			int - Index of the slice, or -1 if it couldn't be added
+	int AddTexture(WCHAR* Filename);
+
+
+	// Function:		Update function
+	// What it does:	Makes the array once every file has finished loading. Called once a frame after the texture cache's Update
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if the array couldn't be made
+	bool Update();
+
+
+	// Function:		Get Texture function
+	// What it does:	Returns the array, or the placeholder if it hasn't been made yet
+	// Takes in:		Nothing
+	// Returns:			ID3D11ShaderResourceView - pointer to the array
+	ID3D11ShaderResourceView* GetTexture();
+
+
+	// Function:		Get Slice Count function
+	// What it does:	Returns the number of slices (one for each texture file)
+	// Takes in:		Nothing
+	// Returns:			int - Number of slices
+	int GetSliceCount();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the array, the placeholder and any textures still held for slices
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// A texture file given a slice, with the texture loaded for it until it is copied into the array
+	struct Slice
+	{
+		wstring Filename;
+		TextureClass* Texture;
+	};
+
+
+	// Function:		Create Array function
+	// What it does:	Makes the array and copies each loaded texture and all its mip levels into its slice
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if not
+	bool CreateArray();
+
+
+	// Function:		Create Placeholder function
+	// What it does:	Makes the one slice grey array shown until the real one is made
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if not
+	bool CreatePlaceholder();
+
+
+	// Function:		Release Slice Textures function
+	// What it does:	Gives the textures loaded for the slices back to the cache
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void ReleaseSliceTextures();
+
+private:
+	ID3D11Device* m_Device;
+	ID3D11DeviceContext* m_DeviceContext;
+	TextureCacheClass* m_TextureCache;
+
+	vector<Slice> m_Slices;
+	ID3D11ShaderResourceView* m_Array;
+	ID3D11ShaderResourceView* m_Placeholder;
+};
+
+
+#endif
@@ -0,0 +1,638 @@
+#include "texturecacheclass.h"
+
+
+// Function:		Texture Cache constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+TextureCacheClass::TextureCacheClass()
+{
+	m_Device = 0;
+	m_Placeholder = 0;
+	m_Stopping = false;
+	m_Hits = 0;
+	m_Misses = 0;
+	m_Bytes = 0;
+	m_Pending = 0;
+	m_Failures = 0;
+}
+
+
+// Placeholder destructor
+TextureCacheClass::~TextureCacheClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Sets the device the textures are loaded with, makes the placeholder texture and starts the loader threads
+// Takes in:		ID3D11Device - pointer to the device
+// Returns:			True if successful, false if not
+
+bool TextureCacheClass::Initialise(ID3D11Device* Device)
+{
+	bool result;
+
+	m_Device = Device;
+	if (!m_Device)
+	{
+		return false;
+	}
+
+	result = CreatePlaceholder();
+	if (!result)
+	{
+		return false;
+	}
+
+	m_Stopping = false;
+	for (int i = 0; i < TEXTURE_LOADER_THREADS; i++)
+	{
+		m_Loaders.push_back(std::thread(&TextureCacheClass::LoaderLoop, this));
+	}
+
+	return true;
+}
+
+
+// Function:		Acquire function
+// What it does:	Returns the texture for a file and adds a user to it. A file that isn't in the cache yet is queued for
+//					the loader threads, and its texture shows the placeholder until Update swaps the loaded one in
+// Takes in:		WCHAR - Pointer to the texture file name
+// Returns:			TextureClass - pointer to the shared texture, or 0 if it couldn't be made
+
+TextureClass* TextureCacheClass::Acquire(WCHAR* Filename)
+{
+	return Acquire(Filename, 0);
+}
+
+
+// Function:		Acquire function
+// What it does:	As above, but the image is scaled to a square of the given size and kept as 8 bit RGBA with all its mip
+//					levels, so it can be copied into a texture array. It is kept apart from the texture loaded at the file's size
+// Takes in:		WCHAR - Pointer to the texture file name, int - Width and height to load it at (0 keeps the file's size)
+// Returns:			TextureClass - pointer to the shared texture, or 0 if it couldn't be made
+
+TextureClass* TextureCacheClass::Acquire(WCHAR* Filename, int Size)
+{
+	HRESULT result;
+	D3DX11_IMAGE_LOAD_INFO LoadInfo;
+	D3DX11_IMAGE_LOAD_INFO* LoadInfoUsed = NULL;
+
+	if ((!m_Device) || (!Filename))
+	{
+		return 0;
+	}
+
+	// Share the texture if the file has already been loaded at this size
+	wstring Key = MakeKey(Filename);
+	if (Size > 0)
+	{
+		Key += L"@" + std::to_wstring(Size);
+
+		// Everything not set here is left to its default, which keeps the full chain of mip levels
+		LoadInfo.Width = Size;
+		LoadInfo.Height = Size;
+		LoadInfo.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		LoadInfoUsed = &LoadInfo;
+	}
+
+	auto Found = m_Textures.find(Key);
+	if (Found != m_Textures.end())
+	{
+		Found->second.Users++;
+		m_Hits++;
+		return Found->second.Texture;
+	}
+
+	// Otherwise give out the placeholder for now and keep the texture for the next request
+	m_Misses++;
+
+	Entry NewEntry;
+	NewEntry.Texture = new TextureClass;
+	if (!NewEntry.Texture)
+	{
+		return 0;
+	}
+
+	NewEntry.Texture->SetTexture(m_Placeholder);
+	NewEntry.Users = 1;
+	NewEntry.Bytes = 0;
+	NewEntry.Loading = true;
+	NewEntry.Loaded = false;
+	m_Textures[Key] = NewEntry;
+
+	// Queue the file for the loader threads. Making the loader and processor doesn't touch the file
+	Load NewLoad;
+	NewLoad.Key = Key;
+	NewLoad.Loader = 0;
+	NewLoad.Processor = 0;
+	NewLoad.Decoded = false;
+
+	result = D3DX11CreateAsyncFileLoader(Filename, &NewLoad.Loader);
+	if (SUCCEEDED(result))
+	{
+		result = D3DX11CreateAsyncShaderResourceViewProcessor(m_Device, LoadInfoUsed, &NewLoad.Processor);
+	}
+	if (FAILED(result))
+	{
+		DestroyLoad(NewLoad);
+		m_Textures[Key].Loading = false;
+		m_Failures++;
+		return NewEntry.Texture;
+	}
+
+	{
+		std::unique_lock<std::mutex> Lock(m_Lock);
+		m_Queued.push_back(NewLoad);
+	}
+	m_LoadReady.notify_one();
+	m_Pending++;
+
+	return NewEntry.Texture;
+}
+
+
+// Function:		Update function
+// What it does:	Makes the textures the loader threads have finished decoding on the device, and swaps each one in for
+//					the placeholder. Only called from the thread that renders
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void TextureCacheClass::Update()
+{
+	HRESULT result;
+	list<Load> Finished;
+
+	// Take the finished files so the loader threads can carry on while the textures are made
+	{
+		std::unique_lock<std::mutex> Lock(m_Lock);
+		Finished.swap(m_Finished);
+	}
+
+	for (auto ThisLoad = Finished.begin(); ThisLoad != Finished.end(); ++ThisLoad)
+	{
+		ID3D11ShaderResourceView* View = 0;
+		m_Pending--;
+
+		if (ThisLoad->Decoded)
+		{
+			result = ThisLoad->Processor->CreateDeviceObject((void**)&View);
+			if (FAILED(result))
+			{
+				View = 0;
+			}
+		}
+		DestroyLoad(*ThisLoad);
+
+		// The texture may have been released while it was loading, or loaded already by an earlier request for the same file
+		auto Found = m_Textures.find(ThisLoad->Key);
+		if (Found != m_Textures.end())
+		{
+			Found->second.Loading = false;
+		}
+
+		if (!View)
+		{
+			m_Failures++;
+			continue;
+		}
+
+		if ((Found != m_Textures.end()) && (!Found->second.Loaded))
+		{
+			Found->second.Texture->SetTexture(View);
+			Found->second.Bytes = GetTextureBytes(View);
+			Found->second.Loaded = true;
+			m_Bytes += Found->second.Bytes;
+		}
+
+		// The texture holds its own reference to the view
+		View->Release();
+	}
+}
+
+
+// Function:		Is Loading function
+// What it does:	Checks if a texture is still waiting for its file. Once it isn't, the texture is either loaded or has
+//					kept the placeholder because the file couldn't be loaded
+// Takes in:		TextureClass - pointer to the texture
+// Returns:			True if the file is still being loaded, false if not
+
+bool TextureCacheClass::IsLoading(TextureClass* Texture)
+{
+	Entry* Found = FindEntry(Texture);
+	if (!Found)
+	{
+		return false;
+	}
+
+	return Found->Loading;
+}
+
+
+// Function:		Is Loaded function
+// What it does:	Checks if the file of a texture has been loaded and swapped in for the placeholder
+// Takes in:		TextureClass - pointer to the texture
+// Returns:			True if it has, false if not
+
+bool TextureCacheClass::IsLoaded(TextureClass* Texture)
+{
+	Entry* Found = FindEntry(Texture);
+	if (!Found)
+	{
+		return false;
+	}
+
+	return Found->Loaded;
+}
+
+
+// Function:		Release function
+// What it does:	Gives back a texture returned by Acquire, and frees it once it has no users left
+// Takes in:		TextureClass - pointer to the texture
+// Returns:			Nothing
+
+void TextureCacheClass::Release(TextureClass* Texture)
+{
+	if (!Texture)
+	{
+		return;
+	}
+
+	// There are only a few textures, so look through them for this one
+	for (auto Found = m_Textures.begin(); Found != m_Textures.end(); ++Found)
+	{
+		if (Found->second.Texture != Texture)
+		{
+			continue;
+		}
+
+		Found->second.Users--;
+		if (Found->second.Users <= 0)
+		{
+			m_Bytes -= Found->second.Bytes;
+			Texture->Shutdown();
+			delete Texture;
+			m_Textures.erase(Found);
+		}
+		return;
+	}
+}
+
+
+// Function:		Get Texture Count function
+// What it does:	Returns the number of textures held by the cache
+// Takes in:		Nothing
+// Returns:			int - Number of textures
+
+int TextureCacheClass::GetTextureCount()
+{
+	return m_Textures.size();
+}
+
+
+// Function:		Get Hits function
+// What it does:	Returns the number of requests that found the texture already loaded
+// Takes in:		Nothing
+// Returns:			int - Number of hits
+
+int TextureCacheClass::GetHits()
+{
+	return m_Hits;
+}
+
+
+// Function:		Get Misses function
+// What it does:	Returns the number of requests that had to load the texture
+// Takes in:		Nothing
+// Returns:			int - Number of misses
+
+int TextureCacheClass::GetMisses()
+{
+	return m_Misses;
+}
+
+
+// Function:		Get Bytes function
+// What it does:	Returns the video memory used by the textures held by the cache
+// Takes in:		Nothing
+// Returns:			unsigned long - Size in bytes
+
+unsigned long TextureCacheClass::GetBytes()
+{
+	return m_Bytes;
+}
+
+
+// Function:		Get Pending Count function
+// What it does:	Returns the number of files queued or being loaded that Update hasn't finished with yet
+// Takes in:		Nothing
+// Returns:			int - Number of files
+
+int TextureCacheClass::GetPendingCount()
+{
+	return m_Pending;
+}
+
+
+// Function:		Get Failures function
+// What it does:	Returns the number of files that couldn't be loaded, whose textures kept the placeholder
+// Takes in:		Nothing
+// Returns:			int - Number of files
+
+int TextureCacheClass::GetFailures()
+{
+	return m_Failures;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Stops the loader threads and frees every texture in the cache, whether or not it still has users
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void TextureCacheClass::Shutdown()
+{
+	// Stop the loader threads once they finish the file they are on
+	{
+		std::unique_lock<std::mutex> Lock(m_Lock);
+		m_Stopping = true;
+	}
+	m_LoadReady.notify_all();
+
+	for (unsigned int i = 0; i < m_Loaders.size(); i++)
+	{
+		m_Loaders[i].join();
+	}
+	m_Loaders.clear();
+
+	// Free the files that were never loaded or never made on the device
+	for (auto ThisLoad = m_Queued.begin(); ThisLoad != m_Queued.end(); ++ThisLoad)
+	{
+		DestroyLoad(*ThisLoad);
+	}
+	for (auto ThisLoad = m_Finished.begin(); ThisLoad != m_Finished.end(); ++ThisLoad)
+	{
+		DestroyLoad(*ThisLoad);
+	}
+	m_Queued.clear();
+	m_Finished.clear();
+	m_Pending = 0;
+
+	for (auto Texture = m_Textures.begin(); Texture != m_Textures.end(); ++Texture)
+	{
+		Texture->second.Texture->Shutdown();
+		delete Texture->second.Texture;
+	}
+
+	m_Textures.clear();
+	m_Bytes = 0;
+
+	if (m_Placeholder)
+	{
+		m_Placeholder->Release();
+		m_Placeholder = 0;
+	}
+
+	m_Device = 0;
+}
+
+
+// Function:		Loader Loop function
+// What it does:	Run by each loader thread. Takes files from the queue, reads and decodes them, and adds them to the
+//					finished list, until the cache is shut down
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void TextureCacheClass::LoaderLoop()
+{
+	HRESULT result;
+
+	while (true)
+	{
+		Load ThisLoad;
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			while ((!m_Stopping) && (m_Queued.empty()))
+			{
+				m_LoadReady.wait(Lock);
+			}
+			if (m_Stopping)
+			{
+				return;
+			}
+			ThisLoad = m_Queued.front();
+			m_Queued.pop_front();
+		}
+
+		// Read the file, then decode the image into memory. Nothing here uses the device context, so it is safe off the
+		// main thread
+		void* Data = 0;
+		SIZE_T Bytes = 0;
+		result = ThisLoad.Loader->Load();
+		if (SUCCEEDED(result))
+		{
+			result = ThisLoad.Loader->Decompress(&Data, &Bytes);
+		}
+		if (SUCCEEDED(result))
+		{
+			result = ThisLoad.Processor->Process(Data, Bytes);
+		}
+		ThisLoad.Decoded = SUCCEEDED(result);
+
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			m_Finished.push_back(ThisLoad);
+		}
+	}
+}
+
+
+// Function:		Create Placeholder function
+// What it does:	Makes the grey texture shown while files are loading
+// Takes in:		Nothing
+// Returns:			True if successful, false if not
+
+bool TextureCacheClass::CreatePlaceholder()
+{
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC TextureDesc;
+	D3D11_SUBRESOURCE_DATA PixelData;
+	ID3D11Texture2D* Texture = 0;
+
+	// One mid grey pixel, stretched over whatever it is drawn on
+	unsigned char Pixel[4] = { 128, 128, 128, 255 };
+
+	TextureDesc.Width = 1;
+	TextureDesc.Height = 1;
+	TextureDesc.MipLevels = 1;
+	TextureDesc.ArraySize = 1;
+	TextureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	TextureDesc.SampleDesc.Count = 1;
+	TextureDesc.SampleDesc.Quality = 0;
+	TextureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	TextureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	TextureDesc.CPUAccessFlags = 0;
+	TextureDesc.MiscFlags = 0;
+
+	PixelData.pSysMem = Pixel;
+	PixelData.SysMemPitch = sizeof(Pixel);
+	PixelData.SysMemSlicePitch = 0;
+
+	result = m_Device->CreateTexture2D(&TextureDesc, &PixelData, &Texture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = m_Device->CreateShaderResourceView(Texture, NULL, &m_Placeholder);
+	Texture->Release();
+	if (FAILED(result))
+	{
+		m_Placeholder = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
+// Function:		Destroy Load function
+// What it does:	Frees the loader and processor of a file
+// Takes in:		Load - reference to the file being loaded
+// Returns:			Nothing
+
+void TextureCacheClass::DestroyLoad(Load &ThisLoad)
+{
+	if (ThisLoad.Loader)
+	{
+		ThisLoad.Loader->Destroy();
+		ThisLoad.Loader = 0;
+	}
+
+	if (ThisLoad.Processor)
+	{
+		ThisLoad.Processor->Destroy();
+		ThisLoad.Processor = 0;
+	}
+}
+
+
+// Function:		Make Key function
+// What it does:	Makes the key a file is kept under, with back slashes turned to forward slashes and letters in lower case
+// Takes in:		WCHAR - Pointer to the file name
+// Returns:			wstring - Key
+
+wstring TextureCacheClass::MakeKey(WCHAR* Filename)
+{
+	wstring Key = Filename;
+	for (unsigned int i = 0; i < Key.size(); i++)
+	{
+		if (Key[i] == L'\\')
+		{
+			Key[i] = L'/';
+		}
+		else if ((Key[i] >= L'A') && (Key[i] <= L'Z'))
+		{
+			Key[i] = Key[i] - L'A' + L'a';
+		}
+	}
+
+	return Key;
+}
+
+
+// Function:		Find Entry function
+// What it does:	Finds the entry holding a texture
+// Takes in:		TextureClass - pointer to the texture
+// Returns:			Pointer to the entry, or 0 if the texture isn't in the cache
+
+TextureCacheClass::Entry* TextureCacheClass::FindEntry(TextureClass* Texture)
+{
+	// There are only a few textures, so look through them for this one
+	for (auto Found = m_Textures.begin(); Found != m_Textures.end(); ++Found)
+	{
+		if (Found->second.Texture == Texture)
+		{
+			return &Found->second;
+		}
+	}
+
+	return 0;
+}
+
+
+// Function:		Get Texture Bytes function
+// What it does:	Works out the video memory used by a texture and all its mip levels from its description
+// Takes in:		ID3D11ShaderResourceView - pointer to the texture
+// Returns:			unsigned long - Size in bytes (0 if it isn't a 2D texture)
+
+unsigned long TextureCacheClass::GetTextureBytes(ID3D11ShaderResourceView* View)
+{
+	ID3D11Resource* Resource = 0;
+	D3D11_RESOURCE_DIMENSION Dimension;
+	D3D11_TEXTURE2D_DESC Description;
+
+	if (!View)
+	{
+		return 0;
+	}
+
+	View->GetResource(&Resource);
+	if (!Resource)
+	{
+		return 0;
+	}
+
+	Resource->GetType(&Dimension);
+	if (Dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+	{
+		Resource->Release();
+		return 0;
+	}
+
+	((ID3D11Texture2D*)Resource)->GetDesc(&Description);
+	Resource->Release();
+
+	// Block compressed formats use 4 or 8 bits a pixel in blocks of 4 by 4, everything loaded from the image files here
+	// uses 32 bits a pixel
+	unsigned long BitsPerPixel = 32;
+	bool Blocks = false;
+	switch (Description.Format)
+	{
+	case DXGI_FORMAT_BC1_UNORM:
+		BitsPerPixel = 4;
+		Blocks = true;
+		break;
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC3_UNORM:
+		BitsPerPixel = 8;
+		Blocks = true;
+		break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		BitsPerPixel = 64;
+		break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		BitsPerPixel = 128;
+		break;
+	default:
+		break;
+	}
+
+	// Add up each mip level of each slice, halving the size each level
+	unsigned long Bytes = 0;
+	unsigned long Width = Description.Width;
+	unsigned long Height = Description.Height;
+	for (unsigned int i = 0; i < Description.MipLevels; i++)
+	{
+		unsigned long LevelWidth = Blocks ? ((Width + 3) / 4) * 4 : Width;
+		unsigned long LevelHeight = Blocks ? ((Height + 3) / 4) * 4 : Height;
+		Bytes += (LevelWidth * LevelHeight * BitsPerPixel) / 8;
+
+		Width = (Width > 1) ? Width / 2 : 1;
+		Height = (Height > 1) ? Height / 2 : 1;
+	}
+
+	return Bytes * Description.ArraySize;
+}
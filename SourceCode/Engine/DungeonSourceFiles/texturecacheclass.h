@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: texturecacheclass.h
+// Texture Cache Class
+// Loads each texture file once, on loader threads, and shares it between everything that uses it
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TEXTURE_CACHE_CLASS_H
+#define TEXTURE_CACHE_CLASS_H
+
+#include <d3d11.h>
+#include <d3dx11async.h>
+#include "textureclass.h"
+
+// For the file names used as keys
+#include <string>
+using std::wstring;
+
+// For map
+#include <map>
+using std::map;
+
+// For list
+#include <list>
+using std::list;
+
+// For vector
+#include <vector>
+using std::vector;
+
+// For the loader threads and waking them up
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// The number of threads texture files are read and decoded on
+#define TEXTURE_LOADER_THREADS 2
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureCacheClass
+// Textures are looked up by file name (with the slashes and case made the same, so two spellings of a path share a texture).
+// The first request for a file loads it, and every later request returns the same texture and adds to its count of users.
+// Each user gives the texture back with Release, and the texture is freed when its last user has given it back. The cache
+// counts the requests that found a loaded texture (hits), the ones that had to load it (misses), and the video memory
+// used by the textures it holds.
+// Files are not loaded while they are requested. The file is queued, and the loader threads read and decode it into memory
+// while generation carries on. Until then the texture shows a small grey placeholder. Update is called once a frame on the
+// main thread to make the textures that have finished decoding on the device and swap them in for the placeholder, so
+// everything holding the texture draws with the real one from then on
+////////////////////////////////////////////////////////////////////////////////
+class TextureCacheClass
+{
+public:
+	// Function:		Texture Cache constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	TextureCacheClass();
+
+
+	// Placeholder destructor
+	~TextureCacheClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Sets the device the textures are loaded with, makes the placeholder texture and starts the loader threads
+	// Takes in:		ID3D11Device - pointer to the device
+	// Returns:			True if successful, false if not
+	bool Initialise(ID3D11Device* Device);
+
+
+	// Function:		Acquire function
+	// What it does:	Returns the texture for a file and adds a user to it. A file that isn't in the cache yet is queued for
+	//					the loader threads, and its texture shows the placeholder until Update swaps the loaded one in
+	// Takes in:		WCHAR - Pointer to the texture file name
+	// Returns:			TextureClass - pointer to the shared texture, or 0 if it couldn't be made
+	TextureClass* Acquire(WCHAR* Filename);
+
+
+	// Function:		Acquire function
+	// What it does:	As above, but the image is scaled to a square of the given size and kept as 8 bit RGBA with all its mip
+	//					levels, so it can be copied into a texture array. It is kept apart from the texture loaded at the file's size
+	// Takes in:		WCHAR - Pointer to the texture file name, int - Width and height to load it at (0 keeps the file's size)
+	// Returns:			TextureClass - pointer to the shared texture, or 0 if it couldn't be made
+	TextureClass* Acquire(WCHAR* Filename, int Size);
+
+
+	// Function:		Is Loading function
+	// What it does:	Checks if a texture is still waiting for its file. Once it isn't, the texture is either loaded or has
+	//					kept the placeholder because the file couldn't be loaded
+	// Takes in:		TextureClass - pointer to the texture
+	// Returns:			True if the file is still being loaded, false if not
+	bool IsLoading(TextureClass* Texture);
+
+
+	// Function:		Is Loaded function
+	// What it does:	Checks if the file of a texture has been loaded and swapped in for the placeholder
+	// Takes in:		TextureClass - pointer to the texture
+	// Returns:			True if it has, false if not
+	bool IsLoaded(TextureClass* Texture);
+
+
+	// Function:		Update function
+	// What it does:	Makes the textures the loader threads have finished decoding on the device, and swaps each one in for
+	//					the placeholder. Only called from the thread that renders
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Update();
+
+
+	// Function:		Release function
+	// What it does:	Gives back a texture returned by Acquire, and frees it once it has no users left
+	// Takes in:		TextureClass - pointer to the texture
+	// Returns:			Nothing
+	void Release(TextureClass* Texture);
+
+
+	// Functions to get the number of textures held, the number of hits and misses, and the video memory the textures use in bytes
+	int GetTextureCount();
+	int GetHits();
+	int GetMisses();
+	unsigned long GetBytes();
+
+	// Functions to get the number of files still being loaded, and the number that couldn't be loaded (and kept the placeholder)
+	int GetPendingCount();
+	int GetFailures();
+
+
+	// Function:		Shutdown function
+	// What it does:	Stops the loader threads and frees every texture in the cache, whether or not it still has users
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// A texture in the cache, with its number of users and size. Loading is true until the loader threads and Update are
+	// done with its file, and Loaded is false while it shows the placeholder
+	struct Entry
+	{
+		TextureClass* Texture;
+		int Users;
+		unsigned long Bytes;
+		bool Loading;
+		bool Loaded;
+	};
+
+	// A file being loaded. The loader reads the file and the processor decodes it on a loader thread, then the processor
+	// makes the texture on the device in Update
+	struct Load
+	{
+		wstring Key;
+		ID3DX11DataLoader* Loader;
+		ID3DX11DataProcessor* Processor;
+		bool Decoded;
+	};
+
+
+	// Function:		Loader Loop function
+	// What it does:	Run by each loader thread. Takes files from the queue, reads and decodes them, and adds them to the
+	//					finished list, until the cache is shut down
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void LoaderLoop();
+
+
+	// Function:		Create Placeholder function
+	// What it does:	Makes the grey texture shown while files are loading
+	// Takes in:		Nothing
+	// Returns:			True if successful, false if not
+	bool CreatePlaceholder();
+
+
+	// Function:		Destroy Load function
+	// What it does:	Frees the loader and processor of a file
+	// Takes in:		Load - reference to the file being loaded
+	// Returns:			Nothing
+	static void DestroyLoad(Load &ThisLoad);
+
+
+	// Function:		Make Key function
+	// What it does:	Makes the key a file is kept under, with back slashes turned to forward slashes and letters in lower case
+	// Takes in:		WCHAR - Pointer to the file name
+	// Returns:			wstring - Key
+	static wstring MakeKey(WCHAR* Filename);
+
+
+	// Function:		Find Entry function
+	// What it does:	Finds the entry holding a texture
+	// Takes in:		TextureClass - pointer to the texture
+	// Returns:			Pointer to the entry, or 0 if the texture isn't in the cache
+	Entry* FindEntry(TextureClass* Texture);
+
+
+	// Function:		Get Texture Bytes function
+	// What it does:	Works out the video memory used by a texture and all its mip levels from its description
+	// Takes in:		ID3D11ShaderResourceView - pointer to the texture
+	// Returns:			unsigned long - Size in bytes (0 if it isn't a 2D texture)
+	static unsigned long GetTextureBytes(ID3D11ShaderResourceView* View);
+
+private:
+	ID3D11Device* m_Device;
+	map<wstring, Entry> m_Textures;
+	ID3D11ShaderResourceView* m_Placeholder;
+
+	// Loader threads, the files waiting for them and the files they have finished, and the lock and signal used to hand
+	// them files
+	vector<std::thread> m_Loaders;
+	list<Load> m_Queued;
+	list<Load> m_Finished;
+	std::mutex m_Lock;
+	std::condition_variable m_LoadReady;
+	bool m_Stopping;
+
+	// Counters
+	int m_Hits;
+	int m_Misses;
+	unsigned long m_Bytes;
+	int m_Pending;
+	int m_Failures;
+};
+
+
+#endif
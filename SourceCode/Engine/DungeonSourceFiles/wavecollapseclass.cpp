@@ -0,0 +1,507 @@
+#include "wavecollapseclass.h"
+
+
+// Offsets to the neighbouring cell on each side, in the same order as the sockets (left, up, right, down)
+static const int SideX[4] = { -1, 0, 1, 0 };
+static const int SideY[4] = { 0, 1, 0, -1 };
+
+
+// Function:		Count Bits function
+// What it does:	Counts the set bits in a domain by adding neighbouring groups of bits together in parallel
+// Takes in:		WaveDomain - Domain to count
+// Returns:			int - Number of tiles in the domain
+
+static int CountBits(WaveDomain Domain)
+{
+	Domain = Domain - ((Domain >> 1) & 0x55555555);
+	Domain = (Domain & 0x33333333) + ((Domain >> 2) & 0x33333333);
+	Domain = (Domain + (Domain >> 4)) & 0x0F0F0F0F;
+	return (int)((Domain * 0x01010101) >> 24);
+}
+
+
+// Function:		Wave Collapse constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+WaveCollapseClass::WaveCollapseClass()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_TileCount = 0;
+	m_AllTiles = 0;
+	m_Backtracks = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		m_OpenTiles[i] = 0;
+	}
+}
+
+
+// Placeholder destructor
+WaveCollapseClass::~WaveCollapseClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Allocates the cells for a map of the given size and clears the tile set
+// Takes in:		int - Width of the map in tiles, int - Height of the map in tiles
+// Returns:			True if the map was created, false if the size isn't valid
+
+bool WaveCollapseClass::Initialise(int Width, int Height)
+{
+	if ((Width <= 0) || (Height <= 0))
+	{
+		return false;
+	}
+
+	m_Width = Width;
+	m_Height = Height;
+	m_Domains.assign(m_Width * m_Height, 0);
+
+	m_TileCount = 0;
+	m_AllTiles = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_OpenTiles[i] = 0;
+	}
+
+	return true;
+}
+
+
+// Function:		Add Tile function
+// What it does:	Adds a tile to the tile set. Must be called before Reset
+// Takes in:		int - Sockets of the tile (WAVE_SOCKET bits), int - Weight used when picking between tiles
+// Returns:			int - Index of the new tile, or -1 if the tile set is full
+
+int WaveCollapseClass::AddTile(int Sockets, int Weight)
+{
+	if (m_TileCount >= WAVE_MAX_TILES)
+	{
+		return -1;
+	}
+
+	int Tile = m_TileCount;
+	m_Sockets[Tile] = Sockets;
+	m_Weights[Tile] = (Weight > 0) ? Weight : 1;
+	m_AllTiles |= (1u << Tile);
+
+	// Add the tile to the open set of each side it has a socket on, so propagation only needs one AND per side
+	for (int Side = 0; Side < 4; Side++)
+	{
+		if (Sockets & (1 << Side))
+		{
+			m_OpenTiles[Side] |= (1u << Tile);
+		}
+	}
+
+	m_TileCount++;
+	return Tile;
+}
+
+
+// Function:		Reset function
+// What it does:	Sets every cell back to all of the tiles, then removes tiles with sockets that would lead out of the map
+//					from the cells on the edges
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void WaveCollapseClass::Reset()
+{
+	m_Domains.assign(m_Width * m_Height, m_AllTiles);
+	m_PropagateStack.clear();
+	m_Trail.clear();
+	m_Decisions.clear();
+	m_Heap = priority_queue<unsigned long long, vector<unsigned long long>, std::greater<unsigned long long> >();
+	m_Backtracks = 0;
+
+	// Cells on the edges of the map can't have a socket leading off the map
+	for (int y = 0; y < m_Height; y++)
+	{
+		for (int x = 0; x < m_Width; x++)
+		{
+			WaveDomain Allowed = m_AllTiles;
+			for (int Side = 0; Side < 4; Side++)
+			{
+				int nx = x + SideX[Side];
+				int ny = y + SideY[Side];
+				if ((nx < 0) || (ny < 0) || (nx >= m_Width) || (ny >= m_Height))
+				{
+					Allowed &= ~m_OpenTiles[Side];
+				}
+			}
+
+			m_Domains[(y * m_Width) + x] = Allowed;
+		}
+	}
+
+	// Add every cell to the heap so the first pick can see all of them
+	for (int Cell = 0; Cell < m_Width * m_Height; Cell++)
+	{
+		PushCell(Cell);
+	}
+
+	// Queue the edge cells so their neighbours are updated on the first run
+	for (int x = 0; x < m_Width; x++)
+	{
+		m_PropagateStack.push_back(x);
+		m_PropagateStack.push_back(((m_Height - 1) * m_Width) + x);
+	}
+	for (int y = 0; y < m_Height; y++)
+	{
+		m_PropagateStack.push_back(y * m_Width);
+		m_PropagateStack.push_back((y * m_Width) + m_Width - 1);
+	}
+}
+
+
+// Function:		Set Tile function
+// What it does:	Forces a cell to be the given tile before the collapse is run (used for the entrance)
+// Takes in:		int - X cell, int - Y cell, int - Tile index
+// Returns:			True if the tile can go in this cell, false if not
+
+bool WaveCollapseClass::SetTile(int x, int y, int Tile)
+{
+	if ((x < 0) || (y < 0) || (x >= m_Width) || (y >= m_Height) || (Tile < 0) || (Tile >= m_TileCount))
+	{
+		return false;
+	}
+
+	return Restrict((y * m_Width) + x, 1u << Tile);
+}
+
+
+// Function:		Run function
+// What it does:	Collapses the map one cell at a time, always picking the cell with the fewest possible tiles and a weighted
+//					random tile for it, then propagates the change to the neighbouring cells. If a cell runs out of tiles the last
+//					choice is undone and that tile is banned, up to the backtrack limit
+// Takes in:		int - Most backtracks allowed, int - Timeout in milliseconds (0 for no timeout)
+// Returns:			int - WAVE_SOLVED if every cell has a tile, WAVE_CONTRADICTION if no map could be found
+//					within the backtrack limit, WAVE_TIMEOUT if the time ran out
+
+int WaveCollapseClass::Run(int BacktrackLimit, int TimeoutMs)
+{
+	clock_t StartTime = clock();
+	clock_t TimeLimit = (clock_t)(((long long)TimeoutMs * CLOCKS_PER_SEC) / 1000);
+
+	// Apply the edge rules and any tiles that were set before the run
+	if (!Propagate())
+	{
+		return WAVE_CONTRADICTION;
+	}
+
+	while (true)
+	{
+		// Stop if the collapse has taken too long so that the caller can fall back to something else
+		if ((TimeoutMs > 0) && ((clock() - StartTime) > TimeLimit))
+		{
+			return WAVE_TIMEOUT;
+		}
+
+		int Cell = PickCell();
+		if (Cell < 0)
+		{
+			return WAVE_SOLVED;
+		}
+
+		// Remember the choice so it can be undone, then collapse the cell to the chosen tile
+		Decision NewDecision;
+		NewDecision.TrailSize = (int)m_Trail.size();
+		NewDecision.Cell = Cell;
+		NewDecision.Tile = PickTile(m_Domains[Cell]);
+		m_Decisions.push_back(NewDecision);
+
+		bool result = Restrict(Cell, 1u << NewDecision.Tile) && Propagate();
+
+		// If the choice led to a contradiction, undo it and ban that tile from the cell instead
+		// If banning the tile also fails, keep going back through earlier choices
+		while (!result)
+		{
+			if ((m_Decisions.empty()) || (m_Backtracks >= BacktrackLimit))
+			{
+				return WAVE_CONTRADICTION;
+			}
+			m_Backtracks++;
+
+			Decision Last = m_Decisions.back();
+			m_Decisions.pop_back();
+			Undo(Last.TrailSize);
+
+			result = Restrict(Last.Cell, m_Domains[Last.Cell] & ~(1u << Last.Tile)) && Propagate();
+		}
+	}
+}
+
+
+// Function:		Restrict function
+// What it does:	Removes every tile not in the given bitset from a cell, records the change in the trail and queues the cell
+//					so its neighbours are updated
+// Takes in:		int - Cell index, WaveDomain - Tiles the cell is allowed to keep
+// Returns:			True if the cell still has a tile, false if it has run out (a contradiction)
+
+bool WaveCollapseClass::Restrict(int Cell, WaveDomain Allowed)
+{
+	WaveDomain OldDomain = m_Domains[Cell];
+	WaveDomain NewDomain = OldDomain & Allowed;
+
+	// Nothing to do if every tile in the cell is allowed
+	if (NewDomain == OldDomain)
+	{
+		return true;
+	}
+
+	if (NewDomain == 0)
+	{
+		m_PropagateStack.clear();
+		return false;
+	}
+
+	TrailEntry Entry;
+	Entry.Cell = Cell;
+	Entry.OldDomain = OldDomain;
+	m_Trail.push_back(Entry);
+
+	m_Domains[Cell] = NewDomain;
+	m_PropagateStack.push_back(Cell);
+	PushCell(Cell);
+
+	return true;
+}
+
+
+// Function:		Propagate function
+// What it does:	Updates the neighbours of every queued cell until no more cells change
+// Takes in:		Nothing
+// Returns:			True if there were no contradictions, false if a cell ran out of tiles
+
+bool WaveCollapseClass::Propagate()
+{
+	while (!m_PropagateStack.empty())
+	{
+		int Cell = m_PropagateStack.back();
+		m_PropagateStack.pop_back();
+
+		int x = Cell % m_Width;
+		int y = Cell / m_Width;
+		WaveDomain Domain = m_Domains[Cell];
+
+		for (int Side = 0; Side < 4; Side++)
+		{
+			int nx = x + SideX[Side];
+			int ny = y + SideY[Side];
+			if ((nx < 0) || (ny < 0) || (nx >= m_Width) || (ny >= m_Height))
+			{
+				continue;
+			}
+
+			// The neighbour's socket facing this cell must match. If any tile left in this cell is open on this side
+			// the neighbour can be open on its opposite side, and if any tile is closed the neighbour can be closed
+			int Opposite = (Side + 2) % 4;
+			WaveDomain Allowed = 0;
+			if (Domain & m_OpenTiles[Side])
+			{
+				Allowed |= m_OpenTiles[Opposite];
+			}
+			if (Domain & ~m_OpenTiles[Side])
+			{
+				Allowed |= m_AllTiles & ~m_OpenTiles[Opposite];
+			}
+
+			if (!Restrict((ny * m_Width) + nx, Allowed))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+// Function:		Pick Cell function
+// What it does:	Takes cells from the heap until it finds one that is up to date and hasn't collapsed yet
+// Takes in:		Nothing
+// Returns:			int - Cell index, or -1 if every cell has collapsed
+
+int WaveCollapseClass::PickCell()
+{
+	while (!m_Heap.empty())
+	{
+		unsigned long long Key = m_Heap.top();
+		m_Heap.pop();
+
+		// The key holds the tile count in the top bits, so skip it if the cell has changed since it was pushed
+		int Cell = (int)(Key & 0xFFFFFFFFULL);
+		int Count = (int)(Key >> 48);
+		int CurrentCount = CountBits(m_Domains[Cell]);
+		if ((CurrentCount > 1) && (CurrentCount == Count))
+		{
+			return Cell;
+		}
+	}
+
+	return -1;
+}
+
+
+// Function:		Pick Tile function
+// What it does:	Picks a random tile from a bitset using the tile weights
+// Takes in:		WaveDomain - Tiles to pick from
+// Returns:			int - Tile index
+
+int WaveCollapseClass::PickTile(WaveDomain Domain)
+{
+	int TotalWeight = 0;
+	for (int Tile = 0; Tile < m_TileCount; Tile++)
+	{
+		if (Domain & (1u << Tile))
+		{
+			TotalWeight += m_Weights[Tile];
+		}
+	}
+
+	int Chance = rand() % TotalWeight;
+	int LastTile = 0;
+	for (int Tile = 0; Tile < m_TileCount; Tile++)
+	{
+		if (Domain & (1u << Tile))
+		{
+			Chance -= m_Weights[Tile];
+			if (Chance < 0)
+			{
+				return Tile;
+			}
+			LastTile = Tile;
+		}
+	}
+
+	return LastTile;
+}
+
+
+// Function:		Push Cell function
+// What it does:	Adds a cell to the heap keyed by the number of tiles it has left, with a random tie break
+// Takes in:		int - Cell index
+// Returns:			Nothing
+
+void WaveCollapseClass::PushCell(int Cell)
+{
+	unsigned long long Count = CountBits(m_Domains[Cell]);
+	if (Count <= 1)
+	{
+		return;
+	}
+
+	// Tile count in the top 16 bits, a random value in the next 16 so ties are broken randomly, then the cell index
+	unsigned long long Noise = (unsigned long long)(rand() & 0xFFFF);
+	m_Heap.push((Count << 48) | (Noise << 32) | (unsigned long long)Cell);
+}
+
+
+// Function:		Undo function
+// What it does:	Restores cells from the trail until it is back to the given size
+// Takes in:		int - Size of the trail to go back to
+// Returns:			Nothing
+
+void WaveCollapseClass::Undo(int TrailSize)
+{
+	while ((int)m_Trail.size() > TrailSize)
+	{
+		TrailEntry Entry = m_Trail.back();
+		m_Trail.pop_back();
+		m_Domains[Entry.Cell] = Entry.OldDomain;
+
+		// The restored cell has more tiles than when it was last pushed, so push it again
+		PushCell(Entry.Cell);
+	}
+
+	m_PropagateStack.clear();
+}
+
+
+// Function:		Get Tile function
+// What it does:	Returns the tile a cell has collapsed to
+// Takes in:		int - X cell, int - Y cell
+// Returns:			int - Tile index, or -1 if the cell is outside the map or hasn't collapsed to a single tile
+
+int WaveCollapseClass::GetTile(int x, int y)
+{
+	if ((x < 0) || (y < 0) || (x >= m_Width) || (y >= m_Height))
+	{
+		return -1;
+	}
+
+	WaveDomain Domain = m_Domains[(y * m_Width) + x];
+	if (CountBits(Domain) != 1)
+	{
+		return -1;
+	}
+
+	int Tile = 0;
+	while (!(Domain & (1u << Tile)))
+	{
+		Tile++;
+	}
+
+	return Tile;
+}
+
+
+// Function:		Get Tile Sockets function
+// What it does:	Returns the sockets of a tile in the tile set
+// Takes in:		int - Tile index
+// Returns:			int - WAVE_SOCKET bits of the tile
+
+int WaveCollapseClass::GetTileSockets(int Tile)
+{
+	if ((Tile < 0) || (Tile >= m_TileCount))
+	{
+		return 0;
+	}
+
+	return m_Sockets[Tile];
+}
+
+
+// Function:		Get Backtracks function
+// What it does:	Returns the amount of times the last run had to backtrack
+// Takes in:		Nothing
+// Returns:			int - Backtrack count
+
+int WaveCollapseClass::GetBacktracks()
+{
+	return m_Backtracks;
+}
+
+
+// Functions to get the size of the map in tiles
+int WaveCollapseClass::GetWidth()
+{
+	return m_Width;
+}
+
+int WaveCollapseClass::GetHeight()
+{
+	return m_Height;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Releases the cells and the tile set
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void WaveCollapseClass::Shutdown()
+{
+	vector<WaveDomain>().swap(m_Domains);
+	vector<int>().swap(m_PropagateStack);
+	vector<TrailEntry>().swap(m_Trail);
+	vector<Decision>().swap(m_Decisions);
+	m_Heap = priority_queue<unsigned long long, vector<unsigned long long>, std::greater<unsigned long long> >();
+	m_TileCount = 0;
+	m_AllTiles = 0;
+}
@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: wavecollapseclass.h
+// Wave Collapse Class
+// Generates tile maps with wave function collapse, storing the possible tiles of each cell as a bitset
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WAVE_COLLAPSE_CLASS_H
+#define WAVE_COLLAPSE_CLASS_H
+
+// For rand and clock
+#include <stdlib.h>
+#include <time.h>
+
+// For vector and priority_queue
+#include <vector>
+#include <queue>
+#include <functional>
+using std::vector;
+using std::priority_queue;
+
+// The most tiles a tile set can hold (one bit of a domain per tile)
+#define WAVE_MAX_TILES 32
+
+// Socket bits for the sides of a tile. A socket is open if the tile has a door or passage on that side
+#define WAVE_SOCKET_LEFT 1
+#define WAVE_SOCKET_UP 2
+#define WAVE_SOCKET_RIGHT 4
+#define WAVE_SOCKET_DOWN 8
+
+// Results of running the collapse
+#define WAVE_SOLVED 0
+#define WAVE_CONTRADICTION 1
+#define WAVE_TIMEOUT 2
+
+typedef unsigned int WaveDomain;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: WaveCollapseClass
+// Holds a grid of cells where each cell is a bitset of the tiles it could still become. Tiles are described by their
+// four sockets and two neighbouring tiles fit if the sockets on their shared side are both open or both closed.
+// Propagation narrows a neighbour's bitset with a single AND per side, the lowest entropy cell (fewest bits set) is
+// found with a min heap, and contradictions are undone by backtracking through a trail of changed cells
+////////////////////////////////////////////////////////////////////////////////
+class WaveCollapseClass
+{
+public:
+	// Function:		Wave Collapse constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	WaveCollapseClass();
+
+
+	// Placeholder destructor
+	~WaveCollapseClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Allocates the cells for a map of the given size and clears the tile set
+	// Takes in:		int - Width of the map in tiles, int - Height of the map in tiles
+	// Returns:			True if the map was created, false if the size isn't valid
+	bool Initialise(int Width, int Height);
+
+
+	// Function:		Add Tile function
+	// What it does:	Adds a tile to the tile set. Must be called before Reset
+	// Takes in:		int - Sockets of the tile (WAVE_SOCKET bits), int - Weight used when picking between tiles
+	// Returns:			int - Index of the new tile, or -1 if the tile set is full
+	int AddTile(int Sockets, int Weight);
+
+
+	// Function:		Reset function
+	// What it does:	Sets every cell back to all of the tiles, then removes tiles with sockets that would lead out of the map
+	//					from the cells on the edges
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Reset();
+
+
+	// Function:		Set Tile function
+	// What it does:	Forces a cell to be the given tile before the collapse is run (used for the entrance)
+	// Takes in:		int - X cell, int - Y cell, int - Tile index
+	// Returns:			True if the tile can go in this cell, false if not
+	bool SetTile(int x, int y, int Tile);
+
+
+	// Function:		Run function
+	// What it does:	Collapses the map one cell at a time, always picking the cell with the fewest possible tiles and a weighted
+	//					random tile for it, then propagates the change to the neighbouring cells. If a cell runs out of tiles the last
+	//					choice is undone and that tile is banned, up to the backtrack limit
+	// Takes in:		int - Most backtracks allowed, int - Timeout in milliseconds (0 for no timeout)
+	// Returns:			int - WAVE_SOLVED if every cell has a tile, WAVE_CONTRADICTION if no map could be found
+	//					within the backtrack limit, WAVE_TIMEOUT if the time ran out
+	int Run(int BacktrackLimit, int TimeoutMs);
+
+
+	// Function:		Get Tile function
+	// What it does:	Returns the tile a cell has collapsed to
+	// Takes in:		int - X cell, int - Y cell
+	// Returns:			int - Tile index, or -1 if the cell is outside the map or hasn't collapsed to a single tile
+	int GetTile(int x, int y);
+
+
+	// Function:		Get Tile Sockets function
+	// What it does:	Returns the sockets of a tile in the tile set
+	// Takes in:		int - Tile index
+	// Returns:			int - WAVE_SOCKET bits of the tile
+	int GetTileSockets(int Tile);
+
+
+	// Function:		Get Backtracks function
+	// What it does:	Returns the amount of times the last run had to backtrack
+	// Takes in:		Nothing
+	// Returns:			int - Backtrack count
+	int GetBacktracks();
+
+
+	// Functions to get the size of the map in tiles
+	int GetWidth();
+	int GetHeight();
+
+
+	// Function:		Shutdown function
+	// What it does:	Releases the cells and the tile set
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// A change to a cell, so that it can be undone when backtracking
+	struct TrailEntry
+	{
+		int Cell;
+		WaveDomain OldDomain;
+	};
+
+	// A choice made by the collapse, with the size of the trail before it was made
+	struct Decision
+	{
+		int TrailSize;
+		int Cell;
+		int Tile;
+	};
+
+
+	// Function:		Restrict function
+	// What it does:	Removes every tile not in the given bitset from a cell, records the change in the trail and queues the cell
+	//					so its neighbours are updated
+	// Takes in:		int - Cell index, WaveDomain - Tiles the cell is allowed to keep
+	// Returns:			True if the cell still has a tile, false if it has run out (a contradiction)
+	bool Restrict(int Cell, WaveDomain Allowed);
+
+
+	// Function:		Propagate function
+	// What it does:	Updates the neighbours of every queued cell until no more cells change
+	// Takes in:		Nothing
+	// Returns:			True if there were no contradictions, false if a cell ran out of tiles
+	bool Propagate();
+
+
+	// Function:		Pick Cell function
+	// What it does:	Takes cells from the heap until it finds one that is up to date and hasn't collapsed yet
+	// Takes in:		Nothing
+	// Returns:			int - Cell index, or -1 if every cell has collapsed
+	int PickCell();
+
+
+	// Function:		Pick Tile function
+	// What it does:	Picks a random tile from a bitset using the tile weights
+	// Takes in:		WaveDomain - Tiles to pick from
+	// Returns:			int - Tile index
+	int PickTile(WaveDomain Domain);
+
+
+	// Function:		Push Cell function
+	// What it does:	Adds a cell to the heap keyed by the number of tiles it has left, with a random tie break
+	// Takes in:		int - Cell index
+	// Returns:			Nothing
+	void PushCell(int Cell);
+
+
+	// Function:		Undo function
+	// What it does:	Restores cells from the trail until it is back to the given size
+	// Takes in:		int - Size of the trail to go back to
+	// Returns:			Nothing
+	void Undo(int TrailSize);
+
+private:
+	// Map variables
+	int m_Width;
+	int m_Height;
+	vector<WaveDomain> m_Domains;
+
+	// Tile set variables
+	int m_TileCount;
+	int m_Sockets[WAVE_MAX_TILES];
+	int m_Weights[WAVE_MAX_TILES];
+	WaveDomain m_AllTiles;
+	// The tiles with an open socket on each side (left, up, right, down)
+	WaveDomain m_OpenTiles[4];
+
+	// Collapse variables
+	vector<int> m_PropagateStack;
+	vector<TrailEntry> m_Trail;
+	vector<Decision> m_Decisions;
+	priority_queue<unsigned long long, vector<unsigned long long>, std::greater<unsigned long long> > m_Heap;
+	int m_Backtracks;
+};
+
+
+#endif
@@ -0,0 +1,187 @@
+#include "workerpoolclass.h"
+
+
+// Function:		Worker Pool constructor
+// What it does:	Initialises all variables to their defaults
+// Takes in:		Nothing
+// Returns:			Nothing
+
+WorkerPoolClass::WorkerPoolClass()
+{
+	m_Job = 0;
+	m_Data = 0;
+	m_JobCount = 0;
+	m_NextJob = 0;
+	m_JobsFinished = 0;
+	m_Generation = 0;
+	m_WorkersBusy = 0;
+	m_Stopping = false;
+}
+
+
+// Placeholder destructor
+WorkerPoolClass::~WorkerPoolClass()
+{
+}
+
+
+// Function:		Initialise function
+// What it does:	Starts the worker threads. The thread calling Run counts as one of the threads
+// Takes in:		int - Number of threads to run jobs on (1 runs every job on the thread calling Run)
+// Returns:			True if the threads were started, false if the count isn't valid
+
+bool WorkerPoolClass::Initialise(int ThreadCount)
+{
+	if (ThreadCount < 1)
+	{
+		return false;
+	}
+
+	Shutdown();
+
+	m_Stopping = false;
+	for (int i = 1; i < ThreadCount; i++)
+	{
+		m_Threads.push_back(std::thread(&WorkerPoolClass::WorkerLoop, this));
+	}
+
+	return true;
+}
+
+
+// Function:		Run function
+// What it does:	Runs a set of jobs across the threads and waits for all of them to finish
+// Takes in:		WorkerJob - the function run for each job, void - pointer passed to every job, int - Number of jobs
+// Returns:			Nothing
+
+void WorkerPoolClass::Run(WorkerJob Job, void* Data, int JobCount)
+{
+	if (JobCount <= 0)
+	{
+		return;
+	}
+
+	// With no workers, or only one job, there is nothing to hand out
+	if (m_Threads.empty() || (JobCount == 1))
+	{
+		for (int i = 0; i < JobCount; i++)
+		{
+			Job(Data, i);
+		}
+		return;
+	}
+
+	// Hand the set of jobs to the workers
+	{
+		std::unique_lock<std::mutex> Lock(m_Lock);
+		m_Job = Job;
+		m_Data = Data;
+		m_JobCount = JobCount;
+		m_NextJob = 0;
+		m_JobsFinished = 0;
+		m_Generation++;
+	}
+	m_JobsReady.notify_all();
+
+	// Work on the jobs on this thread as well
+	WorkOnJobs();
+
+	// Wait for every job to finish, and for every worker to stop looking at this set before it is replaced
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	while ((m_JobsFinished < m_JobCount) || (m_WorkersBusy > 0))
+	{
+		m_JobsDone.wait(Lock);
+	}
+	m_Job = 0;
+	m_Data = 0;
+	m_JobCount = 0;
+}
+
+
+// Function:		Get Thread Count function
+// What it does:	Returns the number of threads jobs are run on, including the thread calling Run
+// Takes in:		Nothing
+// Returns:			int - Number of threads
+
+int WorkerPoolClass::GetThreadCount()
+{
+	return m_Threads.size() + 1;
+}
+
+
+// Function:		Shutdown function
+// What it does:	Stops the worker threads and waits for them to finish
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void WorkerPoolClass::Shutdown()
+{
+	{
+		std::unique_lock<std::mutex> Lock(m_Lock);
+		m_Stopping = true;
+	}
+	m_JobsReady.notify_all();
+
+	for (unsigned int i = 0; i < m_Threads.size(); i++)
+	{
+		m_Threads[i].join();
+	}
+	m_Threads.clear();
+}
+
+
+// Function:		Worker Loop function
+// What it does:	Run by each worker thread. Waits for a set of jobs, works on them until none are left, then waits again
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void WorkerPoolClass::WorkerLoop()
+{
+	int LastGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			while ((!m_Stopping) && ((m_Generation == LastGeneration) || (m_Job == 0)))
+			{
+				m_JobsReady.wait(Lock);
+			}
+			if (m_Stopping)
+			{
+				return;
+			}
+			LastGeneration = m_Generation;
+			m_WorkersBusy++;
+		}
+
+		WorkOnJobs();
+
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			m_WorkersBusy--;
+		}
+		m_JobsDone.notify_all();
+	}
+}
+
+
+// Function:		Work On Jobs function
+// What it does:	Takes jobs from the current set and runs them until none are left
+// Takes in:		Nothing
+// Returns:			Nothing
+
+void WorkerPoolClass::WorkOnJobs()
+{
+	while (true)
+	{
+		int Index = m_NextJob++;
+		if (Index >= m_JobCount)
+		{
+			return;
+		}
+
+		m_Job(m_Data, Index);
+		m_JobsFinished++;
+	}
+}
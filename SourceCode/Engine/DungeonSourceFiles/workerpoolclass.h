@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: workerpoolclass.h
+// Worker Pool Class
+// Runs numbered jobs across a fixed set of worker threads
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef WORKER_POOL_CLASS_H
+#define WORKER_POOL_CLASS_H
+
+// For the worker threads and waking them up
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// For vector
+#include <vector>
+using std::vector;
+
+// A job run by the pool. Index is the number of this job, from 0 to the job count - 1
+typedef void (*WorkerJob)(void* Data, int Index);
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: WorkerPoolClass
+// Keeps worker threads waiting so a set of jobs can be run across them without creating threads each time. The thread calling
+// Run works on the jobs as well and returns once all of them are finished. Which thread runs which job depends on timing, so
+// each job should only write to its own results for the outcome to be the same on any number of threads
+////////////////////////////////////////////////////////////////////////////////
+class WorkerPoolClass
+{
+public:
+	// Function:		Worker Pool constructor
+	// What it does:	Initialises all variables to their defaults
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	WorkerPoolClass();
+
+
+	// Placeholder destructor
+	~WorkerPoolClass();
+
+
+	// Function:		Initialise function
+	// What it does:	Starts the worker threads. The thread calling Run counts as one of the threads
+	// Takes in:		int - Number of threads to run jobs on (1 runs every job on the thread calling Run)
+	// Returns:			True if the threads were started, false if the count isn't valid
+	bool Initialise(int ThreadCount);
+
+
+	// Function:		Run function
+	// What it does:	Runs a set of jobs across the threads and waits for all of them to finish
+	// Takes in:		WorkerJob - the function run for each job, void - pointer passed to every job, int - Number of jobs
+	// Returns:			Nothing
+	void Run(WorkerJob Job, void* Data, int JobCount);
+
+
+	// Function:		Get Thread Count function
+	// What it does:	Returns the number of threads jobs are run on, including the thread calling Run
+	// Takes in:		Nothing
+	// Returns:			int - Number of threads
+	int GetThreadCount();
+
+
+	// Function:		Shutdown function
+	// What it does:	Stops the worker threads and waits for them to finish
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void Shutdown();
+
+private:
+	// Function:		Worker Loop function
+	// What it does:	Run by each worker thread. Waits for a set of jobs, works on them until none are left, then waits again
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void WorkerLoop();
+
+
+	// Function:		Work On Jobs function
+	// What it does:	Takes jobs from the current set and runs them until none are left
+	// Takes in:		Nothing
+	// Returns:			Nothing
+	void WorkOnJobs();
+
+private:
+	// Worker threads and the lock and signals used to hand them jobs
+	vector<std::thread> m_Threads;
+	std::mutex m_Lock;
+	std::condition_variable m_JobsReady;
+	std::condition_variable m_JobsDone;
+
+	// The current set of jobs. Generation goes up by one for each set so the workers know when there is a new one
+	WorkerJob m_Job;
+	void* m_Data;
+	int m_JobCount;
+	std::atomic<int> m_NextJob;
+	std::atomic<int> m_JobsFinished;
+	int m_Generation;
+	int m_WorkersBusy;
+	bool m_Stopping;
+};
+
+
+#endif
@@ -49,6 +49,25 @@ void TextureClass::Shutdown()
 }
 
 
+void TextureClass::SetTexture(ID3D11ShaderResourceView* texture)
+{
+	// Hold on to the new texture before letting go of the old one, in case they are the same.
+	if(texture)
+	{
+		texture->AddRef();
+	}
+
+	if(m_texture)
+	{
+		m_texture->Release();
+	}
+
+	m_texture = texture;
+
+	return;
+}
+
+
 ID3D11ShaderResourceView* TextureClass::GetTexture()
 {
 	return m_texture;
@@ -25,6 +25,7 @@ public:
 	bool Initialize(ID3D11Device*, WCHAR*);
 	void Shutdown();
 
+	void SetTexture(ID3D11ShaderResourceView*);
 	ID3D11ShaderResourceView* GetTexture();
 
 private:
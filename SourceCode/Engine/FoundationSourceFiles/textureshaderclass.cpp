@@ -9,6 +9,8 @@ TextureShaderClass::TextureShaderClass()
 	m_vertexShader = 0;
 	m_pixelShader = 0;
 	m_layout = 0;
+	m_compactVertexShader = 0;
+	m_compactLayout = 0;
 	m_matrixBuffer = 0;
 	m_sampleState = 0;
 }
@@ -61,7 +63,26 @@ bool TextureShaderClass::Render(ID3D11DeviceContext* deviceContext, int indexCou
 	}
 
 	// Now render the prepared buffers with the shader.
-	RenderShader(deviceContext, indexCount);
+	RenderShader(deviceContext, indexCount, false);
+
+	return true;
+}
+
+bool TextureShaderClass::RenderCompact(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, 
+				D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
+{
+	bool result;
+
+
+	// Set the shader parameters that it will use for rendering.
+	result = SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture);
+	if(!result)
+	{
+		return false;
+	}
+
+	// Now render the prepared buffers with the compact vertex shader.
+	RenderShader(deviceContext, indexCount, true);
 
 	return true;
 }
@@ -73,6 +94,7 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	ID3D10Blob* vertexShaderBuffer;
 	ID3D10Blob* pixelShaderBuffer;
 	D3D11_INPUT_ELEMENT_DESC polygonLayout[3];
+	D3D11_INPUT_ELEMENT_DESC compactLayout[2];
 	unsigned int numElements;
 	D3D11_BUFFER_DESC matrixBufferDesc;
 	D3D11_SAMPLER_DESC samplerDesc;
@@ -179,6 +201,59 @@ bool TextureShaderClass::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR
 	pixelShaderBuffer->Release();
 	pixelShaderBuffer = 0;
 
+	// Compile the compact vertex shader code from the same file.
+	result = D3DX11CompileFromFile(vsFilename, NULL, NULL, "TextureCompactVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, 
+				       &vertexShaderBuffer, &errorMessage, NULL);
+	if(FAILED(result))
+	{
+		if(errorMessage)
+		{
+			OutputShaderErrorMessage(errorMessage, hwnd, vsFilename);
+		}
+		else
+		{
+			MessageBox(hwnd, vsFilename, L"Missing Shader File", MB_OK);
+		}
+
+		return false;
+	}
+
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), NULL, &m_compactVertexShader);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	// The compact layout has half float positions (with the normal index in w) and texture co-ordinates.
+	// This setup needs to match the VertexType structure in the CompactVertexClass.
+	compactLayout[0].SemanticName = "POSITION";
+	compactLayout[0].SemanticIndex = 0;
+	compactLayout[0].Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+	compactLayout[0].InputSlot = 0;
+	compactLayout[0].AlignedByteOffset = 0;
+	compactLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	compactLayout[0].InstanceDataStepRate = 0;
+
+	compactLayout[1].SemanticName = "TEXCOORD";
+	compactLayout[1].SemanticIndex = 0;
+	compactLayout[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	compactLayout[1].InputSlot = 0;
+	compactLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	compactLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	compactLayout[1].InstanceDataStepRate = 0;
+
+	numElements = sizeof(compactLayout) / sizeof(compactLayout[0]);
+
+	result = device->CreateInputLayout(compactLayout, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), 
+					   &m_compactLayout);
+	if(FAILED(result))
+	{
+		return false;
+	}
+
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = 0;
+
 	// Setup the description of the dynamic matrix constant buffer that is in the vertex shader.
 	matrixBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
 	matrixBufferDesc.ByteWidth = sizeof(MatrixBufferType);
@@ -235,6 +310,19 @@ void TextureShaderClass::ShutdownShader()
 		m_matrixBuffer = 0;
 	}
 
+	// Release the compact layout and vertex shader.
+	if(m_compactLayout)
+	{
+		m_compactLayout->Release();
+		m_compactLayout = 0;
+	}
+
+	if(m_compactVertexShader)
+	{
+		m_compactVertexShader->Release();
+		m_compactVertexShader = 0;
+	}
+
 	// Release the layout.
 	if(m_layout)
 	{
@@ -338,13 +426,24 @@ bool TextureShaderClass::SetShaderParameters(ID3D11DeviceContext* deviceContext,
 	return true;
 }
 
-void TextureShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
+void TextureShaderClass::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount, bool compact)
 {
-	// Set the vertex input layout.
-	deviceContext->IASetInputLayout(m_layout);
+	if(compact)
+	{
+		// Set the compact input layout and vertex shader.
+		deviceContext->IASetInputLayout(m_compactLayout);
+		deviceContext->VSSetShader(m_compactVertexShader, NULL, 0);
+	}
+	else
+	{
+		// Set the vertex input layout.
+		deviceContext->IASetInputLayout(m_layout);
+
+		// Set the vertex shader that will be used to render this triangle.
+		deviceContext->VSSetShader(m_vertexShader, NULL, 0);
+	}
 
-	// Set the vertex and pixel shaders that will be used to render this triangle.
-	deviceContext->VSSetShader(m_vertexShader, NULL, 0);
+	// Set the pixel shader that will be used to render this triangle.
 	deviceContext->PSSetShader(m_pixelShader, NULL, 0);
 
 	// Set the sampler state in the pixel shader.